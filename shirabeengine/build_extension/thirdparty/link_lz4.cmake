@@ -0,0 +1,24 @@
+function(linkLibrary)
+
+    set(TARGET_DIR ${SHIRABE_PLATFORM_PREFIX}${SHIRABE_PLATFORM_ADDRESS_SIZE}/${SHIRABE_PLATFORM_CONFIG})
+    set(LZ4        ${THIRD_PARTY_DIR}/_deploy/lz4/${TARGET_DIR})
+
+    # -I
+    append_parentscope(
+        SHIRABE_PROJECT_INCLUDEPATH
+        ${LZ4}/include
+        )
+
+    # -L
+    append_parentscope(
+        SHIRABE_PROJECT_LIBRARY_DIRECTORIES
+        ${LZ4}/lib
+        )
+
+    # -l
+    append_parentscope(
+        SHIRABE_PROJECT_LIBRARY_TARGETS
+        lz4
+        )
+
+endfunction(linkLibrary)
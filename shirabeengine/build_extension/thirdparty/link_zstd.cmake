@@ -0,0 +1,24 @@
+function(linkLibrary)
+
+    set(TARGET_DIR ${SHIRABE_PLATFORM_PREFIX}${SHIRABE_PLATFORM_ADDRESS_SIZE}/${SHIRABE_PLATFORM_CONFIG})
+    set(ZSTD       ${THIRD_PARTY_DIR}/_deploy/zstd/${TARGET_DIR})
+
+    # -I
+    append_parentscope(
+        SHIRABE_PROJECT_INCLUDEPATH
+        ${ZSTD}/include
+        )
+
+    # -L
+    append_parentscope(
+        SHIRABE_PROJECT_LIBRARY_DIRECTORIES
+        ${ZSTD}/lib
+        )
+
+    # -l
+    append_parentscope(
+        SHIRABE_PROJECT_LIBRARY_TARGETS
+        zstd
+        )
+
+endfunction(linkLibrary)
@@ -0,0 +1,25 @@
+#ifndef __SHIRABE_ENGINE_TEST_ASSETCOMPRESSION_H__
+#define __SHIRABE_ENGINE_TEST_ASSETCOMPRESSION_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Asset
+    {
+
+        class Test__AssetCompression
+        {
+        public_methods:
+            bool testAll();
+            bool testRoundTrip();
+            bool testStreamingBlocks();
+            bool testRanges();
+            bool testRejectsCorruptInput();
+        };
+
+    }
+}
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef __SHIRABE_ENGINE_TEST_ASSETINDEX_H__
+#define __SHIRABE_ENGINE_TEST_ASSETINDEX_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Asset
+    {
+
+        class Test__AssetIndex
+        {
+        public_methods:
+            bool testAll();
+            bool testBinaryRoundTrip();
+            bool testRejectsInvalidIndex();
+        };
+
+    }
+}
+
+#endif
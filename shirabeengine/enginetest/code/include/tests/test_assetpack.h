@@ -0,0 +1,24 @@
+#ifndef __SHIRABE_ENGINE_TEST_ASSETPACK_H__
+#define __SHIRABE_ENGINE_TEST_ASSETPACK_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Asset
+    {
+
+        class Test__AssetPack
+        {
+        public_methods:
+            bool testAll();
+            bool testRoundTrip();
+            bool testRangedReads();
+            bool testRejectsInvalidInput();
+        };
+
+    }
+}
+
+#endif
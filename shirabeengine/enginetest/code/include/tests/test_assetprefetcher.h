@@ -0,0 +1,25 @@
+#ifndef __SHIRABE_ENGINE_TEST_ASSETPREFETCHER_H__
+#define __SHIRABE_ENGINE_TEST_ASSETPREFETCHER_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Asset
+    {
+
+        class Test__AssetPrefetcher
+        {
+        public_methods:
+            bool testAll();
+            bool testDataCache();
+            bool testDataCachePinning();
+            bool testStorageCaching();
+            bool testDependencyGraph();
+        };
+
+    }
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __SHIRABE_ENGINE_TEST_ASSETREADQUEUE_H__
+#define __SHIRABE_ENGINE_TEST_ASSETREADQUEUE_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Asset
+    {
+
+        class Test__AssetReadQueue
+        {
+        public_methods:
+            bool testAll();
+            bool testBatch();
+            bool testLooperDelivery();
+            bool testErrors();
+        };
+
+    }
+}
+
+#endif
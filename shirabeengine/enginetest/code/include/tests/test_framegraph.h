@@ -15,6 +15,9 @@ namespace Test
         public_methods:
             bool testAll();
             bool testGraphBuilder();
+            bool testCompiledGraphCache();
+            bool testTransientAliasing();
+            bool testPassCulling();
         };
 
     }
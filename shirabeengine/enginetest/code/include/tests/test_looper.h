@@ -0,0 +1,26 @@
+#ifndef __SHIRABE_ENGINE_TEST_LOOPER_H__
+#define __SHIRABE_ENGINE_TEST_LOOPER_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Threading
+    {
+
+        class Test__Looper
+        {
+        public_methods:
+            bool testAll();
+            bool testPriorityOrdering();
+            bool testAging();
+            bool testStatistics();
+            bool benchmarkPostDelayed();
+            bool benchmarkSubmissionQueue();
+        };
+
+    }
+}
+
+#endif
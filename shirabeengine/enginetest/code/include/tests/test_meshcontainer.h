@@ -0,0 +1,27 @@
+#ifndef __SHIRABE_ENGINE_TEST_MESHCONTAINER_H__
+#define __SHIRABE_ENGINE_TEST_MESHCONTAINER_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Mesh
+    {
+
+        class Test__MeshContainer
+        {
+        public_methods:
+            bool testAll();
+            bool testRoundTrip();
+            bool testInterleaved();
+            bool testWideIndices();
+            bool testRejectsInvalidInput();
+            bool testLodSelection();
+            bool testAsyncLoading();
+        };
+
+    }
+}
+
+#endif
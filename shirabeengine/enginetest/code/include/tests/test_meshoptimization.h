@@ -0,0 +1,25 @@
+#ifndef __SHIRABE_ENGINE_TEST_MESHOPTIMIZATION_H__
+#define __SHIRABE_ENGINE_TEST_MESHOPTIMIZATION_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Mesh
+    {
+
+        class Test__MeshOptimization
+        {
+        public_methods:
+            bool testAll();
+            bool testVertexCache();
+            bool testVertexFetch();
+            bool testWelding();
+            bool testSimplification();
+        };
+
+    }
+}
+
+#endif
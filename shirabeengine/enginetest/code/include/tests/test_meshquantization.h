@@ -0,0 +1,24 @@
+#ifndef __SHIRABE_ENGINE_TEST_MESHQUANTIZATION_H__
+#define __SHIRABE_ENGINE_TEST_MESHQUANTIZATION_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Mesh
+    {
+
+        class Test__MeshQuantization
+        {
+        public_methods:
+            bool testAll();
+            bool testHalf();
+            bool testOctahedral();
+            bool testUnorm16();
+        };
+
+    }
+}
+
+#endif
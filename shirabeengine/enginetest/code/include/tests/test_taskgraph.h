@@ -0,0 +1,28 @@
+#ifndef __SHIRABE_ENGINE_TEST_TASKGRAPH_H__
+#define __SHIRABE_ENGINE_TEST_TASKGRAPH_H__
+
+#include <log/log.h>
+#include <base/declaration.h>
+
+namespace Test
+{
+    namespace Threading
+    {
+
+        class Test__TaskGraph
+        {
+        public_methods:
+            bool testAll();
+            bool testWideFanOutFanIn();
+            bool testLayeredDagOrdering();
+            bool testContinuationsOnFinishedTasks();
+            bool testFailurePropagation();
+            bool testAsyncResultPipelines();
+            bool testDiscardedJobs();
+            bool benchmarkThroughput();
+        };
+
+    }
+}
+
+#endif
@@ -6,7 +6,18 @@
 #include <functional>
 #include <future>
 
+#include "tests/test_assetpack.h"
+#include "tests/test_assetprefetcher.h"
+#include "tests/test_assetindex.h"
+#include "tests/test_assetcompression.h"
+#include "tests/test_assetreadqueue.h"
+#include "tests/test_filesystemassetdatasource.h"
 #include "tests/test_framegraph.h"
+#include "tests/test_looper.h"
+#include "tests/test_meshcontainer.h"
+#include "tests/test_meshoptimization.h"
+#include "tests/test_meshquantization.h"
+#include "tests/test_taskgraph.h"
 
 // #include <Util/Documents/JSON.h>
 
@@ -59,6 +70,39 @@ int main(int argc, char **argv)
 
   Test::FrameGraph::Test__FrameGraph test_framegraph{};
   test_framegraph.testAll();
+
+  Test::Threading::Test__Looper test_looper{};
+  test_looper.testAll();
+
+  Test::Threading::Test__TaskGraph test_taskgraph{};
+  test_taskgraph.testAll();
+
+  Test::Asset::Test__AssetPack test_assetpack{};
+  test_assetpack.testAll();
+
+  Test::Asset::Test__AssetIndex test_assetindex{};
+  test_assetindex.testAll();
+
+  Test::Asset::Test__AssetCompression test_assetcompression{};
+  test_assetcompression.testAll();
+
+  Test::Asset::Test__FileSystemAssetDataSource test_filesystemassetdatasource{};
+  test_filesystemassetdatasource.testAll();
+
+  Test::Asset::Test__AssetReadQueue test_assetreadqueue{};
+  test_assetreadqueue.testAll();
+
+  Test::Asset::Test__AssetPrefetcher test_assetprefetcher{};
+  test_assetprefetcher.testAll();
+
+  Test::Mesh::Test__MeshContainer test_meshcontainer{};
+  test_meshcontainer.testAll();
+
+  Test::Mesh::Test__MeshQuantization test_meshquantization{};
+  test_meshquantization.testAll();
+
+  Test::Mesh::Test__MeshOptimization test_meshoptimization{};
+  test_meshoptimization.testAll();
   
   // using namespace Engine::Documents;
 
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/jobsystem.h>
+#include <asset/assetcompression.h>
+#include <asset/iassetdatasource.h>
+
+#include "tests/test_assetcompression.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+        using namespace engine::threading;
+
+        /**
+         * Create a payload, which is partially compressible, like vertex data.
+         *
+         * @param aSize The size of the payload.
+         * @return      See brief.
+         */
+        static std::vector<uint8_t> makePayload(uint64_t aSize)
+        {
+            std::mt19937         generator(42);
+            std::vector<uint8_t> data(aSize);
+            for(uint64_t k=0; k<aSize; ++k)
+            {
+                // Random noise in the second half, repetitive data in the first.
+                data[k] = (k < (aSize / 2)) ? static_cast<uint8_t>((k / 16) % 7) : static_cast<uint8_t>(generator());
+            }
+            return data;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetCompression::testAll()
+        {
+            bool ok = true;
+
+            ok &= testRoundTrip();
+            ok &= testStreamingBlocks();
+            ok &= testRanges();
+            ok &= testRejectsCorruptInput();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetCompression::testRoundTrip()
+        {
+            Shared<CJobSystem> jobSystem = makeShared<CJobSystem>();
+            jobSystem->initialize(4);
+            jobSystem->run();
+
+            bool ok = true;
+
+            std::vector<uint64_t> const sizes = { 0, 1, 4095, kAssetBlockSize, (kAssetBlockSize + 1), (3 * kAssetBlockSize + 17) };
+            for(EAssetCodec const codec : { EAssetCodec::LZ4, EAssetCodec::Zstd })
+            {
+                for(uint64_t const size : sizes)
+                {
+                    std::vector<uint8_t> const payload = makePayload(size);
+
+                    CEngineResult<std::vector<uint8_t>> const compressed = compressAssetBlocks(payload.data(), payload.size(), codec);
+                    ok &= compressed.successful();
+                    ok &= (codec == assetBlockCodec(compressed.data().data(), compressed.data().size()));
+
+                    std::vector<uint8_t> stored = compressed.data();
+                    uint64_t const storedSize = stored.size();
+                    ByteBuffer const source(std::move(stored), storedSize);
+
+                    // Serially and in parallel.
+                    for(Shared<CJobSystem> const &system : { Shared<CJobSystem>(nullptr), jobSystem })
+                    {
+                        CEngineResult<ByteBuffer> const decompressed = decompressAssetBlocks(source, system);
+                        ok &= decompressed.successful();
+                        ok &= (payload.size() == decompressed.data().size());
+                        ok &= (0 == payload.size() || 0 == std::memcmp(payload.data(), decompressed.data().data(), payload.size()));
+                    }
+                }
+            }
+
+            jobSystem->abortAndJoin();
+            jobSystem->deinitialize();
+
+            std::cout << "Asset compression round trip: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetCompression::testStreamingBlocks()
+        {
+            uint32_t             const blockSize = 4096;
+            std::vector<uint8_t> const payload   = makePayload(10 * blockSize + 100);
+
+            CEngineResult<std::vector<uint8_t>> const compressed = compressAssetBlocks(payload.data(), payload.size(), EAssetCodec::LZ4, blockSize);
+
+            std::vector<uint8_t> stored = compressed.data();
+            uint64_t const storedSize = stored.size();
+            ByteBuffer const source(std::move(stored), storedSize);
+
+            CAssetBlockReader reader(source);
+            bool ok = reader.initialize().successful();
+            ok &= (11 == reader.blockCount());
+            ok &= (payload.size() == reader.size());
+
+            // Decode through a single block sized window, as a streaming consumer would.
+            std::vector<uint8_t> window(blockSize);
+            for(uint32_t k=0; ok && k<reader.blockCount(); ++k)
+            {
+                uint64_t const size = reader.blockDecompressedSize(k);
+                ok &= reader.decompressBlock(k, window.data()).successful();
+                ok &= (0 == std::memcmp(payload.data() + (static_cast<uint64_t>(k) * blockSize), window.data(), size));
+            }
+
+            // The compressible half must shrink.
+            ok &= (source.size() < payload.size());
+
+            std::cout << "Asset compression streaming blocks: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetCompression::testRanges()
+        {
+            uint32_t             const blockSize = 4096;
+            std::vector<uint8_t> const payload   = makePayload(10 * blockSize + 100);
+
+            bool ok = true;
+
+            for(EAssetCodec const codec : { EAssetCodec::LZ4, EAssetCodec::Zstd })
+            {
+                CEngineResult<std::vector<uint8_t>> const compressed = compressAssetBlocks(payload.data(), payload.size(), codec, blockSize);
+                std::vector<uint8_t> const &stored = compressed.data();
+
+                uint64_t bytesRead = 0;
+                AssetRangeReader_t const reader = [&] (uint64_t aOffset, uint64_t aLength) -> CEngineResult<ByteBuffer>
+                {
+                    if(stored.size() < aOffset)
+                    {
+                        return { EEngineStatus::Error };
+                    }
+
+                    uint64_t const length = std::min<uint64_t>(aLength, (stored.size() - aOffset));
+                    bytesRead += length;
+
+                    std::vector<uint8_t> range(stored.begin() + aOffset, stored.begin() + aOffset + length);
+                    return { EEngineStatus::Ok, ByteBuffer(std::move(range), length) };
+                };
+
+                // Within a block, across block borders, whole blocks, the tail and the entire payload.
+                std::vector<std::pair<uint64_t, uint64_t>> const ranges = { { 0,                  1                  }
+                                                                          , { 100,                50                 }
+                                                                          , { (blockSize - 10),   20                 }
+                                                                          , { (2 * blockSize),    (3 * blockSize)    }
+                                                                          , { (blockSize + 1),    (4 * blockSize)    }
+                                                                          , { (10 * blockSize),   kAssetReadToEnd    }
+                                                                          , { 0,                  payload.size()     } };
+                for(auto const &[offset, length] : ranges)
+                {
+                    bytesRead = 0;
+
+                    CEngineResult<ByteBuffer> const range = decompressAssetBlockRange(reader, offset, length);
+                    uint64_t const expected = std::min<uint64_t>(length, (payload.size() - offset));
+
+                    ok &= range.successful();
+                    ok &= (expected == range.data().size());
+                    ok &= (0 == expected || 0 == std::memcmp(payload.data() + offset, range.data().data(), expected));
+
+                    // Small ranges must not read the whole payload.
+                    ok &= ((blockSize < length) || (bytesRead < stored.size()));
+                }
+
+                ok &= decompressAssetBlockRange(reader, payload.size(), 10).successful();
+                ok &= not decompressAssetBlockRange(reader, (payload.size() + 1), 10).successful();
+            }
+
+            std::cout << "Asset compression ranges: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetCompression::testRejectsCorruptInput()
+        {
+            std::vector<uint8_t> const payload = makePayload(kAssetBlockSize);
+
+            bool ok = true;
+
+            ok &= not compressAssetBlocks(payload.data(), payload.size(), EAssetCodec::None).successful();
+
+            // Not block compressed.
+            {
+                std::vector<uint8_t> raw = payload;
+                uint64_t const size = raw.size();
+                ok &= not decompressAssetBlocks(ByteBuffer(std::move(raw), size)).successful();
+            }
+
+            for(EAssetCodec const codec : { EAssetCodec::LZ4, EAssetCodec::Zstd })
+            {
+                std::vector<uint8_t> const compressed = compressAssetBlocks(payload.data(), payload.size(), codec).data();
+
+                // Truncated.
+                {
+                    std::vector<uint8_t> truncated(compressed.begin(), compressed.end() - 1);
+                    uint64_t const size = truncated.size();
+                    ok &= not decompressAssetBlocks(ByteBuffer(std::move(truncated), size)).successful();
+                }
+
+                // Damaged block data.
+                {
+                    std::vector<uint8_t> damaged = compressed;
+                    uint64_t const blockData = (sizeof(SAssetBlockHeader) + (2 * sizeof(uint64_t)));
+                    std::memset(damaged.data() + blockData, 0xFF, 16);
+                    uint64_t const size = damaged.size();
+                    ok &= not decompressAssetBlocks(ByteBuffer(std::move(damaged), size)).successful();
+                }
+            }
+
+            std::cout << "Asset compression corrupt input: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,137 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <asset/assetindex.h>
+#include <asset/assetstorage.h>
+
+#include "tests/test_assetindex.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetIndex::testAll()
+        {
+            bool ok = true;
+
+            ok &= testBinaryRoundTrip();
+            ok &= testRejectsInvalidIndex();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetIndex::testBinaryRoundTrip()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetindex");
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root);
+
+            std::vector<SAsset> assets {};
+            for(uint32_t k=0; k<1000; ++k)
+            {
+                SAsset asset {};
+                asset.uri     = std::filesystem::path("materials") / ("material" + std::to_string(k) + ".spv");
+                asset.id      = assetIdFromUri(asset.uri);
+                asset.parent  = (0 == k) ? 0 : assets.front().id;
+                asset.type    = EAssetType::Material;
+                asset.subtype = (0 == (k % 2)) ? EAssetSubtype::SPVModule : EAssetSubtype::Signature;
+                assets.push_back(asset);
+            }
+
+            // Include an empty uri to cover zero length strings.
+            SAsset empty {};
+            empty.id = 1_uid;
+            assets.push_back(empty);
+
+            bool ok = CAssetIndex::writeBinaryIndex(root / "game.assetindex", assets).successful();
+
+            CEngineResult<Shared<CBinaryAssetIndex>> const load = CBinaryAssetIndex::load(root / "game.assetindex");
+            ok &= load.successful();
+
+            if(ok)
+            {
+                Shared<CBinaryAssetIndex> const index = load.data();
+                ok &= (assets.size() == index->size());
+
+                for(SAsset const &expected : assets)
+                {
+                    CEngineResult<SAsset> const found = index->findAsset(expected.id);
+                    ok &= found.successful();
+                    ok &= (expected.id      == found.data().id);
+                    ok &= (expected.parent  == found.data().parent);
+                    ok &= (expected.type    == found.data().type);
+                    ok &= (expected.subtype == found.data().subtype);
+                    ok &= (0 == found.data().uri.compare((root / expected.uri).lexically_normal()));
+                }
+
+                ok &= not index->findAsset(0_uid).successful();
+
+                // Lookups through the storage resolve the binary index.
+                CAssetStorage storage(nullptr);
+                storage.readIndex(index);
+                ok &= storage.loadAsset(assets[10].id).successful();
+                ok &= storage.assetFromUri((root / assets[10].uri).lexically_normal()).successful();
+            }
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Binary asset index round trip (" << assets.size() << " assets): " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetIndex::testRejectsInvalidIndex()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetindex_invalid");
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root);
+
+            bool ok = true;
+
+            SAsset a {};
+            a.id  = 1_uid;
+            a.uri = "a";
+
+            // Duplicate ids.
+            ok &= not CAssetIndex::writeBinaryIndex(root / "duplicate.assetindex", { a, a }).successful();
+
+            // Missing file.
+            ok &= not CBinaryAssetIndex::load(root / "missing.assetindex").successful();
+
+            // Truncated file.
+            ok &= CAssetIndex::writeBinaryIndex(root / "truncated.assetindex", { a }).successful();
+            std::filesystem::resize_file(root / "truncated.assetindex", std::filesystem::file_size(root / "truncated.assetindex") - 1);
+            ok &= not CBinaryAssetIndex::load(root / "truncated.assetindex").successful();
+
+            // Not an index.
+            {
+                std::ofstream output(root / "garbage.assetindex", std::ios::out | std::ios::binary | std::ios::trunc);
+                output << std::string(128, 'x');
+            }
+            ok &= not CBinaryAssetIndex::load(root / "garbage.assetindex").successful();
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Binary asset index invalid input: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
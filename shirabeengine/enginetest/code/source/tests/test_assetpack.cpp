@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <asset/assetpack.h>
+#include <asset/filesystemassetdatasource.h>
+#include <asset/packassetdatasource.h>
+
+#include "tests/test_assetpack.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+
+        /**
+         * Write aData to aPath, creating parent directories as required.
+         *
+         * @param aPath The file to write.
+         * @param aData The content.
+         */
+        static void writeTestFile(std::filesystem::path const &aPath, std::vector<uint8_t> const &aData)
+        {
+            std::filesystem::create_directories(aPath.parent_path());
+
+            std::ofstream output(aPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            output.write(reinterpret_cast<char const *>(aData.data()), static_cast<std::streamsize>(aData.size()));
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPack::testAll()
+        {
+            bool ok = true;
+
+            ok &= testRoundTrip();
+            ok &= testRangedReads();
+            ok &= testRejectsInvalidInput();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPack::testRoundTrip()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetpack");
+            std::filesystem::remove_all(root);
+
+            // Sizes around the page size and an empty file.
+            std::vector<uint64_t> const sizes = { 0, 1, 17, 4095, 4096, 4097, 100000 };
+
+            std::mt19937                  generator(1234);
+            std::vector<SAssetPackSource> sources  {};
+            std::vector<std::vector<uint8_t>> contents {};
+
+            for(uint64_t k=0; k<sizes.size(); ++k)
+            {
+                std::vector<uint8_t> data(sizes[k]);
+                for(uint8_t &byte : data)
+                {
+                    byte = static_cast<uint8_t>(generator());
+                }
+
+                std::filesystem::path const uri = std::filesystem::path("meshes") / ("mesh" + std::to_string(k) + ".attributes");
+                writeTestFile(root / uri, data);
+
+                sources.push_back({ assetIdFromUri(uri), root / uri });
+                contents.push_back(std::move(data));
+            }
+
+            bool ok = writeAssetPack(root / "game.assetpack", sources).successful();
+
+            CPackAssetDataSource dataSource(root / "game.assetpack", root);
+            ok &= dataSource.initialize().successful();
+            ok &= (sources.size() == dataSource.entryCount());
+
+            for(uint64_t k=0; k<sources.size(); ++k)
+            {
+                // Read through the same path the asset storage composes from the index.
+                CEngineResult<ByteBuffer> const read = dataSource.readAsset(sources[k].path);
+                ok &= read.successful();
+                ok &= (contents[k].size() == read.data().size());
+                ok &= (0 == contents[k].size() || std::equal(contents[k].begin(), contents[k].end(), read.data().data()));
+                ok &= (0 == (reinterpret_cast<uintptr_t>(read.data().data()) % kAssetPackAlignment) || not read.data().isView());
+            }
+
+            ok &= not dataSource.readAsset(root / "meshes" / "missing.attributes").successful();
+
+            // Views stay valid after the pack was closed.
+            CEngineResult<ByteBuffer> const last = dataSource.readAssetById(sources.back().id);
+            ok &= dataSource.deinitialize().successful();
+            ok &= std::equal(contents.back().begin(), contents.back().end(), last.data().data());
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset pack round trip (" << sources.size() << " entries): " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPack::testRangedReads()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetpack_ranges");
+            std::filesystem::remove_all(root);
+
+            std::mt19937         generator(4321);
+            std::vector<uint8_t> data(3 * 4096 + 123);
+            for(uint8_t &byte : data)
+            {
+                byte = static_cast<uint8_t>(generator());
+            }
+
+            std::filesystem::path const uri = std::filesystem::path("textures") / "layers.texturedata";
+            writeTestFile(root / uri, data);
+
+            bool ok = writeAssetPack(root / "game.assetpack", { { assetIdFromUri(uri), root / uri } }).successful();
+
+            CPackAssetDataSource packSource(root / "game.assetpack", root);
+            ok &= packSource.initialize().successful();
+
+            CFileSystemAssetDataSource mappedSource(root, true);
+            CFileSystemAssetDataSource streamSource(root, false);
+
+            std::vector<std::pair<uint64_t, uint64_t>> const ranges = { { 0,          1               }
+                                                                      , { 4000,       200             }
+                                                                      , { 4096,       4096            }
+                                                                      , { 5000,       kAssetReadToEnd }
+                                                                      , { data.size(), 10             } };
+
+            for(IAssetDataSource *source : { static_cast<IAssetDataSource *>(&packSource), static_cast<IAssetDataSource *>(&mappedSource), static_cast<IAssetDataSource *>(&streamSource) })
+            {
+                for(auto const &[offset, length] : ranges)
+                {
+                    CEngineResult<ByteBuffer> const range = source->readAssetRange(root / uri, offset, length);
+                    uint64_t const expected = std::min<uint64_t>(length, (data.size() - offset));
+
+                    ok &= range.successful();
+                    ok &= (expected == range.data().size());
+                    ok &= (0 == expected || std::equal(data.begin() + offset, data.begin() + offset + expected, range.data().data()));
+                }
+
+                ok &= not source->readAssetRange(root / uri, (data.size() + 1), 1).successful();
+            }
+
+            ok &= packSource.deinitialize().successful();
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset pack ranged reads: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPack::testRejectsInvalidInput()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetpack_invalid");
+            std::filesystem::remove_all(root);
+
+            writeTestFile(root / "a.bin", { 1, 2, 3 });
+            writeTestFile(root / "b.bin", { 4, 5, 6 });
+
+            bool ok = true;
+
+            // Duplicate ids.
+            ok &= not writeAssetPack(root / "duplicate.assetpack", { { 1, root / "a.bin" }, { 1, root / "b.bin" } }).successful();
+
+            // Missing source.
+            ok &= not writeAssetPack(root / "missing.assetpack", { { 1, root / "c.bin" } }).successful();
+
+            // Not a pack.
+            CPackAssetDataSource dataSource(root / "a.bin", root);
+            ok &= not dataSource.initialize().successful();
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset pack invalid input: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
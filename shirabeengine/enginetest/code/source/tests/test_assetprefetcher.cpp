@@ -0,0 +1,320 @@
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/jobsystem.h>
+#include <asset/assetprefetcher.h>
+#include <asset/assetstorage.h>
+#include <asset/filesystemassetdatasource.h>
+
+#include "tests/test_assetprefetcher.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+
+        /**
+         * Create a buffer of aSize bytes holding aValue.
+         */
+        static ByteBuffer makeBuffer(uint64_t aSize, uint8_t aValue)
+        {
+            std::vector<uint8_t> data(aSize, aValue);
+            return ByteBuffer(std::move(data), aSize);
+        }
+
+        /**
+         * Test resolver: The data of an asset is the array of the asset ids it refers to.
+         */
+        static std::vector<AssetId_t> resolveIdList(SAsset const &aAsset, ByteBuffer const &aData)
+        {
+            SHIRABE_UNUSED(aAsset);
+
+            std::vector<AssetId_t> dependencies(aData.size() / sizeof(AssetId_t));
+            if(not dependencies.empty())
+            {
+                std::memcpy(dependencies.data(), aData.data(), (dependencies.size() * sizeof(AssetId_t)));
+            }
+            return dependencies;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPrefetcher::testAll()
+        {
+            bool ok = true;
+
+            ok &= testDataCache();
+            ok &= testDataCachePinning();
+            ok &= testStorageCaching();
+            ok &= testDependencyGraph();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPrefetcher::testDataCache()
+        {
+            CAssetDataCache cache(100);
+
+            bool ok = true;
+
+            ok &= cache.insert(1, makeBuffer(40, 1));
+            ok &= cache.insert(2, makeBuffer(40, 2));
+            ok &= cache.find(1).successful(); // 2 is least recently used now.
+            ok &= cache.insert(3, makeBuffer(40, 3));
+
+            ok &= (2 == cache.entryCount());
+            ok &= (80 == cache.size());
+            ok &= cache.contains(1);
+            ok &= not cache.contains(2);
+            ok &= cache.contains(3);
+
+            // Buffers handed out outlive their eviction.
+            CEngineResult<ByteBuffer> const held = cache.find(3);
+            ok &= cache.insert(4, makeBuffer(100, 4));
+            ok &= (1 == cache.entryCount());
+            ok &= (40 == held.data().size() && 3 == held.data().data()[39]);
+
+            ok &= not cache.insert(5, makeBuffer(101, 5));
+            ok &= not cache.contains(5);
+
+            cache.erase(4);
+            ok &= (0 == cache.size());
+
+            ok &= not cache.find(2).successful();
+
+            SAssetDataCacheStatistics const statistics = cache.statistics();
+            ok &= (2 == statistics.hits);
+            ok &= (1 == statistics.misses);
+            ok &= (3 == statistics.evictions);
+            ok &= (0 == statistics.entryCount);
+
+            // The order of use is kept across shards.
+            CAssetDataCache sharded(100, 4);
+            for(AssetId_t id=1; id<=10; ++id)
+            {
+                ok &= sharded.insert(id, makeBuffer(10, static_cast<uint8_t>(id)));
+            }
+            ok &= sharded.find(1).successful();
+            ok &= sharded.insert(11, makeBuffer(20, 11));
+            ok &= sharded.contains(1);
+            ok &= not sharded.contains(2);
+            ok &= not sharded.contains(3);
+            ok &= sharded.contains(4);
+
+            sharded.setCapacity(50);
+            ok &= (50 == sharded.size());
+            ok &= (sharded.contains(1) && sharded.contains(11));
+
+            std::cout << "Asset data cache: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPrefetcher::testDataCachePinning()
+        {
+            CAssetDataCache cache(100, 2);
+
+            bool ok = true;
+
+            cache.pin(2); // Before insertion.
+            ok &= cache.insert(1, makeBuffer(40, 1));
+            ok &= cache.insert(2, makeBuffer(40, 2));
+            cache.pin(1);
+            cache.pin(1);
+
+            // Nothing can be evicted, so the new entry is dropped again.
+            ok &= not cache.insert(3, makeBuffer(40, 3));
+            ok &= (cache.contains(1) && cache.contains(2));
+            ok &= (2 == cache.statistics().pinnedCount);
+
+            cache.unpin(1);
+            ok &= not cache.insert(3, makeBuffer(40, 3)); // 1 is still pinned once.
+
+            cache.unpin(1);
+            ok &= cache.insert(3, makeBuffer(40, 3));
+            ok &= not cache.contains(1);
+            ok &= cache.contains(2);
+
+            // Shrinking the budget below the pinned data evicts everything else and keeps the pinned data.
+            cache.setCapacity(10);
+            ok &= (cache.contains(2) && not cache.contains(3));
+            ok &= (40 == cache.size());
+
+            // Unpinning evicts, what exceeds the budget.
+            cache.unpin(2);
+            ok &= (0 == cache.size());
+
+            std::cout << "Asset data cache pinning: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPrefetcher::testStorageCaching()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetstoragecaching");
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root);
+
+            CAssetStorage::AssetRegistry_t registry {};
+            for(AssetId_t id=1; id<=3; ++id)
+            {
+                std::filesystem::path const path = (root / ("asset" + std::to_string(id) + ".bin"));
+                std::ofstream stream(path, std::ios::out | std::ios::binary);
+                std::vector<char> const content(64, static_cast<char>(id));
+                stream.write(content.data(), static_cast<std::streamsize>(content.size()));
+
+                SAsset asset {};
+                asset.id      = id;
+                asset.type    = EAssetType::Buffer;
+                asset.subtype = EAssetSubtype::DataFile;
+                asset.codec   = EAssetCodec::None;
+                asset.uri     = path;
+                registry.addAsset(id, asset);
+            }
+
+            Shared<CAssetStorage> storage = makeShared<CAssetStorage>(makeUnique<CFileSystemAssetDataSource>(root, false));
+            storage->readIndex(registry);
+
+            Shared<CAssetDataCache> const cache = makeShared<CAssetDataCache>(128);
+            storage->setDataCache(cache);
+
+            bool ok = true;
+
+            // Complete reads populate the cache.
+            ok &= storage->loadAssetData(1).successful();
+            ok &= cache->contains(1);
+
+            std::vector<AssetReadFuture_t> const futures = storage->loadAssetDataBatch({ 1, 2 });
+            for(AssetReadFuture_t const &future : futures)
+            {
+                ok &= future.get().successful();
+            }
+            ok &= cache->contains(2);
+
+            SAssetDataCacheStatistics const statistics = cache->statistics();
+            ok &= (1 == statistics.hits);   // 1 in the batch.
+            ok &= (2 == statistics.misses); // 1 on the first load and 2 in the batch.
+
+            // A pinned asset survives the eviction of another.
+            storage->pinAssetData(1);
+            ok &= storage->loadAssetData(3).successful();
+            ok &= (cache->contains(1) && cache->contains(3) && not cache->contains(2));
+            storage->unpinAssetData(1);
+
+            std::filesystem::remove_all(root);
+            ok &= storage->loadAssetData(1).successful();
+            ok &= not storage->loadAssetData(2).successful();
+
+            std::cout << "Asset storage caching: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetPrefetcher::testDependencyGraph()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_assetprefetcher");
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root);
+
+            // 1 -> { 2, 3 }, 2 -> { 4 }, 3 -> { 4, 5 }, 5 -> { 99 (not indexed) }, 4 -> {}
+            std::vector<std::pair<AssetId_t, std::vector<AssetId_t>>> const graph = { { 1, { 2, 3 } }
+                                                                                    , { 2, { 4    } }
+                                                                                    , { 3, { 4, 5 } }
+                                                                                    , { 4, {      } }
+                                                                                    , { 5, { 99   } } };
+
+            CAssetStorage::AssetRegistry_t registry {};
+            for(auto const &[id, dependencies] : graph)
+            {
+                std::filesystem::path const path = (root / ("asset" + std::to_string(id) + ".bin"));
+                std::ofstream stream(path, std::ios::out | std::ios::binary);
+                stream.write(reinterpret_cast<char const *>(dependencies.data()), static_cast<std::streamsize>(dependencies.size() * sizeof(AssetId_t)));
+                stream.put('\n'); // Not an id, so that leaves aren't empty files.
+
+                SAsset asset {};
+                asset.id      = id;
+                asset.type    = EAssetType::Material;
+                asset.subtype = EAssetSubtype::Meta;
+                asset.codec   = EAssetCodec::None;
+                asset.uri     = path;
+                registry.addAsset(id, asset);
+            }
+
+            Shared<CAssetStorage> storage = makeShared<CAssetStorage>(makeUnique<CFileSystemAssetDataSource>(root, false));
+            storage->readIndex(registry);
+
+            CAssetPrefetcher prefetcher(storage);
+            prefetcher.registerDependencyResolver(EAssetType::Material, &resolveIdList);
+
+            bool ok = not prefetcher.prefetch({ 1 }).successful(); // No cache assigned.
+
+            storage->setDataCache(makeShared<CAssetDataCache>(1024 * 1024));
+
+            CEngineResult<SAssetPrefetchStatistics> const first = prefetcher.prefetch({ 1 });
+            ok &= first.successful();
+            ok &= (3 == first.data().waveCount);
+            ok &= (5 == first.data().readCount);
+            ok &= (1 == first.data().failedCount);
+            ok &= (5 == storage->dataCache()->entryCount());
+
+            // The same, resolving the dependencies on a job system.
+            Shared<threading::CJobSystem> jobSystem = makeShared<threading::CJobSystem>();
+            jobSystem->initialize(2);
+            jobSystem->run();
+
+            storage->setDataCache(makeShared<CAssetDataCache>(1024 * 1024));
+            prefetcher.setJobSystem(jobSystem);
+
+            CEngineResult<SAssetPrefetchStatistics> const parallel = prefetcher.prefetch({ 1 });
+            ok &= parallel.successful();
+            ok &= (3 == parallel.data().waveCount);
+            ok &= (5 == parallel.data().readCount);
+            ok &= (1 == parallel.data().failedCount);
+            ok &= (first.data().bytesRead == parallel.data().bytesRead);
+            ok &= (5 == storage->dataCache()->entryCount());
+
+            // Everything is served from the cache now.
+            std::filesystem::remove_all(root);
+
+            CEngineResult<ByteBuffer> const data = storage->loadAssetData(3);
+            ok &= data.successful();
+            ok &= (resolveIdList({}, data.data()) == graph[2].second);
+
+            CEngineResult<ByteBuffer> const range = storage->loadAssetDataRange(3, sizeof(AssetId_t), kAssetReadToEnd);
+            ok &= (range.successful() && (data.data().size() - sizeof(AssetId_t)) == range.data().size());
+            ok &= (range.successful() && 0 == std::memcmp(range.data().data(), (data.data().data() + sizeof(AssetId_t)), range.data().size()));
+
+            CEngineResult<SAssetPrefetchStatistics> const second = prefetcher.prefetch({ 1, 4 });
+            ok &= second.successful();
+            ok &= (0 == second.data().readCount);
+            ok &= (5 == second.data().cachedCount);
+
+            jobSystem->abortAndJoin();
+            jobSystem->deinitialize();
+
+            std::cout << "Asset prefetcher dependency graph: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/looper.h>
+#include <asset/assetreadqueue.h>
+
+#include "tests/test_assetreadqueue.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+        using namespace engine::threading;
+
+        /**
+         * Create aCount files of different sizes in aRoot, each filled with its own pattern.
+         *
+         * @return The file paths and contents.
+         */
+        static std::vector<std::pair<std::filesystem::path, std::vector<uint8_t>>> makeFiles(std::filesystem::path const &aRoot, uint32_t aCount)
+        {
+            std::filesystem::remove_all(aRoot);
+            std::filesystem::create_directories(aRoot);
+
+            std::vector<std::pair<std::filesystem::path, std::vector<uint8_t>>> files {};
+            for(uint32_t k=0; k<aCount; ++k)
+            {
+                std::vector<uint8_t> data(((k * 7919) % 200000) + 64);
+                for(std::size_t i=0; i<data.size(); ++i)
+                {
+                    data[i] = static_cast<uint8_t>((i * 31) + k);
+                }
+
+                std::filesystem::path const path = (aRoot / ("file" + std::to_string(k) + ".bin"));
+                std::ofstream stream(path, std::ios::out | std::ios::binary);
+                stream.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+                files.emplace_back(path, std::move(data));
+            }
+            return files;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetReadQueue::testAll()
+        {
+            bool ok = true;
+
+            ok &= testBatch();
+            ok &= testLooperDelivery();
+            ok &= testErrors();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetReadQueue::testBatch()
+        {
+            std::filesystem::path const root  = (std::filesystem::temp_directory_path() / "shirabe_test_assetreadqueue");
+            auto                  const files = makeFiles(root, 100);
+
+            bool ok = true;
+
+            // Both backends. io_uring falls back to the thread pool, if unavailable.
+            for(bool const preferIoUring : { true, false })
+            {
+                CAssetReadQueue queue {};
+                ok &= queue.initialize(8, 4, preferIoUring).successful();
+                ok &= (preferIoUring || EAssetReadBackend::ThreadPool == queue.backend());
+
+                std::vector<SAssetReadRequest> requests(files.size());
+                for(std::size_t k=0; k<files.size(); ++k)
+                {
+                    requests[k].path = files[k].first;
+                }
+
+                // A partial read of the first file.
+                requests[0].offset = 3;
+                requests[0].length = 5;
+
+                std::atomic<uint32_t> callbacks = 0;
+                std::vector<AssetReadFuture_t> futures = queue.submitBatch(requests, [&] (std::size_t aIndex, CEngineResult<ByteBuffer> const &aResult) -> void
+                {
+                    if(aIndex < files.size() && aResult.successful())
+                    {
+                        ++callbacks;
+                    }
+                });
+
+                ok &= (files.size() == futures.size());
+                for(std::size_t k=0; k<futures.size(); ++k)
+                {
+                    CEngineResult<ByteBuffer> const &result = futures[k].get();
+
+                    uint8_t  const *const expected = (files[k].second.data() + requests[k].offset);
+                    uint64_t const        size     = std::min<uint64_t>(requests[k].length, files[k].second.size() - requests[k].offset);
+
+                    ok &= result.successful();
+                    ok &= (size == result.data().size());
+                    ok &= (result.successful() && 0 == std::memcmp(expected, result.data().data(), size));
+                }
+                ok &= (files.size() == callbacks.load());
+
+                queue.deinitialize();
+            }
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset read queue batch: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetReadQueue::testLooperDelivery()
+        {
+            std::filesystem::path const root  = (std::filesystem::temp_directory_path() / "shirabe_test_assetreadqueue_looper");
+            auto                  const files = makeFiles(root, 16);
+
+            CLooper<int> looper {};
+            looper.initialize();
+            looper.run();
+
+            std::mutex                 threadsMutex {};
+            std::set<std::thread::id>  threads      {};
+            std::atomic<uint32_t>      delivered    = 0;
+
+            CAssetReadQueue queue {};
+            bool ok = queue.initialize().successful();
+
+            std::function<int(CEngineResult<ByteBuffer> const &)> const onRead = [&] (CEngineResult<ByteBuffer> const &aResult) -> int
+            {
+                {
+                    std::lock_guard<std::mutex> guard(threadsMutex);
+                    threads.insert(std::this_thread::get_id());
+                }
+
+                if(aResult.successful())
+                {
+                    ++delivered;
+                }
+                return 0;
+            };
+
+            std::vector<AssetReadFuture_t> futures {};
+            for(auto const &[path, data] : files)
+            {
+                SAssetReadRequest request {};
+                request.path = path;
+                futures.push_back(queue.submit(request, CAssetReadQueue::deliverTo<int>(looper.getDispatcher(), onRead)));
+            }
+
+            for(AssetReadFuture_t const &future : futures)
+            {
+                ok &= future.get().successful();
+            }
+
+            auto const deadline = (std::chrono::steady_clock::now() + std::chrono::seconds(5));
+            while(files.size() > delivered.load() && std::chrono::steady_clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            queue.deinitialize();
+            looper.abortAndJoin();
+            looper.deinitialize();
+
+            // All completions arrive on the single looper thread.
+            ok &= (files.size() == delivered.load());
+            ok &= (1 == threads.size());
+            ok &= (0 == threads.count(std::this_thread::get_id()));
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset read queue looper delivery: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__AssetReadQueue::testErrors()
+        {
+            std::filesystem::path const root  = (std::filesystem::temp_directory_path() / "shirabe_test_assetreadqueue_errors");
+            auto                  const files = makeFiles(root, 1);
+
+            bool ok = true;
+
+            for(bool const preferIoUring : { true, false })
+            {
+                CAssetReadQueue queue {};
+                ok &= queue.initialize(4, 2, preferIoUring).successful();
+
+                SAssetReadRequest missing {};
+                missing.path = (root / "missing.bin");
+
+                SAssetReadRequest beyondEnd {};
+                beyondEnd.path   = files[0].first;
+                beyondEnd.offset = (files[0].second.size() + 1);
+
+                ok &= (EEngineStatus::FileNotFound == queue.submit(missing).get().result());
+                ok &= not queue.submit(beyondEnd).get().successful();
+
+                queue.deinitialize();
+
+                // Reads submitted after deinitialization fail instead of hanging.
+                ok &= not queue.submit(missing).get().successful();
+            }
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Asset read queue errors: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <asset/filesystemassetdatasource.h>
+
+#include "tests/test_filesystemassetdatasource.h"
+
+namespace Test
+{
+    namespace Asset
+    {
+        using namespace engine;
+        using namespace engine::asset;
+
+        /**
+         * Write aSize random bytes to aPath.
+         *
+         * @param aPath The file to write.
+         * @param aSize The number of bytes.
+         * @return      The content written.
+         */
+        static std::vector<uint8_t> writeRandomFile(std::filesystem::path const &aPath, std::size_t aSize)
+        {
+            std::mt19937         generator(static_cast<uint32_t>(aSize));
+            std::vector<uint8_t> data(aSize);
+            for(uint8_t &byte : data)
+            {
+                byte = static_cast<uint8_t>(generator());
+            }
+
+            std::filesystem::create_directories(aPath.parent_path());
+
+            std::ofstream output(aPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            output.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+            return data;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__FileSystemAssetDataSource::testAll()
+        {
+            bool ok = true;
+
+            ok &= testMemoryMapping();
+            ok &= testRangedReads();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__FileSystemAssetDataSource::testMemoryMapping()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_filesystemassetdatasource_mapping");
+            std::filesystem::remove_all(root);
+
+            std::filesystem::path const path = (root / "asset.bin");
+            std::vector<uint8_t> const  data = writeRandomFile(path, (2 * 4096 + 77));
+
+            bool ok = true;
+
+            ByteBuffer held {};
+            {
+                Unique<CFileSystemAssetDataSource> dataSource = makeUnique<CFileSystemAssetDataSource>(root, true);
+
+                CEngineResult<ByteBuffer> const first  = dataSource->readAsset(path);
+                CEngineResult<ByteBuffer> const second = dataSource->readAsset(path);
+                ok &= (first.successful() && second.successful());
+                ok &= (data.size() == first.data().size());
+                ok &= std::equal(data.begin(), data.end(), first.data().data());
+
+                // Views of the same, cached mapping.
+                ok &= first.data().isView();
+                ok &= (first.data().data() == second.data().data());
+                ok &= (data.size() == dataSource->mappedByteCount());
+
+                held = first.data();
+
+                dataSource->releaseMappings();
+                ok &= (0 == dataSource->mappedByteCount());
+                ok &= std::equal(data.begin(), data.end(), held.data());
+            }
+
+            // The buffer keeps the mapping alive beyond the data source and the file.
+            std::filesystem::remove_all(root);
+
+            ok &= (data.size() == held.size());
+            ok &= std::equal(data.begin(), data.end(), held.data());
+
+            std::cout << "File system asset data source memory mapping: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__FileSystemAssetDataSource::testRangedReads()
+        {
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_filesystemassetdatasource_ranges");
+            std::filesystem::remove_all(root);
+
+            std::filesystem::path const path = (root / "asset.bin");
+            std::vector<uint8_t> const  data = writeRandomFile(path, (3 * 4096 + 123));
+            uint64_t             const  size = data.size();
+
+            bool ok = true;
+
+            for(bool const mapped : { true, false })
+            {
+                CFileSystemAssetDataSource dataSource(root, mapped);
+
+                // Inside the file, across a page boundary.
+                CEngineResult<ByteBuffer> const inside = dataSource.readAssetRange(path, 4000, 200);
+                ok &= inside.successful();
+                ok &= (200 == inside.data().size());
+                ok &= (inside.successful() && std::equal(data.begin() + 4000, data.begin() + 4200, inside.data().data()));
+
+                // Ending exactly at the end of the file.
+                CEngineResult<ByteBuffer> const tail = dataSource.readAssetRange(path, (size - 100), 100);
+                ok &= tail.successful();
+                ok &= (100 == tail.data().size());
+                ok &= (tail.successful() && std::equal(data.end() - 100, data.end(), tail.data().data()));
+
+                // Starting beyond the end of the file.
+                ok &= not dataSource.readAssetRange(path, (size + 1), 1).successful();
+                ok &= not dataSource.readAssetRange(path, (size + 4096), kAssetReadToEnd).successful();
+                ok &= not dataSource.readAssetRange(root / "missing.bin", 0, 1).successful();
+            }
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "File system asset data source ranged reads: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
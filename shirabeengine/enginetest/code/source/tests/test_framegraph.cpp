@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <iostream>
+#include <stack>
 #include <vector>
 
 #include <core/enginetypehelper.h>
@@ -10,6 +13,7 @@
 
 
 #include <renderer/irenderer.h>
+#include <renderer/renderer.h>
 #include <renderer/framegraph/framegraph.h>
 #include <renderer/framegraph/graphbuilder.h>
 #include <renderer/framegraph/passbuilder.h>
@@ -75,6 +79,9 @@ namespace Test
             bool ok = true;
 
             ok |= testGraphBuilder();
+            ok &= testCompiledGraphCache();
+            ok &= testTransientAliasing();
+            ok &= testPassCulling();
 
             return ok;
         }
@@ -265,5 +272,290 @@ namespace Test
             return true;
         }
 
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__FrameGraph::testCompiledGraphCache()
+        {
+            CGraph::EGraphMode const graphics = CGraph::EGraphMode::Graphics;
+
+            RenderableList const renderables = { { "Cube",   "CubeMesh",   1, "CubeMaterial",   2, 0 }
+                                               , { "Sphere", "SphereMesh", 3, "SphereMaterial", 4, 0 } };
+
+            uint32_t builds = 0;
+            auto const build = [&builds] () -> CEngineResult<Unique<CGraph>>
+            {
+                ++builds;
+                return { EEngineStatus::Ok, makeUnique<CGraph>() };
+            };
+
+            CFrameGraphCache cache {};
+
+            uint64_t const key = CFrameGraphCache::deriveStructureKey(1920, 1080, graphics, renderables);
+
+            bool ok = true;
+
+            // The first frame builds, the following ones reuse the graph.
+            CGraph *const graph = cache.acquire(key, build);
+            ok &= (nullptr != graph);
+            ok &= (graph == cache.acquire(key, build));
+            ok &= (graph == cache.acquire(key, build));
+            ok &= (1 == builds && 2 == cache.statistics().hits && 1 == cache.statistics().misses);
+
+            // A LOD switch is per frame state and keeps the structure.
+            RenderableList switched = renderables;
+            switched[1].meshLodIndex = 2;
+            ok &= (key == CFrameGraphCache::deriveStructureKey(1920, 1080, graphics, switched));
+
+            // The size, the mode and the renderables change the structure.
+            RenderableList replaced = renderables;
+            replaced[1].materialInstanceAssetId = 5;
+
+            ok &= (key != CFrameGraphCache::deriveStructureKey(1280, 1080, graphics,                    renderables));
+            ok &= (key != CFrameGraphCache::deriveStructureKey(1920, 1080, CGraph::EGraphMode::Compute, renderables));
+            ok &= (key != CFrameGraphCache::deriveStructureKey(1920, 1080, graphics,                    replaced));
+            ok &= (key != CFrameGraphCache::deriveStructureKey(1920, 1080, graphics,                    { renderables[0] }));
+
+            uint64_t const resizedKey = CFrameGraphCache::deriveStructureKey(1280, 720, graphics, renderables);
+            ok &= (nullptr != cache.acquire(resizedKey, build));
+            ok &= (2 == builds && 2 == cache.statistics().misses);
+
+            // Invalidation and failed builds miss.
+            cache.invalidate();
+            ok &= (nullptr != cache.acquire(resizedKey, build));
+            ok &= (3 == builds && 3 == cache.statistics().misses);
+
+            ok &= (nullptr == cache.acquire(key, [] () -> CEngineResult<Unique<CGraph>> { return { EEngineStatus::Error, nullptr }; }));
+            ok &= (nullptr != cache.acquire(key, build));
+            ok &= (4 == builds && 5 == cache.statistics().misses && 2 == cache.statistics().hits);
+
+            std::cout << "Framegraph cache: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+            //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        /**
+         * Handles of a pass spawned by spawnChainPass(...).
+         */
+        struct SChainPassData
+        {
+            PassUID_t           passUID;
+            SFrameGraphResource texture;
+            SFrameGraphResource output;
+        };
+
+        /**
+         * Spawn a pass, which optionally reads aInput and writes a new texture of aDescriptor.
+         *
+         * @param aGraphBuilder The builder to spawn the pass in.
+         * @param aName         The name of the pass.
+         * @param aInput        The output of a previous pass. Nothing is read, if undefined.
+         * @param aDescriptor   The descriptor of the texture written.
+         * @return              The pass, the texture created and the view written.
+         */
+        static SChainPassData spawnChainPass(
+                CGraphBuilder              &aGraphBuilder,
+                std::string         const &aName,
+                SFrameGraphResource const &aInput,
+                SFrameGraphTexture  const &aDescriptor)
+        {
+            auto const setup = [&] (CPassBuilder &aBuilder, SChainPassData &aOutPassData) -> CEngineResult<>
+            {
+                if(SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE != aInput.resourceId)
+                {
+                    SFrameGraphReadTextureFlags readFlags{ };
+                    readFlags.requiredFormat  = FrameGraphFormat_t::Automatic;
+                    readFlags.readSource      = EFrameGraphReadSource::Color;
+                    readFlags.arraySliceRange = CRange(0, 1);
+                    readFlags.mipSliceRange   = CRange(0, 1);
+
+                    if(not aBuilder.readAttachment(aInput, readFlags).successful())
+                    {
+                        return { EEngineStatus::Error };
+                    }
+                }
+
+                aOutPassData.texture = aBuilder.createTexture(aName + " Target", aDescriptor).data();
+
+                SFrameGraphWriteTextureFlags writeFlags{ };
+                writeFlags.requiredFormat  = FrameGraphFormat_t::Automatic;
+                writeFlags.writeTarget     = EFrameGraphWriteTarget::Color;
+                writeFlags.arraySliceRange = CRange(0, 1);
+                writeFlags.mipSliceRange   = CRange(0, 1);
+
+                aOutPassData.output = aBuilder.writeAttachment(aOutPassData.texture, writeFlags).data();
+
+                return { EEngineStatus::Ok };
+            };
+
+            auto const execute = [] (
+                    SChainPassData                   const &,
+                    CFrameGraphResources             const &,
+                    Shared<IFrameGraphRenderContext>       &) -> CEngineResult<>
+            {
+                return { EEngineStatus::Ok };
+            };
+
+            auto passFetch = aGraphBuilder.spawnPass<CallbackPass<SChainPassData>>(aName, setup, execute);
+            if(not passFetch.successful() || nullptr == passFetch.data())
+            {
+                return { };
+            }
+
+            SChainPassData data = passFetch.data()->passData();
+            data.passUID = passFetch.data()->passUID();
+
+            return data;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__FrameGraph::testTransientAliasing()
+        {
+            Shared<os::SApplicationEnvironment> appEnvironment = makeShared<os::SApplicationEnvironment>();
+            Shared<CWSIDisplay>                 display        = nullptr;
+#if defined SHIRABE_PLATFORM_LINUX
+            display = makeShared<x11::CX11Display>();
+#endif
+
+            SFrameGraphTexture descriptor{};
+            descriptor.width          = 256;
+            descriptor.height         = 256;
+            descriptor.depth          = 1;
+            descriptor.format         = FrameGraphFormat_t::R8G8B8A8_UNORM;
+            descriptor.initialState   = EFrameGraphResourceInitState::Clear;
+            descriptor.arraySize      = 1;
+            descriptor.mipLevels      = 1;
+            descriptor.permittedUsage = EFrameGraphResourceUsage::InputAttachment | EFrameGraphResourceUsage::ColorAttachment;
+
+            uint64_t const size = estimateTextureMemorySize(descriptor);
+
+            bool ok = true;
+            ok &= (256 * 256 * 4 == size);
+
+            CGraphBuilder graphBuilder{};
+            ok &= graphBuilder.initialize(appEnvironment, display).successful();
+
+            // A chain, where each texture is read by the next pass only. Lifetimes of every other texture are disjoint.
+            SChainPassData const a = spawnChainPass(graphBuilder, "A", { },      descriptor);
+            SChainPassData const b = spawnChainPass(graphBuilder, "B", a.output, descriptor);
+            SChainPassData const c = spawnChainPass(graphBuilder, "C", b.output, descriptor);
+            SChainPassData const d = spawnChainPass(graphBuilder, "D", c.output, descriptor);
+
+            graphBuilder.setOutputTextureResourceId(d.output.resourceId);
+
+            CEngineResult<Unique<CGraph>> compilation = graphBuilder.compile();
+            ok &= (compilation.successful() && nullptr != compilation.data());
+            if(ok)
+            {
+                CGraph::CAccessor const accessor(compilation.data().get());
+
+                CFrameGraphMutableResources const &resources = accessor.resourceData();
+
+                auto const aliasOf = [&resources] (SChainPassData const &aPass) -> FrameGraphResourceId_t
+                {
+                    return resources.get<SFrameGraphTexture>(aPass.texture.resourceId).data()->aliasedResource;
+                };
+
+                // C reuses the memory of A and D the one of B, while A and B back them.
+                ok &= (SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE == aliasOf(a));
+                ok &= (SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE == aliasOf(b));
+                ok &= (a.texture.resourceId == aliasOf(c));
+                ok &= (b.texture.resourceId == aliasOf(d));
+                ok &= resources.get<SFrameGraphTexture>(a.texture.resourceId).data()->isAliased;
+
+                SFrameGraphTransientMemoryReport const &report = accessor.transientMemoryReport();
+                ok &= (4        == report.transientTextureCount);
+                ok &= (2        == report.backingTextureCount);
+                ok &= (4 * size == report.bytesWithoutAliasing);
+                ok &= (2 * size == report.bytesWithAliasing);
+                ok &= (2 * size == report.peakLiveBytes);
+            }
+
+            std::cout << "Framegraph transient aliasing: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__FrameGraph::testPassCulling()
+        {
+            Shared<os::SApplicationEnvironment> appEnvironment = makeShared<os::SApplicationEnvironment>();
+            Shared<CWSIDisplay>                 display        = nullptr;
+#if defined SHIRABE_PLATFORM_LINUX
+            display = makeShared<x11::CX11Display>();
+#endif
+
+            SFrameGraphTexture descriptor{};
+            descriptor.width          = 256;
+            descriptor.height         = 256;
+            descriptor.depth          = 1;
+            descriptor.format         = FrameGraphFormat_t::R8G8B8A8_UNORM;
+            descriptor.initialState   = EFrameGraphResourceInitState::Clear;
+            descriptor.arraySize      = 1;
+            descriptor.mipLevels      = 1;
+            descriptor.permittedUsage = EFrameGraphResourceUsage::InputAttachment | EFrameGraphResourceUsage::ColorAttachment;
+
+            bool ok = true;
+
+            CGraphBuilder graphBuilder{};
+            ok &= graphBuilder.initialize(appEnvironment, display).successful();
+
+            // "Unused" reads the output of A, but nothing reads its own output.
+            SChainPassData const a      = spawnChainPass(graphBuilder, "A",      { },      descriptor);
+            SChainPassData const b      = spawnChainPass(graphBuilder, "B",      a.output, descriptor);
+            SChainPassData const unused = spawnChainPass(graphBuilder, "Unused", a.output, descriptor);
+
+            graphBuilder.setOutputTextureResourceId(b.output.resourceId);
+
+            CEngineResult<Unique<CGraph>> compilation = graphBuilder.compile();
+            ok &= (compilation.successful() && nullptr != compilation.data());
+            if(ok)
+            {
+                CGraph::CAccessor const accessor(compilation.data().get());
+
+                std::vector<PassUID_t> executionOrder {};
+                for(std::stack<PassUID_t> order = accessor.passExecutionOrder(); not order.empty(); order.pop())
+                {
+                    executionOrder.push_back(order.top());
+                }
+
+                auto const executes = [&executionOrder] (SChainPassData const &aPass) -> bool
+                {
+                    return (executionOrder.end() != std::find(executionOrder.begin(), executionOrder.end(), aPass.passUID));
+                };
+
+                ok &= executes(a);
+                ok &= executes(b);
+                ok &= not executes(unused);
+
+                // Neither the view written by the culled pass nor its texture are attachments anymore.
+                CFrameGraphMutableResources     const &resources   = accessor.resourceData();
+                SFrameGraphAttachmentCollection const &attachments = resources.attachements();
+
+                Vector<FrameGraphResourceId_t> const &imageIds     = attachments.getAttachementImageResourceIds();
+                Vector<FrameGraphResourceId_t> const &imageViewIds = attachments.getAttachementImageViewResourceIds();
+
+                ok &= (attachments.getAttachmentPassToViewAssignment().end() == attachments.getAttachmentPassToViewAssignment().find(unused.passUID));
+                ok &= (imageViewIds.end() == std::find(imageViewIds.begin(), imageViewIds.end(), unused.output.resourceId));
+                ok &= (imageIds.end()     == std::find(imageIds.begin(),     imageIds.end(),     unused.texture.resourceId));
+                ok &= (imageViewIds.end() != std::find(imageViewIds.begin(), imageViewIds.end(), b.output.resourceId));
+
+                ok &= (0 == resources.get<SFrameGraphTextureView>(unused.output.resourceId).data()->referenceCount);
+                ok &= (0 == resources.get<SFrameGraphTexture>    (unused.texture.resourceId).data()->referenceCount);
+            }
+
+            std::cout << "Framegraph pass culling: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
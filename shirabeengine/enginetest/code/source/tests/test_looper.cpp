@@ -0,0 +1,570 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/looper.h>
+#include <core/threading/mpscqueue.h>
+
+#include "tests/test_looper.h"
+
+namespace Test
+{
+    namespace Threading
+    {
+        using namespace engine;
+        using namespace engine::threading;
+
+        using Clock_t = std::chrono::steady_clock;
+
+        /**
+         * Read the current number of threads of this process.
+         *
+         * @return The thread count or 0, if unavailable on this platform.
+         */
+        static uint32_t currentThreadCount()
+        {
+#if defined SHIRABE_PLATFORM_LINUX
+            std::ifstream status("/proc/self/status");
+            std::string   line {};
+            while(std::getline(status, line))
+            {
+                if(0 == line.rfind("Threads:", 0))
+                {
+                    return static_cast<uint32_t>(std::stoul(line.substr(8)));
+                }
+            }
+#endif
+            return 0;
+        }
+
+        /**
+         * Result of a single delayed post benchmark run.
+         */
+        struct SDelayedPostBenchmarkResult
+        {
+            uint32_t peakThreadCount;
+            uint64_t meanJitterMicroseconds;
+            uint64_t maxJitterMicroseconds;
+        };
+
+        /**
+         * Post aDelays.size() delayed tasks using aPostDelayedFn, wait for all of them and
+         * measure the peak thread count as well as the deviation from the requested delay.
+         *
+         * @param aDelays        Requested delays in milliseconds.
+         * @param aPostDelayedFn Function scheduling a task with a delay in milliseconds.
+         * @return               The benchmark figures.
+         */
+        static SDelayedPostBenchmarkResult runDelayedPostBenchmark(
+                std::vector<uint64_t>                                          const &aDelays,
+                std::function<bool(std::function<int()> const &, uint64_t const &)> const &aPostDelayedFn)
+        {
+            std::vector<int64_t>  jitter(aDelays.size(), 0);
+            std::atomic<uint64_t> finished(0);
+
+            Clock_t::time_point const start = Clock_t::now();
+
+            for(std::size_t k=0; k<aDelays.size(); ++k)
+            {
+                uint64_t const delay = aDelays[k];
+
+                std::function<int()> fn = [&, k, delay] () -> int
+                {
+                    int64_t const elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock_t::now() - start).count();
+                    jitter[k] = (elapsed - static_cast<int64_t>(delay * 1000));
+                    ++finished;
+                    return 0;
+                };
+
+                aPostDelayedFn(fn, delay);
+            }
+
+            uint32_t peakThreadCount = currentThreadCount();
+            while(finished.load() < aDelays.size())
+            {
+                peakThreadCount = std::max(peakThreadCount, currentThreadCount());
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+
+            SDelayedPostBenchmarkResult result {};
+            result.peakThreadCount = peakThreadCount;
+
+            uint64_t total = 0;
+            for(int64_t const &value : jitter)
+            {
+                uint64_t const absolute = static_cast<uint64_t>(std::abs(value));
+                total                       += absolute;
+                result.maxJitterMicroseconds = std::max(result.maxJitterMicroseconds, absolute);
+            }
+            result.meanJitterMicroseconds = (total / std::max<std::size_t>(1, aDelays.size()));
+
+            return result;
+        }
+
+        /**
+         * Push aItemsPerProducer items from each of aProducerCount threads using aPushFn,
+         * while the calling thread pops all of them using aPopFn.
+         *
+         * @param aProducerCount    The number of producer threads.
+         * @param aItemsPerProducer The number of items pushed by each producer.
+         * @param aPushFn           Function pushing a single item.
+         * @param aPopFn            Function popping a single item, returning false if none is available.
+         * @return                  The throughput in million items per second or 0 on error.
+         */
+        static double runSubmissionBenchmark(
+                uint32_t                              const &aProducerCount,
+                uint64_t                              const &aItemsPerProducer,
+                std::function<void(uint64_t)>         const &aPushFn,
+                std::function<bool(uint64_t &)>       const &aPopFn)
+        {
+            std::atomic_bool         go(false);
+            std::vector<std::thread> producers {};
+
+            for(uint32_t p=0; p<aProducerCount; ++p)
+            {
+                producers.emplace_back([&, p] () -> void
+                {
+                    while(not go.load())
+                    {
+                        std::this_thread::yield();
+                    }
+
+                    for(uint64_t k=0; k<aItemsPerProducer; ++k)
+                    {
+                        aPushFn((static_cast<uint64_t>(p) << 32) | k);
+                    }
+                });
+            }
+
+            uint64_t const           total = (aProducerCount * aItemsPerProducer);
+            uint64_t                 count = 0;
+            std::vector<uint64_t>    lastSeen(aProducerCount, 0);
+            bool                     ordered = true;
+
+            Clock_t::time_point const start = Clock_t::now();
+            go.store(true);
+
+            uint64_t item = 0;
+            while(count < total)
+            {
+                if(not aPopFn(item))
+                {
+                    continue;
+                }
+
+                // Items of a single producer must arrive in the order pushed.
+                uint64_t const producer = (item >> 32);
+                uint64_t const sequence = (item & 0xFFFFFFFF) + 1;
+                ordered &= (sequence > lastSeen[producer]);
+                lastSeen[producer] = sequence;
+
+                ++count;
+            }
+
+            Clock_t::time_point const end = Clock_t::now();
+
+            for(std::thread &producer : producers)
+            {
+                producer.join();
+            }
+
+            if(not ordered)
+            {
+                std::cout << "  Per producer order violated.\n";
+                return 0.0;
+            }
+
+            double const seconds = std::chrono::duration<double>(end - start).count();
+            return (static_cast<double>(total) / seconds / 1.0e6);
+        }
+
+        /**
+         * Post a task of aPriority to aLooper, which appends aPriority to aOutOrder once executed.
+         *
+         * @param aLooper     The looper to post to.
+         * @param aPriority   The priority of the task.
+         * @param aOutOrder   The execution order. Only written by the looper thread.
+         * @param aOutFutures Receives the future of the task.
+         * @return           True, if posted. False otherwise.
+         */
+        static bool postRecordingTask(
+                CLooper<int>                        &aLooper,
+                ETaskPriority                 const &aPriority,
+                std::vector<ETaskPriority>          &aOutOrder,
+                std::vector<std::future<int>>       &aOutFutures)
+        {
+            std::function<int()> fn = [&aOutOrder, aPriority] () -> int
+            {
+                aOutOrder.push_back(aPriority);
+                return 0;
+            };
+
+            CLooper<int>::TaskType task {};
+            task.setPriority(aPriority);
+            aOutFutures.push_back(task.bind(fn));
+
+            return aLooper.getDispatcher().post(std::move(task));
+        }
+
+        /**
+         * Wait for all futures with a timeout.
+         *
+         * @param aFutures The futures to wait for.
+         * @return         True, if all of them are ready. False otherwise.
+         */
+        static bool waitForAll(std::vector<std::future<int>> &aFutures)
+        {
+            Clock_t::time_point const deadline = (Clock_t::now() + std::chrono::seconds(5));
+
+            bool ready = true;
+            for(std::future<int> &future : aFutures)
+            {
+                ready &= (std::future_status::ready == future.wait_until(deadline));
+            }
+
+            return ready;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::testAll()
+        {
+            bool ok = true;
+
+            ok &= testPriorityOrdering();
+            ok &= testAging();
+            ok &= testStatistics();
+            ok &= benchmarkPostDelayed();
+            ok &= benchmarkSubmissionQueue();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::testPriorityOrdering()
+        {
+            std::vector<ETaskPriority> const priorities = { ETaskPriority::Least
+                                                          , ETaskPriority::Normal
+                                                          , ETaskPriority::TonyStark
+                                                          , ETaskPriority::Less
+                                                          , ETaskPriority::Highest
+                                                          , ETaskPriority::Normal
+                                                          , ETaskPriority::Higher
+                                                          , ETaskPriority::Least };
+
+            std::vector<ETaskPriority>    order   {};
+            std::vector<std::future<int>> futures {};
+
+            // Without aging, tasks queued at the same time run strictly by priority.
+            CLooper<int> looper {};
+            looper.initialize();
+            looper.setAgingInterval(std::chrono::milliseconds(0));
+
+            bool ok = true;
+
+            // Queue everything before the looper starts, so that all tasks compete with each other.
+            for(ETaskPriority const &priority : priorities)
+            {
+                ok &= postRecordingTask(looper, priority, order, futures);
+            }
+
+            looper.run();
+            ok &= waitForAll(futures);
+            looper.abortAndJoin();
+            looper.deinitialize();
+
+            std::vector<ETaskPriority> expected = priorities;
+            std::stable_sort(expected.begin(), expected.end(), [] (ETaskPriority const &aLHS, ETaskPriority const &aRHS) -> bool
+            {
+                return (taskPriorityLevel(aLHS) > taskPriorityLevel(aRHS));
+            });
+
+            ok &= (expected == order);
+
+            std::cout << "CLooper priority ordering: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::testAging()
+        {
+            std::vector<ETaskPriority>    order   {};
+            std::vector<std::future<int>> futures {};
+
+            // Five levels separate Least and TonyStark. A Least task waiting 10 intervals outranks a fresh TonyStark task.
+            CLooper<int> looper {};
+            looper.initialize();
+            looper.setAgingInterval(std::chrono::milliseconds(10));
+
+            bool ok = true;
+
+            ok &= postRecordingTask(looper, ETaskPriority::Least, order, futures);
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            ok &= postRecordingTask(looper, ETaskPriority::TonyStark, order, futures);
+            ok &= postRecordingTask(looper, ETaskPriority::Normal,    order, futures);
+
+            looper.run();
+            ok &= waitForAll(futures);
+            looper.abortAndJoin();
+            looper.deinitialize();
+
+            ok &= (std::vector<ETaskPriority>{ ETaskPriority::Least, ETaskPriority::TonyStark, ETaskPriority::Normal } == order);
+
+            // The default keeps a fresh high priority task ahead of a Least task waiting a few frames.
+            ok &= (std::chrono::milliseconds(250) < kDefaultLooperAgingInterval);
+
+            std::cout << "CLooper aging: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::testStatistics()
+        {
+            std::vector<ETaskPriority>    order   {};
+            std::vector<std::future<int>> futures {};
+
+            CLooper<int> looper {};
+            looper.initialize();
+
+            bool ok = true;
+
+            for(uint32_t k=0; k<3; ++k)
+            {
+                ok &= postRecordingTask(looper, ETaskPriority::Higher, order, futures);
+            }
+            ok &= postRecordingTask(looper, ETaskPriority::Less, order, futures);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+            looper.run();
+            ok &= waitForAll(futures);
+            looper.abortAndJoin();
+
+            LooperStatistics_t const statistics = looper.statistics();
+            looper.deinitialize();
+
+            SLooperPriorityStatistics const &higher = statistics[taskPriorityLevel(ETaskPriority::Higher)];
+            SLooperPriorityStatistics const &less   = statistics[taskPriorityLevel(ETaskPriority::Less)];
+            SLooperPriorityStatistics const &normal = statistics[taskPriorityLevel(ETaskPriority::Normal)];
+
+            // All tasks were queued before the looper started, so each level was drained at full depth.
+            ok &= (3 == higher.enqueued && 3 == higher.dequeued && 0 == higher.queueDepth && 3 == higher.maxQueueDepth);
+            ok &= (1 == less.enqueued   && 1 == less.dequeued   && 0 == less.queueDepth   && 1 == less.maxQueueDepth);
+            ok &= (0 == normal.enqueued && 0 == normal.dequeued && 0 == normal.averageWaitMicroseconds());
+
+            // Every task waited at least for the delayed start.
+            ok &= (20000 <= higher.averageWaitMicroseconds() && higher.averageWaitMicroseconds() <= higher.maxWaitMicroseconds);
+            ok &= (20000 <= less.maxWaitMicroseconds);
+
+            std::cout << "CLooper statistics: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::benchmarkPostDelayed()
+        {
+            using LooperType = CLooper<int>;
+            using TaskType   = LooperType::TaskType;
+
+            std::mt19937_64                         generator(1337);
+            std::uniform_int_distribution<uint64_t> distribution(1, 500);
+
+            std::vector<uint64_t> delays(500);
+            for(uint64_t &delay : delays)
+            {
+                delay = distribution(generator);
+            }
+
+            LooperType looper {};
+            looper.initialize();
+            looper.run();
+
+            std::vector<std::future<int>> futures {};
+            std::mutex                    futuresMutex {};
+
+            auto const makeTask = [&] (std::function<int()> aFunction) -> TaskType
+            {
+                TaskType task {};
+
+                std::lock_guard<std::mutex> guard(futuresMutex);
+                futures.push_back(task.bind(aFunction));
+
+                return task;
+            };
+
+            //
+            // Timer wheel driven by the looper thread.
+            //
+            auto const timerWheelPost = [&] (std::function<int()> const &aFunction, uint64_t const &aDelay) -> bool
+            {
+                return looper.getDispatcher().postDelayed(makeTask(aFunction), aDelay);
+            };
+
+            //
+            // Previous implementation: One std::async thread sleeping per delayed task.
+            //
+            std::vector<std::future<bool>> legacyFutures {};
+            auto const legacyPost = [&] (std::function<int()> const &aFunction, uint64_t const &aDelay) -> bool
+            {
+                Shared<TaskType> task = makeShared<TaskType>(makeTask(aFunction));
+
+                legacyFutures.push_back(std::async(std::launch::async, [&looper, task, aDelay] () -> bool
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(aDelay));
+                    return looper.getDispatcher().post(std::move(*task));
+                }));
+
+                return true;
+            };
+
+            SDelayedPostBenchmarkResult const legacy = runDelayedPostBenchmark(delays, legacyPost);
+            legacyFutures.clear();
+
+            SDelayedPostBenchmarkResult const wheel  = runDelayedPostBenchmark(delays, timerWheelPost);
+
+            looper.abortAndJoin();
+            looper.deinitialize();
+
+            std::cout << "CLooper::postDelayed benchmark (" << delays.size() << " tasks, 1-500ms):\n"
+                      << "  std::async:  peak threads " << legacy.peakThreadCount
+                      << ", mean jitter " << legacy.meanJitterMicroseconds << "us"
+                      << ", max jitter "  << legacy.maxJitterMicroseconds  << "us\n"
+                      << "  timer wheel: peak threads " << wheel.peakThreadCount
+                      << ", mean jitter " << wheel.meanJitterMicroseconds << "us"
+                      << ", max jitter "  << wheel.maxJitterMicroseconds  << "us\n";
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__Looper::benchmarkSubmissionQueue()
+        {
+            uint64_t const totalItems = (1u << 21);
+
+            std::cout << "CLooper submission queue benchmark (" << totalItems << " items, Mitems/s):\n";
+
+            bool ok = true;
+
+            for(uint32_t producerCount : { 1u, 2u, 4u, 8u, 16u, 32u })
+            {
+                uint64_t const itemsPerProducer = (totalItems / producerCount);
+
+                //
+                // Previous implementation: Recursive mutex guarding a queue, taken by producers and the consumer.
+                //
+                std::recursive_mutex mutex {};
+                std::deque<uint64_t> queue {};
+
+                auto const lockedPush = [&] (uint64_t aItem) -> void
+                {
+                    std::lock_guard<std::recursive_mutex> guard(mutex);
+                    queue.push_back(aItem);
+                };
+                auto const lockedPop = [&] (uint64_t &aOutItem) -> bool
+                {
+                    std::lock_guard<std::recursive_mutex> guard(mutex);
+                    if(queue.empty())
+                    {
+                        return false;
+                    }
+
+                    aOutItem = queue.front();
+                    queue.pop_front();
+                    return true;
+                };
+
+                //
+                // Lock-free ring with overflow fallback.
+                //
+                Unique<CMpscQueue<uint64_t>> mpsc = makeUnique<CMpscQueue<uint64_t>>();
+
+                auto const mpscPush = [&] (uint64_t aItem) -> void
+                {
+                    uint64_t item = aItem;
+                    mpsc->push(std::move(item));
+                };
+                auto const mpscPop = [&] (uint64_t &aOutItem) -> bool
+                {
+                    return mpsc->pop(aOutItem);
+                };
+
+                double const locked   = runSubmissionBenchmark(producerCount, itemsPerProducer, lockedPush, lockedPop);
+                double const lockFree = runSubmissionBenchmark(producerCount, itemsPerProducer, mpscPush,   mpscPop);
+
+                ok &= (0.0 < locked && 0.0 < lockFree && mpsc->empty());
+
+                std::cout << "  " << producerCount << " producer(s): "
+                          << "recursive_mutex " << locked   << ", "
+                          << "mpsc "            << lockFree << "\n";
+            }
+
+            //
+            // End to end: Tasks posted from many threads must all be executed by a parked looper.
+            //
+            CLooper<int> looper {};
+            looper.initialize();
+            looper.run();
+
+            std::atomic<uint64_t>    executed(0);
+            std::vector<std::thread> producers {};
+            for(uint32_t p=0; p<8; ++p)
+            {
+                producers.emplace_back([&] () -> void
+                {
+                    for(uint32_t k=0; k<2000; ++k)
+                    {
+                        std::function<int()> fn = [&] () -> int { ++executed; return 0; };
+
+                        CLooper<int>::TaskType task {};
+                        task.bind(fn);
+                        looper.getDispatcher().post(std::move(task));
+                    }
+                });
+            }
+
+            for(std::thread &producer : producers)
+            {
+                producer.join();
+            }
+
+            Clock_t::time_point const deadline = (Clock_t::now() + std::chrono::seconds(5));
+            while(executed.load() < 16000 && Clock_t::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            looper.abortAndJoin();
+            looper.deinitialize();
+
+            std::cout << "  looper end to end: " << executed.load() << "/16000 tasks executed\n";
+            ok &= (16000 == executed.load());
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,528 @@
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/jobsystem.h>
+#include <core/threading/taskgraph.h>
+#include <asset/assetstorage.h>
+#include <asset/filesystemassetdatasource.h>
+#include <util/documents/json.h>
+#include <mesh/declaration.h>
+#include <mesh/loader.h>
+#include <mesh/meshcontainer.h>
+
+#include "tests/test_meshcontainer.h"
+
+namespace Test
+{
+    namespace Mesh
+    {
+        using namespace engine;
+        using namespace engine::mesh;
+
+        /**
+         * Create aSize random bytes.
+         */
+        static std::vector<uint8_t> randomBytes(std::mt19937 &aGenerator, uint64_t aSize)
+        {
+            std::vector<uint8_t> data(aSize);
+            for(uint8_t &byte : data)
+            {
+                byte = static_cast<uint8_t>(aGenerator());
+            }
+            return data;
+        }
+
+        /**
+         * Wrap aData into a buffer owning it.
+         */
+        static ByteBuffer toBuffer(std::vector<uint8_t> aData)
+        {
+            uint64_t const size = aData.size();
+            return ByteBuffer(std::move(aData), size);
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testAll()
+        {
+            bool ok = true;
+
+            ok &= testRoundTrip();
+            ok &= testInterleaved();
+            ok &= testWideIndices();
+            ok &= testRejectsInvalidInput();
+            ok &= testLodSelection();
+            ok &= testAsyncLoading();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testRoundTrip()
+        {
+            uint32_t const vertexCount = 7; // Odd, so that the attributes need padding.
+
+            std::vector<SMeshAttributeDescription> const attributes = { { "POSITION", 0, 0, vertexCount, 8, EMeshAttributeFormat::Unorm16x4, 0 }
+                                                                      , { "NORMAL",   1, 0, vertexCount, 4, EMeshAttributeFormat::Snorm16x2, 0 }
+                                                                      , { "TANGENT",  2, 0, vertexCount, 8, EMeshAttributeFormat::Snorm16x4, 0 }
+                                                                      , { "TEXCOORD", 3, 0, vertexCount, 4, EMeshAttributeFormat::Float16x2, 0 }
+                                                                      , { "COLOR",    4, 0, vertexCount, 3, EMeshAttributeFormat::Undefined, 0 } };
+            SMeshAttributeDescription const indices = { "Indices", 0, 0, 9, 2, EMeshAttributeFormat::Undefined, 0 };
+
+            std::mt19937 generator(1234);
+
+            std::vector<std::vector<uint8_t>> attributeData {};
+            for(SMeshAttributeDescription const &attribute : attributes)
+            {
+                attributeData.push_back(randomBytes(generator, (attribute.length * attribute.bytesPerSample)));
+            }
+            std::vector<uint8_t> const indexData = randomBytes(generator, (indices.length * indices.bytesPerSample));
+
+            std::vector<SMeshLod> const lods   = { { 0, 6, 0.0f }, { 6, 3, 0.25f } };
+            SMeshBounds           const bounds = { { -1.0f, -2.0f, -3.0f }, { 4.0f, 0.5f, 1.0f } };
+
+            CEngineResult<std::vector<uint8_t>> const encoded   = encodeMeshContainer(attributes, attributeData, indices, indexData, vertexCount, lods, bounds);
+            std::vector<uint8_t>                const &container = encoded.data();
+
+            bool ok = encoded.successful();
+
+            CEngineResult<SMeshDataFile> const decoded  = decodeMeshContainer(42, toBuffer(container));
+            SMeshDataFile                const &dataFile = decoded.data();
+
+            ok &= decoded.successful();
+            ok &= (42                == dataFile.assetId);
+            ok &= (vertexCount       == dataFile.attributeSampleCount);
+            ok &= (indices.length    == dataFile.indexSampleCount);
+            ok &= (attributes.size() == dataFile.attributes.size());
+            ok &= (bounds.minimum    == dataFile.bounds.minimum);
+            ok &= (bounds.maximum    == dataFile.bounds.maximum);
+            ok &= (lods.size()       == dataFile.lods.size());
+
+            for(std::size_t k=0; k<lods.size() && k<dataFile.lods.size(); ++k)
+            {
+                ok &= (lods[k].firstIndex == dataFile.lods[k].firstIndex);
+                ok &= (lods[k].indexCount == dataFile.lods[k].indexCount);
+                ok &= (lods[k].error      == dataFile.lods[k].error);
+            }
+
+            // Sections and attributes are aligned, so that they can be uploaded from a mapping.
+            ok &= (0 == (dataFile.vertexDataRange().offset % kMeshContainerSectionAlignment));
+            ok &= (0 == (dataFile.indexDataRange() .offset % kMeshContainerSectionAlignment));
+
+            asset::SAssetDataRange const vertexRange = dataFile.vertexDataRange();
+            for(std::size_t k=0; k<attributes.size() && k<dataFile.attributes.size(); ++k)
+            {
+                asset::SAssetDataRange const range = dataFile.attributeDataRange(k);
+
+                ok &= (attributes[k].name           == dataFile.attributes[k].name);
+                ok &= (attributes[k].length         == dataFile.attributes[k].length);
+                ok &= (attributes[k].bytesPerSample == dataFile.attributes[k].bytesPerSample);
+                ok &= (attributes[k].format         == dataFile.attributes[k].format);
+                ok &= (attributes[k].bytesPerSample == dataFile.attributes[k].stride);
+                ok &= (0 == (range.offset % kMeshContainerAttributeAlignment));
+                ok &= (attributeData[k].size() == range.length);
+                ok &= ((range.offset + range.length) <= vertexRange.length);
+                ok &= std::equal(attributeData[k].begin(), attributeData[k].end(), container.begin() + static_cast<std::ptrdiff_t>(vertexRange.offset + range.offset));
+            }
+
+            // Planar, i.e. a stream per attribute.
+            ok &= (attributes.size() == dataFile.streams().size());
+
+            asset::SAssetDataRange const indexRange = dataFile.indexDataRange();
+            ok &= (indexData.size() == indexRange.length);
+            ok &= ((indexRange.offset + indexRange.length) <= container.size());
+            ok &= std::equal(indexData.begin(), indexData.end(), container.begin() + static_cast<std::ptrdiff_t>(indexRange.offset));
+
+            std::cout << "Mesh container round trip: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testInterleaved()
+        {
+            uint32_t const vertexCount = 5;
+
+            // Positions alone, the rest interleaved. Listed out of stream order.
+            std::vector<SMeshAttributeDescription> const attributes = { { "NORMAL",   1, 0, vertexCount, 4, EMeshAttributeFormat::Snorm16x2, 0 }
+                                                                      , { "POSITION", 0, 0, vertexCount, 8, EMeshAttributeFormat::Unorm16x4, 0 }
+                                                                      , { "TANGENT",  1, 0, vertexCount, 8, EMeshAttributeFormat::Snorm16x4, 0 }
+                                                                      , { "TEXCOORD", 1, 0, vertexCount, 4, EMeshAttributeFormat::Float16x2, 0 } };
+            SMeshAttributeDescription const indices = { "Indices", 0, 0, 3, 2, EMeshAttributeFormat::Undefined, 0 };
+
+            std::mt19937 generator(1234);
+
+            std::vector<std::vector<uint8_t>> attributeData {};
+            for(SMeshAttributeDescription const &attribute : attributes)
+            {
+                attributeData.push_back(randomBytes(generator, (attribute.length * attribute.bytesPerSample)));
+            }
+            std::vector<uint8_t> const indexData = randomBytes(generator, (indices.length * indices.bytesPerSample));
+
+            SMeshBounds const bounds = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+            CEngineResult<std::vector<uint8_t>> const encoded   = encodeMeshContainer(attributes, attributeData, indices, indexData, vertexCount, {}, bounds);
+            std::vector<uint8_t>                const &container = encoded.data();
+
+            bool ok = encoded.successful();
+
+            CEngineResult<SMeshDataFile> const decoded  = decodeMeshContainer(1, toBuffer(container));
+            SMeshDataFile                const &dataFile = decoded.data();
+            ok &= (decoded.successful() && attributes.size() == dataFile.attributes.size());
+
+            std::vector<SMeshStream> const streams = dataFile.streams();
+            ok &= (2 == streams.size());
+            if(not ok)
+            {
+                std::cout << "Mesh container interleaved: FAILED\n";
+                return false;
+            }
+
+            ok &= (0  == streams[0].index && 8  == streams[0].stride);
+            ok &= (1  == streams[1].index && 16 == streams[1].stride);
+            ok &= (0 == (streams[0].offset % kMeshContainerAttributeAlignment));
+            ok &= (0 == (streams[1].offset % kMeshContainerAttributeAlignment));
+
+            // Interleaved in the order of the descriptions.
+            ok &= (streams[1].offset      == dataFile.attributes[0].offset);
+            ok &= (streams[0].offset      == dataFile.attributes[1].offset);
+            ok &= (streams[1].offset + 4  == dataFile.attributes[2].offset);
+            ok &= (streams[1].offset + 12 == dataFile.attributes[3].offset);
+
+            asset::SAssetDataRange const vertexRange = dataFile.vertexDataRange();
+            for(std::size_t k=0; k<attributes.size(); ++k)
+            {
+                SMeshAttributeDescription const &attribute = dataFile.attributes[k];
+                asset::SAssetDataRange    const  range     = dataFile.attributeDataRange(k);
+
+                ok &= (attributes[k].index == attribute.index);
+                ok &= ((range.offset + range.length) <= vertexRange.length);
+
+                for(uint64_t v=0; v<attribute.length; ++v)
+                {
+                    auto const sample = container.begin() + static_cast<std::ptrdiff_t>(vertexRange.offset + attribute.offset + (v * attribute.stride));
+                    auto const source = attributeData[k].begin() + static_cast<std::ptrdiff_t>(v * attribute.bytesPerSample);
+                    ok &= std::equal(source, source + static_cast<std::ptrdiff_t>(attribute.bytesPerSample), sample);
+                }
+            }
+
+            // The attributes of a stream need a sample per vertex each.
+            std::vector<SMeshAttributeDescription> uneven = attributes;
+            uneven[2].length = (vertexCount - 1);
+            std::vector<std::vector<uint8_t>> unevenData = attributeData;
+            unevenData[2].resize(uneven[2].length * uneven[2].bytesPerSample);
+            ok &= not encodeMeshContainer(uneven, unevenData, indices, indexData, vertexCount, {}, bounds).successful();
+
+            std::cout << "Mesh container interleaved: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testWideIndices()
+        {
+            bool ok = true;
+
+            // 16 bit, as long as they address all vertices. Never 8 bit.
+            ok &= (2 == meshIndexBytesPerSample(3));
+            ok &= (2 == meshIndexBytesPerSample(65535));
+            ok &= (4 == meshIndexBytesPerSample(65536));
+
+            uint32_t const vertexCount = 70000;
+
+            std::vector<SMeshAttributeDescription> const attributes = { { "POSITION", 0, 0, vertexCount, 8, EMeshAttributeFormat::Unorm16x4, 0 } };
+
+            std::mt19937 generator(1234);
+            std::vector<std::vector<uint8_t>> const attributeData = { randomBytes(generator, (vertexCount * 8)) };
+
+            // A triangle fan over all vertices, so that the indices exceed 16 bit.
+            std::vector<uint32_t> indices {};
+            for(uint32_t v=1; (v + 1)<vertexCount; ++v)
+            {
+                indices.insert(indices.end(), { 0, v, (v + 1) });
+            }
+
+            uint64_t const indexBytesPerSample = meshIndexBytesPerSample(vertexCount);
+
+            std::vector<uint8_t> indexData(indices.size() * indexBytesPerSample);
+            std::memcpy(indexData.data(), indices.data(), indexData.size());
+
+            SMeshAttributeDescription const indexDescription = { "Indices", 0, 0, indices.size(), indexBytesPerSample, EMeshAttributeFormat::Undefined, 0 };
+            SMeshBounds               const bounds           = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+            CEngineResult<std::vector<uint8_t>> const encoded   = encodeMeshContainer(attributes, attributeData, indexDescription, indexData, vertexCount, {}, bounds);
+            std::vector<uint8_t>                const &container = encoded.data();
+            ok &= encoded.successful();
+
+            CEngineResult<SMeshDataFile> const decoded  = decodeMeshContainer(1, toBuffer(container));
+            SMeshDataFile                const &dataFile = decoded.data();
+            ok &= decoded.successful();
+            ok &= (vertexCount    == dataFile.attributeSampleCount);
+            ok &= (indices.size() == dataFile.indexSampleCount);
+            ok &= (4              == dataFile.indices.bytesPerSample);
+
+            asset::SAssetDataRange const indexRange = dataFile.indexDataRange();
+            ok &= ((indices.size() * sizeof(uint32_t)) == indexRange.length);
+            if(ok)
+            {
+                std::vector<uint32_t> decodedIndices(indices.size());
+                std::memcpy(decodedIndices.data(), container.data() + indexRange.offset, indexRange.length);
+                ok &= (indices == decodedIndices);
+                ok &= ((vertexCount - 1) == *std::max_element(decodedIndices.begin(), decodedIndices.end()));
+            }
+
+            // The graphics API can't bind 8 bit indices.
+            std::vector<uint8_t>      const narrowData(3, 0);
+            SMeshAttributeDescription const narrow = { "Indices", 0, 0, 3, 1, EMeshAttributeFormat::Undefined, 0 };
+            ok &= not encodeMeshContainer(attributes, attributeData, narrow, narrowData, vertexCount, {}, bounds).successful();
+
+            std::cout << "Mesh container wide indices: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testRejectsInvalidInput()
+        {
+            std::vector<SMeshAttributeDescription> const attributes = { { "POSITION", 0, 0, 3, 12, EMeshAttributeFormat::Undefined, 0 } };
+            SMeshAttributeDescription              const indices    = { "Indices",  0, 0, 3,  4, EMeshAttributeFormat::Undefined, 0 };
+
+            std::vector<std::vector<uint8_t>> const attributeData = { std::vector<uint8_t>(36, 1) };
+            std::vector<uint8_t>              const indexData     = std::vector<uint8_t>(12, 2);
+
+            SMeshBounds const bounds = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+
+            bool ok = true;
+
+            // Data not matching the descriptions.
+            ok &= not encodeMeshContainer(attributes, { std::vector<uint8_t>(35, 1) }, indices, indexData, 3, {}, bounds).successful();
+            ok &= not encodeMeshContainer(attributes, attributeData, indices, std::vector<uint8_t>(13, 2), 3, {}, bounds).successful();
+            ok &= not encodeMeshContainer(attributes, {}, indices, indexData, 3, {}, bounds).successful();
+
+            // Names exceeding the descriptor.
+            ok &= not encodeMeshContainer({ { std::string(kMeshContainerAttributeNameLength + 1, 'a'), 0, 0, 3, 12, EMeshAttributeFormat::Undefined, 0 } }, attributeData, indices, indexData, 3, {}, bounds).successful();
+
+            // Samples not matching the format.
+            ok &= not encodeMeshContainer({ { "POSITION", 0, 0, 3, 12, EMeshAttributeFormat::Unorm16x4, 0 } }, attributeData, indices, indexData, 3, {}, bounds).successful();
+
+            // LODs exceeding the indices.
+            ok &= not encodeMeshContainer(attributes, attributeData, indices, indexData, 3, { { 1, 3, 0.0f } }, bounds).successful();
+
+            CEngineResult<std::vector<uint8_t>> const encoded   = encodeMeshContainer(attributes, attributeData, indices, indexData, 3, {}, bounds);
+            std::vector<uint8_t>                const &container = encoded.data();
+            ok &= encoded.successful();
+
+            // Without LODs, a single one spans all indices.
+            CEngineResult<SMeshDataFile> const decoded = decodeMeshContainer(1, toBuffer(container));
+            ok &= (decoded.successful() && 1 == decoded.data().lods.size() && 0 == decoded.data().lods[0].firstIndex && 3 == decoded.data().lods[0].indexCount);
+
+            // Truncated.
+            for(uint64_t const size : { uint64_t(0), uint64_t(sizeof(SMeshContainerHeader) - 1), uint64_t(container.size() - 1) })
+            {
+                ok &= not decodeMeshContainer(1, toBuffer(std::vector<uint8_t>(container.begin(), container.begin() + static_cast<std::ptrdiff_t>(size)))).successful();
+            }
+
+            // Not a container.
+            std::vector<uint8_t> corrupt = container;
+            corrupt[0] = 'X';
+            ok &= not decodeMeshContainer(1, toBuffer(corrupt)).successful();
+
+            // An attribute exceeding the vertex section.
+            corrupt = container;
+            SMeshContainerAttribute descriptor {};
+            std::memcpy(&descriptor, corrupt.data() + sizeof(SMeshContainerHeader), sizeof(descriptor));
+            descriptor.length = (1ull << 62u);
+            std::memcpy(corrupt.data() + sizeof(SMeshContainerHeader), &descriptor, sizeof(descriptor));
+            ok &= not decodeMeshContainer(1, toBuffer(corrupt)).successful();
+
+            // Samples overlapping each other.
+            corrupt = container;
+            std::memcpy(&descriptor, corrupt.data() + sizeof(SMeshContainerHeader), sizeof(descriptor));
+            descriptor.stride = (descriptor.bytesPerSample - 1);
+            std::memcpy(corrupt.data() + sizeof(SMeshContainerHeader), &descriptor, sizeof(descriptor));
+            ok &= not decodeMeshContainer(1, toBuffer(corrupt)).successful();
+
+            // An unknown format.
+            corrupt = container;
+            std::memcpy(&descriptor, corrupt.data() + sizeof(SMeshContainerHeader), sizeof(descriptor));
+            descriptor.format = 0xffu;
+            std::memcpy(corrupt.data() + sizeof(SMeshContainerHeader), &descriptor, sizeof(descriptor));
+            ok &= not decodeMeshContainer(1, toBuffer(corrupt)).successful();
+
+            // A LOD exceeding the index section.
+            corrupt = container;
+            uint64_t const lodOffset = sizeof(SMeshContainerHeader) + sizeof(SMeshContainerAttribute);
+            SMeshContainerLod lod {};
+            std::memcpy(&lod, corrupt.data() + lodOffset, sizeof(lod));
+            lod.indexCount = 4;
+            std::memcpy(corrupt.data() + lodOffset, &lod, sizeof(lod));
+            ok &= not decodeMeshContainer(1, toBuffer(corrupt)).successful();
+
+            std::cout << "Mesh container invalid input: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testLodSelection()
+        {
+            std::vector<SMeshLod> const lods = { { 0, 300, 0.0f }, { 300, 150, 0.01f }, { 450, 75, 0.1f } };
+
+            bool ok = true;
+
+            // Close up, a hundredth is still more than a pixel.
+            ok &= (0 == selectMeshLod(lods, 1000.0f, 1.0f));
+            ok &= (1 == selectMeshLod(lods,  100.0f, 1.0f));
+            ok &= (2 == selectMeshLod(lods,   10.0f, 1.0f));
+            ok &= (2 == selectMeshLod(lods,    0.0f, 1.0f));
+
+            // A larger tolerance switches earlier.
+            ok &= (1 == selectMeshLod(lods, 1000.0f, 10.0f));
+
+            ok &= (0 == selectMeshLod({},   10.0f, 1.0f));
+
+            std::cout << "Mesh LOD selection: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshContainer::testAsyncLoading()
+        {
+            using namespace engine::asset;
+            using namespace engine::documents;
+            using namespace engine::threading;
+
+            std::filesystem::path const root = (std::filesystem::temp_directory_path() / "shirabe_test_meshasyncloading");
+            std::filesystem::remove_all(root);
+            std::filesystem::create_directories(root);
+
+            AssetId_t const metaId = 1;
+            AssetId_t const dataId = 2;
+
+            bool ok = true;
+
+            // A triangle with planar positions.
+            std::vector<SMeshAttributeDescription> const attributes = { { "POSITION", 0, 0, 3, 12, EMeshAttributeFormat::Float32x3, 0 } };
+            SMeshAttributeDescription const indices = { "Indices", 0, 0, 3, 2, EMeshAttributeFormat::Undefined, 0 };
+
+            std::vector<float>    const positions = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+            std::vector<uint16_t> const triangle  = { 0, 1, 2 };
+
+            std::vector<uint8_t> positionData(positions.size() * sizeof(float));
+            std::memcpy(positionData.data(), positions.data(), positionData.size());
+            std::vector<uint8_t> indexData(triangle.size() * sizeof(uint16_t));
+            std::memcpy(indexData.data(), triangle.data(), indexData.size());
+
+            CEngineResult<std::vector<uint8_t>> const container = encodeMeshContainer(attributes, { positionData }, indices, indexData, 3, {}, { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f } });
+            ok &= container.successful();
+
+            SMeshMeta meta {};
+            meta.uid        = metaId;
+            meta.name       = "triangle";
+            meta.dataFileId = dataId;
+
+            std::string serializedMeta {};
+            {
+                CJSONSerializer<SMeshMeta> serializer {};
+                ok &= serializer.initialize();
+
+                auto const serialization = serializer.serialize(meta);
+                ok &= serialization.successful();
+                if(serialization.successful())
+                {
+                    serializedMeta = serialization.data()->asString().data();
+                }
+                ok &= serializer.deinitialize();
+            }
+
+            if(not ok)
+            {
+                std::cout << "Mesh async loading: FAILED\n";
+                return ok;
+            }
+
+            std::ofstream(root / "triangle.mesh.meta", std::ios::out | std::ios::binary).write(serializedMeta.data(), static_cast<std::streamsize>(serializedMeta.size()));
+            std::ofstream(root / "triangle.mesh",      std::ios::out | std::ios::binary).write(reinterpret_cast<char const *>(container.data().data()), static_cast<std::streamsize>(container.data().size()));
+
+            CAssetStorage::AssetRegistry_t registry {};
+            {
+                SAsset asset {};
+                asset.id      = metaId;
+                asset.type    = EAssetType::Mesh;
+                asset.subtype = EAssetSubtype::Meta;
+                asset.codec   = EAssetCodec::None;
+                asset.uri     = (root / "triangle.mesh.meta");
+                registry.addAsset(metaId, asset);
+
+                asset.id      = dataId;
+                asset.subtype = EAssetSubtype::DataFile;
+                asset.uri     = (root / "triangle.mesh");
+                registry.addAsset(dataId, asset);
+            }
+
+            Shared<CAssetStorage> storage = makeShared<CAssetStorage>(makeUnique<CFileSystemAssetDataSource>(root, false));
+            storage->readIndex(registry);
+
+            Shared<CJobSystem> jobSystem = makeShared<CJobSystem>();
+            ok &= jobSystem->initialize(2);
+            ok &= jobSystem->run();
+
+            {
+                Shared<CTaskGraph> const graph  = makeShared<CTaskGraph>(jobSystem);
+                CMeshLoader              loader {};
+
+                // Concurrent requests share the pipeline and its instance.
+                CAsyncResult<Shared<CMeshInstance>> const first  = loader.loadMeshInstanceAsync(graph, storage, metaId);
+                CAsyncResult<Shared<CMeshInstance>> const second = loader.loadMeshInstanceAsync(graph, storage, metaId);
+
+                CEngineResult<Shared<CMeshInstance>> const firstInstance  = first .get();
+                CEngineResult<Shared<CMeshInstance>> const secondInstance = second.get();
+                ok &= (firstInstance.successful() && secondInstance.successful());
+                if(firstInstance.successful() && secondInstance.successful())
+                {
+                    ok &= (firstInstance.data() == secondInstance.data());
+                    ok &= ("triangle" == firstInstance.data()->name());
+
+                    SMeshDataFile const &dataFile = firstInstance.data()->dataFile();
+                    ok &= (1 == dataFile.attributes.size());
+                    ok &= (3 == dataFile.attributeSampleCount);
+                    ok &= (3 == dataFile.indexSampleCount);
+                }
+
+                // Missing assets fail instead of blocking.
+                ok &= not loader.loadMeshInstanceAsync(graph, storage, 3).get().successful();
+            }
+
+            ok &= jobSystem->abortAndJoin();
+            ok &= jobSystem->deinitialize();
+
+            std::filesystem::remove_all(root);
+
+            std::cout << "Mesh async loading: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,381 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <mesh/meshoptimization.h>
+
+#include "tests/test_meshoptimization.h"
+
+namespace Test
+{
+    namespace Mesh
+    {
+        using namespace engine;
+        using namespace engine::mesh;
+
+        using Position_t = std::array<float, 3>;
+        using Triangle_t = std::array<Position_t, 3>;
+
+        /**
+         * A triangle list over float3 positions.
+         */
+        struct STestMesh
+        {
+            std::vector<uint8_t>  positions;
+            std::vector<uint32_t> indices;
+            uint32_t              vertexCount;
+        };
+
+        /**
+         * Create a flat grid of aSize x aSize quads in the xy-plane, facing +z.
+         */
+        static STestMesh gridMesh(uint32_t aSize)
+        {
+            STestMesh mesh {};
+            mesh.vertexCount = (aSize + 1) * (aSize + 1);
+            mesh.positions.resize(mesh.vertexCount * sizeof(Position_t));
+
+            for(uint32_t y=0; y<=aSize; ++y)
+            {
+                for(uint32_t x=0; x<=aSize; ++x)
+                {
+                    Position_t const position = { static_cast<float>(x), static_cast<float>(y), 0.0f };
+                    std::memcpy(mesh.positions.data() + (((y * (aSize + 1)) + x) * sizeof(Position_t)), position.data(), sizeof(Position_t));
+                }
+            }
+
+            for(uint32_t y=0; y<aSize; ++y)
+            {
+                for(uint32_t x=0; x<aSize; ++x)
+                {
+                    uint32_t const v00 = (y * (aSize + 1)) + x;
+                    uint32_t const v10 = v00 + 1;
+                    uint32_t const v01 = v00 + (aSize + 1);
+                    uint32_t const v11 = v01 + 1;
+
+                    mesh.indices.insert(mesh.indices.end(), { v00, v10, v11, v00, v11, v01 });
+                }
+            }
+
+            return mesh;
+        }
+
+        /**
+         * Shuffle the triangles and the vertices of aMesh, so that it has no locality left.
+         */
+        static void shuffleMesh(STestMesh &aMesh, std::mt19937 &aGenerator)
+        {
+            std::vector<uint32_t> triangles((aMesh.indices.size() / 3));
+            std::iota(triangles.begin(), triangles.end(), 0);
+            std::shuffle(triangles.begin(), triangles.end(), aGenerator);
+
+            std::vector<uint32_t> vertices(aMesh.vertexCount);
+            std::iota(vertices.begin(), vertices.end(), 0);
+            std::shuffle(vertices.begin(), vertices.end(), aGenerator);
+
+            // vertices[k] is the old vertex stored at k.
+            std::vector<uint32_t> remap(aMesh.vertexCount);
+            std::vector<uint8_t>  positions(aMesh.positions.size());
+            for(uint32_t k=0; k<aMesh.vertexCount; ++k)
+            {
+                remap[vertices[k]] = k;
+                std::memcpy(positions.data() + (k * sizeof(Position_t)), aMesh.positions.data() + (vertices[k] * sizeof(Position_t)), sizeof(Position_t));
+            }
+
+            std::vector<uint32_t> indices {};
+            indices.reserve(aMesh.indices.size());
+            for(uint32_t const triangle : triangles)
+            {
+                for(uint32_t k=0; k<3; ++k)
+                {
+                    indices.push_back(remap[aMesh.indices[(3 * triangle) + k]]);
+                }
+            }
+
+            aMesh.positions = std::move(positions);
+            aMesh.indices   = std::move(indices);
+        }
+
+        /**
+         * Return the position of vertex aIndex.
+         */
+        static Position_t positionOf(std::vector<uint8_t> const &aPositions, uint32_t aIndex)
+        {
+            Position_t position {};
+            std::memcpy(position.data(), aPositions.data() + (aIndex * sizeof(Position_t)), sizeof(Position_t));
+            return position;
+        }
+
+        /**
+         * Return the triangles of a mesh by their positions, each rotated to start at its smallest
+         * position, which keeps the winding, and sorted. Equal for meshes with the same triangles.
+         */
+        static std::vector<Triangle_t> canonicalTriangles(std::vector<uint8_t> const &aPositions, std::vector<uint32_t> const &aIndices)
+        {
+            std::vector<Triangle_t> triangles {};
+            for(std::size_t t=0; (t + 2)<aIndices.size(); t += 3)
+            {
+                Triangle_t triangle = { positionOf(aPositions, aIndices[t + 0])
+                                      , positionOf(aPositions, aIndices[t + 1])
+                                      , positionOf(aPositions, aIndices[t + 2]) };
+
+                std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+                triangles.push_back(triangle);
+            }
+
+            std::sort(triangles.begin(), triangles.end());
+            return triangles;
+        }
+
+        /**
+         * Return the z-component of the cross product of the edges of triangle aTriangle, which is
+         * twice its signed area for triangles in the xy-plane.
+         */
+        static float signedDoubleArea(std::vector<uint8_t> const &aPositions, std::vector<uint32_t> const &aIndices, std::size_t aTriangle)
+        {
+            Position_t const a = positionOf(aPositions, aIndices[(3 * aTriangle) + 0]);
+            Position_t const b = positionOf(aPositions, aIndices[(3 * aTriangle) + 1]);
+            Position_t const c = positionOf(aPositions, aIndices[(3 * aTriangle) + 2]);
+
+            return ((b[0] - a[0]) * (c[1] - a[1])) - ((b[1] - a[1]) * (c[0] - a[0]));
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshOptimization::testAll()
+        {
+            bool ok = true;
+
+            ok &= testVertexCache();
+            ok &= testVertexFetch();
+            ok &= testWelding();
+            ok &= testSimplification();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshOptimization::testVertexCache()
+        {
+            std::mt19937 generator(1234);
+
+            STestMesh mesh = gridMesh(32);
+            shuffleMesh(mesh, generator);
+
+            std::vector<Triangle_t> const triangles = canonicalTriangles(mesh.positions, mesh.indices);
+            std::vector<uint32_t>   const original  = mesh.indices;
+
+            SVertexCacheStatistics const before = analyzeVertexCache(mesh.indices, mesh.vertexCount);
+
+            optimizeVertexCache(mesh.indices, mesh.vertexCount);
+
+            SVertexCacheStatistics const after = analyzeVertexCache(mesh.indices, mesh.vertexCount);
+
+            bool ok = true;
+
+            // The triangles are only reordered: Same indices, same triangles, same windings.
+            std::vector<uint32_t> sortedOriginal  = original;
+            std::vector<uint32_t> sortedOptimized = mesh.indices;
+            std::sort(sortedOriginal .begin(), sortedOriginal .end());
+            std::sort(sortedOptimized.begin(), sortedOptimized.end());
+
+            ok &= (sortedOriginal == sortedOptimized);
+            ok &= (triangles      == canonicalTriangles(mesh.positions, mesh.indices));
+
+            // A shuffled grid transforms almost every vertex of every triangle. Optimized, a regular
+            // grid gets close to one transform per vertex.
+            ok &= (before.triangleCount == after.triangleCount);
+            ok &= (after.acmr < before.acmr);
+            ok &= (after.acmr < 1.0);
+            ok &= (after.atvr < 1.5);
+
+            std::cout << "Mesh optimization vertex cache: " << (ok ? "OK" : "FAILED")
+                      << " (ACMR " << before.acmr << " -> " << after.acmr << ")\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshOptimization::testVertexFetch()
+        {
+            std::mt19937 generator(1234);
+
+            STestMesh mesh = gridMesh(32);
+            shuffleMesh(mesh, generator);
+
+            // Add an unreferenced vertex, which has to be dropped.
+            Position_t const unreferenced = { -1.0f, -1.0f, -1.0f };
+            mesh.positions.insert(mesh.positions.end(), reinterpret_cast<uint8_t const *>(unreferenced.data()), reinterpret_cast<uint8_t const *>(unreferenced.data()) + sizeof(Position_t));
+            ++mesh.vertexCount;
+
+            std::vector<Triangle_t> const triangles = canonicalTriangles(mesh.positions, mesh.indices);
+
+            // A cache far smaller than the vertices, so that locality matters.
+            std::vector<uint64_t> const strides    = { sizeof(Position_t) };
+            uint64_t              const lineSize   = 64;
+            uint32_t              const lineCount  = 8;
+
+            optimizeVertexCache(mesh.indices, mesh.vertexCount);
+            SVertexFetchStatistics const before = analyzeVertexFetch(mesh.indices, mesh.vertexCount, strides, lineSize, lineCount);
+
+            std::vector<SVertexStream> streams = { { &mesh.positions, sizeof(Position_t) } };
+
+            uint32_t const vertexCount = optimizeVertexFetch(streams, mesh.indices, mesh.vertexCount);
+            SVertexFetchStatistics const after = analyzeVertexFetch(mesh.indices, vertexCount, strides, lineSize, lineCount);
+
+            bool ok = true;
+
+            ok &= ((mesh.vertexCount - 1) == vertexCount);
+            ok &= ((vertexCount * sizeof(Position_t)) == mesh.positions.size());
+            ok &= (triangles == canonicalTriangles(mesh.positions, mesh.indices));
+
+            // Vertices are stored in the order of their first use.
+            uint32_t next = 0;
+            for(uint32_t const index : mesh.indices)
+            {
+                ok &= (index <= next);
+                next = std::max(next, (index + 1));
+            }
+
+            ok &= (after.overfetch < before.overfetch);
+
+            std::cout << "Mesh optimization vertex fetch: " << (ok ? "OK" : "FAILED")
+                      << " (overfetch " << before.overfetch << " -> " << after.overfetch << ")\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshOptimization::testWelding()
+        {
+            STestMesh const grid = gridMesh(8);
+
+            // Unindexed: Every triangle has its own vertices, with a second stream equal for all
+            // vertices but those of the first triangle, which must not be merged with the others.
+            std::vector<uint8_t>  positions {};
+            std::vector<uint8_t>  tags      {};
+            std::vector<uint32_t> indices   {};
+            for(std::size_t k=0; k<grid.indices.size(); ++k)
+            {
+                Position_t const position = positionOf(grid.positions, grid.indices[k]);
+                positions.insert(positions.end(), reinterpret_cast<uint8_t const *>(position.data()), reinterpret_cast<uint8_t const *>(position.data()) + sizeof(Position_t));
+
+                tags.push_back((k < 3) ? 1 : 0);
+                indices.push_back(static_cast<uint32_t>(k));
+            }
+
+            std::vector<Triangle_t> const triangles = canonicalTriangles(positions, indices);
+
+            std::vector<SVertexStream> streams = { { &positions, sizeof(Position_t) }, { &tags, 1 } };
+
+            uint32_t const vertexCount = weldVertices(streams, indices, static_cast<uint32_t>(indices.size()));
+
+            bool ok = true;
+
+            // The vertices of the first triangle exist twice.
+            ok &= ((grid.vertexCount + 3) == vertexCount);
+            ok &= ((vertexCount * sizeof(Position_t)) == positions.size());
+            ok &= (vertexCount == tags.size());
+            ok &= (triangles == canonicalTriangles(positions, indices));
+
+            for(uint32_t const index : indices)
+            {
+                ok &= (index < vertexCount);
+            }
+
+            // The first triangle keeps its own vertices.
+            for(uint32_t k=0; k<3; ++k)
+            {
+                ok &= (1 == tags[indices[k]]);
+            }
+            for(std::size_t k=3; k<indices.size(); ++k)
+            {
+                ok &= (0 == tags[indices[k]]);
+            }
+
+            std::cout << "Mesh optimization welding: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshOptimization::testSimplification()
+        {
+            uint32_t const size = 16;
+
+            STestMesh const mesh = gridMesh(size);
+
+            bool ok = true;
+
+            // A flat grid collapses without error, down to the locked border vertices.
+            float error = -1.0f;
+            std::vector<uint32_t> const simplified = simplifyMesh(mesh.positions.data(), sizeof(Position_t), mesh.indices, mesh.vertexCount, 0, 0.001f, error);
+
+            ok &= (0 == (simplified.size() % 3));
+            ok &= (simplified.size() <= (mesh.indices.size() / 2));
+            ok &= (0.0f <= error && error <= 0.001f);
+
+            // No triangle is degenerate or flipped, and the surface is still covered exactly once.
+            float area = 0.0f;
+            for(std::size_t t=0; t<(simplified.size() / 3); ++t)
+            {
+                for(uint32_t k=0; k<3; ++k)
+                {
+                    ok &= (simplified[(3 * t) + k] < mesh.vertexCount);
+                }
+
+                float const doubleArea = signedDoubleArea(mesh.positions, simplified, t);
+                ok &= (0.0f < doubleArea);
+                area += (0.5f * doubleArea);
+            }
+            ok &= (std::fabs(area - static_cast<float>(size * size)) < 0.001f);
+
+            // The border of the grid is kept: Every border vertex is still referenced.
+            for(uint32_t v=0; v<mesh.vertexCount; ++v)
+            {
+                Position_t const position = positionOf(mesh.positions, v);
+                bool       const border   = (0.0f == position[0] || 0.0f == position[1] || static_cast<float>(size) == position[0] || static_cast<float>(size) == position[1]);
+                if(border)
+                {
+                    ok &= (simplified.end() != std::find(simplified.begin(), simplified.end(), v));
+                }
+            }
+
+            // A bent surface stops simplifying at the error bound.
+            STestMesh bent = gridMesh(size);
+            for(uint32_t v=0; v<bent.vertexCount; ++v)
+            {
+                Position_t position = positionOf(bent.positions, v);
+                position[2] = (0.005f * ((position[0] * position[0]) + (position[1] * position[1])));
+                std::memcpy(bent.positions.data() + (v * sizeof(Position_t)), position.data(), sizeof(Position_t));
+            }
+
+            float bentError = -1.0f;
+            std::vector<uint32_t> const bentSimplified = simplifyMesh(bent.positions.data(), sizeof(Position_t), bent.indices, bent.vertexCount, 0, 0.01f, bentError);
+
+            ok &= (bentSimplified.size() < bent.indices.size());
+            ok &= (bentSimplified.size() > simplified.size());
+            ok &= (0.0f <= bentError && bentError <= 0.01f);
+
+            std::cout << "Mesh optimization simplification: " << (ok ? "OK" : "FAILED")
+                      << " (" << mesh.indices.size() << " -> " << simplified.size() << " indices)\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
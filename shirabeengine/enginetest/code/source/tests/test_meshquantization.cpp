@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include <mesh/meshquantization.h>
+
+#include "tests/test_meshquantization.h"
+
+namespace Test
+{
+    namespace Mesh
+    {
+        using namespace engine;
+        using namespace engine::mesh;
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshQuantization::testAll()
+        {
+            bool ok = true;
+
+            ok &= testHalf();
+            ok &= testOctahedral();
+            ok &= testUnorm16();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshQuantization::testHalf()
+        {
+            bool ok = true;
+
+            // Exactly representable.
+            ok &= (0x0000 == floatToHalf(0.0f));
+            ok &= (0x8000 == floatToHalf(-0.0f));
+            ok &= (0x3c00 == floatToHalf(1.0f));
+            ok &= (0xc000 == floatToHalf(-2.0f));
+            ok &= (0x3800 == floatToHalf(0.5f));
+            ok &= (0x7bff == floatToHalf(65504.0f));
+            ok &= (0x0001 == floatToHalf(std::ldexp(1.0f, -24)));
+            ok &= (0x0400 == floatToHalf(std::ldexp(1.0f, -14)));
+
+            // Ties round to even, beyond the range to infinity.
+            ok &= (0x3c00 == floatToHalf(1.0f + std::ldexp(1.0f, -11)));
+            ok &= (0x3c02 == floatToHalf(1.0f + std::ldexp(3.0f, -11)));
+            ok &= (0x7c00 == floatToHalf(65520.0f));
+            ok &= (0xfc00 == floatToHalf(-1.0e6f));
+            ok &= (0x7c00 == floatToHalf(std::numeric_limits<float>::infinity()));
+            ok &= std::isnan(halfToFloat(floatToHalf(std::numeric_limits<float>::quiet_NaN())));
+
+            // All finite halfs survive a round trip.
+            for(uint32_t bits=0; bits<0x10000u; ++bits)
+            {
+                uint16_t const half = static_cast<uint16_t>(bits);
+                if(0x7c00u == (half & 0x7c00u))
+                {
+                    continue;
+                }
+                ok &= (half == floatToHalf(halfToFloat(half)));
+            }
+
+            // Texture coordinates in the usual range keep 11 significant bits.
+            std::mt19937                          generator(1234);
+            std::uniform_real_distribution<float> distribution(-4.0f, 4.0f);
+            for(uint32_t k=0; k<1000; ++k)
+            {
+                float const value = distribution(generator);
+                ok &= (std::fabs(value - halfToFloat(floatToHalf(value))) <= (std::fabs(value) * std::ldexp(1.0f, -11)));
+            }
+
+            std::cout << "Mesh quantization half: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshQuantization::testOctahedral()
+        {
+            bool ok = true;
+
+            // The axes are exact.
+            for(std::array<float, 3> const &axis : { std::array<float, 3> { 1.0f,  0.0f,  0.0f }
+                                                   , std::array<float, 3> {-1.0f,  0.0f,  0.0f }
+                                                   , std::array<float, 3> { 0.0f,  1.0f,  0.0f }
+                                                   , std::array<float, 3> { 0.0f, -1.0f,  0.0f }
+                                                   , std::array<float, 3> { 0.0f,  0.0f,  1.0f }
+                                                   , std::array<float, 3> { 0.0f,  0.0f, -1.0f } })
+            {
+                ok &= (axis == decodeOctahedral(encodeOctahedral(axis)));
+            }
+
+            // Random directions stay within a few hundredths of a degree.
+            std::mt19937                    generator(1234);
+            std::normal_distribution<float> distribution(0.0f, 1.0f);
+
+            float largestAngle = 0.0f;
+            for(uint32_t k=0; k<10000; ++k)
+            {
+                std::array<float, 3> direction = { distribution(generator), distribution(generator), distribution(generator) };
+
+                float const length = std::sqrt((direction[0] * direction[0]) + (direction[1] * direction[1]) + (direction[2] * direction[2]));
+                for(float &component : direction)
+                {
+                    component /= length;
+                }
+
+                std::array<float, 3> const decoded = decodeOctahedral(encodeOctahedral(direction));
+
+                float const cosine = std::clamp((direction[0] * decoded[0]) + (direction[1] * decoded[1]) + (direction[2] * decoded[2]), -1.0f, 1.0f);
+                largestAngle = std::max(largestAngle, std::acos(cosine));
+            }
+            ok &= (largestAngle < 0.001f);
+
+            std::cout << "Mesh quantization octahedral: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__MeshQuantization::testUnorm16()
+        {
+            float const minimum = -2.5f;
+            float const maximum =  7.0f;
+
+            bool ok = true;
+
+            ok &= (0     == quantizeUnorm16(minimum, minimum, maximum));
+            ok &= (65535 == quantizeUnorm16(maximum, minimum, maximum));
+            ok &= (0     == quantizeUnorm16(-10.0f,  minimum, maximum));
+            ok &= (65535 == quantizeUnorm16( 10.0f,  minimum, maximum));
+            ok &= (0     == quantizeUnorm16(1.0f, 1.0f, 1.0f));
+
+            ok &= (minimum == dequantizeUnorm16(0,     minimum, maximum));
+            ok &= (maximum == dequantizeUnorm16(65535, minimum, maximum));
+
+            // At most half a step off, plus float rounding.
+            float const tolerance = (((maximum - minimum) / 65535.0f) * 0.5f) + 1.0e-6f;
+            for(uint32_t k=0; k<=1000; ++k)
+            {
+                float const value = minimum + ((maximum - minimum) * (static_cast<float>(k) / 1000.0f));
+                ok &= (std::fabs(value - dequantizeUnorm16(quantizeUnorm16(value, minimum, maximum), minimum, maximum)) <= tolerance);
+            }
+
+            std::cout << "Mesh quantization unorm16: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
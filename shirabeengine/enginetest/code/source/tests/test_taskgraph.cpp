@@ -0,0 +1,455 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/threading/asyncresult.h>
+#include <core/threading/jobsystem.h>
+#include <core/threading/taskgraph.h>
+
+#include "tests/test_taskgraph.h"
+
+namespace Test
+{
+    namespace Threading
+    {
+        using namespace engine;
+        using namespace engine::threading;
+
+        using Clock_t = std::chrono::steady_clock;
+
+        /**
+         * Create and start a job system with the default number of workers.
+         *
+         * @return The running job system.
+         */
+        static Shared<CJobSystem> makeJobSystem()
+        {
+            Shared<CJobSystem> jobSystem = makeShared<CJobSystem>();
+            jobSystem->initialize();
+            jobSystem->run();
+
+            return jobSystem;
+        }
+
+        /**
+         * Stop and release a job system created with makeJobSystem.
+         *
+         * @param aJobSystem The job system to stop.
+         */
+        static void releaseJobSystem(Shared<CJobSystem> const &aJobSystem)
+        {
+            aJobSystem->abortAndJoin();
+            aJobSystem->deinitialize();
+        }
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testAll()
+        {
+            bool ok = true;
+
+            ok &= testWideFanOutFanIn();
+            ok &= testLayeredDagOrdering();
+            ok &= testContinuationsOnFinishedTasks();
+            ok &= testFailurePropagation();
+            ok &= testAsyncResultPipelines();
+            ok &= testDiscardedJobs();
+            ok &= benchmarkThroughput();
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testWideFanOutFanIn()
+        {
+            static constexpr uint32_t const kWidth = 4096;
+
+            Shared<CJobSystem> jobSystem = makeJobSystem();
+
+            bool ok = true;
+            {
+                CTaskGraph graph(jobSystem);
+
+                std::atomic<uint32_t> rootRuns(0);
+                std::atomic<uint32_t> middleRuns(0);
+                std::atomic<uint32_t> middleBeforeRoot(0);
+                uint32_t              middleRunsSeenBySink = 0;
+
+                CTaskHandle const root = graph.add([&] () -> CEngineResult<>
+                {
+                    ++rootRuns;
+                    return { EEngineStatus::Ok };
+                });
+
+                std::vector<CTaskHandle> middle {};
+                middle.reserve(kWidth);
+                for(uint32_t k=0; k<kWidth; ++k)
+                {
+                    middle.push_back(root.then([&] () -> CEngineResult<>
+                    {
+                        if(0 == rootRuns.load())
+                        {
+                            ++middleBeforeRoot;
+                        }
+                        ++middleRuns;
+                        return { EEngineStatus::Ok };
+                    }));
+                }
+
+                CTaskHandle const sink = graph.whenAll(middle).then([&] () -> CEngineResult<>
+                {
+                    middleRunsSeenBySink = middleRuns.load();
+                    return { EEngineStatus::Ok };
+                });
+
+                ok &= sink.wait().successful();
+                ok &= (1      == rootRuns.load());
+                ok &= (0      == middleBeforeRoot.load());
+                ok &= (kWidth == middleRunsSeenBySink);
+
+                graph.waitAll();
+                ok &= (0 == graph.pendingTaskCount());
+            }
+
+            releaseJobSystem(jobSystem);
+
+            std::cout << "CTaskGraph fan out/fan in (" << kWidth << " nodes): " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testLayeredDagOrdering()
+        {
+            static constexpr uint32_t const kLayers         = 16;
+            static constexpr uint32_t const kWidth          = 256;
+            static constexpr uint32_t const kFanIn          = 4;
+            static constexpr uint32_t const kNodeCount      = (kLayers * kWidth);
+
+            std::mt19937                            generator(1337);
+            std::uniform_int_distribution<uint32_t> distribution(0, (kWidth - 1));
+
+            // Random dependencies on the previous layer.
+            std::vector<std::vector<uint32_t>> dependencies(kNodeCount);
+            for(uint32_t layer=1; layer<kLayers; ++layer)
+            {
+                for(uint32_t k=0; k<kWidth; ++k)
+                {
+                    for(uint32_t d=0; d<kFanIn; ++d)
+                    {
+                        dependencies[(layer * kWidth) + k].push_back(((layer - 1) * kWidth) + distribution(generator));
+                    }
+                }
+            }
+
+            bool ok = true;
+
+            // Run once on the job system and once inline.
+            for(bool const useJobSystem : { true, false })
+            {
+                Shared<CJobSystem> jobSystem = (useJobSystem ? makeJobSystem() : nullptr);
+
+                std::vector<uint64_t> completionOrder(kNodeCount, 0);
+                std::atomic<uint64_t> sequence(0);
+                std::atomic<uint32_t> violations(0);
+
+                {
+                    CTaskGraph               graph(jobSystem);
+                    std::vector<CTaskHandle> handles(kNodeCount);
+
+                    for(uint32_t n=0; n<kNodeCount; ++n)
+                    {
+                        std::vector<CTaskHandle> nodeDependencies {};
+                        for(uint32_t const &d : dependencies[n])
+                        {
+                            nodeDependencies.push_back(handles[d]);
+                        }
+
+                        handles[n] = graph.add([&, n] () -> CEngineResult<>
+                        {
+                            // Every dependency must have completed before.
+                            for(uint32_t const &d : dependencies[n])
+                            {
+                                if(0 == completionOrder[d])
+                                {
+                                    ++violations;
+                                }
+                            }
+
+                            completionOrder[n] = ++sequence;
+                            return { EEngineStatus::Ok };
+                        }, nodeDependencies);
+                    }
+
+                    graph.waitAll();
+                }
+
+                for(uint32_t n=0; n<kNodeCount; ++n)
+                {
+                    for(uint32_t const &d : dependencies[n])
+                    {
+                        ok &= (completionOrder[d] < completionOrder[n]);
+                    }
+                }
+
+                ok &= (kNodeCount == sequence.load());
+                ok &= (0          == violations.load());
+
+                if(nullptr != jobSystem)
+                {
+                    releaseJobSystem(jobSystem);
+                }
+            }
+
+            std::cout << "CTaskGraph layered DAG (" << kNodeCount << " nodes): " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testContinuationsOnFinishedTasks()
+        {
+            Shared<CJobSystem> jobSystem = makeJobSystem();
+
+            bool ok = true;
+            {
+                CTaskGraph graph(jobSystem);
+
+                std::atomic<uint32_t> runs(0);
+
+                CTaskHandle const first = graph.add([&] () -> CEngineResult<> { ++runs; return { EEngineStatus::Ok }; });
+                ok &= first.wait().successful();
+
+                // Chaining to a finished task runs the continuation right away.
+                CTaskHandle const second = first.then([&] () -> CEngineResult<> { ++runs; return { EEngineStatus::Ok }; });
+                ok &= second.wait().successful();
+
+                // Empty joins finish immediately.
+                ok &= graph.whenAll({}).wait().successful();
+
+                ok &= (2 == runs.load());
+            }
+
+            releaseJobSystem(jobSystem);
+
+            std::cout << "CTaskGraph continuations on finished tasks: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testFailurePropagation()
+        {
+            Shared<CJobSystem> jobSystem = makeJobSystem();
+
+            bool ok = true;
+            {
+                CTaskGraph graph(jobSystem);
+
+                std::atomic<uint32_t> skippedRuns(0);
+                std::atomic<uint32_t> independentRuns(0);
+
+                CTaskHandle const failing     = graph.add([] () -> CEngineResult<> { return { EEngineStatus::Error }; });
+                CTaskHandle const throwing    = graph.add([] () -> CEngineResult<> { throw std::runtime_error("Expected by test."); });
+                CTaskHandle const independent = graph.add([&] () -> CEngineResult<> { ++independentRuns; return { EEngineStatus::Ok }; });
+
+                CTaskHandle const dependent   = failing.then([&] () -> CEngineResult<> { ++skippedRuns; return { EEngineStatus::Ok }; });
+                CTaskHandle const transitive  = dependent.then([&] () -> CEngineResult<> { ++skippedRuns; return { EEngineStatus::Ok }; });
+                CTaskHandle const afterThrow  = throwing.then([&] () -> CEngineResult<> { ++skippedRuns; return { EEngineStatus::Ok }; });
+                CTaskHandle const join        = graph.whenAll({ independent, failing });
+
+                ok &= not transitive.wait().successful();
+                ok &= not afterThrow.wait().successful();
+                ok &= not join      .wait().successful();
+                ok &=     independent.wait().successful();
+
+                ok &= (0 == skippedRuns.load());
+                ok &= (1 == independentRuns.load());
+            }
+
+            releaseJobSystem(jobSystem);
+
+            std::cout << "CTaskGraph failure propagation: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testAsyncResultPipelines()
+        {
+            static constexpr uint32_t const kPipelineCount = 1024;
+
+            Shared<CJobSystem> jobSystem = makeJobSystem();
+
+            bool ok = true;
+            {
+                CTaskGraph graph(jobSystem);
+
+                // Emulate "read bytes" -> "decode" -> "instantiate" for many assets at once.
+                std::vector<CAsyncResult<std::string>> pipelines {};
+                pipelines.reserve(kPipelineCount);
+                for(uint32_t k=0; k<kPipelineCount; ++k)
+                {
+                    CAsyncResult<std::vector<uint8_t>> const read = async<std::vector<uint8_t>>(graph, [k] () -> CEngineResult<std::vector<uint8_t>>
+                    {
+                        return { EEngineStatus::Ok, std::vector<uint8_t>(k % 64, static_cast<uint8_t>(k)) };
+                    });
+
+                    CAsyncResult<uint64_t> const decoded = read.then([] (std::vector<uint8_t> const &aBytes) -> CEngineResult<uint64_t>
+                    {
+                        return { EEngineStatus::Ok, static_cast<uint64_t>(aBytes.size()) };
+                    });
+
+                    pipelines.push_back(decoded.then([k] (uint64_t const &aSize) -> CEngineResult<std::string>
+                    {
+                        if(13 == k)
+                        {
+                            return { EEngineStatus::Error };
+                        }
+                        return { EEngineStatus::Ok, std::to_string(k) + ":" + std::to_string(aSize) };
+                    }));
+                }
+
+                for(uint32_t k=0; k<kPipelineCount; ++k)
+                {
+                    CEngineResult<std::string> const value = pipelines[k].get();
+                    if(13 == k)
+                    {
+                        ok &= not value.successful();
+                        continue;
+                    }
+
+                    ok &= value.successful();
+                    ok &= (value.data() == (std::to_string(k) + ":" + std::to_string(k % 64)));
+                }
+
+                // Stages after a failed stage are skipped.
+                std::atomic<uint32_t> skippedRuns(0);
+                CAsyncResult<int> const skipped = pipelines[13].then([&] (std::string const &) -> CEngineResult<int>
+                {
+                    ++skippedRuns;
+                    return { EEngineStatus::Ok, 1 };
+                });
+                ok &= not skipped.get().successful();
+                ok &= (0 == skippedRuns.load());
+
+                ok &= (42 == ready<int>(graph, { EEngineStatus::Ok, 42 }).get().data());
+            }
+
+            releaseJobSystem(jobSystem);
+
+            std::cout << "CAsyncResult pipelines (" << kPipelineCount << " x 3 stages): " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::testDiscardedJobs()
+        {
+            // Never run, so that the jobs stay pending until they are discarded.
+            CJobSystem jobSystem {};
+
+            bool ok = true;
+            ok &= jobSystem.initialize(2);
+
+            std::atomic<uint32_t> runs(0);
+
+            std::vector<CJobHandle<uint32_t>> handles {};
+            for(uint32_t k=0; k<8; ++k)
+            {
+                handles.push_back(jobSystem.post<uint32_t>([&runs, k] () -> uint32_t { ++runs; return k; }));
+                ok &= handles.back().valid();
+            }
+
+            ok &= jobSystem.deinitialize();
+
+            // Waiting on a discarded job returns instead of blocking forever. The result is a broken promise.
+            for(CJobHandle<uint32_t> const &handle : handles)
+            {
+                handle.wait();
+                ok &= handle.finished();
+
+                try
+                {
+                    handle.get();
+                    ok = false;
+                }
+                catch(std::future_error const &)
+                {
+                }
+            }
+
+            ok &= (0 == runs.load());
+
+            std::cout << "CJobSystem discarded jobs: " << (ok ? "OK" : "FAILED") << "\n";
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool Test__TaskGraph::benchmarkThroughput()
+        {
+            static constexpr uint32_t const kWidth  = 1000;
+            static constexpr uint32_t const kLayers = 100;
+
+            Shared<CJobSystem> jobSystem   = makeJobSystem();
+            uint32_t     const workerCount = jobSystem->workerCount();
+
+            std::atomic<uint64_t> runs(0);
+            bool                  completed = false;
+
+            Clock_t::time_point const start = Clock_t::now();
+            {
+                CTaskGraph graph(jobSystem);
+
+                // Each layer is a wide fan out joined before the next layer starts.
+                CTaskHandle barrier = graph.add(nullptr);
+                for(uint32_t layer=0; layer<kLayers; ++layer)
+                {
+                    std::vector<CTaskHandle> nodes {};
+                    nodes.reserve(kWidth);
+                    for(uint32_t k=0; k<kWidth; ++k)
+                    {
+                        nodes.push_back(barrier.then([&] () -> CEngineResult<> { ++runs; return { EEngineStatus::Ok }; }));
+                    }
+                    barrier = graph.whenAll(nodes);
+                }
+
+                completed = barrier.wait().successful();
+            }
+            Clock_t::time_point const end = Clock_t::now();
+
+            releaseJobSystem(jobSystem);
+
+            double const seconds = std::chrono::duration<double>(end - start).count();
+            bool   const ok      = (completed && (kWidth * kLayers) == runs.load());
+
+            std::cout << "CTaskGraph throughput (" << kLayers << " layers of " << kWidth << " nodes, "
+                      << workerCount << " workers): "
+                      << static_cast<uint64_t>(runs.load() / seconds) << " tasks/s\n";
+
+            return ok;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -87,3 +87,17 @@ vec3 unpack_normal(vec3 aInput)
 {
     return ((2.0f * aInput) - 1.0f);
 }
+
+//
+// Inverse of the octahedral encoding of unit vectors in the mesh data files.
+//
+vec3 decode_octahedral(vec2 aInput)
+{
+    vec3 direction = vec3(aInput.xy, 1.0f - abs(aInput.x) - abs(aInput.y));
+    if(0.0f > direction.z)
+    {
+        vec2 signs   = vec2((0.0f <= direction.x) ? 1.0f : -1.0f, (0.0f <= direction.y) ? 1.0f : -1.0f);
+        direction.xy = ((1.0f - abs(direction.yx)) * signs);
+    }
+    return normalize(direction);
+}
@@ -12,12 +12,22 @@ uniform struct_modelMatrices
     mat4  inverseTransposeWorld;
 } modelMatrices;
 
+//
+// Per draw data of the mesh, see SMeshDrawConstants.
+//
+layout (push_constant)
+uniform struct_meshDrawConstants
+{
+    vec4  positionScale;  // Dequantizes the positions to object space:
+    vec4  positionOffset; // offset + scale * position, i.e. the bounds of the mesh.
+} meshDrawConstants;
+
 //
 // Input description
 //
-layout (location = 0) in vec3 vertex_position;
-layout (location = 1) in vec3 vertex_normal;
-layout (location = 2) in vec4 vertex_tangent;
+layout (location = 0) in vec3 vertex_position; // Normalized to the bounds of the mesh.
+layout (location = 1) in vec2 vertex_normal;   // Octahedral.
+layout (location = 2) in vec4 vertex_tangent;  // Octahedral, the handedness of the bitangent in z.
 layout (location = 3) in vec2 vertex_texcoord;
 
 //
@@ -28,15 +38,17 @@ out struct_vertexData_full shader_output;
 
 void main()
 {
-    vec4 position = vec4(vertex_position.xyz, 1.0);
+    vec4 position = vec4(meshDrawConstants.positionOffset.xyz + (meshDrawConstants.positionScale.xyz * vertex_position.xyz), 1.0);
+    vec3 normal   = decode_octahedral(vertex_normal);
+    vec3 tangent  = decode_octahedral(vertex_tangent.xy);
 
     mat4 view_transform     = (graphicsData.primaryCamera.view * modelMatrices.world);
     mat3 view_transform_3x3 = mat3(view_transform);
 
     vec4 position_viewspace  = (view_transform * position);
-    vec3 normal_viewspace    = normalize(view_transform_3x3 * vertex_normal);
-    vec3 tangent_viewspace   = normalize(view_transform_3x3 * vertex_tangent.xyz);
-    vec3 bitangent_viewspace = normalize(cross(normal_viewspace, tangent_viewspace) * vertex_tangent.w);
+    vec3 normal_viewspace    = normalize(view_transform_3x3 * normal);
+    vec3 tangent_viewspace   = normalize(view_transform_3x3 * tangent);
+    vec3 bitangent_viewspace = normalize(cross(normal_viewspace, tangent_viewspace) * vertex_tangent.z);
 
     gl_Position   = (graphicsData.primaryCamera.projection * position_viewspace);
     // gl_Position.z = (gl_Position.z + gl_Position.w) / 2.0;
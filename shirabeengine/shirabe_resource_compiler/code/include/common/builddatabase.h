@@ -0,0 +1,141 @@
+#ifndef __SHIRABEDEVELOPMENT_BUILDDATABASE_H__
+#define __SHIRABEDEVELOPMENT_BUILDDATABASE_H__
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <core/enginestatus.h>
+#include <log/log.h>
+
+#include "common/config.h"
+
+namespace resource_compiler
+{
+    /**
+     * Version of the outputs of the resource compiler. Increase on any change of the processors,
+     * which changes their outputs, to rebuild all inputs recorded with a previous version.
+     */
+    static constexpr uint32_t const kResourceCompilerVersion = 6;
+
+    /**
+     * The SBuildArtifacts struct lists the files a processor read and wrote for a single input,
+     * besides the input itself.
+     */
+    struct SBuildArtifacts
+    {
+        std::vector<std::filesystem::path> dependencies; // E.g. shader sources and their includes, images, glTF buffers.
+        std::vector<std::filesystem::path> outputs;
+    };
+
+    /**
+     * The CBuildDatabase class records, from which state of its input and dependencies each input
+     * file was built, so that unchanged inputs can be skipped on the next run.
+     *
+     * Files are compared by size and modification time first. Only if those differ, the content
+     * hash is recomputed, so that checking an unchanged tree only costs a stat per file and touched,
+     * but unchanged files are not rebuilt.
+     *
+     * All methods are thread safe.
+     */
+    class CBuildDatabase
+    {
+        SHIRABE_DECLARE_LOG_TAG(CBuildDatabase);
+
+    public_methods:
+        /**
+         * Read the records of a previous run. A missing file yields an empty database.
+         *
+         * @param aFilename The database file.
+         * @return          EEngineStatus::Ok, if successful or missing. An error, if the file is invalid.
+         */
+        engine::CEngineResult<> load(std::filesystem::path const &aFilename);
+
+        /**
+         * Write all records.
+         *
+         * @param aFilename The database file.
+         * @return          EEngineStatus::Ok, if successful. An error otherwise.
+         */
+        engine::CEngineResult<> save(std::filesystem::path const &aFilename) const;
+
+        /**
+         * Check, whether aInput was built with aOptionsHash from its current state and the current
+         * state of all its dependencies, and whether all of its outputs still exist.
+         *
+         * @param aInput       The input file.
+         * @param aOptionsHash The hash of the options affecting the outputs, see optionsHash(...).
+         * @return             True, if aInput doesn't need to be processed.
+         */
+        bool isUpToDate(std::filesystem::path const &aInput, uint64_t aOptionsHash) const;
+
+        /**
+         * Record the current state of aInput and the artifacts of its successful build.
+         *
+         * @param aInput       The input file.
+         * @param aOptionsHash The hash of the options aInput was built with.
+         * @param aArtifacts   The dependencies and outputs of the build.
+         */
+        void record(std::filesystem::path const &aInput, uint64_t aOptionsHash, SBuildArtifacts const &aArtifacts);
+
+        /**
+         * Drop the record of aInput, e.g. after a failed build.
+         *
+         * @param aInput The input file.
+         */
+        void forget(std::filesystem::path const &aInput);
+
+        /**
+         * Drop the records of all inputs, which are not in aInputs anymore.
+         *
+         * @param aInputs The inputs of the current run.
+         */
+        void retain(std::vector<std::filesystem::path> const &aInputs);
+
+    public_static_functions:
+        /**
+         * Hash all options of aConfig, which affect the outputs, together with kResourceCompilerVersion.
+         *
+         * @param aConfig The configuration of the run.
+         * @return        See brief.
+         */
+        static uint64_t optionsHash(SConfiguration const &aConfig);
+
+    private_structs:
+        struct SFileState
+        {
+            std::filesystem::path path;
+            uint64_t              size;
+            int64_t               modificationTime;
+            uint64_t              hash;
+        };
+
+        struct SRecord
+        {
+            uint64_t                           optionsHash;
+            SFileState                         input;
+            std::vector<SFileState>            dependencies;
+            std::vector<std::filesystem::path> outputs;
+        };
+
+    private_static_functions:
+        /**
+         * Capture the current state of aPath.
+         *
+         * @return The state, if aPath is a readable file.
+         */
+        static engine::CEngineResult<SFileState> captureFileState(std::filesystem::path const &aPath);
+
+        /**
+         * Check, whether aPath is still in aState. Rehashes the file, if its size or modification time changed.
+         */
+        static bool isUnchanged(SFileState const &aState);
+
+    private_members:
+        mutable std::mutex                       mMutex;
+        std::unordered_map<std::string, SRecord> mRecords;
+    };
+}
+
+#endif //__SHIRABEDEVELOPMENT_BUILDDATABASE_H__
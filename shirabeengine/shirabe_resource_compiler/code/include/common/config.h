@@ -6,6 +6,7 @@
 #define __SHIRABEDEVELOPMENT_CONFIG_H__
 
 #include <core/bitfield.h>
+#include <asset/assettypes.h>
 
 /**
  * Enumeration describing various tool options to be respected while processing.
@@ -22,8 +23,21 @@ enum class EOptions
     DumpConfig           = (1lu << 6lu),
     DumpReflection       = (1lu << 7lu),
     DumpBareVersion      = (1lu << 8lu),
+    EmitAssetPack        = (1lu << 9lu),
+    Rebuild              = (1lu << 10lu),
+    DumpMeshCleartext    = (1lu << 11lu),
 };
 
+/**
+ * Layout of the vertex attributes in a mesh container, see mesh::SMeshContainerAttribute.
+ */
+enum class EMeshVertexLayout
+        : uint32_t
+{
+    Planar = 0,  // A stream per attribute.
+    Interleaved, // All attributes in a single stream.
+    Split,       // Positions alone, e.g. for depth only passes, and the other attributes interleaved.
+};
 
 /**
  * @brief The SConfiguration struct
@@ -35,6 +49,10 @@ struct SConfiguration
     std::vector<std::filesystem::path>   includePaths;
     std::vector<std::filesystem::path>   filesToProcess;
     engine::core::CBitField<EOptions>    options;
+    engine::asset::EAssetCodec           compressionCodec;
+    uint32_t                             jobCount;     // Number of files processed in parallel. 0 for one per hardware thread.
+    uint32_t                             meshLodCount; // Levels of detail generated per mesh, including the original. 1 to disable.
+    EMeshVertexLayout                    meshVertexLayout;
 };
 
 #endif //__SHIRABEDEVELOPMENT_CONFIG_H__
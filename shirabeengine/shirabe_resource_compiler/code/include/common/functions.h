@@ -6,10 +6,32 @@
 #define __SHIRABEDEVELOPMENT_FUNCTIONS_H__
 
 #include <filesystem>
+#include <vector>
+#include <core/enginestatus.h>
+
+#include "common/config.h"
 
 namespace resource_compiler
 {
     auto checkPathExists(std::filesystem::path const &aPath) -> void;
+
+    /**
+     * Write asset data to a file, block compressed with the configured codec, if any.
+     *
+     * @param aPath   The file to write.
+     * @param aData   The uncompressed asset data.
+     * @param aConfig The configuration providing the codec.
+     * @return        EEngineStatus::Ok, if successful. An error otherwise.
+     */
+    auto writeAssetData(std::filesystem::path const &aPath, std::vector<uint8_t> const &aData, SConfiguration const &aConfig) -> engine::CEngineResult<>;
+
+    /**
+     * Determine the codec an asset data file was written with by writeAssetData.
+     *
+     * @param aPath The file to inspect.
+     * @return      The codec or EAssetCodec::None, if the file is not block compressed.
+     */
+    auto readAssetDataCodec(std::filesystem::path const &aPath) -> engine::asset::EAssetCodec;
 }
 
 #endif //__SHIRABEDEVELOPMENT_FUNCTIONS_H__
@@ -8,13 +8,14 @@
 #include <filesystem>
 #include <core/result.h>
 
+#include "common/builddatabase.h"
 #include "common/config.h"
 #include "materials/definition.h"
 #include "materials/shadercompilationunit.h"
 
 namespace materials
 {
-    CResult<EResult> processMaterial(std::filesystem::path const &aMaterialFile, SConfiguration const &aConfig);
+    CResult<EResult> processMaterial(std::filesystem::path const &aMaterialFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts);
 }
 
 #endif //__SHIRABEDEVELOPMENT_MATERIALPROCESSOR_H__
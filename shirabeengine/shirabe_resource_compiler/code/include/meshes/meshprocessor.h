@@ -8,6 +8,7 @@
 #include <filesystem>
 #include <core/result.h>
 
+#include "common/builddatabase.h"
 #include "common/config.h"
 #include "meshes/definition.h"
 
@@ -16,7 +17,7 @@ namespace meshes
     using engine::CResult;
     using resource_compiler::EResult;
 
-    CResult<EResult> processMesh(std::filesystem::path const &aMeshFile, SConfiguration const &aConfig);
+    CResult<EResult> processMesh(std::filesystem::path const &aMeshFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts);
 }
 
 #endif //__SHIRABEDEVELOPMENT_MATERIALPROCESSOR_H__
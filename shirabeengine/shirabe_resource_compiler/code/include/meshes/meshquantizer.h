@@ -0,0 +1,46 @@
+#ifndef __SHIRABEDEVELOPMENT_MESHQUANTIZER_H__
+#define __SHIRABEDEVELOPMENT_MESHQUANTIZER_H__
+
+#include <cstdint>
+#include <vector>
+
+#include <mesh/meshcontainer.h>
+
+namespace meshes
+{
+    /**
+     * Quantize float3 positions to EMeshAttributeFormat::Unorm16x4 relative to aBounds.
+     *
+     * @param aPositions The float3 samples.
+     * @param aBounds    The bounds of all samples, which the runtime dequantizes with.
+     * @return           The quantized samples.
+     */
+    std::vector<uint8_t> quantizePositions(std::vector<uint8_t> const &aPositions, engine::mesh::SMeshBounds const &aBounds);
+
+    /**
+     * Encode float3 unit vectors octahedral as EMeshAttributeFormat::Snorm16x2.
+     *
+     * @param aNormals The float3 samples.
+     * @return         The encoded samples.
+     */
+    std::vector<uint8_t> quantizeNormals(std::vector<uint8_t> const &aNormals);
+
+    /**
+     * Encode float4 tangents as EMeshAttributeFormat::Snorm16x4: The octahedral direction
+     * in x and y, the handedness of the bitangent in z, 0 in w.
+     *
+     * @param aTangents The float4 samples.
+     * @return          The encoded samples.
+     */
+    std::vector<uint8_t> quantizeTangents(std::vector<uint8_t> const &aTangents);
+
+    /**
+     * Convert float2 texture coordinates to EMeshAttributeFormat::Float16x2.
+     *
+     * @param aTexcoords The float2 samples.
+     * @return           The converted samples.
+     */
+    std::vector<uint8_t> quantizeTexcoords(std::vector<uint8_t> const &aTexcoords);
+}
+
+#endif //__SHIRABEDEVELOPMENT_MESHQUANTIZER_H__
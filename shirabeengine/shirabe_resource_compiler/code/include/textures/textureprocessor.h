@@ -8,6 +8,7 @@
 #include <filesystem>
 #include <core/result.h>
 
+#include "common/builddatabase.h"
 #include "common/config.h"
 #include "textures/definition.h"
 
@@ -16,7 +17,7 @@ namespace texture
     using engine::CResult;
     using resource_compiler::EResult;
 
-    CResult<EResult> processTexture(std::filesystem::path const &aTextureFile, SConfiguration const &aConfig);
+    CResult<EResult> processTexture(std::filesystem::path const &aTextureFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts);
 }
 
 #endif //__SHIRABEDEVELOPMENT_MATERIALPROCESSOR_H__
@@ -2,6 +2,7 @@
 #define _CRT_SECURE_NO_WARNINGS
 #endif
 
+#include <atomic>
 #include <iterator>
 #include <filesystem>
 #include <cstring>
@@ -27,14 +28,18 @@
 
 #include <log/log.h>
 #include <base/string.h>
+#include <asset/assetindex.h>
+#include <asset/assetpack.h>
 #include <core/bitfield.h>
 #include <core/enginetypehelper.h>
 #include <core/result.h>
 #include <core/helpers.h>
+#include <core/threading/jobsystem.h>
 #include <material/serialization.h>
 #include <material/declaration.h>
 #include <util/documents/json.h>
 
+#include "common/builddatabase.h"
 #include "common/config.h"
 #include "common/definition.h"
 
@@ -77,6 +82,26 @@ void usage()
             "  --recursive_scan                                                                                      \n"
             "      Effect: If any of the paths in the -i option is a directory, include                              \n"
             "              all subdirectories in the input file search.                                              \n"
+            "  --compress=<lz4|zstd>                                                                                 \n"
+            "      Effect: Block compress mesh buffers and texture data with the given codec.                        \n"
+            "              The codec of each asset is recorded in the asset index.                                   \n"
+            "  --pack                                                                                                \n"
+            "      Effect: Additionally write all indexed output files into the single asset pack                    \n"
+            "              game.assetpack in the output directory.                                                   \n"
+            "  --dump_mesh_cleartext                                                                                 \n"
+            "      Effect: Additionally write the vertex attributes of each mesh as text next to its container.      \n"
+            "  --mesh_lods=<count>                                                                                   \n"
+            "      Effect: Generate up to <count> levels of detail per mesh, including the original, by halving      \n"
+            "              the triangle count of the previous level. 1 disables the generation. Defaults to 4.       \n"
+            "  --mesh_layout=<planar|interleaved|split>                                                              \n"
+            "      Effect: Store the vertex attributes of each mesh in a stream per attribute, in a single           \n"
+            "              interleaved stream, or positions alone and the rest interleaved. Defaults to planar.      \n"
+            "  --rebuild                                                                                             \n"
+            "      Effect: Process all input files, even if unchanged since the last run.                            \n"
+            "              Unchanged files are skipped otherwise, see game.builddb in the output directory.          \n"
+            "  -j=<count>                                                                                            \n"
+            "      Effect: Process up to <count> input files in parallel. Without a count, one per hardware thread.  \n"
+            "              The output of each file is printed in input order. Defaults to 1.                         \n"
             "  -o=<dirpath>                                                                                          \n"
             "      Effect: Specifies the path of a directory where all output files should be stored relatively      \n"
             "  -i=<filepath>                                                                                         \n"
@@ -123,6 +148,10 @@ public_methods:
         std::vector<std::filesystem::path> filesToProcess = {};
         std::filesystem::path              inputPath      = {};
         std::filesystem::path              outputPath     = {};
+        asset::EAssetCodec                 compression    = asset::EAssetCodec::None;
+        uint32_t                           jobCount       = 1;
+        uint32_t                           meshLodCount   = 4;
+        EMeshVertexLayout                  meshLayout     = EMeshVertexLayout::Planar;
 
         // std::string                        dataFile                = {};
         // std::vector<std::filesystem::path> includePaths            = {};
@@ -167,6 +196,13 @@ public_methods:
 
             std::string const referencableValue = value;
 
+            std::unordered_map<std::string, EMeshVertexLayout> const meshLayouts =
+            {
+                { "planar",      EMeshVertexLayout::Planar      },
+                { "interleaved", EMeshVertexLayout::Interleaved },
+                { "split",       EMeshVertexLayout::Split       },
+            };
+
             std::unordered_map<std::string, std::function<bool()>> handlers =
             {
                 { "--help",           [&] () { usage();                                                return true; }},
@@ -174,6 +210,13 @@ public_methods:
                 { "--debug",          [&] () { options.set(EOptions::DebugMode);                    return true; }},
                 { "--optimize",       [&] () { options.set(EOptions::OptimizationEnabled);          return true; }},
                 { "--recursive_scan", [&] () { options.set(EOptions::RecursiveScan);                return true; }},
+                { "--pack",           [&] () { options.set(EOptions::EmitAssetPack);                return true; }},
+                { "--rebuild",        [&] () { options.set(EOptions::Rebuild);                      return true; }},
+                { "--dump_mesh_cleartext", [&] () { options.set(EOptions::DumpMeshCleartext);       return true; }},
+                { "--compress",       [&] () { compression = from_string<asset::EAssetCodec>(referencableValue); return (asset::EAssetCodec::None != compression); }},
+                { "-j",               [&] () { jobCount   = static_cast<uint32_t>(std::strtoul(referencableValue.c_str(), nullptr, 10)); return true; }},
+                { "--mesh_lods",      [&] () { meshLodCount = static_cast<uint32_t>(std::strtoul(referencableValue.c_str(), nullptr, 10)); return (0 < meshLodCount); }},
+                { "--mesh_layout",    [&] () { auto const layout = meshLayouts.find(referencableValue); if(meshLayouts.end() != layout) { meshLayout = layout->second; } return (meshLayouts.end() != layout); }},
                 // { "-I",               [&] () { includePaths.push_back(referencableValue);                  return true; }},
                 { "-i" ,              [&] () { inputPath  = referencableValue;                          return true; }},
                 { "-o",               [&] () { outputPath = referencableValue;                          return true; }},
@@ -271,6 +314,10 @@ public_methods:
         config.outputPath          = outputPath.lexically_normal();
         config.includePaths        = includePaths;
         config.filesToProcess      = filesToProcess;
+        config.compressionCodec    = compression;
+        config.jobCount            = jobCount;
+        config.meshLodCount        = meshLodCount;
+        config.meshVertexLayout    = meshLayout;
         // config.indexFile           = index;
         // config.inputPaths          = inputFiles;
         // config.moduleOutputPath    = outputModulePath       .lexically_normal();
@@ -281,6 +328,11 @@ public_methods:
         // config.indexFile.signatureAssetUid     = asset::assetIdFromUri(outputSignaturePath);
         // config.indexFile.configurationAssetUid = asset::assetIdFromUri(outputConfigurationPath);
 
+        if(1 != jobCount)
+        {
+            config.options.set(EOptions::MultiThreaded);
+        }
+
         mConfig = config;
 
         return EResult::Success;
@@ -295,51 +347,46 @@ public_methods:
      */
     CResult<EResult> run()
     {
-        for(auto const &file : mConfig.filesToProcess)
+        std::filesystem::path const buildDatabasePath = (mConfig.outputPath / "game.builddb");
+        if(not mConfig.options.check(EOptions::Rebuild))
         {
-            std::filesystem::path const extension = file.extension();
-            if(".material" == extension)
-            {
-                auto const &[result, code] = materials::processMaterial(file, mConfig);
-                if(EResult::Success != code)
-                {
-                    CLog::Error(logTag(), "Failed to process material file w/ name {}", file.string());
-                    continue;
-                }
-            }
-            else if(".materialinstance" == extension)
-            {
-                // auto const &[result, code] = processMaterialInstance(file);
-                // if(EResult::Success != code)
-                // {
-                //     CLog::Error(logTag(), "Failed to process material instance w/ name {}", file.string());
-                //     continue;
-                // }
-            }
-            else if(".gltf" == extension)
+            CEngineResult<> const loadResult = mBuildDatabase.load(buildDatabasePath);
+            if(not loadResult.successful())
             {
-                auto const &[result, code] = meshes::processMesh(file, mConfig);
-                if(EResult::Success != code)
-                {
-                    CLog::Error(logTag(), "Failed to process mesh file w/ name {}", file.string());
-                    continue;
-                }
+                CLog::Warning(logTag(), "Failed to read the build database. Processing all files.");
             }
-            else if(".texture" == extension)
-            {
-                auto const &[result, code] = texture::processTexture(file, mConfig);
-                if(EResult::Success != code)
-                {
-                    CLog::Error(logTag(), "Failed to process texture file w/ name {}", file.string());
-                    continue;
-                }
-            }
-            else
+        }
+        mBuildDatabase.retain(mConfig.filesToProcess);
+        mOptionsHash    = CBuildDatabase::optionsHash(mConfig);
+        mProcessedCount = 0;
+
+        if(mConfig.options.check(EOptions::MultiThreaded))
+        {
+            processFilesParallel();
+        }
+        else
+        {
+            for(auto const &file : mConfig.filesToProcess)
             {
-                continue; // ...
+                processFile(file);
             }
         }
 
+        // The database is written, even if the index fails, so that the processed files aren't processed again.
+        CEngineResult<> const saveResult = mBuildDatabase.save(buildDatabasePath);
+        if(not saveResult.successful())
+        {
+            CLog::Warning(logTag(), "Failed to write the build database. All files will be processed on the next run.");
+        }
+
+        bool const indexExists = std::filesystem::exists(mConfig.outputPath / "game.assetindex")
+                                 && (not mConfig.options.check(EOptions::EmitAssetPack) || std::filesystem::exists(mConfig.outputPath / "game.assetpack"));
+        if(0 == mProcessedCount.load() && indexExists)
+        {
+            CLog::Status(logTag(), "All {} files are up to date.", mConfig.filesToProcess.size());
+            return EResult::Success;
+        }
+
         // Regenerate asset index...
         std::vector<asset::SAsset> processedAssets {};
         auto const processedFilesIterator = std::filesystem::recursive_directory_iterator(mConfig.outputPath);
@@ -388,28 +435,13 @@ public_methods:
                 a.id      = asset::assetIdFromUri(a.uri);
                 processedAssets.push_back(a);
             }
-            else if(".attributes" == extension)
-            {
-                a.type    = asset::EAssetType::Mesh;
-                a.subtype = asset::EAssetSubtype::AttributeBuffer;
-                a.uri     = std::filesystem::relative(filePath, (std::filesystem::current_path() / mConfig.outputPath));
-                a.id      = asset::assetIdFromUri(a.uri);
-                processedAssets.push_back(a);
-            }
-            else if(".indices" == extension)
-            {
-                a.type    = asset::EAssetType::Mesh;
-                a.subtype = asset::EAssetSubtype::AttributeBuffer;
-                a.uri     = std::filesystem::relative(filePath, (std::filesystem::current_path() / mConfig.outputPath));
-                a.id      = asset::assetIdFromUri(a.uri);
-                processedAssets.push_back(a);
-            }
-            else if(".datafile" == extension)
+            else if(".meshdata" == extension)
             {
                 a.type    = asset::EAssetType::Mesh;
                 a.subtype = asset::EAssetSubtype::DataFile;
                 a.uri     = std::filesystem::relative(filePath, (std::filesystem::current_path() / mConfig.outputPath));
                 a.id      = asset::assetIdFromUri(a.uri);
+                a.codec   = readAssetDataCodec(filePath);
                 processedAssets.push_back(a);
             }
             else if(".texturedata" == extension)
@@ -418,6 +450,7 @@ public_methods:
                 a.subtype = asset::EAssetSubtype::DataFile;
                 a.uri     = std::filesystem::relative(filePath, (std::filesystem::current_path() / mConfig.outputPath));
                 a.id      = asset::assetIdFromUri(a.uri);
+                a.codec   = readAssetDataCodec(filePath);
                 processedAssets.push_back(a);
             }
         }
@@ -426,15 +459,41 @@ public_methods:
         ss << "<Index>\n";
         for(auto const &a : processedAssets)
         {
-            ss << CString::format("<Asset aid=\"{}\" parent_aid=\"0\" type=\"{}\" subtype=\"{}\" uri=\"{}\"></Asset>\n"
+            ss << CString::format("<Asset aid=\"{}\" parent_aid=\"0\" type=\"{}\" subtype=\"{}\" codec=\"{}\" uri=\"{}\"></Asset>\n"
                                   , a.id
                                   , convert_to_string<asset::EAssetType>(a.type)
                                   , convert_to_string<asset::EAssetSubtype>(a.subtype)
+                                  , convert_to_string<asset::EAssetCodec>(a.codec)
                                   , a.uri.string());
         }
         ss << "</Index>";
         writeFile(mConfig.outputPath / "game.assetindex.xml", ss.str());
 
+        // The engine loads the binary index. The XML index is kept for inspection and tooling.
+        CEngineResult<> const indexResult = asset::CAssetIndex::writeBinaryIndex(mConfig.outputPath / "game.assetindex", processedAssets);
+        if(not indexResult.successful())
+        {
+            CLog::Error(logTag(), "Failed to write binary asset index.");
+            return EResult::WriteFailed;
+        }
+
+        if(mConfig.options.check(EOptions::EmitAssetPack))
+        {
+            std::vector<asset::SAssetPackSource> packSources {};
+            packSources.reserve(processedAssets.size());
+            for(auto const &a : processedAssets)
+            {
+                packSources.push_back({ a.id, mConfig.outputPath / a.uri, a.codec });
+            }
+
+            CEngineResult<> const packResult = asset::writeAssetPack(mConfig.outputPath / "game.assetpack", packSources);
+            if(not packResult.successful())
+            {
+                CLog::Error(logTag(), "Failed to write asset pack.");
+                return EResult::WriteFailed;
+            }
+        }
+
         return EResult::Success;
     }
 
@@ -445,6 +504,159 @@ public_methods:
 
 private_methods:
 
+    /**
+     * Process a single input file depending on its extension.
+     * Files unchanged since their last successful processing are skipped, see CBuildDatabase.
+     * Failures are logged and don't affect other files.
+     *
+     * @param aFile The file to process.
+     * @return      EResult::Success, if successful or skipped. The error of the respective processor otherwise.
+     */
+    EResult processFile(std::filesystem::path const &aFile)
+    {
+        // Material instances aren't processed yet.
+        std::vector<std::filesystem::path> const processedExtensions = { ".material", ".gltf", ".texture" };
+        if(processedExtensions.end() == std::find(processedExtensions.begin(), processedExtensions.end(), aFile.extension()))
+        {
+            return EResult::Success;
+        }
+
+        if(mBuildDatabase.isUpToDate(aFile, mOptionsHash))
+        {
+            CLog::Debug(logTag(), "Skipping unchanged file w/ name {}", aFile.string());
+            return EResult::Success;
+        }
+
+        ++mProcessedCount;
+
+        // Forgotten first, so that a failure or crash leaves the file to be processed again.
+        mBuildDatabase.forget(aFile);
+
+        SBuildArtifacts artifacts {};
+
+        std::filesystem::path const extension = aFile.extension();
+        if(".material" == extension)
+        {
+            auto const &[result, code] = materials::processMaterial(aFile, mConfig, artifacts);
+            if(EResult::Success != code)
+            {
+                CLog::Error(logTag(), "Failed to process material file w/ name {}", aFile.string());
+                return code;
+            }
+        }
+        else if(".materialinstance" == extension)
+        {
+            // auto const &[result, code] = processMaterialInstance(file);
+            // if(EResult::Success != code)
+            // {
+            //     CLog::Error(logTag(), "Failed to process material instance w/ name {}", file.string());
+            //     continue;
+            // }
+        }
+        else if(".gltf" == extension)
+        {
+            auto const &[result, code] = meshes::processMesh(aFile, mConfig, artifacts);
+            if(EResult::Success != code)
+            {
+                CLog::Error(logTag(), "Failed to process mesh file w/ name {}", aFile.string());
+                return code;
+            }
+        }
+        else if(".texture" == extension)
+        {
+            auto const &[result, code] = texture::processTexture(aFile, mConfig, artifacts);
+            if(EResult::Success != code)
+            {
+                CLog::Error(logTag(), "Failed to process texture file w/ name {}", aFile.string());
+                return code;
+            }
+        }
+
+        mBuildDatabase.record(aFile, mOptionsHash, artifacts);
+
+        return EResult::Success;
+    }
+
+    /**
+     * Process all input files on a job system with mConfig.jobCount workers.
+     *
+     * The log output of each file is captured and printed as a whole in input order,
+     * as soon as the file and all files before it are done, so that the output of
+     * concurrent files doesn't interleave.
+     */
+    void processFilesParallel()
+    {
+        struct SFileResult
+        {
+            EResult     code;
+            std::string output;
+        };
+
+        threading::CJobSystem jobSystem {};
+        if(not jobSystem.initialize(mConfig.jobCount) || not jobSystem.run())
+        {
+            CLog::Error(logTag(), "Failed to start the job system. Processing files one after another.");
+            for(auto const &file : mConfig.filesToProcess)
+            {
+                processFile(file);
+            }
+            return;
+        }
+
+        CLog::Status(logTag(), "Processing {} files on {} workers.", mConfig.filesToProcess.size(), jobSystem.workerCount());
+
+        auto const processCaptured = [this] (std::filesystem::path const &aFile) -> SFileResult
+        {
+            std::stringstream   output   {};
+            std::ostream *const previous = CLog::captureThreadOutput(&output);
+
+            EResult code = EResult::Success;
+            try
+            {
+                code = processFile(aFile);
+            }
+            catch(std::exception const &e)
+            {
+                CLog::Error(logTag(), "Failed to process file w/ name {}. Error: {}", aFile.string(), e.what());
+                code = EResult::InputInvalid;
+            }
+
+            CLog::captureThreadOutput(previous);
+            return { code, output.str() };
+        };
+
+        std::vector<threading::CJobHandle<SFileResult>> handles {};
+        handles.reserve(mConfig.filesToProcess.size());
+
+        for(auto const &file : mConfig.filesToProcess)
+        {
+            handles.push_back(jobSystem.post<SFileResult>([processCaptured, file] () -> SFileResult
+            {
+                return processCaptured(file);
+            }));
+        }
+
+        uint32_t failedCount = 0;
+        for(std::size_t k=0; k<handles.size(); ++k)
+        {
+            // Files, which couldn't be posted, are processed right here.
+            SFileResult const result = (handles[k].valid() ? handles[k].get() : processCaptured(mConfig.filesToProcess[k]));
+            std::cout << result.output << std::flush;
+
+            if(EResult::Success != result.code)
+            {
+                ++failedCount;
+            }
+        }
+
+        jobSystem.abortAndJoin();
+        jobSystem.deinitialize();
+
+        if(0 < failedCount)
+        {
+            CLog::Error(logTag(), "Failed to process {} of {} files.", failedCount, mConfig.filesToProcess.size());
+        }
+    }
 
     /**
      * @brief ReadInputPaths
@@ -469,7 +681,10 @@ private_methods:
 
 private_members:
 
-    SConfiguration mConfig;
+    SConfiguration        mConfig;
+    CBuildDatabase        mBuildDatabase;
+    uint64_t              mOptionsHash;
+    std::atomic<uint32_t> mProcessedCount;
 };
 
 #if defined SHIRABE_PLATFORM_WINDOWS
@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <unordered_set>
+
+#include <nlohmann/json.hpp>
+
+#include "common/builddatabase.h"
+
+namespace resource_compiler
+{
+    using namespace engine;
+
+    namespace
+    {
+        constexpr uint64_t const kFnvOffsetBasis = 0xcbf29ce484222325ull;
+        constexpr uint64_t const kFnvPrime       = 0x100000001b3ull;
+
+        /**
+         * 64 bit FNV-1a over aSize bytes at aData, continuing from aHash.
+         */
+        uint64_t fnv1a(uint64_t aHash, void const *aData, std::size_t aSize)
+        {
+            uint8_t const *bytes = static_cast<uint8_t const *>(aData);
+            for(std::size_t k=0; k<aSize; ++k)
+            {
+                aHash ^= bytes[k];
+                aHash *= kFnvPrime;
+            }
+            return aHash;
+        }
+
+        uint64_t fnv1a(uint64_t aHash, std::string const &aString)
+        {
+            // The terminator separates consecutive strings.
+            return fnv1a(aHash, aString.c_str(), (aString.size() + 1));
+        }
+
+        /**
+         * Hash the content of aPath.
+         *
+         * @return The hash, if the file could be read.
+         */
+        CEngineResult<uint64_t> hashFile(std::filesystem::path const &aPath)
+        {
+            std::ifstream input(aPath, std::ios::in | std::ios::binary);
+            if(not input)
+            {
+                return { EEngineStatus::FileNotFound };
+            }
+
+            std::vector<char> chunk(1u << 20u);
+
+            uint64_t hash = kFnvOffsetBasis;
+            while(input)
+            {
+                input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                hash = fnv1a(hash, chunk.data(), static_cast<std::size_t>(input.gcount()));
+            }
+
+            if(input.bad())
+            {
+                return { EEngineStatus::Error };
+            }
+            return { EEngineStatus::Ok, hash };
+        }
+    }
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    CEngineResult<> CBuildDatabase::load(std::filesystem::path const &aFilename)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mRecords.clear();
+
+        std::ifstream input(aFilename, std::ios::in);
+        if(not input)
+        {
+            return { EEngineStatus::Ok };
+        }
+
+        auto const readState = [] (nlohmann::json const &aJson) -> SFileState
+        {
+            SFileState state {};
+            state.path             = aJson.at("path").get<std::string>();
+            state.size             = aJson.at("size").get<uint64_t>();
+            state.modificationTime = aJson.at("mtime").get<int64_t>();
+            state.hash             = aJson.at("hash").get<uint64_t>();
+            return state;
+        };
+
+        try
+        {
+            nlohmann::json json {};
+            input >> json;
+
+            if(kResourceCompilerVersion != json.at("version").get<uint32_t>())
+            {
+                CLog::Status(logTag(), "Build database of a different version. Rebuilding everything.");
+                return { EEngineStatus::Ok };
+            }
+
+            for(nlohmann::json const &entry : json.at("records"))
+            {
+                SRecord record {};
+                record.optionsHash = entry.at("options").get<uint64_t>();
+                record.input       = readState(entry.at("input"));
+
+                for(nlohmann::json const &dependency : entry.at("dependencies"))
+                {
+                    record.dependencies.push_back(readState(dependency));
+                }
+
+                for(nlohmann::json const &output : entry.at("outputs"))
+                {
+                    record.outputs.push_back(output.get<std::string>());
+                }
+
+                mRecords[record.input.path.string()] = std::move(record);
+            }
+        }
+        catch(std::exception const &e)
+        {
+            CLog::Error(logTag(), "Invalid build database '{}'. Error: {}", aFilename.string(), e.what());
+            mRecords.clear();
+            return { EEngineStatus::Error };
+        }
+
+        return { EEngineStatus::Ok };
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    CEngineResult<> CBuildDatabase::save(std::filesystem::path const &aFilename) const
+    {
+        auto const writeState = [] (SFileState const &aState) -> nlohmann::json
+        {
+            return { { "path",  aState.path.string()    }
+                   , { "size",  aState.size             }
+                   , { "mtime", aState.modificationTime }
+                   , { "hash",  aState.hash             } };
+        };
+
+        nlohmann::json records = nlohmann::json::array();
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+            for(auto const &[input, record] : mRecords)
+            {
+                nlohmann::json dependencies = nlohmann::json::array();
+                for(SFileState const &dependency : record.dependencies)
+                {
+                    dependencies.push_back(writeState(dependency));
+                }
+
+                nlohmann::json outputs = nlohmann::json::array();
+                for(std::filesystem::path const &output : record.outputs)
+                {
+                    outputs.push_back(output.string());
+                }
+
+                records.push_back({ { "options",      record.optionsHash        }
+                                  , { "input",        writeState(record.input)  }
+                                  , { "dependencies", std::move(dependencies)   }
+                                  , { "outputs",      std::move(outputs)        } });
+            }
+        }
+
+        nlohmann::json const json = { { "version", kResourceCompilerVersion }
+                                    , { "records", std::move(records)       } };
+
+        std::ofstream output(aFilename, std::ios::out | std::ios::trunc);
+        output << json.dump(1);
+        if(not output)
+        {
+            CLog::Error(logTag(), "Failed to write build database '{}'.", aFilename.string());
+            return { EEngineStatus::Error };
+        }
+
+        return { EEngineStatus::Ok };
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    bool CBuildDatabase::isUpToDate(std::filesystem::path const &aInput, uint64_t aOptionsHash) const
+    {
+        SRecord record {};
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            auto const iterator = mRecords.find(aInput.string());
+            if(mRecords.end() == iterator)
+            {
+                return false;
+            }
+            record = iterator->second;
+        }
+
+        if(aOptionsHash != record.optionsHash)
+        {
+            return false;
+        }
+
+        auto const exists = [] (std::filesystem::path const &aPath) -> bool
+        {
+            std::error_code error {};
+            return std::filesystem::exists(aPath, error);
+        };
+
+        // Cheapest checks first.
+        return std::all_of(record.outputs.begin(), record.outputs.end(), exists)
+               && isUnchanged(record.input)
+               && std::all_of(record.dependencies.begin(), record.dependencies.end(), &CBuildDatabase::isUnchanged);
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    void CBuildDatabase::record(std::filesystem::path const &aInput, uint64_t aOptionsHash, SBuildArtifacts const &aArtifacts)
+    {
+        CEngineResult<SFileState> const input = captureFileState(aInput);
+        if(not input.successful())
+        {
+            forget(aInput);
+            return;
+        }
+
+        SRecord record {};
+        record.optionsHash = aOptionsHash;
+        record.input       = input.data();
+        record.outputs     = aArtifacts.outputs;
+
+        std::unordered_set<std::string> captured {};
+        for(std::filesystem::path const &dependency : aArtifacts.dependencies)
+        {
+            std::filesystem::path const path = dependency.lexically_normal();
+            if(not captured.insert(path.string()).second)
+            {
+                continue;
+            }
+
+            CEngineResult<SFileState> const state = captureFileState(path);
+            if(not state.successful())
+            {
+                // A dependency, which can't be read, can't be checked either.
+                CLog::Warning(logTag(), "Dependency '{}' of '{}' is not readable. '{}' will be rebuilt next time.", path.string(), aInput.string(), aInput.string());
+                forget(aInput);
+                return;
+            }
+            record.dependencies.push_back(state.data());
+        }
+
+        std::lock_guard<std::mutex> guard(mMutex);
+        mRecords[aInput.string()] = std::move(record);
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    void CBuildDatabase::forget(std::filesystem::path const &aInput)
+    {
+        std::lock_guard<std::mutex> guard(mMutex);
+        mRecords.erase(aInput.string());
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    void CBuildDatabase::retain(std::vector<std::filesystem::path> const &aInputs)
+    {
+        std::unordered_set<std::string> inputs {};
+        for(std::filesystem::path const &input : aInputs)
+        {
+            inputs.insert(input.string());
+        }
+
+        std::lock_guard<std::mutex> guard(mMutex);
+        for(auto iterator = mRecords.begin(); mRecords.end() != iterator; )
+        {
+            if(inputs.end() == inputs.find(iterator->first))
+            {
+                iterator = mRecords.erase(iterator);
+            }
+            else
+            {
+                ++iterator;
+            }
+        }
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    uint64_t CBuildDatabase::optionsHash(SConfiguration const &aConfig)
+    {
+        // Options, which only affect the console output or the scheduling, don't affect the outputs.
+        std::array<EOptions, 6> const relevantOptions = { EOptions::DebugMode
+                                                        , EOptions::OptimizationEnabled
+                                                        , EOptions::DumpConfig
+                                                        , EOptions::DumpReflection
+                                                        , EOptions::DumpBareVersion
+                                                        , EOptions::DumpMeshCleartext };
+
+        uint64_t hash = kFnvOffsetBasis;
+        hash = fnv1a(hash, &kResourceCompilerVersion, sizeof(kResourceCompilerVersion));
+
+        for(EOptions const &option : relevantOptions)
+        {
+            uint8_t const set = (aConfig.options.check(option) ? 1 : 0);
+            hash = fnv1a(hash, &set, sizeof(set));
+        }
+
+        uint32_t const codec = static_cast<uint32_t>(aConfig.compressionCodec);
+        hash = fnv1a(hash, &codec, sizeof(codec));
+        hash = fnv1a(hash, &aConfig.meshLodCount, sizeof(aConfig.meshLodCount));
+        uint32_t const meshLayout = static_cast<uint32_t>(aConfig.meshVertexLayout);
+        hash = fnv1a(hash, &meshLayout, sizeof(meshLayout));
+
+        hash = fnv1a(hash, aConfig.inputPath .string());
+        hash = fnv1a(hash, aConfig.outputPath.string());
+        for(std::filesystem::path const &includePath : aConfig.includePaths)
+        {
+            hash = fnv1a(hash, includePath.string());
+        }
+
+        return hash;
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    CEngineResult<CBuildDatabase::SFileState> CBuildDatabase::captureFileState(std::filesystem::path const &aPath)
+    {
+        std::error_code sizeError {};
+        std::error_code timeError {};
+
+        SFileState state {};
+        state.path             = aPath;
+        state.size             = std::filesystem::file_size(aPath, sizeError);
+        state.modificationTime = static_cast<int64_t>(std::filesystem::last_write_time(aPath, timeError).time_since_epoch().count());
+        if(sizeError || timeError)
+        {
+            return { EEngineStatus::FileNotFound };
+        }
+
+        CEngineResult<uint64_t> const hash = hashFile(aPath);
+        if(not hash.successful())
+        {
+            return { hash.result() };
+        }
+        state.hash = hash.data();
+
+        return { EEngineStatus::Ok, state };
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    bool CBuildDatabase::isUnchanged(SFileState const &aState)
+    {
+        std::error_code sizeError {};
+        std::error_code timeError {};
+
+        uint64_t const size             = std::filesystem::file_size(aState.path, sizeError);
+        int64_t  const modificationTime = static_cast<int64_t>(std::filesystem::last_write_time(aState.path, timeError).time_since_epoch().count());
+        if(sizeError || timeError)
+        {
+            return false;
+        }
+
+        if(size == aState.size && modificationTime == aState.modificationTime)
+        {
+            return true;
+        }
+
+        // Touched, but maybe not modified.
+        CEngineResult<uint64_t> const hash = hashFile(aState.path);
+        return (hash.successful() && size == aState.size && hash.data() == aState.hash);
+    }
+    //<-----------------------------------------------------------------------------
+}
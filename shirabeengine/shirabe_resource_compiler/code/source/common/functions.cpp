@@ -1,9 +1,12 @@
 //
 // Created by dotti on 10.12.19.
 //
+#include <fstream>
 #include "common/functions.h"
 #include "common/definition.h"
 #include <log/log.h>
+#include <core/helpers.h>
+#include <asset/assetcompression.h>
 
 namespace resource_compiler
 {
@@ -36,4 +39,36 @@ namespace resource_compiler
             }
         }
     };
+
+    auto writeAssetData(std::filesystem::path const &aPath, std::vector<uint8_t> const &aData, SConfiguration const &aConfig) -> engine::CEngineResult<>
+    {
+        using namespace engine::asset;
+
+        if(EAssetCodec::None == aConfig.compressionCodec)
+        {
+            return engine::writeFile(aPath.string(), aData);
+        }
+
+        auto const [result, compressed] = compressAssetBlocks(aData.data(), aData.size(), aConfig.compressionCodec);
+        if(engine::CheckEngineError(result))
+        {
+            CLog::Error(logTag(), "Failed to compress '{}'.", aPath.string());
+            return { result };
+        }
+
+        return engine::writeFile(aPath.string(), compressed);
+    }
+
+    auto readAssetDataCodec(std::filesystem::path const &aPath) -> engine::asset::EAssetCodec
+    {
+        using namespace engine::asset;
+
+        std::ifstream input(aPath, std::ios::in | std::ios::binary);
+
+        SAssetBlockHeader header {};
+        input.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+        uint64_t const count = static_cast<uint64_t>(input.gcount());
+        return assetBlockCodec(reinterpret_cast<uint8_t const *>(&header), count);
+    }
 }
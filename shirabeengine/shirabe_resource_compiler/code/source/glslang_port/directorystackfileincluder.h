@@ -58,6 +58,7 @@ class CDirectoryStackFileIncluder
 public_constructors:
     CDirectoryStackFileIncluder()
         : mExternalLocalDirectoryCount(0)
+        , mResolvedIncludes()
     { }
 
 public_destructors:
@@ -113,6 +114,16 @@ public_methods:
         mExternalLocalDirectoryCount = mDirectoryStack.size();
     }
 
+    /**
+     * Return the paths of all files included so far, each once, in the order of their first inclusion.
+     *
+     * @return See brief.
+     */
+    std::vector<std::string> const &resolvedIncludes() const
+    {
+        return mResolvedIncludes;
+    }
+
     /**
      * @brief releaseInclude
      * @param result
@@ -167,6 +178,11 @@ protected_methods:
                 std::string directory = getDirectory(path);
                 mDirectoryStack.push_back(directory);
 
+                if(mResolvedIncludes.end() == std::find(mResolvedIncludes.begin(), mResolvedIncludes.end(), path))
+                {
+                    mResolvedIncludes.push_back(path);
+                }
+
                 IncludeResult *result = newIncludeResult(path, file, file.tellg());
                 return result;
             }
@@ -229,6 +245,7 @@ protected_methods:
 private_members:
     std::vector<std::string> mDirectoryStack;
     size_t                   mExternalLocalDirectoryCount;
+    std::vector<std::string> mResolvedIncludes;
 };
 
 #endif
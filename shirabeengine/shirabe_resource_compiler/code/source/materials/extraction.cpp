@@ -142,7 +142,7 @@ namespace materials
             // {
                 //
                 // We don't have to check the members itself, since duplicate names inside a
-                // single GLSL file are caught by the glslangValidator and cross-stage duplicate
+                // single GLSL file are caught by glslang and cross-stage duplicate
                 // names are no problem.
                 //
 
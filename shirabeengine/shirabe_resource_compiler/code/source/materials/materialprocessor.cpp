@@ -6,6 +6,17 @@
 #include "common/config.h"
 #include "common/functions.h"
 
+#include "glslang_port/directorystackfileincluder.h"
+#include "glslang_port/resourcelimits.h"
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <optional>
+
+#include <glslang/Public/ShaderLang.h>
+#include <SPIRV/GlslangToSpv.h>
+
 #include <core/helpers.h>
 #include <util/documents/json.h>
 #include <material/declaration.h>
@@ -268,75 +279,196 @@ namespace materials
     }
 
     /**
-     * Format a valid glslangValidator command line and invoke the command to create a .spv module reading its stdout/stderr output.
+     * Initializes glslang once per process and finalizes it on exit.
+     */
+    class CGlslangProcess
+    {
+    public_constructors:
+        CGlslangProcess()
+        {
+            glslang::InitializeProcess();
+        }
+
+    public_destructors:
+        ~CGlslangProcess()
+        {
+            glslang::FinalizeProcess();
+        }
+
+    public_static_functions:
+        static void ensureInitialized()
+        {
+            static CGlslangProcess const sProcess {};
+        }
+    };
+
+    /**
+     * Result of compiling a single stage. The messages are logged by the caller, so that they end
+     * up in the output captured for the material instead of the output of a worker thread.
+     */
+    struct SGlslangStageResult
+    {
+        bool                               successful;
+        std::string                        messages;
+        std::vector<std::filesystem::path> includes; // As resolved by the includer.
+    };
+
+    /**
+     * Map a pipeline stage to the glslang stage compiling it.
      *
-     * @param aUnit Source data information for the glslangValidator command.
-     * @return      EResult::Success           if successful.
-     * @return      EResult::CompilationFailed on error.
+     * @param aStage The pipeline stage.
+     * @return       The glslang stage, if aStage is a shader stage.
      */
-    static CResult<EResult> runGlslang(SConfiguration const &aConfiguration, SShaderCompilationUnit &aUnit, bool const aCompileStagesIndividually = false)
+    static std::optional<EShLanguage> glslangStage(VkPipelineStageFlagBits const aStage)
     {
-        std::string const application = CString::format("{}/tools/glslang/bin/glslangValidator", std::filesystem::current_path().string());
-        std::string       options     = "-v -d -g -Od -V --target-env vulkan1.1";
+        switch(aStage)
+        {
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_VERTEX_SHADER_BIT:                  return EShLangVertex;
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TESSELLATION_CONTROL_SHADER_BIT:    return EShLangTessControl;
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TESSELLATION_EVALUATION_SHADER_BIT: return EShLangTessEvaluation;
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_GEOMETRY_SHADER_BIT:                return EShLangGeometry;
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT:                return EShLangFragment;
+            case VkPipelineStageFlagBits::VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT:                 return EShLangCompute;
+            default:                                                                            return std::nullopt;
+        }
+    }
 
-        auto const appendIncludes = [&options] (std::string const &aInclude) -> void
+    /**
+     * Compile a single GLSL stage to a .spv module with the linked glslang library.
+     * Equivalent to "glslangValidator -d -g -Od -V --target-env vulkan1.1 -I<include paths>".
+     *
+     * @param aConfiguration The configuration providing the include paths.
+     * @param aElement       The stage to compile. The module is written to its absolute output path.
+     * @return               See SGlslangStageResult.
+     */
+    static SGlslangStageResult compileGlslangStage(SConfiguration const &aConfiguration, SShaderCompilationElement const &aElement)
+    {
+        std::optional<EShLanguage> const stage = glslangStage(aElement.stage);
+        if(not stage.has_value())
         {
-            options.append(" -I" + aInclude);
-        };
-        std::for_each(aConfiguration.includePaths.begin(), aConfiguration.includePaths.end(), appendIncludes);
+            return { false, CString::format("{}: Unsupported shader stage.", aElement.fileName) };
+        }
 
-        std::underlying_type_t<EResult> result = 0;
+        CGlslangProcess::ensureInitialized();
 
-        auto const once = [&] (std::string const &aInputFilenames, std::string const &aOutputFilename) -> void
+        // Defaults for shaders without #version and the default desktop profile, like -d.
+        int32_t     const defaultVersion = 110;
+        EShMessages const messages       = static_cast<EShMessages>(EShMsgSpvRules | EShMsgVulkanRules | EShMsgDebugInfo);
+
+        char    const *source = aElement.contents.c_str();
+        int32_t const  length = static_cast<int32_t>(aElement.contents.size());
+        char    const *name   = aElement.fileName.c_str();
+
+        glslang::TShader shader(stage.value());
+        shader.setStringsWithLengthsAndNames(&source, &length, &name, 1);
+        shader.setEnvInput (glslang::EShSourceGlsl,  stage.value(), glslang::EShClientVulkan, 100);
+        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_1);
+        shader.setEnvTarget(glslang::EShTargetSpv,    glslang::EShTargetSpv_1_3);
+
+        // The includer tracks the directories of the includes currently being parsed,
+        // so it is bound to a single parse. The resource limits are shared by all stages.
+        CDirectoryStackFileIncluder includer {};
+        for(std::filesystem::path const &includePath : aConfiguration.includePaths)
         {
-            std::string                const command       = CString::format("{} {} -o {} {}", application, options, aOutputFilename, aInputFilenames);
-            CEngineResult<std::string> const commandResult = executeCmd(command);
+            includer.pushExternalLocalDirectory(includePath.string());
+        }
 
-            bool const compilationError = (std::string::npos != commandResult.data().find("compilation error")
-                                           or std::string::npos != commandResult.data().find("not found"));
-            if(compilationError || not commandResult.successful())
-            {
-                CLog::Error(logTag(), commandResult.data());
-                result |= EnumValueOf(EResult::CompilationFailed);
-            }
-            else
-            {
-                CLog::Debug(logTag(), commandResult.data());
-                result |= EnumValueOf(EResult::Success);
-            }
+        std::string log {};
 
-            CLog::Debug(logTag(), command);
-        };
+        bool const parsed = shader.parse(&glslang_wrapper::DefaultBuiltInResource(), defaultVersion, false, messages, includer);
+        log.append(shader.getInfoLog());
+        log.append(shader.getInfoDebugLog());
+        if(not parsed)
+        {
+            return { false, CString::format("{}: Compilation failed.\n{}", aElement.fileName, log) };
+        }
 
-        if(aCompileStagesIndividually)
+        std::vector<std::filesystem::path> includes {};
+        for(std::string const &include : includer.resolvedIncludes())
         {
-            auto const compile = [&] (SShaderCompilationElement const &aElement) -> void
-            {
-                std::string const outputFile = aElement.outputPathAbsolute;
-                std::string const inputFile  = aElement.fileName;
+            includes.push_back(std::filesystem::path(include).lexically_normal());
+        }
 
-                once(inputFile, outputFile);
+        glslang::TProgram program {};
+        program.addShader(&shader);
 
-                aUnit.outputFiles.push_back(outputFile);
-            };
-            std::for_each(aUnit.elements.begin(), aUnit.elements.end(), compile);
+        bool const linked = program.link(messages);
+        log.append(program.getInfoLog());
+        log.append(program.getInfoDebugLog());
+        if(not linked)
+        {
+            return { false, CString::format("{}: Linking failed.\n{}", aElement.fileName, log), includes };
         }
-        else
+
+        glslang::SpvOptions spvOptions {};
+        spvOptions.generateDebugInfo = true; // -g
+        spvOptions.disableOptimizer  = true; // -Od
+
+        std::vector<uint32_t> spirv  {};
+        spv::SpvBuildLogger   logger {};
+        glslang::GlslangToSpv(*program.getIntermediate(stage.value()), spirv, &logger, &spvOptions);
+        log.append(logger.getAllMessages());
+
+        std::ofstream output(aElement.outputPathAbsolute, std::ios::out | std::ios::binary | std::ios::trunc);
+        output.write(reinterpret_cast<char const *>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+        if(not output)
+        {
+            return { false, CString::format("{}: Failed to write {}.\n{}", aElement.fileName, aElement.outputPathAbsolute, log), includes };
+        }
+
+        return { true, log, includes };
+    }
+
+    /**
+     * Compile all stages of aUnit to .spv modules in-process. The stages are compiled in parallel,
+     * unless the files are processed in parallel already (-j).
+     *
+     * @param aConfiguration The configuration providing the include paths and options.
+     * @param aUnit          The stages to compile. Receives the written modules as output files.
+     * @param aOutIncludes   Receives the files included by any stage, each once.
+     * @return               EResult::Success           if successful.
+     * @return               EResult::CompilationFailed on error.
+     */
+    static CResult<EResult> runGlslang(SConfiguration const &aConfiguration, SShaderCompilationUnit &aUnit, std::vector<std::filesystem::path> &aOutIncludes)
+    {
+        // With -j, every worker of the job system compiles a file. A thread per stage on top would
+        // oversubscribe the cores, so the stages are deferred and compiled in sequence on get().
+        std::launch const policy = (aConfiguration.options.check(EOptions::MultiThreaded) ? std::launch::deferred : std::launch::async);
+
+        std::vector<std::future<SGlslangStageResult>> stages {};
+        for(SShaderCompilationElement const &element : aUnit.elements)
+        {
+            stages.push_back(std::async(policy, &compileGlslangStage, std::cref(aConfiguration), std::cref(element)));
+        }
+
+        EResult result = EResult::Success;
+
+        for(std::size_t k=0; k<stages.size(); ++k)
         {
-            std::string const outputFiles = aUnit.elements.at(0).outputPathAbsolute;
-            std::string       inputFiles  = "";
+            SGlslangStageResult const stageResult = stages[k].get();
+            for(std::filesystem::path const &include : stageResult.includes)
+            {
+                if(aOutIncludes.end() == std::find(aOutIncludes.begin(), aOutIncludes.end(), include))
+                {
+                    aOutIncludes.push_back(include);
+                }
+            }
 
-            auto const append = [&inputFiles] (SShaderCompilationElement const &aElement)
+            if(not stageResult.successful)
             {
-                inputFiles.append(" " + aElement.fileName);
-            };
-            std::for_each(aUnit.elements.begin(), aUnit.elements.end(), append);
+                CLog::Error(logTag(), stageResult.messages);
+                result = EResult::CompilationFailed;
+                continue;
+            }
 
-            once(inputFiles, outputFiles);
-            aUnit.outputFiles.push_back(aUnit.elements.at(0).outputPathAbsolute);
+            if(not stageResult.messages.empty())
+            {
+                CLog::Debug(logTag(), stageResult.messages);
+            }
+            aUnit.outputFiles.push_back(aUnit.elements[k].outputPathAbsolute);
         }
 
-        return static_cast<EResult>(result);
+        return result;
     }
 
     /**
@@ -531,7 +663,7 @@ namespace materials
         return EResult::Success;
     }
 
-    CResult<EResult> processMaterial(std::filesystem::path const &aMaterialFile, SConfiguration const &aConfig)
+    CResult<EResult> processMaterial(std::filesystem::path const &aMaterialFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts)
     {
         std::filesystem::path const &materialPathAbs  = std::filesystem::current_path() / aMaterialFile;
         std::filesystem::path const &parentPath       = std::filesystem::relative(aMaterialFile, aConfig.inputPath).parent_path();
@@ -591,6 +723,8 @@ namespace materials
             }
         }
 
+        aOutArtifacts.dependencies.insert(aOutArtifacts.dependencies.end(), inputFiles.begin(), inputFiles.end());
+
         // Determine compilation items and config.
         auto [generationSuccessful, unit] = generateCompilationUnit(aConfig, inputFiles, outputModulePathAbsolute, metaData);
         if(not generationSuccessful)
@@ -599,7 +733,11 @@ namespace materials
             return EResult::InputInvalid;
         }
 
-        CResult<EResult> const glslangResult = runGlslang(aConfig, unit, true);
+        // The includes are dependencies of the material as well. Only glslang knows which files it included.
+        std::vector<std::filesystem::path> includes {};
+
+        CResult<EResult> const glslangResult = runGlslang(aConfig, unit, includes);
+        aOutArtifacts.dependencies.insert(aOutArtifacts.dependencies.end(), includes.begin(), includes.end());
         if(not glslangResult.successful())
         {
             CLog::Error(logTag(), "Failed to run glslang.");
@@ -624,6 +762,7 @@ namespace materials
         }
 
         writeFile(outputMetaPathAbsolute, serializedData);
+        aOutArtifacts.outputs.push_back(outputMetaPathAbsolute);
 
         CResult<EResult> const signatureSerializationResult = serializeMaterialSignature(extractionResult.data(), serializedData);
         if(not signatureSerializationResult.successful())
@@ -633,6 +772,8 @@ namespace materials
         }
 
         writeFile(outputSignaturePathAbsolute, serializedData);
+        aOutArtifacts.outputs.push_back(outputSignaturePathAbsolute);
+        aOutArtifacts.outputs.insert(aOutArtifacts.outputs.end(), unit.outputFiles.begin(), unit.outputFiles.end());
 
         //CMaterialConfig        config                    = CMaterialConfig::fromMaterialDesc(extractionResult.data(), );
         //CResult<EResult> const configSerializationResult = serializeMaterialConfig(config, serializedData);
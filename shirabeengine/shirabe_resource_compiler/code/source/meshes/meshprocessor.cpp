@@ -1,5 +1,11 @@
 #include "meshes/meshprocessor.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <map>
 #include <tuple>
 #include <fx/gltf.h>
 #include <core/databuffer.h>
@@ -9,8 +15,11 @@
 #include <util/documents/json.h>
 #include <util/crc32.h>
 #include <mesh/declaration.h>
+#include <mesh/meshcontainer.h>
+#include <mesh/meshoptimization.h>
 
 #include "common/functions.h"
+#include "meshes/meshquantizer.h"
 
 //
 // Created by dotti on 09.12.19.
@@ -22,6 +31,11 @@ namespace meshes
     using engine::CResult;
     using resource_compiler::EResult;
 
+    /**
+     * The maximum distance error of a single simplification step, relative to the diagonal of the mesh's bounds.
+     */
+    static constexpr float const kMeshLodMaximumRelativeError = 0.05f;
+
 
     /**
      * Accept a SMaterial instance and serialize it to a JSON string.
@@ -64,46 +78,6 @@ namespace meshes
         return EResult::Success;
     }
 
-    /**
-     * Accept a SMaterial instance and serialize it to a JSON string.
-     *
-     * @param aMaterial
-     * @param aOutSerializedData
-     * @return
-     */
-    static CResult<EResult> serializeMeshDataFile(mesh::SMeshDataFile const &aDataFile, std::string &aOutSerializedData)
-    {
-        using namespace resource_compiler::serialization;
-        using namespace engine::documents;
-
-        Unique<IJSONSerializer<mesh::SMeshDataFile>> serializer = makeUnique<CJSONSerializer<mesh::SMeshDataFile>>();
-        bool const initialized = serializer->initialize();
-        if(not initialized)
-        {
-            return EResult::SerializationFailed;
-        }
-        CResult<Shared<serialization::ISerializer<mesh::SMeshDataFile>::IResult>> const serialization = serializer->serialize(aDataFile);
-        if(not serialization.successful())
-        {
-            return EResult::SerializationFailed;
-        }
-
-        CResult<std::string> data = serialization.data()->asString();
-        aOutSerializedData = data.data();
-
-        bool const deinitialized = serializer->deinitialize();
-        if(not deinitialized)
-        {
-            return EResult::SerializationFailed;
-        }
-
-        serializer = nullptr;
-
-        CLog::Debug(logTag(), aOutSerializedData);
-
-        return EResult::Success;
-    }
-
     fx::gltf::Document const __loadFromData(ByteBuffer const &aInputBuffer)
     {
         try
@@ -200,7 +174,7 @@ namespace meshes
         return { accessor, bufferView, buffer, data, dataTypeSize, (accessor.count * dataTypeSize) };
     }
 
-    CResult<EResult> processMesh(std::filesystem::path const &aMeshFile, SConfiguration const &aConfig)
+    CResult<EResult> processMesh(std::filesystem::path const &aMeshFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts)
     {
         std::filesystem::path const &pathAbs    = std::filesystem::current_path() / aMeshFile;
         std::filesystem::path const &parentPath = std::filesystem::relative(aMeshFile, aConfig.inputPath).parent_path();
@@ -208,33 +182,34 @@ namespace meshes
 
         std::filesystem::path const outputPath                      = ( parentPath)                                                                  .lexically_normal();
         std::filesystem::path const outputMetaFilePath              = ( parentPath / (std::filesystem::path(meshID.string() + ".mesh.meta"))) .lexically_normal();
-        std::filesystem::path const outputDataFilePath              = ( parentPath / (std::filesystem::path(meshID.string() + ".datafile")))  .lexically_normal();
-        std::filesystem::path const outputAttributeBufferPath       = ( parentPath / (std::filesystem::path(meshID.string() + ".attributes"))).lexically_normal();
-        std::filesystem::path const outputIndexBufferPath           = ( parentPath / (std::filesystem::path(meshID.string() + ".indices")))   .lexically_normal();
+        std::filesystem::path const outputDataFilePath              = ( parentPath / (std::filesystem::path(meshID.string() + ".meshdata")))  .lexically_normal();
         std::filesystem::path const outputPathAbsolute              = (std::filesystem::current_path() / aConfig.outputPath / outputPath               ).lexically_normal();
         std::filesystem::path const outputMetaFilePathAbs           = (std::filesystem::current_path() / aConfig.outputPath / outputMetaFilePath       ).lexically_normal();
         std::filesystem::path const outputDataFilePathAbs           = (std::filesystem::current_path() / aConfig.outputPath / outputDataFilePath       ).lexically_normal();
-        std::filesystem::path const outputAttributeBufferPathAbs    = (std::filesystem::current_path() / aConfig.outputPath / outputAttributeBufferPath).lexically_normal();
-        std::filesystem::path const outputIndexBufferPathAbs        = (std::filesystem::current_path() / aConfig.outputPath / outputIndexBufferPath    ).lexically_normal();
 
         resource_compiler::checkPathExists(outputPathAbsolute);
 
         fx::gltf::Document document = fx::gltf::LoadFromText(aMeshFile);
+        for(auto const &buffer : document.buffers)
+        {
+            if(not buffer.uri.empty() && not buffer.IsEmbeddedResource())
+            {
+                aOutArtifacts.dependencies.push_back(aMeshFile.parent_path() / buffer.uri);
+            }
+        }
 
         std::vector<uint8_t> positions;
         std::vector<uint8_t> normals;
         std::vector<uint8_t> tangents;
         std::vector<uint8_t> uvcoordinates;
-        std::vector<uint8_t> indices;
-
-        std::vector<uint8_t> attributeBuffer;
-        std::vector<uint8_t> indexBuffer;
+        std::vector<uint32_t> indices;
 
         struct BufferInfo
         {
             uint32_t count;
             uint64_t stride;
             uint64_t byteSize;
+            bool     nonFloat; // Any primitive stores the samples in another component type than float.
         } positionBufferInfo {}
         , normalBufferInfo   {}
         , tangentBufferInfo  {}
@@ -253,122 +228,343 @@ namespace meshes
             memcpy(aTargetBuffer.data() + previousSize, aSourceData, additionalSize);
         };
 
+        // Primitives are appended, so their counts accumulate. The container checks, that they match the data.
+        auto const track = [] (BufferInfo &aInfo, fx::gltf::Accessor const &aAccessor, uint64_t const aStride, uint64_t const aTotalSize)
+        {
+            aInfo.count    += aAccessor.count;
+            aInfo.stride    = aStride;
+            aInfo.byteSize += aTotalSize;
+            aInfo.nonFloat  = (aInfo.nonFloat || fx::gltf::Accessor::ComponentType::Float != aAccessor.componentType);
+        };
+
+        // glTF indices are relative to their primitive. Widened to 32 bit and rebased onto the
+        // appended vertices, so that all primitives form a single triangle list.
+        auto const appendIndices = [] (std::vector<uint32_t>       &aTargetBuffer
+                                     , fx::gltf::Accessor    const &aAccessor
+                                     , uint8_t               const *aSourceData
+                                     , uint32_t              const &aBaseVertex)
+        {
+            aTargetBuffer.reserve(aTargetBuffer.size() + aAccessor.count);
+            for(uint32_t k=0; k<aAccessor.count; ++k)
+            {
+                uint32_t index = 0;
+                switch(aAccessor.componentType)
+                {
+                    case fx::gltf::Accessor::ComponentType::UnsignedByte:  index = aSourceData[k];                                            break;
+                    case fx::gltf::Accessor::ComponentType::UnsignedShort: { uint16_t v = 0; memcpy(&v, aSourceData + (2 * k), 2); index = v; } break;
+                    default:                                               { memcpy(&index, aSourceData + (4 * k), 4); }                      break;
+                }
+                aTargetBuffer.push_back(aBaseVertex + index);
+            }
+        };
+
+        bool triangleListsOnly = true;
+
         for(auto const &mesh : document.meshes)
         {
             for(auto const &primitive : mesh.primitives)
             {
+                uint32_t const baseVertex = positionBufferInfo.count;
+                triangleListsOnly = triangleListsOnly && (fx::gltf::Primitive::Mode::Triangles == primitive.mode);
+
                 for(auto const &[attributeName, accessorIndex] : primitive.attributes)
                 {
                     auto const &[accessor, bufferView, buffer, data, stride, totalSize] = __getData(document, accessorIndex);
 
-                    if("POSITION"   == attributeName) { append(positions,     accessor, data, stride); positionBufferInfo = { .count = accessor.count, .stride = stride, .byteSize = totalSize}; }
-                    if("NORMAL"     == attributeName) { append(normals,       accessor, data, stride); normalBufferInfo   = { .count = accessor.count, .stride = stride, .byteSize = totalSize}; }
-                    if("TANGENT"    == attributeName) { append(tangents,      accessor, data, stride); tangentBufferInfo  = { .count = accessor.count, .stride = stride, .byteSize = totalSize}; }
-                    if("TEXCOORD_0" == attributeName) { append(uvcoordinates, accessor, data, stride); texcoordBufferInfo = { .count = accessor.count, .stride = stride, .byteSize = totalSize}; }
+                    if("POSITION"   == attributeName) { append(positions,     accessor, data, stride); track(positionBufferInfo, accessor, stride, totalSize); }
+                    if("NORMAL"     == attributeName) { append(normals,       accessor, data, stride); track(normalBufferInfo,   accessor, stride, totalSize); }
+                    if("TANGENT"    == attributeName) { append(tangents,      accessor, data, stride); track(tangentBufferInfo,  accessor, stride, totalSize); }
+                    if("TEXCOORD_0" == attributeName) { append(uvcoordinates, accessor, data, stride); track(texcoordBufferInfo, accessor, stride, totalSize); }
                 }
 
                 auto const &[accessor, bufferView, buffer, data, stride, totalSize] = __getData(document, primitive.indices);
-                append(indices, accessor, data, stride);
-                indexBufferInfo = { .count = accessor.count, .stride = stride, .byteSize = totalSize};
+                appendIndices(indices, accessor, data, baseVertex);
+                track(indexBufferInfo, accessor, stride, totalSize);
             }
         }
 
-        //
-        // For now, let's assume, that indices are in monotonuous increasing order across primitives...
-        //
-        attributeBuffer.insert(attributeBuffer.end(), positions    .begin(), positions    .end());
-        attributeBuffer.insert(attributeBuffer.end(), normals      .begin(), normals      .end());
-        attributeBuffer.insert(attributeBuffer.end(), tangents     .begin(), tangents     .end());
-        attributeBuffer.insert(attributeBuffer.end(), uvcoordinates.begin(), uvcoordinates.end());
+        uint32_t vertexCount = positionBufferInfo.count;
+        for(uint32_t const index : indices)
+        {
+            if(vertexCount <= index)
+            {
+                CLog::Error(logTag(), "Index {} of mesh '{}' exceeds its {} vertices.", index, aMeshFile.string(), vertexCount);
+                return EResult::InputInvalid;
+            }
+        }
 
-        indexBuffer = indices;
+        std::vector<std::tuple<std::vector<uint8_t> *, BufferInfo *>> const streams = { { &positions,     &positionBufferInfo }
+                                                                                     , { &normals,       &normalBufferInfo   }
+                                                                                     , { &tangents,      &tangentBufferInfo  }
+                                                                                     , { &uvcoordinates, &texcoordBufferInfo } };
 
-        #define WRITE_CLEARTEXT_ATTRIBUTES_FILE 1
-        #if WRITE_CLEARTEXT_ATTRIBUTES_FILE == 1
-        auto const writeBufferToString = [](std::vector<uint8_t> const &buffer, uint8_t const componentCount, std::string const &name, std::stringstream &ss)
+        // Welding and reordering requires each present attribute to have a sample per vertex.
+        bool optimizable = triangleListsOnly && (0 == (indices.size() % 3));
+        std::vector<mesh::SVertexStream> vertexStreams {};
+        for(auto const &[data, info] : streams)
         {
-            uint8_t counter = 0;
-            ss << "\n" << name << ":\n";
-            for( uint64_t k = 0; k < buffer.size(); k += 4 )
+            if(data->empty())
             {
-                ss << *(( float * ) (buffer.data() + k)) << (counter < (componentCount-1) ? "," : "\n");
+                continue;
+            }
+            optimizable = optimizable && (vertexCount == info->count);
+            vertexStreams.push_back({ data, info->stride });
+        }
 
-                counter = (++counter) % componentCount;
+        if(optimizable)
+        {
+            mesh::SMeshOptimizationReport const report = mesh::optimizeMesh(vertexStreams, indices, vertexCount);
+
+            CLog::Status(logTag(), "Optimized mesh '{}': {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}."
+                         , aMeshFile.string()
+                         , positionBufferInfo.count, vertexCount
+                         , report.before.acmr, report.after.acmr
+                         , report.before.atvr, report.after.atvr);
+
+            for(auto const &[data, info] : streams)
+            {
+                if(not data->empty())
+                {
+                    info->count    = vertexCount;
+                    info->byteSize = data->size();
+                }
             }
+        }
+        else
+        {
+            CLog::Warning(logTag(), "Mesh '{}' is not a plain triangle list with a sample per vertex for each attribute. Skipping the vertex cache optimization.", aMeshFile.string());
+        }
+
+        // glTF positions are float3.
+        bool const floatPositions = ((3 * sizeof(float)) == positionBufferInfo.stride);
+
+        mesh::SMeshBounds bounds {};
+        if(floatPositions && 0 < vertexCount)
+        {
+            bounds.minimum.fill(std::numeric_limits<float>::max());
+            bounds.maximum.fill(std::numeric_limits<float>::lowest());
+            for(uint32_t v=0; v<vertexCount; ++v)
+            {
+                float position[3] = {};
+                memcpy(position, positions.data() + (v * positionBufferInfo.stride), sizeof(position));
+                for(std::size_t k=0; k<3; ++k)
+                {
+                    bounds.minimum[k] = std::min(bounds.minimum[k], position[k]);
+                    bounds.maximum[k] = std::max(bounds.maximum[k], position[k]);
+                }
+            }
+        }
+
+        // LOD 0 are the optimized indices. Each further LOD halves the triangles of the previous one
+        // and is appended to the indices, so that all LODs share the vertices.
+        std::vector<mesh::SMeshLod> lods = { { 0, static_cast<uint32_t>(indices.size()), 0.0f } };
+        if(optimizable && floatPositions && 1 < aConfig.meshLodCount)
+        {
+            float const diagonal = std::sqrt(std::pow(bounds.maximum[0] - bounds.minimum[0], 2.0f)
+                                           + std::pow(bounds.maximum[1] - bounds.minimum[1], 2.0f)
+                                           + std::pow(bounds.maximum[2] - bounds.minimum[2], 2.0f));
+
+            std::vector<uint32_t> previous = indices;
+            float                 error    = 0.0f;
+
+            for(uint32_t level=1; level<aConfig.meshLodCount; ++level)
+            {
+                float                 collapseError = 0.0f;
+                std::vector<uint32_t> simplified    = mesh::simplifyMesh(positions.data(), positionBufferInfo.stride, previous, vertexCount, (previous.size() / 6) * 3, (kMeshLodMaximumRelativeError * diagonal), collapseError);
+
+                // Stop, once the simplification is stuck on locked borders and seams.
+                if(simplified.empty() || (simplified.size() * 10) > (previous.size() * 9))
+                {
+                    break;
+                }
+
+                mesh::optimizeVertexCache(simplified, vertexCount);
+
+                // The errors of consecutive simplifications add up at most.
+                error += collapseError;
+                lods.push_back({ static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(simplified.size()), error });
+                indices.insert(indices.end(), simplified.begin(), simplified.end());
+
+                CLog::Status(logTag(), "Mesh '{}' LOD {}: {} triangles, error {:.5f}.", aMeshFile.string(), level, (simplified.size() / 3), error);
+
+                previous = std::move(simplified);
+            }
+        }
+
+        // Indices of the input are of any width, but are bound with 16 or 32 bit.
+        uint64_t const indexBytesPerSample = mesh::meshIndexBytesPerSample(vertexCount);
+
+        std::vector<uint8_t> indexData(indices.size() * indexBytesPerSample);
+        for(std::size_t k=0; k<indices.size(); ++k)
+        {
+            // Little endian, as everything in the data files.
+            for(uint64_t b=0; b<indexBytesPerSample; ++b)
+            {
+                indexData[(k * indexBytesPerSample) + b] = static_cast<uint8_t>(indices[k] >> (8 * b));
+            }
+        }
+
+        indexBufferInfo.count    = static_cast<uint32_t>(indices.size());
+        indexBufferInfo.stride   = indexBytesPerSample;
+        indexBufferInfo.byteSize = indexData.size();
+
+        if(aConfig.options.check(EOptions::DumpMeshCleartext))
+        {
+            auto const writeBufferToString = [](std::vector<uint8_t> const &buffer, uint8_t const componentCount, std::string const &name, std::stringstream &ss)
+            {
+                uint8_t counter = 0;
+                ss << "\n" << name << ":\n";
+                for( uint64_t k = 0; k < buffer.size(); k += 4 )
+                {
+                    ss << *(( float * ) (buffer.data() + k)) << (counter < (componentCount-1) ? "," : "\n");
+
+                    counter = (++counter) % componentCount;
+                }
+            };
+            std::stringstream ss {};
+            writeBufferToString(positions,     3, "Positions", ss);
+            writeBufferToString(normals,       3, "Normals",   ss);
+            writeBufferToString(tangents,      4, "Tangents",  ss);
+            writeBufferToString(uvcoordinates, 2, "Texcoords", ss);
+
+            std::filesystem::path const cleartextPathAbs = std::filesystem::path(outputDataFilePathAbs).concat(".cleartext");
+            engine::writeFile(cleartextPathAbs, ss.str());
+            aOutArtifacts.outputs.push_back(cleartextPathAbs);
+        }
+
+        // Float streams are quantized, see mesh::EMeshAttributeFormat. The vertex shaders decode the
+        // quantized formats only, so that streams in any other encoding fail the mesh.
+        auto const quantize = [&aMeshFile] (std::string                            const &aName
+                                          , std::vector<uint8_t>                         &aData
+                                          , BufferInfo                                   &aInfo
+                                          , mesh::EMeshAttributeFormat             const  aFloatFormat
+                                          , mesh::EMeshAttributeFormat             const  aQuantizedFormat
+                                          , std::function<std::vector<uint8_t>()>  const &aQuantizer) -> CResult<mesh::EMeshAttributeFormat>
+        {
+            if(not aData.empty() && (aInfo.nonFloat || mesh::meshAttributeFormatSize(aFloatFormat) != aInfo.stride))
+            {
+                CLog::Error(logTag(), "Attribute {} of mesh '{}' isn't stored as {} bytes of floats per sample and can't be quantized.", aName, aMeshFile.string(), mesh::meshAttributeFormatSize(aFloatFormat));
+                return { false, mesh::EMeshAttributeFormat::Undefined };
+            }
+
+            aData          = aQuantizer();
+            aInfo.stride   = mesh::meshAttributeFormatSize(aQuantizedFormat);
+            aInfo.byteSize = aData.size();
+            return aQuantizedFormat;
         };
-        std::stringstream ss {};
-        writeBufferToString(positions,     3, "Positions", ss);
-        writeBufferToString(normals,       3, "Normals",   ss);
-        writeBufferToString(tangents,      4, "Tangents",  ss);
-        writeBufferToString(uvcoordinates, 2, "Texcoords", ss);
-        engine::writeFile(std::filesystem::path(outputAttributeBufferPathAbs).concat(".cleartext"), ss.str());
-        #endif
-
-        engine::writeFile(outputAttributeBufferPathAbs, attributeBuffer);
-        engine::writeFile(outputIndexBufferPathAbs,     indexBuffer);
-
-        mesh::SMeshDataFile dataFile {};
-        dataFile.uid                  = 1234;
-        dataFile.name                 = meshID;
-        dataFile.dataBinaryFilename   = outputAttributeBufferPath;
-        dataFile.indexBinaryFilename  = outputIndexBufferPath;
-        dataFile.attributeSampleCount = positionBufferInfo.count;
-        dataFile.indexSampleCount     = indexBufferInfo.count;
-
-        mesh::SMeshAttributeDescription positionAttribute {};
-        mesh::SMeshAttributeDescription normalAttribute   {};
-        mesh::SMeshAttributeDescription tangentAttribute  {};
-        mesh::SMeshAttributeDescription texcoordAttribute {};
-        mesh::SMeshAttributeDescription indexAttribute    {};
-
-        positionAttribute.name           = "POSITION";
-        positionAttribute.index          = 0;
-        positionAttribute.offset         = 0;
-        positionAttribute.length         = positionBufferInfo.count;
-        positionAttribute.bytesPerSample = positionBufferInfo.stride;
-
-        normalAttribute.name             = "NORMAL";
-        normalAttribute.index            = 0;
-        normalAttribute.offset           = (positionAttribute.offset + positionAttribute.length);
-        normalAttribute.length           = normalBufferInfo.count;
-        normalAttribute.bytesPerSample   = normalBufferInfo.stride;
-
-        tangentAttribute.name           = "TANGENT";
-        tangentAttribute.index          = 0;
-        tangentAttribute.offset         = (normalAttribute.offset + normalAttribute.length);
-        tangentAttribute.length         = tangentBufferInfo.count;
-        tangentAttribute.bytesPerSample = tangentBufferInfo.stride;
-
-        texcoordAttribute.name           = "TEXCOORD";
-        texcoordAttribute.index          = 0;
-        texcoordAttribute.offset         = (tangentAttribute.offset + tangentAttribute.length);
-        texcoordAttribute.length         = texcoordBufferInfo.count;
-        texcoordAttribute.bytesPerSample = texcoordBufferInfo.stride;
-
-        dataFile.attributes.push_back(positionAttribute);
-        dataFile.attributes.push_back(normalAttribute);
-        dataFile.attributes.push_back(tangentAttribute);
-        dataFile.attributes.push_back(texcoordAttribute);
-
-        indexAttribute.name           = "Indices";
-        indexAttribute.index          = 0;
-        indexAttribute.offset         = 0;
-        indexAttribute.length         = indexBufferInfo.count;
-        indexAttribute.bytesPerSample = indexBufferInfo.stride;
-
-        dataFile.indices = indexAttribute;
 
-        std::string serializedData = {};
+        uint64_t const floatVertexSize = (positionBufferInfo.stride + normalBufferInfo.stride + tangentBufferInfo.stride + texcoordBufferInfo.stride);
+
+        CResult<mesh::EMeshAttributeFormat> const positionFormat = quantize("POSITION", positions, positionBufferInfo, mesh::EMeshAttributeFormat::Float32x3, mesh::EMeshAttributeFormat::Unorm16x4, [&] () { return quantizePositions(positions, bounds); });
+        CResult<mesh::EMeshAttributeFormat> const normalFormat   = quantize("NORMAL",   normals,   normalBufferInfo,   mesh::EMeshAttributeFormat::Float32x3, mesh::EMeshAttributeFormat::Snorm16x2, [&] () { return quantizeNormals(normals); });
+        CResult<mesh::EMeshAttributeFormat> const tangentFormat  = quantize("TANGENT",  tangents,  tangentBufferInfo,  mesh::EMeshAttributeFormat::Float32x4, mesh::EMeshAttributeFormat::Snorm16x4, [&] () { return quantizeTangents(tangents); });
+        CResult<mesh::EMeshAttributeFormat> const texcoordFormat = quantize("TEXCOORD", uvcoordinates, texcoordBufferInfo, mesh::EMeshAttributeFormat::Float32x2, mesh::EMeshAttributeFormat::Float16x2, [&] () { return quantizeTexcoords(uvcoordinates); });
+        if(not (positionFormat.successful() && normalFormat.successful() && tangentFormat.successful() && texcoordFormat.successful()))
+        {
+            return EResult::InputInvalid;
+        }
+
+        uint64_t const quantizedVertexSize = (positionBufferInfo.stride + normalBufferInfo.stride + tangentBufferInfo.stride + texcoordBufferInfo.stride);
+        CLog::Status(logTag(), "Quantized mesh '{}': {} -> {} bytes per vertex.", aMeshFile.string(), floatVertexSize, quantizedVertexSize);
+
+        std::array<BufferInfo const *, 4> const attributeInfos = { &positionBufferInfo, &normalBufferInfo, &tangentBufferInfo, &texcoordBufferInfo };
+
+        // The stream of attribute k in aLayout. Attributes without a sample per vertex, e.g. absent
+        // ones, keep a stream of their own, since the attributes of a stream are interleaved per vertex.
+        auto const streamOf = [&] (EMeshVertexLayout aLayout, std::size_t aAttributeIndex) -> uint64_t
+        {
+            if(vertexCount != attributeInfos[aAttributeIndex]->count)
+            {
+                return (attributeInfos.size() + aAttributeIndex);
+            }
+
+            switch(aLayout)
+            {
+                case EMeshVertexLayout::Interleaved: return 0;
+                case EMeshVertexLayout::Split:       return ((0 == aAttributeIndex) ? 0 : 1);
+                default:                             return aAttributeIndex;
+            }
+        };
 
-        // Write datafile
-        CResult<EResult> const dataFileSerializationResult = serializeMeshDataFile(dataFile, serializedData);
-        if(not dataFileSerializationResult.successful())
+        // Compare the fetches of the finest LOD for all layouts, to pick one per content.
+        if(optimizable)
         {
-            CLog::Error(logTag(), "Failed to serialize data file.");
+            std::vector<uint32_t> const finestIndices(indices.begin(), indices.begin() + lods[0].indexCount);
+
+            auto const analyze = [&] (EMeshVertexLayout aLayout) -> mesh::SVertexFetchStatistics
+            {
+                std::map<uint64_t, uint64_t> strides {};
+                for(std::size_t k=0; k<attributeInfos.size(); ++k)
+                {
+                    if(vertexCount == attributeInfos[k]->count)
+                    {
+                        strides[streamOf(aLayout, k)] += attributeInfos[k]->stride;
+                    }
+                }
+
+                std::vector<uint64_t> streamStrides {};
+                for(auto const &[stream, stride] : strides)
+                {
+                    streamStrides.push_back(stride);
+                }
+                return mesh::analyzeVertexFetch(finestIndices, vertexCount, streamStrides);
+            };
+
+            mesh::SVertexFetchStatistics const planar      = analyze(EMeshVertexLayout::Planar);
+            mesh::SVertexFetchStatistics const interleaved = analyze(EMeshVertexLayout::Interleaved);
+            mesh::SVertexFetchStatistics const split       = analyze(EMeshVertexLayout::Split);
+
+            CLog::Status(logTag(), "Vertex fetch of mesh '{}' in bytes per vertex (overfetch): planar {:.1f} ({:.2f}), interleaved {:.1f} ({:.2f}), split {:.1f} ({:.2f})."
+                         , aMeshFile.string()
+                         , planar     .bytesPerVertex, planar     .overfetch
+                         , interleaved.bytesPerVertex, interleaved.overfetch
+                         , split      .bytesPerVertex, split      .overfetch);
+        }
+
+        auto const describe = [] (std::string const &aName, BufferInfo const &aInfo, mesh::EMeshAttributeFormat aFormat, uint64_t aStream) -> mesh::SMeshAttributeDescription
+        {
+            mesh::SMeshAttributeDescription description {};
+            description.name           = aName;
+            description.index          = aStream;
+            description.offset         = 0; // Assigned by the container layout.
+            description.length         = aInfo.count;
+            description.bytesPerSample = aInfo.stride;
+            description.format         = aFormat;
+            description.stride         = 0; // Assigned by the container layout.
+            return description;
+        };
+
+        EMeshVertexLayout const layout = aConfig.meshVertexLayout;
+
+        std::vector<mesh::SMeshAttributeDescription> const attributes = { describe("POSITION", positionBufferInfo, positionFormat.data(), streamOf(layout, 0))
+                                                                        , describe("NORMAL",   normalBufferInfo,   normalFormat  .data(), streamOf(layout, 1))
+                                                                        , describe("TANGENT",  tangentBufferInfo,  tangentFormat .data(), streamOf(layout, 2))
+                                                                        , describe("TEXCOORD", texcoordBufferInfo, texcoordFormat.data(), streamOf(layout, 3)) };
+
+        std::vector<std::vector<uint8_t>> attributeData {};
+        attributeData.push_back(std::move(positions));
+        attributeData.push_back(std::move(normals));
+        attributeData.push_back(std::move(tangents));
+        attributeData.push_back(std::move(uvcoordinates));
+
+        mesh::SMeshAttributeDescription const indexAttribute = describe("Indices", indexBufferInfo, mesh::EMeshAttributeFormat::Undefined, 0);
+
+        auto const [encodeResult, container] = mesh::encodeMeshContainer(attributes, attributeData, indexAttribute, indexData, vertexCount, lods, bounds);
+        if(CheckEngineError(encodeResult))
+        {
+            CLog::Error(logTag(), "Failed to encode mesh container.");
             return EResult::SerializationFailed;
         }
 
-        engine::writeFile(outputDataFilePathAbs, serializedData);
+        CEngineResult<> const writeResult = resource_compiler::writeAssetData(outputDataFilePathAbs, container, aConfig);
+        if(not writeResult.successful())
+        {
+            CLog::Error(logTag(), "Failed to write mesh container '{}'.", outputDataFilePathAbs.string());
+            return EResult::WriteFailed;
+        }
+        aOutArtifacts.outputs.push_back(outputDataFilePathAbs);
+
+        std::string serializedData = {};
 
         engine::mesh::SMeshMeta meta {};
         meta.uid        = 1234;
@@ -384,6 +580,7 @@ namespace meshes
         }
 
         engine::writeFile(outputMetaFilePathAbs, serializedData);
+        aOutArtifacts.outputs.push_back(outputMetaFilePathAbs);
 
         return EResult::Success;
     }
@@ -0,0 +1,120 @@
+#include <array>
+#include <cstring>
+
+#include <mesh/meshquantization.h>
+
+#include "meshes/meshquantizer.h"
+
+namespace meshes
+{
+    using namespace engine::mesh;
+
+    namespace
+    {
+        /**
+         * Read the float sample aIndex of TComponentCount components from aData.
+         */
+        template <std::size_t TComponentCount>
+        std::array<float, TComponentCount> readFloats(std::vector<uint8_t> const &aData, std::size_t aIndex)
+        {
+            std::array<float, TComponentCount> sample {};
+            std::memcpy(sample.data(), aData.data() + (aIndex * sizeof(sample)), sizeof(sample));
+            return sample;
+        }
+
+        /**
+         * Write the 16 bit components of aSample into sample aIndex of aData, little endian.
+         */
+        template <typename TComponent, std::size_t TComponentCount>
+        void writeComponents(std::vector<uint8_t> &aData, std::size_t aIndex, std::array<TComponent, TComponentCount> const &aSample)
+        {
+            static_assert(2 == sizeof(TComponent), "Only 16 bit components are written.");
+
+            uint8_t *target = aData.data() + (aIndex * sizeof(aSample));
+            for(std::size_t k=0; k<TComponentCount; ++k)
+            {
+                uint16_t const bits = static_cast<uint16_t>(aSample[k]);
+                target[(2 * k) + 0] = static_cast<uint8_t>(bits);
+                target[(2 * k) + 1] = static_cast<uint8_t>(bits >> 8u);
+            }
+        }
+    }
+
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    std::vector<uint8_t> quantizePositions(std::vector<uint8_t> const &aPositions, SMeshBounds const &aBounds)
+    {
+        std::size_t const count = (aPositions.size() / (3 * sizeof(float)));
+
+        std::vector<uint8_t> quantized(count * meshAttributeFormatSize(EMeshAttributeFormat::Unorm16x4));
+        for(std::size_t v=0; v<count; ++v)
+        {
+            std::array<float, 3> const position = readFloats<3>(aPositions, v);
+
+            std::array<uint16_t, 4> sample {};
+            for(std::size_t k=0; k<3; ++k)
+            {
+                sample[k] = quantizeUnorm16(position[k], aBounds.minimum[k], aBounds.maximum[k]);
+            }
+            writeComponents(quantized, v, sample);
+        }
+        return quantized;
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    std::vector<uint8_t> quantizeNormals(std::vector<uint8_t> const &aNormals)
+    {
+        std::size_t const count = (aNormals.size() / (3 * sizeof(float)));
+
+        std::vector<uint8_t> quantized(count * meshAttributeFormatSize(EMeshAttributeFormat::Snorm16x2));
+        for(std::size_t v=0; v<count; ++v)
+        {
+            writeComponents(quantized, v, encodeOctahedral(readFloats<3>(aNormals, v)));
+        }
+        return quantized;
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    std::vector<uint8_t> quantizeTangents(std::vector<uint8_t> const &aTangents)
+    {
+        std::size_t const count = (aTangents.size() / (4 * sizeof(float)));
+
+        std::vector<uint8_t> quantized(count * meshAttributeFormatSize(EMeshAttributeFormat::Snorm16x4));
+        for(std::size_t v=0; v<count; ++v)
+        {
+            std::array<float, 4>   const tangent   = readFloats<4>(aTangents, v);
+            std::array<int16_t, 2> const direction = encodeOctahedral({ tangent[0], tangent[1], tangent[2] });
+
+            std::array<int16_t, 4> const sample = { direction[0], direction[1], static_cast<int16_t>((0.0f > tangent[3]) ? -32767 : 32767), 0 };
+            writeComponents(quantized, v, sample);
+        }
+        return quantized;
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    std::vector<uint8_t> quantizeTexcoords(std::vector<uint8_t> const &aTexcoords)
+    {
+        std::size_t const count = (aTexcoords.size() / (2 * sizeof(float)));
+
+        std::vector<uint8_t> quantized(count * meshAttributeFormatSize(EMeshAttributeFormat::Float16x2));
+        for(std::size_t v=0; v<count; ++v)
+        {
+            std::array<float, 2> const texcoord = readFloats<2>(aTexcoords, v);
+
+            std::array<uint16_t, 2> const sample = { floatToHalf(texcoord[0]), floatToHalf(texcoord[1]) };
+            writeComponents(quantized, v, sample);
+        }
+        return quantized;
+    }
+    //<-----------------------------------------------------------------------------
+}
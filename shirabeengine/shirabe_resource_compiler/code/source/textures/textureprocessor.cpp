@@ -242,7 +242,7 @@ namespace texture
         return infos;
     }
 
-    CResult<EResult> processTexture(std::filesystem::path const &aTextureFile, SConfiguration const &aConfig)
+    CResult<EResult> processTexture(std::filesystem::path const &aTextureFile, SConfiguration const &aConfig, resource_compiler::SBuildArtifacts &aOutArtifacts)
     {
         std::filesystem::path const &pathAbs    = std::filesystem::current_path() / aTextureFile;
         std::filesystem::path const &parentPath = std::filesystem::relative(aTextureFile, aConfig.inputPath).parent_path();
@@ -277,6 +277,7 @@ namespace texture
         {
             enriched.push_back(pathAbs.parent_path() / path);
         }
+        aOutArtifacts.dependencies.insert(aOutArtifacts.dependencies.end(), enriched.begin(), enriched.end());
 
         STextureCollectionLoadInfo textureInputLoads = __loadTexturesFromFiles(enriched);
 
@@ -289,7 +290,8 @@ namespace texture
             memcpy(buffer.mutableDataVector().data() + (k * input.data.size()), input.data.dataVector().data(), input.data.size());
         }
 
-        engine::writeFile(outputDataFilePathAbs, buffer.dataVector());
+        resource_compiler::writeAssetData(outputDataFilePathAbs, buffer.dataVector(), aConfig);
+        aOutArtifacts.outputs.push_back(outputDataFilePathAbs);
 
         std::string serializedData = {};
 
@@ -308,6 +310,7 @@ namespace texture
         }
 
         engine::writeFile(outputMetaFilePathAbs, serializedData);
+        aOutArtifacts.outputs.push_back(outputMetaFilePathAbs);
 
         return EResult::Success;
     }
@@ -134,6 +134,15 @@ namespace engine
          */
         ~CCamera();
 
+    public_operators:
+        /**
+         * Copy assign another camera.
+         *
+         * @param aOther The other camera to copy from.
+         * @return       This camera.
+         */
+        CCamera &operator=(CCamera const &aOther);
+
     public_methods:
         /**
          * Return the assigned view type.
@@ -195,10 +204,34 @@ namespace engine
             return mProjectionMatrix;
         }
 
+        /**
+         * Return the world space position of the camera as of the last update.
+         *
+         * @return See brief.
+         */
+        SHIRABE_INLINE CVector3D<float> const &position() const
+        {
+            return mPosition;
+        }
+
+        /**
+         * Return the number of pixels, which a unit of world space length covers on screen
+         * at the point of a sphere closest to the camera. Used to project geometric errors,
+         * e.g. to select mesh LODs. Orthographic cameras return the same value at any distance.
+         *
+         * @param aWorldPosition The center of the sphere.
+         * @param aRadius        The radius of the sphere. Points in front of the near plane
+         *                       are evaluated at the near plane.
+         * @return               See brief.
+         */
+        float pixelsPerUnit(CVector3D<float> const &aWorldPosition, float aRadius = 0.0f) const;
+
         SHIRABE_INLINE void update(CTimer const &aTimer, CTransform const &aTransform)
         {
             SHIRABE_UNUSED(aTimer);
 
+            mPosition = aTransform.translation();
+
             ECoordinateSystem system = ECoordinateSystem::LH;
             createViewMatrix(aTransform, system);
             createProjectionMatrix(system);
@@ -224,6 +257,7 @@ namespace engine
         SFrustumParameters    mFrustumParameters;
         SProjectionParameters mProjectionParameters;
         CVector3D<float>           mLookAtTarget;
+        CVector3D<float>           mPosition;
 
         CMatrix4x4            mViewMatrix;
         CMatrix4x4            mProjectionMatrix;
@@ -6,8 +6,10 @@
 #include <core/enginestatus.h>
 #include <core/enginetypehelper.h>
 #include <core/benchmarking/timer/timer.h>
+#include <core/threading/jobsystem.h>
 #include <wsi/windowmanager.h>
 #include <asset/assetstorage.h>
+#include <asset/assetreadqueue.h>
 #include <renderer/irenderer.h>
 
 #include <resources/cresourcemanager.h>
@@ -88,12 +90,16 @@ namespace engine
         // Timing
         CTimer                       mTimer;
 
+        // Threading
+        Shared<threading::CJobSystem> mJobSystem;
+
         // WSI
         Shared<CWindowManager>        mWindowManager;
         Shared<IWindow>               mMainWindow;
 
         // Assets & Resources
         Shared<CAssetStorage>         mAssetStorage;
+        Shared<CAssetReadQueue>       mAssetReadQueue;
         Shared<CResourceManager>      mResourceManager;
         Shared<CMaterialLoader>       mMaterialLoader;
         Shared<CMeshLoader>           mMeshLoader;
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include <math/geometric/rect.h>
 #include "buildingblocks/camera.h"
 
@@ -15,6 +19,7 @@ namespace engine
         , mFrustumParameters(SFrustumParameters::Default())
         , mProjectionParameters(SProjectionParameters::Default())
         , mLookAtTarget({ 0, 0, 0 })
+        , mPosition({ 0, 0, 0 })
         , mViewMatrix()
         , mProjectionMatrix()
     { }
@@ -28,6 +33,7 @@ namespace engine
         , mFrustumParameters(aOther.frustumParameters())
         , mProjectionParameters(aOther.projectionParameters())
         , mLookAtTarget(aOther.lookAtTarget())
+        , mPosition(aOther.position())
         , mViewMatrix(aOther.mViewMatrix)
         , mProjectionMatrix(aOther.mProjectionMatrix)
     { }
@@ -44,6 +50,7 @@ namespace engine
         , mFrustumParameters(aFrustumParameters)
         , mProjectionParameters(aProjectionParameters)
         , mLookAtTarget(aLookAt)
+        , mPosition({ 0, 0, 0 })
         , mViewMatrix()
         , mProjectionMatrix()
     { }
@@ -56,6 +63,68 @@ namespace engine
     { }
     //<-----------------------------------------------------------------------------
 
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    CCamera &CCamera::operator=(CCamera const &aOther)
+    {
+        mViewType             = aOther.viewType();
+        mFrustumParameters    = aOther.frustumParameters();
+        mProjectionParameters = aOther.projectionParameters();
+        mLookAtTarget         = aOther.lookAtTarget();
+        mPosition             = aOther.position();
+        mViewMatrix           = aOther.mViewMatrix;
+        mProjectionMatrix     = aOther.mProjectionMatrix;
+
+        return (*this);
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+
+    /**
+     * Return the near plane bounding rectangle of an orthographic frustum.
+     *
+     * @param aFrustumParameters The frustum to bound.
+     * @return                   The bounds as { left, top, right, bottom } in view space units.
+     */
+    static CVector4D<float> orthographicBounds(CCamera::SFrustumParameters const &aFrustumParameters)
+    {
+        return CVector4D<float>({
+            (-0.5f * aFrustumParameters.width),
+            (-0.5f * aFrustumParameters.height),
+            ( 0.5f * aFrustumParameters.width),
+            ( 0.5f * aFrustumParameters.height)
+        });
+    }
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    float CCamera::pixelsPerUnit(CVector3D<float> const &aWorldPosition, float aRadius) const
+    {
+        float const height = static_cast<float>(mFrustumParameters.height);
+
+        if(ECameraProjectionType::Orthographic == mProjectionParameters.projectionType)
+        {
+            // Independent of the distance: The viewport height maps to the height of the view volume.
+            CVector4D<float> const bounds        = orthographicBounds(mFrustumParameters);
+            float            const frustumHeight = std::abs(bounds.w() - bounds.y());
+
+            return (height / std::max(frustumHeight, std::numeric_limits<float>::epsilon()));
+        }
+
+        float const distance = std::max({ ((aWorldPosition - mPosition).length() - aRadius)
+                                        , mFrustumParameters.nearPlaneDistance
+                                        , std::numeric_limits<float>::epsilon() });
+
+        return (height / (2.0f * distance * std::tan(0.5f * mFrustumParameters.fovY)));
+    }
+    //<-----------------------------------------------------------------------------
+
     //<-----------------------------------------------------------------------------
     //<
     //<-----------------------------------------------------------------------------
@@ -296,12 +365,7 @@ namespace engine
             break;
         case ECameraProjectionType::Orthographic:
             mat = projectionOrtho(
-                        CVector4D<float>({
-                            (-0.5f * mFrustumParameters.width),
-                            (-0.5f * mFrustumParameters.height),
-                            ( 0.5f * mFrustumParameters.width),
-                            ( 0.5f * mFrustumParameters.height)
-                        }),
+                        orthographicBounds(mFrustumParameters),
                         static_cast<double>(mFrustumParameters.nearPlaneDistance),
                         static_cast<double>(mFrustumParameters.farPlaneDistance),
                         aCoordinateSystem);
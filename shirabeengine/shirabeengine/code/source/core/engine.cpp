@@ -1,7 +1,9 @@
 #include <filesystem>
 
 #include <asset/assetindex.h>
+#include <asset/assetprefetcher.h>
 #include <asset/filesystemassetdatasource.h>
+#include <asset/packassetdatasource.h>
 #include <core/enginestatus.h>
 #include <renderer/renderer.h>
 #include <renderer/framegraph/framegraphrendercontext.h>
@@ -24,7 +26,9 @@
 #include "ecws/materialcomponent.h"
 #include "ecws/transformcomponent.h"
 #include "ecws/cameracomponent.h"
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 #if defined SHIRABE_PLATFORM_LINUX
     #include <wsi/x11/x11display.h>
@@ -41,6 +45,29 @@
 
 namespace engine
 {
+    /**
+     * The screen space error in pixels, up to which a coarser mesh LOD is selected.
+     */
+    static constexpr float const kMeshLodMaximumPixelError = 1.0f;
+
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    static float maximumScaleOf(CMatrix4x4 const &aWorld)
+    {
+        // The largest row or column norm of the upper 3x3 is an upper bound of the
+        // scale, regardless of the matrix being applied to row or column vectors.
+        auto const norm = [] (float aX, float aY, float aZ) -> float { return std::sqrt((aX * aX) + (aY * aY) + (aZ * aZ)); };
+
+        return std::max({ norm(aWorld.r00(), aWorld.r01(), aWorld.r02())
+                        , norm(aWorld.r10(), aWorld.r11(), aWorld.r12())
+                        , norm(aWorld.r20(), aWorld.r21(), aWorld.r22())
+                        , norm(aWorld.r00(), aWorld.r10(), aWorld.r20())
+                        , norm(aWorld.r01(), aWorld.r11(), aWorld.r21())
+                        , norm(aWorld.r02(), aWorld.r12(), aWorld.r22()) });
+    }
+    //<-----------------------------------------------------------------------------
+
     //<-----------------------------------------------------------------------------
     //
     //<-----------------------------------------------------------------------------
@@ -97,7 +124,9 @@ namespace engine
         : mApplicationEnvironment(std::move(aEnvironment))
         , mWindowManager    (nullptr) // Do not initialize here, to avoid exceptions in constructor. Memory leaks!!!
         , mMainWindow       (nullptr)
+        , mJobSystem        (nullptr)
         , mAssetStorage     (nullptr)
+        , mAssetReadQueue   (nullptr)
         , mResourceManager  (nullptr)
         , mVulkanEnvironment(nullptr)
         , mRenderer         (nullptr)
@@ -262,11 +291,64 @@ namespace engine
             std::filesystem::path const root          = std::filesystem::current_path();
             std::filesystem::path const resourcesPath = root/"data/output/resources";
 
-            CAssetStorage::AssetRegistry_t assetIndex = asset::CAssetIndex::loadIndexById(resourcesPath/"game.assetindex.xml");
 
-            Unique<IAssetDataSource> assetDataSource = makeUnique<CFileSystemAssetDataSource>(resourcesPath);
+            // Prefer the single file asset pack, if the resource compiler emitted one.
+            Unique<IAssetDataSource> assetDataSource = nullptr;
+
+            std::filesystem::path const packPath = resourcesPath/"game.assetpack";
+            if(std::filesystem::exists(packPath))
+            {
+                Unique<CPackAssetDataSource> packDataSource = makeUnique<CPackAssetDataSource>(packPath, resourcesPath);
+                if(packDataSource->initialize().successful())
+                {
+                    assetDataSource = std::move(packDataSource);
+                }
+            }
+
+            if(nullptr == assetDataSource)
+            {
+                Unique<CFileSystemAssetDataSource> fileSystemDataSource = makeUnique<CFileSystemAssetDataSource>(resourcesPath);
+
+                // Batched and asynchronous reads are kept in flight together on the read queue.
+                Shared<asset::CAssetReadQueue> readQueue = makeShared<asset::CAssetReadQueue>();
+                if(readQueue->initialize().successful())
+                {
+                    fileSystemDataSource->setReadQueue(readQueue);
+                    mAssetReadQueue = readQueue;
+                }
+
+                assetDataSource = std::move(fileSystemDataSource);
+            }
             Shared<CAssetStorage>    assetStorage    = makeShared<CAssetStorage>(std::move(assetDataSource));
-            assetStorage->readIndex(assetIndex);
+
+            // Prefer the binary asset index. The XML index is only parsed, if no binary index was emitted.
+            CEngineResult<Shared<asset::CBinaryAssetIndex>> const binaryIndex = asset::CBinaryAssetIndex::load(resourcesPath/"game.assetindex");
+            if(binaryIndex.successful())
+            {
+                assetStorage->readIndex(binaryIndex.data());
+            }
+            else
+            {
+                CAssetStorage::AssetRegistry_t assetIndex = asset::CAssetIndex::loadIndexById(resourcesPath/"game.assetindex.xml");
+                assetStorage->readIndex(assetIndex);
+            }
+
+            // Asset data prefetched ahead of loading is kept in a bounded cache.
+            static constexpr uint64_t const kAssetDataCacheCapacity = (256ull * 1024ull * 1024ull);
+            assetStorage->setDataCache(makeShared<asset::CAssetDataCache>(kAssetDataCacheCapacity));
+
+            // Asset loads and decompression are spread across all cores by the engine's job system.
+            Shared<threading::CJobSystem> jobSystem = makeShared<threading::CJobSystem>();
+            if(jobSystem->initialize() && jobSystem->run())
+            {
+                assetStorage->setJobSystem(jobSystem);
+                mJobSystem = jobSystem;
+            }
+            else
+            {
+                CLog::Warning(logTag(), "Failed to start the job system. Loading assets on the calling thread.");
+            }
+
             mAssetStorage = assetStorage;
 
             mMeshLoader     = makeShared<mesh::CMeshLoader>();
@@ -294,6 +376,11 @@ namespace engine
             }
 
             Shared<CResourceManager> manager = makeShared<CResourceManager>(std::move(gpuApiResourceFactory), mAssetStorage);
+            if(nullptr != mJobSystem)
+            {
+                // Otherwise the resource tasks run inline on the waiting thread.
+                manager->setTaskGraph(makeShared<threading::CTaskGraph>(mJobSystem));
+            }
             // manager->addAssetLoader<SMesh>(...);
             manager->addAssetLoader<SMaterial>(material::getAssetLoader(manager, mAssetStorage, mMaterialLoader));
             manager->addAssetLoader<SMesh>    (mesh    ::getAssetLoader(manager, mAssetStorage, mMeshLoader));
@@ -342,32 +429,68 @@ namespace engine
             CEngineResult<> initialization = mScene.initialize();
             status = initialization.result();
 
-            auto const &[coreMaterialLoadResult, core] = mMaterialLoader->loadMaterialInstance(mAssetStorage
-                                                                                               , util::crc32FromString("materials/core/core.material.meta")
-                                                                                               , true
-                                                                                               , true);
-
-            auto const &[phongMaterialLoadResult, phong] = mMaterialLoader->loadMaterialInstance(mAssetStorage
-                                                                                               , util::crc32FromString("materials/deferred/phong/phong_lighting.material.meta")
-                                                                                               , true);
-            auto const &[compositingMaterialLoadResult, compositing] = mMaterialLoader->loadMaterialInstance(mAssetStorage
-                                                                                                 , util::crc32FromString("materials/deferred/compositing/compositing.material.meta")
-                                                                                                 , true);
-
-            auto const &[materialLoadResult, material] = mMaterialLoader->loadMaterialInstance(mAssetStorage
-                                                                                               , util::crc32FromString("materials/standard/standard.material.meta")
-                                                                                               , true);
+            AssetId_t const coreMaterialId        = util::crc32FromString("materials/core/core.material.meta");
+            AssetId_t const phongMaterialId       = util::crc32FromString("materials/deferred/phong/phong_lighting.material.meta");
+            AssetId_t const compositingMaterialId = util::crc32FromString("materials/deferred/compositing/compositing.material.meta");
+            AssetId_t const standardMaterialId    = util::crc32FromString("materials/standard/standard.material.meta");
+            AssetId_t const meshId                = util::crc32FromString("meshes/barramundi/BarramundiFish.mesh.meta");
+            AssetId_t const baseColorTextureId    = util::crc32FromString("textures/BarramundiFish_baseColor.texture.meta");
+            AssetId_t const normalTextureId       = util::crc32FromString("textures/BarramundiFish_normal.texture.meta");
 
-            auto const &[meshLoadResult,     mesh]     = mMeshLoader->loadMeshInstance(mAssetStorage
-                                                                                       , util::crc32FromString("meshes/barramundi/BarramundiFish.mesh.meta"));
+            // Read everything the scene depends on in parallel, one wave per dependency level,
+            // instead of walking each meta chain one read at a time below.
+            {
+                asset::CAssetPrefetcher prefetcher(mAssetStorage);
+                prefetcher.registerDependencyResolver(EAssetType::Material, &CMaterialLoader::resolveDependencies);
+                prefetcher.registerDependencyResolver(EAssetType::Mesh,     &CMeshLoader::resolveDependencies);
+                prefetcher.registerDependencyResolver(EAssetType::Texture,  &CTextureLoader::resolveDependencies);
+
+                auto const &[prefetchResult, prefetchStatistics] = prefetcher.prefetch({ coreMaterialId
+                                                                                       , phongMaterialId
+                                                                                       , compositingMaterialId
+                                                                                       , standardMaterialId
+                                                                                       , meshId
+                                                                                       , baseColorTextureId
+                                                                                       , normalTextureId });
+                if(CheckEngineError(prefetchResult))
+                {
+                    CLog::Warning(logTag(), "Failed to prefetch the scene assets. Loading them on demand.");
+                }
+                else
+                {
+                    CLog::Debug(logTag(), "Prefetched {} assets ({} bytes) in {} waves.", prefetchStatistics.readCount, prefetchStatistics.bytesRead, prefetchStatistics.waveCount);
+                }
+            }
 
-            auto const &[textureResult,     texture]     = mTextureLoader->loadInstance(mAssetStorage
-                                                                                       , util::crc32FromString("textures/BarramundiFish_baseColor.texture.meta"));
-            auto const &[texture2Result,     texture2]     = mTextureLoader->loadInstance(mAssetStorage
-                                                                                        , util::crc32FromString("textures/BarramundiFish_normal.texture.meta"));
+            // Load the scene assets on the resource task graph, so that the reads and decoding
+            // of all of them overlap. Collect the instances once everything is scheduled.
+            Shared<threading::CTaskGraph> const &taskGraph = mResourceManager->getTaskGraph();
+
+            auto const coreMaterialLoad        = mMaterialLoader->loadMaterialInstanceAsync(taskGraph, mAssetStorage, coreMaterialId,        true, true);
+            auto const phongMaterialLoad       = mMaterialLoader->loadMaterialInstanceAsync(taskGraph, mAssetStorage, phongMaterialId,       true);
+            auto const compositingMaterialLoad = mMaterialLoader->loadMaterialInstanceAsync(taskGraph, mAssetStorage, compositingMaterialId, true);
+            auto const standardMaterialLoad    = mMaterialLoader->loadMaterialInstanceAsync(taskGraph, mAssetStorage, standardMaterialId,    true);
+            auto const meshLoad                = mMeshLoader    ->loadMeshInstanceAsync    (taskGraph, mAssetStorage, meshId);
+            auto const baseColorTextureLoad    = mTextureLoader ->loadInstanceAsync        (taskGraph, mAssetStorage, baseColorTextureId);
+            auto const normalTextureLoad       = mTextureLoader ->loadInstanceAsync        (taskGraph, mAssetStorage, normalTextureId);
+
+            auto const &[coreMaterialLoadResult,        core]        = coreMaterialLoad       .get();
+            auto const &[phongMaterialLoadResult,       phong]       = phongMaterialLoad      .get();
+            auto const &[compositingMaterialLoadResult, compositing] = compositingMaterialLoad.get();
+            auto const &[materialLoadResult,            material]    = standardMaterialLoad   .get();
+            auto const &[meshLoadResult,                mesh]        = meshLoad               .get();
+            auto const &[textureResult,                 texture]     = baseColorTextureLoad   .get();
+            auto const &[texture2Result,                texture2]    = normalTextureLoad      .get();
+
+            if(CheckEngineError(coreMaterialLoadResult) || CheckEngineError(phongMaterialLoadResult) || CheckEngineError(compositingMaterialLoadResult)
+               || CheckEngineError(materialLoadResult) || CheckEngineError(meshLoadResult) || CheckEngineError(textureResult) || CheckEngineError(texture2Result))
+            {
+                CLog::Error(logTag(), "Failed to load the scene assets.");
+                return EEngineStatus::Error;
+            }
 
-            material->getMutableConfiguration().setSampledImage("diffuseTexture", util::crc32FromString("textures/BarramundiFish_baseColor.texture.meta"));
-            material->getMutableConfiguration().setSampledImage("normalTexture", util::crc32FromString("textures/BarramundiFish_normal.texture.meta"));
+            material->getMutableConfiguration().setSampledImage("diffuseTexture", baseColorTextureId);
+            material->getMutableConfiguration().setSampledImage("normalTexture", normalTextureId);
 
 
             auto coreTransform         = makeShared<ecws::CTransformComponent>("core_transform");
@@ -451,6 +574,19 @@ namespace engine
             status = mRenderer->deinitialize();
         }
 
+        if(nullptr != mAssetReadQueue)
+        {
+            mAssetReadQueue->deinitialize();
+            mAssetReadQueue = nullptr;
+        }
+
+        if(nullptr != mJobSystem)
+        {
+            mJobSystem->abortAndJoin();
+            mJobSystem->deinitialize();
+            mJobSystem = nullptr;
+        }
+
         if(nullptr != mMainWindow)
         {
                 mMainWindow->hide();
@@ -533,18 +669,35 @@ namespace engine
             for(auto const &entity : entities)
             {
                 std::string const &name = entity->name();
-                ecws::CBoundedCollection<Shared<ecws::CMeshComponent>>     meshes    = entity->getTypedComponentsOfType<ecws::CMeshComponent>();
-                ecws::CBoundedCollection<Shared<ecws::CMaterialComponent>> materials = entity->getTypedComponentsOfType<ecws::CMaterialComponent>();
+                ecws::CBoundedCollection<Shared<ecws::CMeshComponent>>      meshes     = entity->getTypedComponentsOfType<ecws::CMeshComponent>();
+                ecws::CBoundedCollection<Shared<ecws::CMaterialComponent>>  materials  = entity->getTypedComponentsOfType<ecws::CMaterialComponent>();
+                ecws::CBoundedCollection<Shared<ecws::CTransformComponent>> transforms = entity->getTypedComponentsOfType<ecws::CTransformComponent>();
 
                 for(auto const &mesh : meshes)
+                {
+                    // Select the coarsest LOD, whose error stays below a pixel at the mesh's closest point.
+                    uint32_t meshLodIndex = 0;
+                    if(not transforms.empty())
+                    {
+                        CTransform          const &transform = (*(transforms.cbegin()))->getTransform();
+                        mesh::SMeshDataFile const &dataFile  = mesh->getMeshInstance()->dataFile();
+
+                        float const scale         = maximumScaleOf(transform.world());
+                        float const pixelsPerUnit = camera->pixelsPerUnit(transform.translation(), (scale * dataFile.boundingRadius()));
+
+                        meshLodIndex = mesh::selectMeshLod(dataFile.lods, (scale * pixelsPerUnit), kMeshLodMaximumPixelError);
+                    }
+
                     for(auto const &material : materials)
                     {
                         renderableCollection.push_back({ name
                                                          , mesh->getMeshInstance()->name()
                                                          , mesh->getMeshInstance()->getAssetId()
                                                          , material->getMaterialInstance()->name()
-                                                         , material->getMaterialInstance()->master()->getAssetId() });
+                                                         , material->getMaterialInstance()->master()->getAssetId()
+                                                         , meshLodIndex });
                     }
+                }
             }
 
             mRenderer->renderScene(renderableCollection);
@@ -0,0 +1,159 @@
+#ifndef __SHIRABE_ASSET_COMPRESSION_H__
+#define __SHIRABE_ASSET_COMPRESSION_H__
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+#include <core/databuffer.h>
+#include <core/threading/jobsystem.h>
+#include <log/log.h>
+
+#include "asset/assettypes.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        /*
+         * Layout of a block compressed asset payload (little endian):
+         *
+         *   [SAssetBlockHeader]                   at offset 0
+         *   [uint64_t x blockCount+1]             offsets of the stored blocks, relative to the first block
+         *   [block 0] ... [block N-1]             each decompressing to blockSize bytes, except the last
+         *
+         * Blocks are compressed independently, so that they can be decompressed in parallel or
+         * one after another into a small window. A block, which does not shrink, is stored raw.
+         * Since compressed blocks are always smaller, a stored size equal to the block size
+         * denotes a raw block.
+         */
+
+        static constexpr char     const kAssetBlockMagic[4] = { 'S', 'H', 'B', 'C' };
+        static constexpr uint32_t const kAssetBlockSize     = (256u << 10u);
+
+        /**
+         * The SAssetBlockHeader struct is stored at the beginning of a block compressed payload.
+         */
+        struct SAssetBlockHeader
+        {
+        public_members:
+            char     magic[4];
+            uint8_t  codec;       // EAssetCodec
+            uint8_t  reserved0[3];
+            uint32_t blockSize;
+            uint32_t blockCount;
+            uint64_t size;        // Bytes after decompression.
+            uint64_t reserved1;
+        };
+        static_assert(32 == sizeof(SAssetBlockHeader), "SAssetBlockHeader must be 32 bytes.");
+
+        /**
+         * Determine the codec of a payload from its header.
+         *
+         * @param aData The payload.
+         * @param aSize The size of the payload.
+         * @return      The codec or EAssetCodec::None, if the payload is not block compressed.
+         */
+        SHIRABE_TEST_EXPORT EAssetCodec assetBlockCodec(uint8_t const *aData, uint64_t aSize);
+
+        /**
+         * Compress a payload block by block.
+         *
+         * @param aData      The payload.
+         * @param aSize      The size of the payload.
+         * @param aCodec     The codec to use. Must not be EAssetCodec::None.
+         * @param aBlockSize The number of uncompressed bytes per block.
+         * @return           The block compressed payload or an error.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<std::vector<uint8_t>> compressAssetBlocks(uint8_t     const *aData
+                                                                                    , uint64_t    const  aSize
+                                                                                    , EAssetCodec const  aCodec
+                                                                                    , uint32_t    const  aBlockSize = kAssetBlockSize);
+
+        /**
+         * Decompress a block compressed payload.
+         *
+         * If a job system is provided, blocks are decompressed in parallel on it. Waiting for the
+         * jobs helps out on the job system, so it is safe to call this from within a job.
+         *
+         * @param aSource    The block compressed payload.
+         * @param aJobSystem Optional job system to decompress on.
+         * @return           The decompressed payload or an error.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<ByteBuffer> decompressAssetBlocks(ByteBuffer                    const &aSource
+                                                                            , Shared<threading::CJobSystem> const &aJobSystem = nullptr);
+
+        /**
+         * Reads aLength bytes at aOffset of a stored payload.
+         */
+        using AssetRangeReader_t = std::function<CEngineResult<ByteBuffer>(uint64_t /* aOffset */, uint64_t /* aLength */)>;
+
+        /**
+         * Decompress a range of a block compressed payload, reading only the header, the table
+         * entries and the stored blocks covering the range.
+         *
+         * @param aReader Reads ranges of the stored payload.
+         * @param aOffset Offset of the range in the decompressed payload.
+         * @param aLength Length of the range. Clamped to the end of the payload.
+         * @return        The decompressed range or an error.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<ByteBuffer> decompressAssetBlockRange(AssetRangeReader_t const &aReader
+                                                                                , uint64_t           const  aOffset
+                                                                                , uint64_t           const  aLength);
+
+        /**
+         * The CAssetBlockReader class provides block wise access to a block compressed payload,
+         * so that it can be decompressed as a stream or in parallel.
+         */
+        class SHIRABE_TEST_EXPORT CAssetBlockReader
+        {
+            SHIRABE_DECLARE_LOG_TAG(CAssetBlockReader);
+
+        public_constructors:
+            /**
+             * @param aSource The block compressed payload. Must outlive the reader.
+             */
+            explicit CAssetBlockReader(ByteBuffer const &aSource);
+
+        public_methods:
+            /**
+             * Validate the header and block table of the payload.
+             *
+             * @return EEngineStatus::Ok, if the payload is valid. An error otherwise.
+             */
+            CEngineResult<> initialize();
+
+            /**
+             * Decompress block aIndex into aOutput.
+             *
+             * @param aIndex  The block to decompress.
+             * @param aOutput Receives blockDecompressedSize(aIndex) bytes.
+             * @return        EEngineStatus::Ok, if successful. An error otherwise.
+             */
+            CEngineResult<> decompressBlock(uint32_t aIndex, uint8_t *aOutput) const;
+
+            /**
+             * Return the number of bytes block aIndex decompresses to.
+             *
+             * @param aIndex The block.
+             * @return       See brief.
+             */
+            uint64_t blockDecompressedSize(uint32_t aIndex) const;
+
+            SHIRABE_INLINE EAssetCodec codec()      const { return static_cast<EAssetCodec>(mHeader.codec); }
+            SHIRABE_INLINE uint32_t    blockSize()  const { return mHeader.blockSize;                       }
+            SHIRABE_INLINE uint32_t    blockCount() const { return mHeader.blockCount;                      }
+            SHIRABE_INLINE uint64_t    size()       const { return mHeader.size;                            }
+
+        private_members:
+            ByteBuffer        const &mSource;
+            SAssetBlockHeader        mHeader;
+            uint64_t          const *mBlockOffsets;
+            uint8_t           const *mBlocks;
+        };
+    }
+}
+
+#endif
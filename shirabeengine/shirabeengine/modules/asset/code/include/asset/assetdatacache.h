@@ -0,0 +1,219 @@
+#ifndef __SHIRABE_ASSET_DATACACHE_H__
+#define __SHIRABE_ASSET_DATACACHE_H__
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+#include <core/databuffer.h>
+#include <log/log.h>
+
+#include "asset/assettypes.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        /**
+         * The SAssetDataCacheStatistics struct summarizes the state of a CAssetDataCache.
+         */
+        struct SAssetDataCacheStatistics
+        {
+        public_members:
+            uint64_t hits        = 0;
+            uint64_t misses      = 0;
+            uint64_t evictions   = 0;
+            uint64_t size        = 0; // Bytes cached.
+            uint64_t entryCount  = 0;
+            uint64_t pinnedCount = 0; // Cached entries, which can't be evicted.
+        };
+
+        /**
+         * The CAssetDataCache class keeps the data of recently loaded assets in memory, up to
+         * a byte budget. If full, the least recently used entries are evicted.
+         *
+         * The cache is split into shards with their own lock and LRU order, so that concurrent
+         * loads of different assets rarely contend. The budget is shared by all shards. Eviction
+         * picks the shard with the least recently used entry, so that the order is global.
+         *
+         * Pinned assets, e.g. ones which are actively streaming, are never evicted.
+         *
+         * Cached data is handed out as views sharing the cached memory, so that hits don't copy.
+         * Buffers handed out stay valid after eviction. All methods are thread safe.
+         */
+        class SHIRABE_TEST_EXPORT CAssetDataCache
+        {
+            SHIRABE_DECLARE_LOG_TAG(CAssetDataCache);
+
+        public_constructors:
+            /**
+             * @param aCapacity   The byte budget.
+             * @param aShardCount The number of shards. At least one.
+             */
+            explicit CAssetDataCache(uint64_t aCapacity, uint32_t aShardCount = 16);
+
+            CAssetDataCache(CAssetDataCache const &)            = delete;
+            CAssetDataCache &operator=(CAssetDataCache const &) = delete;
+
+        public_methods:
+            /**
+             * Store the data of aAssetId, replacing any previous data.
+             * Data larger than the capacity is not stored.
+             *
+             * @param aAssetId The asset the data belongs to.
+             * @param aData    The data to store. Owned data is copied, see share(...).
+             * @return         True, if the data was stored.
+             */
+            bool insert(AssetId_t const &aAssetId, ByteBuffer const &aData);
+
+            /**
+             * Look up the data of aAssetId and mark it as most recently used.
+             * Counts as a hit or a miss.
+             *
+             * @param aAssetId The asset to look up.
+             * @return         The data, if cached. EEngineStatus::Error otherwise.
+             */
+            CEngineResult<ByteBuffer> find(AssetId_t const &aAssetId);
+
+            /**
+             * Check, whether the data of aAssetId is cached, without touching it.
+             *
+             * @param aAssetId The asset to check.
+             * @return         See brief.
+             */
+            bool contains(AssetId_t const &aAssetId) const;
+
+            /**
+             * Drop the data of aAssetId, if cached, even if pinned. Pins remain.
+             *
+             * @param aAssetId The asset to drop.
+             */
+            void erase(AssetId_t const &aAssetId);
+
+            /**
+             * Drop all data. Pins remain.
+             */
+            void clear();
+
+            /**
+             * Exclude the data of aAssetId from eviction, until unpinned as often as pinned.
+             * Assets may be pinned before their data is inserted.
+             *
+             * @param aAssetId The asset to pin.
+             */
+            void pin(AssetId_t const &aAssetId);
+
+            /**
+             * Revert a previous pin of aAssetId.
+             *
+             * @param aAssetId The asset to unpin.
+             */
+            void unpin(AssetId_t const &aAssetId);
+
+            /**
+             * Change the byte budget, evicting data as required.
+             *
+             * @param aCapacity The new byte budget.
+             */
+            void setCapacity(uint64_t aCapacity);
+
+            /**
+             * Return the maximum number of bytes cached, if nothing is pinned.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint64_t capacity() const
+            {
+                return mCapacity.load();
+            }
+
+            /**
+             * Return the number of bytes cached.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint64_t size() const
+            {
+                return mSize.load();
+            }
+
+            /**
+             * Return the number of assets cached.
+             *
+             * @return See brief.
+             */
+            std::size_t entryCount() const;
+
+            /**
+             * Return the counters and the current occupation of the cache.
+             *
+             * @return See brief.
+             */
+            SAssetDataCacheStatistics statistics() const;
+
+        public_static_functions:
+            /**
+             * Move owned data behind a shared owner, so that it can be inserted without a copy
+             * and views of it stay valid after eviction. Views are returned as is.
+             *
+             * @param aData The data to share.
+             * @return      A view of the shared data.
+             */
+            static ByteBuffer share(ByteBuffer &&aData);
+
+        private_structs:
+            struct SEntry
+            {
+                ByteBuffer                     data;
+                bool                           pinned;
+                uint64_t                       lastUse;
+                std::list<AssetId_t>::iterator position; // Valid, if not pinned.
+            };
+
+            struct SShard
+            {
+                mutable std::mutex                      mutex;
+                std::list<AssetId_t>                    usage;   // Unpinned entries, most recently used first.
+                std::unordered_map<AssetId_t, SEntry>   entries;
+                std::unordered_map<AssetId_t, uint32_t> pins;
+            };
+
+        private_methods:
+            SHIRABE_INLINE SShard &shardFor(AssetId_t const &aAssetId) const
+            {
+                return *mShards[aAssetId % mShards.size()];
+            }
+
+            /**
+             * Remove aIterator from aShard. Requires the mutex of aShard to be held.
+             */
+            void remove(SShard &aShard, std::unordered_map<AssetId_t, SEntry>::iterator const &aIterator);
+
+            /**
+             * Mark aEntry of aShard as most recently used. Requires the mutex of aShard to be held.
+             */
+            void touch(SShard &aShard, SEntry &aEntry);
+
+            /**
+             * Evict least recently used entries, until the cache fits its capacity.
+             * Requires no shard mutex to be held.
+             */
+            void evictToCapacity();
+
+        private_members:
+            std::atomic<uint64_t>       mCapacity;
+            std::atomic<uint64_t>       mSize;
+            std::atomic<uint64_t>       mHits;
+            std::atomic<uint64_t>       mMisses;
+            std::atomic<uint64_t>       mEvictions;
+            std::atomic<uint64_t>       mClock; // Orders uses across shards.
+            std::vector<Unique<SShard>> mShards;
+        };
+    }
+}
+
+#endif
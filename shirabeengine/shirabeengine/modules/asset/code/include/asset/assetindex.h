@@ -1,7 +1,11 @@
 #ifndef __SHIRABE_ASSET_INDEX_H__
 #define __SHIRABE_ASSET_INDEX_H__
 
+#include <vector>
+
 #include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+#include <log/log.h>
 #include <util/documents/xml.h>
 
 #include "asset/assettypes.h"
@@ -11,6 +15,105 @@ namespace engine
 {
     namespace asset
     {
+        /*
+         * Layout of a binary asset index file (little endian):
+         *
+         *   [SAssetIndexHeader]                   at offset 0
+         *   [AssetId_t  x N]                      ids, sorted ascending
+         *   [AssetId_t  x N]                      parent ids
+         *   [uint8_t    x N]                      EAssetType
+         *   [uint8_t    x N]                      EAssetSubtype
+         *   [uint8_t    x N]                      EAssetCodec of the asset data
+         *   [padding]                             to a multiple of 4
+         *   [uint32_t   x N+1]                    uri offsets into the string table, N+1 for the end
+         *   [char       x stringTableSize]        uris, relative to the index directory, not terminated
+         *
+         * All columns are addressed in place. Loading is a single read and lookups are a
+         * binary search over the id column.
+         */
+
+        static constexpr char     const kAssetIndexMagic[8] = { 'S', 'H', 'R', 'B', 'I', 'N', 'D', 'X' };
+        static constexpr uint32_t const kAssetIndexVersion  = 2;
+
+        /**
+         * The SAssetIndexHeader struct is stored at the very beginning of a binary index file.
+         */
+        struct SAssetIndexHeader
+        {
+        public_members:
+            char     magic[8];
+            uint32_t version;
+            uint32_t assetCount;
+            uint64_t stringTableSize;
+            uint64_t reserved[5];
+        };
+        static_assert(64 == sizeof(SAssetIndexHeader), "SAssetIndexHeader must be 64 bytes.");
+
+        /**
+         * The CBinaryAssetIndex class provides read access to a binary asset index file without
+         * unpacking it into a registry.
+         */
+        class SHIRABE_TEST_EXPORT CBinaryAssetIndex
+        {
+            SHIRABE_DECLARE_LOG_TAG(CBinaryAssetIndex);
+
+        public_constructors:
+            CBinaryAssetIndex();
+
+        public_static_functions:
+            /**
+             * Load a binary index file written by writeBinaryIndex.
+             *
+             * @param aIndexPath The index file. Asset uris are resolved relative to its directory.
+             * @return           The index, if the file exists and is valid.
+             */
+            static CEngineResult<Shared<CBinaryAssetIndex>> load(std::filesystem::path const &aIndexPath);
+
+        public_methods:
+            /**
+             * Find an asset by id.
+             *
+             * @param aAssetId The id of the asset.
+             * @return         The asset with its composed uri, if found.
+             */
+            CEngineResult<SAsset> findAsset(AssetId_t const &aAssetId) const;
+
+            /**
+             * Return the asset at aIndex in id order.
+             *
+             * @param aIndex Index in [0, size()).
+             * @return       See brief.
+             */
+            SAsset assetAt(uint32_t aIndex) const;
+
+            /**
+             * Return the number of assets of the index.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint32_t size() const
+            {
+                return mAssetCount;
+            }
+
+        private_methods:
+            /**
+             * Return the uri at aIndex composed with the index directory.
+             */
+            std::filesystem::path uriAt(uint32_t aIndex) const;
+
+        private_members:
+            std::vector<uint8_t>   mData;
+            std::filesystem::path  mSourceDirectory;
+            uint32_t               mAssetCount;
+            AssetId_t      const  *mIds;
+            AssetId_t      const  *mParents;
+            uint8_t        const  *mTypes;
+            uint8_t        const  *mSubtypes;
+            uint8_t        const  *mCodecs;
+            uint32_t       const  *mUriOffsets;
+            char           const  *mStrings;
+        };
 
         /**
          * The CAssetIndex class describes an indexed set of assets by their UID, which is loaded from an
@@ -21,6 +124,15 @@ namespace engine
         public:
             SHIRABE_TEST_EXPORT static CAssetRegistry<SAsset> loadIndexById(std::filesystem::path const &aIndexPath);
             // static AssetRegistry<Asset> loadIndexFromServer(std::string const&filename);
+
+            /**
+             * Write a binary index file for aAssets.
+             *
+             * @param aIndexPath The index file to write. Overwritten, if existing.
+             * @param aAssets    The assets to index. Ids must be unique and uris relative to the index directory.
+             * @return           EEngineStatus::Ok, if successful. An error otherwise.
+             */
+            SHIRABE_TEST_EXPORT static CEngineResult<> writeBinaryIndex(std::filesystem::path const &aIndexPath, std::vector<SAsset> const &aAssets);
         };
 
     }
@@ -0,0 +1,116 @@
+#ifndef __SHIRABE_ASSET_ASSETPACK_H__
+#define __SHIRABE_ASSET_ASSETPACK_H__
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+
+#include "asset/assettypes.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        /*
+         * Layout of an asset pack file (little endian):
+         *
+         *   [SAssetPackHeader]                     at offset 0
+         *   [payload 0][padding] ... [payload N-1]  each starting at a multiple of alignment
+         *   [SAssetPackEntry x N][padding]          the TOC, sorted by id, starting at tocOffset
+         *
+         * Payloads are aligned to pages, so that they can be mapped and handed out in place.
+         * The TOC is written last, so that payloads can be streamed (and compressed) without
+         * knowing their stored sizes upfront.
+         */
+
+        static constexpr char     const kAssetPackMagic[8]  = { 'S', 'H', 'R', 'B', 'P', 'A', 'C', 'K' };
+        static constexpr uint32_t const kAssetPackVersion   = 1;
+        static constexpr uint64_t const kAssetPackAlignment = 4096;
+
+        /**
+         * Per-entry flags of an asset pack.
+         */
+        enum class EAssetPackEntryFlags
+            : uint16_t
+        {
+            None       = 0,
+            Compressed = 1, // The payload is block compressed with the entry's codec. See assetcompression.h.
+        };
+
+        /**
+         * The SAssetPackHeader struct is stored at the very beginning of a pack file.
+         */
+        struct SAssetPackHeader
+        {
+        public_members:
+            char     magic[8];
+            uint32_t version;
+            uint32_t entryCount;
+            uint64_t alignment;
+            uint64_t tocOffset;
+            uint64_t reserved[4];
+        };
+        static_assert(64 == sizeof(SAssetPackHeader), "SAssetPackHeader must be 64 bytes.");
+
+        /**
+         * The SAssetPackEntry struct describes a single payload of a pack file.
+         */
+        struct alignas(32) SAssetPackEntry
+        {
+        public_members:
+            AssetId_t id;
+            uint16_t  flags;      // EAssetPackEntryFlags
+            uint16_t  codec;      // EAssetCodec of the payload, if compressed.
+            uint64_t  offset;     // Absolute file offset of the payload.
+            uint64_t  storedSize; // Bytes stored in the pack.
+            uint64_t  size;       // Bytes after decompression.
+        };
+        static_assert(32 == sizeof(SAssetPackEntry), "SAssetPackEntry must be 32 bytes.");
+
+        /**
+         * Describes a file to be added to a pack.
+         */
+        struct SAssetPackSource
+        {
+        public_members:
+            AssetId_t             id;
+            std::filesystem::path path;
+            EAssetCodec           codec = EAssetCodec::None; // The codec the file is block compressed with.
+        };
+
+        /**
+         * Validate the header of a pack file.
+         *
+         * @param aHeader   The header to validate.
+         * @param aFileSize The size of the pack file.
+         * @return          True, if the header is valid and the TOC is within the file.
+         */
+        SHIRABE_TEST_EXPORT bool validateAssetPackHeader(SAssetPackHeader const &aHeader, uint64_t aFileSize);
+
+        /**
+         * Find the entry of aId in a TOC sorted by id.
+         *
+         * @param aEntries    The first entry of the TOC.
+         * @param aEntryCount The number of entries.
+         * @param aId         The asset id to find.
+         * @return            The entry or nullptr, if not found.
+         */
+        SHIRABE_TEST_EXPORT SAssetPackEntry const *findAssetPackEntry(SAssetPackEntry const *aEntries, uint32_t aEntryCount, AssetId_t aId);
+
+        /**
+         * Write a pack file containing aSources.
+         *
+         * Payloads are streamed from disk one by one, so that the pack can be larger than memory.
+         *
+         * @param aPackPath The pack file to write. Overwritten, if existing.
+         * @param aSources  The files to add. Ids must be unique.
+         * @return          EEngineStatus::Ok, if successful. An error otherwise.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<> writeAssetPack(std::filesystem::path const &aPackPath, std::vector<SAssetPackSource> const &aSources);
+    }
+}
+
+#endif
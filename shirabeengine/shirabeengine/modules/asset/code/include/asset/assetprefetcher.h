@@ -0,0 +1,102 @@
+#ifndef __SHIRABE_ASSET_PREFETCHER_H__
+#define __SHIRABE_ASSET_PREFETCHER_H__
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+#include <core/threading/jobsystem.h>
+#include <log/log.h>
+
+#include "asset/assettypes.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        class CAssetStorage;
+
+        /**
+         * Return the assets aAsset refers to, decoded from its data.
+         */
+        using AssetDependencyResolver_t = std::function<std::vector<AssetId_t>(SAsset const & /* aAsset */, ByteBuffer const & /* aData */)>;
+
+        /**
+         * The SAssetPrefetchStatistics struct summarizes a single prefetch.
+         */
+        struct SAssetPrefetchStatistics
+        {
+        public_members:
+            uint32_t waveCount   = 0; // Number of dependency levels read.
+            uint32_t readCount   = 0; // Number of assets read from the data source.
+            uint32_t cachedCount = 0; // Number of assets, which were cached already.
+            uint32_t failedCount = 0; // Number of assets, which could not be read.
+            uint64_t bytesRead   = 0;
+        };
+
+        /**
+         * The CAssetPrefetcher class loads the data of a set of root assets and everything they
+         * refer to into the data cache of an asset storage, ahead of time.
+         *
+         * Dependencies are found by resolvers registered per asset type, which decode the data of
+         * an asset, e.g. a material meta file referring to its signature. All assets of a dependency
+         * level are read as one batch, so that a graph is loaded in as many round trips as it is
+         * deep, instead of one round trip per asset.
+         */
+        class SHIRABE_TEST_EXPORT CAssetPrefetcher
+        {
+            SHIRABE_DECLARE_LOG_TAG(CAssetPrefetcher);
+
+        public_constructors:
+            /**
+             * @param aAssetStorage The storage to read from. Must have a data cache assigned.
+             */
+            explicit CAssetPrefetcher(Shared<CAssetStorage> aAssetStorage);
+
+        public_methods:
+            /**
+             * Register the resolver for the dependencies of all assets of aAssetType.
+             *
+             * @param aAssetType The asset type the resolver decodes.
+             * @param aResolver  The resolver.
+             */
+            void registerDependencyResolver(EAssetType const &aAssetType, AssetDependencyResolver_t aResolver);
+
+            /**
+             * Assign the job system to resolve dependencies on. Without, they are resolved on the
+             * thread completing the read, which holds up the completion of further reads.
+             *
+             * @param aJobSystem The job system to post resolution jobs to.
+             */
+            void setJobSystem(Shared<threading::CJobSystem> const &aJobSystem);
+
+            /**
+             * Load aRoots and all their transitive dependencies into the data cache.
+             * Blocks, until all reads have completed.
+             *
+             * Assets, which can't be read, are skipped together with their dependencies.
+             *
+             * @param aRoots The assets to start from.
+             * @return       Statistics of the prefetch. EEngineStatus::Error, if no data cache is assigned.
+             */
+            CEngineResult<SAssetPrefetchStatistics> prefetch(std::vector<AssetId_t> const &aRoots);
+
+        private_methods:
+            /**
+             * Resolve the dependencies of aAsset with the resolver registered for its type.
+             *
+             * @return The dependencies or an empty list, if no resolver is registered.
+             */
+            std::vector<AssetId_t> resolveDependencies(SAsset const &aAsset, ByteBuffer const &aData) const;
+
+        private_members:
+            Shared<CAssetStorage>                                      mAssetStorage;
+            std::unordered_map<EAssetType, AssetDependencyResolver_t> mResolvers;
+            Shared<threading::CJobSystem>                              mJobSystem;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef __SHIRABE_ASSET_READQUEUE_H__
+#define __SHIRABE_ASSET_READQUEUE_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <core/enginetypehelper.h>
+#include <core/enginestatus.h>
+#include <core/threading/looper.h>
+#include <log/log.h>
+
+#include "asset/iassetdatasource.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        /**
+         * The EAssetReadBackend enum describes, how a CAssetReadQueue performs its reads.
+         */
+        enum class EAssetReadBackend
+        {
+            None = 0,
+            IoUring,    // Linux io_uring. All reads of the queue are in flight at once.
+            ThreadPool, // Blocking pread calls on a pool of threads.
+        };
+
+        /**
+         * A single read of a CAssetReadQueue.
+         */
+        struct SAssetReadRequest
+        {
+        public_members:
+            std::filesystem::path path;
+            uint64_t              offset = 0;
+            uint64_t              length = kAssetReadToEnd; // Clamped to the end of the file.
+        };
+
+        /**
+         * The CAssetReadQueue class keeps many file reads in flight at once.
+         *
+         * On Linux, reads are submitted to an io_uring and completed by a single I/O thread.
+         * If io_uring is unavailable (old kernel or a sandbox denying it), or on other platforms,
+         * reads are performed by a pool of threads with pread. Both backends share the interface,
+         * so that callers can't tell them apart.
+         *
+         * Completion callbacks are invoked on the I/O thread. To handle completions on a specific
+         * thread, wrap the callback with deliverTo(...) to forward it to a looper.
+         */
+        class SHIRABE_TEST_EXPORT CAssetReadQueue
+        {
+            SHIRABE_DECLARE_LOG_TAG(CAssetReadQueue);
+
+        public_constructors:
+            CAssetReadQueue();
+
+            CAssetReadQueue(CAssetReadQueue const &)            = delete;
+            CAssetReadQueue &operator=(CAssetReadQueue const &) = delete;
+
+        public_destructors:
+            ~CAssetReadQueue();
+
+        public_methods:
+            /**
+             * Create the backend and start the I/O threads.
+             *
+             * @param aQueueDepth     The maximum number of reads in flight.
+             * @param aThreadCount    The number of threads of the thread pool backend.
+             * @param aPreferIoUring  Try io_uring first, where supported.
+             * @return                EEngineStatus::Ok, if successful. An error otherwise.
+             */
+            CEngineResult<> initialize(uint32_t aQueueDepth   = 64
+                                       , uint32_t aThreadCount  = 4
+                                       , bool     aPreferIoUring = true);
+
+            /**
+             * Stop the I/O threads. Pending reads are completed with an error.
+             */
+            void deinitialize();
+
+            /**
+             * Enqueue a read.
+             *
+             * @param aRequest  The read to perform.
+             * @param aCallback Optional callback invoked on completion, on the I/O thread.
+             * @return          A future receiving the read data.
+             */
+            AssetReadFuture_t submit(SAssetReadRequest const &aRequest, AssetReadCallback_t aCallback = {});
+
+            /**
+             * Enqueue multiple reads at once. All of them are in flight at the same time, up to
+             * the queue depth.
+             *
+             * @param aRequests The reads to perform.
+             * @param aCallback Optional callback invoked with the index and result of each read, on the I/O thread.
+             * @return          A future per request, in the order of aRequests.
+             */
+            std::vector<AssetReadFuture_t> submitBatch(std::vector<SAssetReadRequest> const &aRequests, AssetReadBatchCallback_t aCallback = {});
+
+            /**
+             * Return the backend chosen on initialize. Changes to EAssetReadBackend::ThreadPool,
+             * if the ring fails while running.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE EAssetReadBackend backend() const
+            {
+                return mBackend.load();
+            }
+
+            /**
+             * Wrap aFunction, so that it is run on the looper of aDispatcher with the read result.
+             *
+             * @tparam TTaskResult The task result type of the looper.
+             * @param aDispatcher  The dispatcher of the looper. Must outlive all reads.
+             * @param aFunction    The function to run on the looper.
+             * @return             A callback suitable for submit(...).
+             */
+            template <typename TTaskResult>
+            static AssetReadCallback_t deliverTo(typename threading::CLooper<TTaskResult>::CDispatcher &aDispatcher
+                                                 , std::function<TTaskResult(CEngineResult<ByteBuffer> const &)> aFunction)
+            {
+                return [&aDispatcher, aFunction] (CEngineResult<ByteBuffer> const &aResult) -> void
+                {
+                    std::function<TTaskResult()> fn = [aFunction, aResult] () -> TTaskResult
+                    {
+                        return aFunction(aResult);
+                    };
+
+                    typename threading::CLooper<TTaskResult>::TaskType task {};
+                    task.bind(fn);
+                    aDispatcher.post(std::move(task));
+                };
+            }
+
+        private_structs:
+            struct SPendingRead;
+            struct SIoUring;
+
+        private_methods:
+            void runIoUring();
+            void runThreadPoolWorker();
+
+            /**
+             * Open the file of aRead and size its buffer. Completes aRead on error.
+             *
+             * @return True, if the read can be performed.
+             */
+            static bool prepare(SPendingRead &aRead);
+
+            /**
+             * Complete aRead with aStatus, fulfilling its promise and invoking its callback.
+             */
+            static void complete(SPendingRead &aRead, EEngineStatus aStatus);
+
+        private_members:
+            std::atomic<EAssetReadBackend>   mBackend;
+            uint32_t                         mQueueDepth;
+            std::atomic<bool>                mAbortRequested;
+
+            std::mutex                       mRequestMutex;
+            std::condition_variable          mRequestCondition;
+            std::deque<Unique<SPendingRead>> mRequests;
+
+            Unique<SIoUring>                 mRing;
+            std::vector<std::thread>         mThreads;
+        };
+
+    }
+}
+
+#endif
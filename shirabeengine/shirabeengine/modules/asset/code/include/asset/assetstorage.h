@@ -3,15 +3,19 @@
 
 #include <core/enginetypehelper.h>
 #include <core/databuffer.h>
+#include <core/threading/jobsystem.h>
 
 #include "asset/iassetdatasource.h"
 #include "asset/asseterror.h"
+#include "asset/assetdatacache.h"
 #include "asset/assetregistry.h"
 
 namespace engine
 {
     namespace asset
     {
+        class CBinaryAssetIndex;
+
         /**
          * The IAssetStorage class describes the basic means of interaction with an asset storage.
          */
@@ -61,12 +65,24 @@ namespace engine
 
             /**
              * Load the byte data for a provided asset descriptor.
+             * Data stored compressed is returned decompressed.
              *
              * @param aAsset The asset descriptor for which byte data should be loaded.
              * @return       A filled byte buffer if successful. False otherwise.
              */
             virtual CEngineResult<ByteBuffer> loadAssetData(AssetId_t const &aAsset) = 0;
 
+            /**
+             * Load a range of the byte data for a provided asset descriptor, without loading the
+             * rest of the asset. Offset and length refer to the decompressed data.
+             *
+             * @param aAsset  The asset descriptor for which byte data should be loaded.
+             * @param aOffset The first byte to load.
+             * @param aLength The number of bytes to load. Clamped to the end of the data.
+             * @return        A filled byte buffer if successful. False otherwise.
+             */
+            virtual CEngineResult<ByteBuffer> loadAssetDataRange(AssetId_t const &aAsset, uint64_t aOffset, uint64_t aLength) = 0;
+
             /**
              * Unload this asset and remove it's data from the index.
              * Note: This won't delete the data from the hard disk.
@@ -83,6 +99,8 @@ namespace engine
         class SHIRABE_TEST_EXPORT CAssetStorage
                 : public IAssetStorage
         {
+            SHIRABE_DECLARE_LOG_TAG(CAssetStorage);
+
         public_typedefs:
             using AssetRegistry_t = CAssetRegistry<SAsset>;
 
@@ -97,6 +115,14 @@ namespace engine
              */
             void readIndex(AssetRegistry_t const &aIndex);
 
+            /**
+             * Use a binary asset index for lookups, without copying it into the registry.
+             * Assets added to the registry take precedence.
+             *
+             * @param aIndex
+             */
+            void readIndex(Shared<CBinaryAssetIndex> const &aIndex);
+
             /**
              * Determine an asset by Uid.
              *
@@ -140,6 +166,77 @@ namespace engine
              */
             CEngineResult<ByteBuffer> loadAssetData(AssetId_t const &aAsset) final;
 
+            /**
+             * Load a range of the byte data for a provided asset descriptor.
+             * For compressed data, only the blocks covering the range are read and decompressed.
+             *
+             * @param aAsset  The asset descriptor for which byte data should be loaded.
+             * @param aOffset The first byte to load.
+             * @param aLength The number of bytes to load. Clamped to the end of the data.
+             * @return        A filled byte buffer if successful. False otherwise.
+             */
+            CEngineResult<ByteBuffer> loadAssetDataRange(AssetId_t const &aAsset, uint64_t aOffset, uint64_t aLength) final;
+
+            /**
+             * Assign a cache, which is consulted before reading asset data from the data source.
+             * Complete reads of asset data populate the cache, ranged reads don't.
+             *
+             * @param aDataCache The cache to use or nullptr.
+             */
+            void setDataCache(Shared<CAssetDataCache> const &aDataCache);
+
+            /**
+             * Return the cache assigned with setDataCache.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE Shared<CAssetDataCache> const &dataCache() const
+            {
+                return mDataCache;
+            }
+
+            /**
+             * Exclude the cached data of an asset from eviction, e.g. while it is streaming.
+             * Pins are counted. No-op, if no data cache is assigned.
+             *
+             * @param aAssetUID The asset to pin.
+             */
+            void pinAssetData(AssetId_t const &aAssetUID);
+
+            /**
+             * Revert a previous pinAssetData(...).
+             *
+             * @param aAssetUID The asset to unpin.
+             */
+            void unpinAssetData(AssetId_t const &aAssetUID);
+
+            /**
+             * Assign the job system used to load asset data asynchronously.
+             *
+             * @param aJobSystem The job system to post load jobs to.
+             */
+            void setJobSystem(Shared<threading::CJobSystem> const &aJobSystem);
+
+            /**
+             * Load the byte data for a provided asset descriptor on the assigned job system.
+             * Multiple loads run in parallel on all workers of the job system.
+             *
+             * @param aAsset The asset descriptor for which byte data should be loaded.
+             * @return       A handle to wait for the byte buffer. Invalid, if no job system is assigned.
+             */
+            threading::CJobHandle<CEngineResult<ByteBuffer>> loadAssetDataAsync(AssetId_t const &aAsset);
+
+            /**
+             * Load the byte data of multiple assets at once. All reads are handed to the data source
+             * together, so that sources with asynchronous I/O keep them in flight at the same time.
+             * Data stored compressed is decompressed on the assigned job system, if any.
+             *
+             * @param aAssets   The asset descriptors for which byte data should be loaded.
+             * @param aCallback Optional callback invoked with the index and data of each asset, once available.
+             * @return          A future per asset, in the order of aAssets.
+             */
+            std::vector<AssetReadFuture_t> loadAssetDataBatch(std::vector<AssetId_t> const &aAssets, AssetReadBatchCallback_t aCallback = {});
+
             /**
              * Unload this asset and remove it's data from the index.
              * Note: This won't delete the data from the hard disk.
@@ -149,9 +246,40 @@ namespace engine
              */
             CEngineResult<> removeAsset(AssetId_t const &aAssetUID) final;
 
+        private_methods:
+            /**
+             * Find an asset in the registry or, if not registered, in the binary index.
+             *
+             * @param aAssetUID The UID of the asset to find.
+             * @return          The asset, if found.
+             */
+            CEngineResult<SAsset> findAsset(AssetId_t const &aAssetUID);
+
+            /**
+             * Read asset data from the data source and decompress it, if stored compressed.
+             *
+             * @param aUri   The uri of the asset data.
+             * @param aCodec The codec the data is stored with.
+             * @return       The decompressed data, if successful.
+             */
+            CEngineResult<ByteBuffer> readAssetData(std::filesystem::path const &aUri, EAssetCodec const &aCodec);
+
+            /**
+             * Look up asset data in the data cache, if any, or read it and insert it into the cache.
+             *
+             * @param aAssetUID The asset to load.
+             * @param aUri      The uri of the asset data.
+             * @param aCodec    The codec the data is stored with.
+             * @return          The decompressed data, if successful.
+             */
+            CEngineResult<ByteBuffer> fetchAssetData(AssetId_t const &aAssetUID, std::filesystem::path const &aUri, EAssetCodec const &aCodec);
+
         private_members:
             AssetRegistry_t                   mAssetIndex;
-            Unique<IAssetDataSource> mAssetDataSource;
+            Shared<CBinaryAssetIndex>         mBinaryAssetIndex;
+            Unique<IAssetDataSource>          mAssetDataSource;
+            Shared<threading::CJobSystem>     mJobSystem;
+            Shared<CAssetDataCache>           mDataCache;
         };        
 
     }
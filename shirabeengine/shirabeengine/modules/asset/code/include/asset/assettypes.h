@@ -58,6 +58,17 @@ namespace engine
             IndexBuffer,
             DataFile
         };
+
+        /**
+         * The EAssetCodec enum describes, how the data of an asset is compressed.
+         */
+        enum class EAssetCodec
+            : uint8_t
+        {
+            None = 0,
+            LZ4  = 1,
+            Zstd = 2,
+        };
         
         /**
          * The SAsset struct is the common descriptor for an engine asset.
@@ -69,6 +80,7 @@ namespace engine
             AssetId_t             parent;
             EAssetType            type;
             EAssetSubtype         subtype;
+            EAssetCodec           codec;
             std::filesystem::path uri;
         };
 
@@ -142,6 +154,16 @@ namespace engine
             std::string name;
         };
 
+        /**
+         * The SAssetDataRange struct describes a byte range of the (decompressed) data of an asset.
+         */
+        struct SAssetDataRange
+        {
+        public_members:
+            uint64_t offset;
+            uint64_t length;
+        };
+
         /**
          * The SImage struct describes a raw image resource.
          */
@@ -201,6 +223,15 @@ namespace engine
      */
     template <> asset::EAssetSubtype from_string<asset::EAssetSubtype>(std::string const &aInput);
 
+    /**
+     * Extract an EAssetCodec from string.
+     *
+     * @param aInput Input string.
+     * @return       A EAssetCodec representation of the input string.
+     *               If not matched, EAssetCodec::None is returned.
+     */
+    template <> asset::EAssetCodec from_string<asset::EAssetCodec>(std::string const &aInput);
+
     /**
      * Extract an EAssetType from string.
      *
@@ -218,6 +249,14 @@ namespace engine
      *               If not matched, EAssetType::Undefined is returned.
      */
     template <> std::string convert_to_string<asset::EAssetSubtype>(asset::EAssetSubtype const &aInput);
+
+    /**
+     * Convert an EAssetCodec to string.
+     *
+     * @param aInput Input codec.
+     * @return       A EAssetCodec string representation.
+     */
+    template <> std::string convert_to_string<asset::EAssetCodec>(asset::EAssetCodec const &aInput);
 }
 
 #endif
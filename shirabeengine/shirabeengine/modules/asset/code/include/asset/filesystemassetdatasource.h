@@ -1,18 +1,35 @@
 #ifndef __SHIRABE_ASSET_FILESYSTEMASSETDATASOURCE_H__
 #define __SHIRABE_ASSET_FILESYSTEMASSETDATASOURCE_H__
 
+#include <mutex>
+#include <log/log.h>
 #include "iassetdatasource.h"
+#include "assetreadqueue.h"
 
 namespace engine
 {
     namespace asset
     {
 
+        /**
+         * Reads assets from the file system.
+         *
+         * Where supported, files are memory mapped and returned as read-only ByteBuffer views of
+         * the mapping, so that no heap copy of the file is made. Mappings are kept open across
+         * reads and shared by all buffers referring to them. A mapping is released, once it was
+         * dropped from the cache and no buffer refers to it anymore.
+         */
         class CFileSystemAssetDataSource
                 : public IAssetDataSource
         {
+            SHIRABE_DECLARE_LOG_TAG(CFileSystemAssetDataSource);
+
         public_constructors:
-            CFileSystemAssetDataSource(std::filesystem::path const &aAssetSourcePath);
+            /**
+             * @param aAssetSourcePath   The asset root directory.
+             * @param aUseMemoryMapping  Map files instead of reading them into the heap.
+             */
+            CFileSystemAssetDataSource(std::filesystem::path const &aAssetSourcePath, bool aUseMemoryMapping = true);
 
         public_destructors:
             ~CFileSystemAssetDataSource() = default;
@@ -22,8 +39,61 @@ namespace engine
 
             CEngineResult<> writeAsset(std::filesystem::path const &aPath, ByteBuffer const &aBuffer);
 
+            /**
+             * Read a range of an asset. Mapped files return a view of the range without touching
+             * the rest of the file.
+             */
+            CEngineResult<ByteBuffer> readAssetRange(std::filesystem::path const &aPath, uint64_t aOffset, uint64_t aLength) override;
+
+            /**
+             * Read an asset through the assigned read queue.
+             * Without a read queue, the asset is read synchronously.
+             */
+            AssetReadFuture_t readAssetAsync(std::filesystem::path const &aPath, AssetReadCallback_t aCallback = {}) override;
+
+            /**
+             * Submit all reads to the assigned read queue at once, so that they are in flight together.
+             * Without a read queue, the assets are read synchronously.
+             */
+            std::vector<AssetReadFuture_t> readAssetsBatch(std::vector<std::filesystem::path> const &aPaths, AssetReadBatchCallback_t aCallback = {}) override;
+
+            /**
+             * Assign the queue used for asynchronous reads.
+             *
+             * @param aReadQueue An initialized read queue or nullptr to read synchronously.
+             */
+            void setReadQueue(Shared<CAssetReadQueue> const &aReadQueue);
+
+            /**
+             * Drop all cached mappings. Buffers still referring to a mapping keep it alive.
+             */
+            void releaseMappings();
+
+            /**
+             * Return the number of bytes of all cached mappings.
+             *
+             * @return See brief.
+             */
+            uint64_t mappedByteCount() const;
+
+        private_structs:
+            struct SFileMapping;
+
+        private_methods:
+            /**
+             * Fetch the cached mapping of aPath or map the file.
+             *
+             * @param aPath The file to map.
+             * @return      The mapping or nullptr, if the file could not be mapped.
+             */
+            Shared<SFileMapping> fetchMapping(std::filesystem::path const &aPath);
+
         private_members:
-            std::filesystem::path mAssetSourcePath;
+            std::filesystem::path                     mAssetSourcePath;
+            bool                                      mUseMemoryMapping;
+            Shared<CAssetReadQueue>                   mReadQueue;
+            mutable std::mutex                        mMappingMutex;
+            Map<std::string, Shared<SFileMapping>>    mMappings;
         };
 
     }
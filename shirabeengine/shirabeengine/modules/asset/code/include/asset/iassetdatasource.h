@@ -1,6 +1,11 @@
 #ifndef __SHIRABE_ASSET_IASSETDATASOURCE_H__
 #define __SHIRABE_ASSET_IASSETDATASOURCE_H__
 
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <vector>
+
 #include <core/enginetypehelper.h>
 #include <core/enginestatus.h>
 
@@ -10,6 +15,15 @@ namespace engine
 {
     namespace asset
     {
+        /**
+         * Length of a read, which extends to the end of the file.
+         */
+        static constexpr uint64_t const kAssetReadToEnd = ~0ull;
+
+        using AssetReadFuture_t   = std::shared_future<CEngineResult<ByteBuffer>>;
+        using AssetReadCallback_t = std::function<void(CEngineResult<ByteBuffer> const &)>;
+        // Invoked with the index of the read within its batch.
+        using AssetReadBatchCallback_t = std::function<void(std::size_t, CEngineResult<ByteBuffer> const &)>;
 
         class IAssetDataSource
         {
@@ -31,6 +45,77 @@ namespace engine
              */
             virtual CEngineResult<> writeAsset(std::filesystem::path const &aPath, ByteBuffer const &aBuffer) = 0;
 
+            /**
+             * Read aLength bytes at aOffset of an asset.
+             * Sources without ranged access read the whole asset and copy the range.
+             *
+             * @param aPath   The asset to read.
+             * @param aOffset The first byte to read.
+             * @param aLength The number of bytes to read. Clamped to the end of the asset.
+             * @return        The range, if aOffset is within the asset. An error otherwise.
+             */
+            virtual CEngineResult<ByteBuffer> readAssetRange(std::filesystem::path const &aPath, uint64_t aOffset, uint64_t aLength)
+            {
+                CEngineResult<ByteBuffer> const read = readAsset(aPath);
+                if(not read.successful() || read.data().size() < aOffset)
+                {
+                    return { EEngineStatus::Error };
+                }
+
+                uint64_t const length = std::min(aLength, (read.data().size() - aOffset));
+
+                // Copy, since views of heap buffers don't keep them alive.
+                std::vector<uint8_t> range(read.data().data() + aOffset, read.data().data() + aOffset + length);
+                return { EEngineStatus::Ok, ByteBuffer(std::move(range), length) };
+            }
+
+            /**
+             * Read an asset without blocking the caller.
+             * Sources without asynchronous I/O read synchronously and return a ready future.
+             *
+             * @param aPath     The asset to read.
+             * @param aCallback Optional callback invoked with the result, once the read completed.
+             * @return          A future receiving the result.
+             */
+            virtual AssetReadFuture_t readAssetAsync(std::filesystem::path const &aPath, AssetReadCallback_t aCallback = {})
+            {
+                std::promise<CEngineResult<ByteBuffer>> promise {};
+                AssetReadFuture_t future = promise.get_future().share();
+
+                CEngineResult<ByteBuffer> result = readAsset(aPath);
+                if(aCallback)
+                {
+                    aCallback(result);
+                }
+                promise.set_value(std::move(result));
+
+                return future;
+            }
+
+            /**
+             * Read multiple assets at once. Sources with asynchronous I/O keep all reads in flight
+             * at the same time.
+             *
+             * @param aPaths    The assets to read.
+             * @param aCallback Optional callback invoked with the index and result of each read, once it completed.
+             * @return          A future per asset, in the order of aPaths.
+             */
+            virtual std::vector<AssetReadFuture_t> readAssetsBatch(std::vector<std::filesystem::path> const &aPaths, AssetReadBatchCallback_t aCallback = {})
+            {
+                std::vector<AssetReadFuture_t> futures {};
+                futures.reserve(aPaths.size());
+                for(std::size_t k=0; k<aPaths.size(); ++k)
+                {
+                    AssetReadCallback_t callback {};
+                    if(aCallback)
+                    {
+                        callback = [aCallback, k] (CEngineResult<ByteBuffer> const &aResult) -> void { aCallback(k, aResult); };
+                    }
+                    futures.push_back(readAssetAsync(aPaths[k], std::move(callback)));
+                }
+                return futures;
+            }
+
         };
 
     }
@@ -0,0 +1,117 @@
+#ifndef __SHIRABE_ASSET_PACKASSETDATASOURCE_H__
+#define __SHIRABE_ASSET_PACKASSETDATASOURCE_H__
+
+#include <fstream>
+#include <mutex>
+#include <log/log.h>
+#include "iassetdatasource.h"
+#include "asset/assetpack.h"
+
+namespace engine
+{
+    namespace asset
+    {
+
+        /**
+         * Reads assets from a single asset pack file written by writeAssetPack.
+         *
+         * Asset paths are resolved to asset ids relative to the asset root directory, the same way
+         * the resource compiler derives them. Where supported, the pack is mapped once and assets are
+         * returned as read-only ByteBuffer views of the mapping. Otherwise, the pack is kept open and
+         * payloads are read with a single seek and read each.
+         */
+        class SHIRABE_TEST_EXPORT CPackAssetDataSource
+                : public IAssetDataSource
+        {
+            SHIRABE_DECLARE_LOG_TAG(CPackAssetDataSource);
+
+        public_constructors:
+            /**
+             * @param aPackPath         The pack file to read from.
+             * @param aAssetSourcePath  The asset root directory, which asset paths are relative to.
+             */
+            CPackAssetDataSource(std::filesystem::path const &aPackPath, std::filesystem::path const &aAssetSourcePath);
+
+        public_destructors:
+            ~CPackAssetDataSource();
+
+        public_methods:
+            /**
+             * Open the pack and read its table of contents.
+             *
+             * @return EEngineStatus::Ok, if successful. An error otherwise.
+             */
+            CEngineResult<> initialize();
+
+            /**
+             * Close the pack. Buffers still referring to the mapping keep it alive.
+             *
+             * @return EEngineStatus::Ok.
+             */
+            CEngineResult<> deinitialize();
+
+            CEngineResult<ByteBuffer> readAsset(std::filesystem::path const &aPath);
+
+            CEngineResult<> writeAsset(std::filesystem::path const &aPath, ByteBuffer const &aBuffer);
+
+            /**
+             * Read a range of the stored payload of an asset. Returns a view of the mapping, if mapped.
+             */
+            CEngineResult<ByteBuffer> readAssetRange(std::filesystem::path const &aPath, uint64_t aOffset, uint64_t aLength) override;
+
+            /**
+             * Read an asset by id.
+             *
+             * @param aAssetId The id of the asset.
+             * @return         The payload, if found.
+             */
+            CEngineResult<ByteBuffer> readAssetById(AssetId_t const &aAssetId);
+
+            /**
+             * Return the number of entries of the pack.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint32_t entryCount() const
+            {
+                return mEntryCount;
+            }
+
+        private_structs:
+            struct SPackMapping;
+
+        private_methods:
+            /**
+             * Look up the TOC entry of an asset.
+             *
+             * @param aAssetId The id of the asset.
+             * @return         A copy of the entry, if found. EEngineStatus::FileNotFound otherwise.
+             */
+            CEngineResult<SAssetPackEntry> findEntry(AssetId_t const &aAssetId);
+
+            /**
+             * Return a range of the payload of aEntry.
+             *
+             * @param aEntry  The TOC entry.
+             * @param aOffset The first byte of the payload to return.
+             * @param aLength The number of bytes. Clamped to the end of the payload.
+             * @return        The range or an error.
+             */
+            CEngineResult<ByteBuffer> readEntry(SAssetPackEntry const &aEntry, uint64_t aOffset, uint64_t aLength);
+
+        private_members:
+            std::filesystem::path         mPackPath;
+            std::filesystem::path         mAssetSourcePath;
+            Shared<SPackMapping>          mMapping;
+            SAssetPackEntry       const  *mEntries;
+            uint32_t                      mEntryCount;
+
+            std::vector<SAssetPackEntry>  mEntryStorage; // The TOC, if not mapped.
+            std::mutex                    mMutex;        // Guards the TOC, the mapping and the stream.
+            std::ifstream                 mStream;       // The pack, if not mapped.
+        };
+
+    }
+}
+
+#endif // __SHIRABE_ASSET_PACKASSETDATASOURCE_H__
@@ -0,0 +1,461 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#include <lz4.h>
+#include <lz4hc.h>
+#include <zstd.h>
+
+#include "asset/assetcompression.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        SHIRABE_DECLARE_LOG_TAG(AssetCompression);
+
+        // Offline compression favours ratio. Decompression speed does not depend on the level.
+        static constexpr int const kLZ4HCLevel = LZ4HC_CLEVEL_DEFAULT;
+        static constexpr int const kZstdLevel  = 12;
+
+        /**
+         * Decode a single stored block. Raw blocks are copied.
+         *
+         * @return True, if the block decoded to exactly aDecompressedSize bytes.
+         */
+        static bool decodeBlock(EAssetCodec const  aCodec
+                                , uint8_t  const *aBlock
+                                , uint64_t const  aStoredSize
+                                , uint8_t        *aOutput
+                                , uint64_t const  aDecompressedSize)
+        {
+            if(aStoredSize == aDecompressedSize)
+            {
+                std::memcpy(aOutput, aBlock, aDecompressedSize);
+                return true;
+            }
+
+            switch(aCodec)
+            {
+            case EAssetCodec::LZ4:
+                {
+                    int const result = LZ4_decompress_safe(reinterpret_cast<char const *>(aBlock)
+                                                           , reinterpret_cast<char *>(aOutput)
+                                                           , static_cast<int>(aStoredSize)
+                                                           , static_cast<int>(aDecompressedSize));
+                    return (static_cast<int64_t>(aDecompressedSize) == result);
+                }
+            case EAssetCodec::Zstd:
+                {
+                    std::size_t const result = ZSTD_decompress(aOutput, aDecompressedSize, aBlock, aStoredSize);
+                    return (not ZSTD_isError(result) && aDecompressedSize == result);
+                }
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * Check the header fields, which don't depend on the payload size.
+         *
+         * @return True, if the header is consistent.
+         */
+        static bool validateBlockHeader(SAssetBlockHeader const &aHeader)
+        {
+            return (0 == std::memcmp(aHeader.magic, kAssetBlockMagic, sizeof(kAssetBlockMagic))
+                    && (EAssetCodec::LZ4 == static_cast<EAssetCodec>(aHeader.codec) || EAssetCodec::Zstd == static_cast<EAssetCodec>(aHeader.codec))
+                    && 0 != aHeader.blockSize
+                    && (static_cast<uint64_t>(aHeader.blockCount) * aHeader.blockSize) >= aHeader.size
+                    && (0 == aHeader.blockCount || ((static_cast<uint64_t>(aHeader.blockCount) - 1) * aHeader.blockSize) < aHeader.size));
+        }
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        EAssetCodec assetBlockCodec(uint8_t const *aData, uint64_t aSize)
+        {
+            if(nullptr == aData || sizeof(SAssetBlockHeader) > aSize)
+            {
+                return EAssetCodec::None;
+            }
+
+            SAssetBlockHeader header {};
+            std::memcpy(&header, aData, sizeof(header));
+            if(0 != std::memcmp(header.magic, kAssetBlockMagic, sizeof(kAssetBlockMagic)))
+            {
+                return EAssetCodec::None;
+            }
+
+            return static_cast<EAssetCodec>(header.codec);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<std::vector<uint8_t>> compressAssetBlocks(uint8_t     const *aData
+                                                                , uint64_t    const  aSize
+                                                                , EAssetCodec const  aCodec
+                                                                , uint32_t    const  aBlockSize)
+        {
+            if(EAssetCodec::LZ4 != aCodec && EAssetCodec::Zstd != aCodec)
+            {
+                CLog::Error(logTag(), "Unsupported codec {}.", static_cast<uint32_t>(aCodec));
+                return { EEngineStatus::Error };
+            }
+
+            // LZ4 addresses blocks with int sizes.
+            if(0 == aBlockSize || static_cast<uint32_t>(LZ4_MAX_INPUT_SIZE) < aBlockSize)
+            {
+                CLog::Error(logTag(), "Invalid block size {}.", aBlockSize);
+                return { EEngineStatus::Error };
+            }
+
+            uint64_t const blockCount = ((aSize + aBlockSize - 1) / aBlockSize);
+            if(std::numeric_limits<uint32_t>::max() < blockCount)
+            {
+                CLog::Error(logTag(), "Payload of {} bytes exceeds the block limit.", aSize);
+                return { EEngineStatus::Error };
+            }
+
+            SAssetBlockHeader header {};
+            std::memcpy(header.magic, kAssetBlockMagic, sizeof(kAssetBlockMagic));
+            header.codec      = static_cast<uint8_t>(aCodec);
+            header.blockSize  = aBlockSize;
+            header.blockCount = static_cast<uint32_t>(blockCount);
+            header.size       = aSize;
+
+            uint64_t const tableSize = ((blockCount + 1) * sizeof(uint64_t));
+
+            std::vector<uint8_t> output(sizeof(SAssetBlockHeader) + tableSize);
+            std::memcpy(output.data(), &header, sizeof(header));
+
+            std::vector<uint64_t> offsets(blockCount + 1, 0);
+            std::vector<uint8_t>  scratch(std::max<uint64_t>(LZ4_compressBound(static_cast<int>(aBlockSize)), ZSTD_compressBound(aBlockSize)));
+
+            for(uint64_t k=0; k<blockCount; ++k)
+            {
+                uint8_t  const *const block     = (aData + (k * aBlockSize));
+                uint64_t const        blockSize = std::min<uint64_t>(aBlockSize, (aSize - (k * aBlockSize)));
+
+                uint64_t compressedSize = 0;
+                if(EAssetCodec::LZ4 == aCodec)
+                {
+                    int const result = LZ4_compress_HC(reinterpret_cast<char const *>(block)
+                                                       , reinterpret_cast<char *>(scratch.data())
+                                                       , static_cast<int>(blockSize)
+                                                       , static_cast<int>(scratch.size())
+                                                       , kLZ4HCLevel);
+                    compressedSize = (0 < result) ? static_cast<uint64_t>(result) : 0;
+                }
+                else
+                {
+                    std::size_t const result = ZSTD_compress(scratch.data(), scratch.size(), block, blockSize, kZstdLevel);
+                    compressedSize = ZSTD_isError(result) ? 0 : result;
+                }
+
+                offsets[k] = (output.size() - sizeof(SAssetBlockHeader) - tableSize);
+
+                // Store incompressible blocks raw. See the layout notes.
+                if(0 == compressedSize || blockSize <= compressedSize)
+                {
+                    output.insert(output.end(), block, (block + blockSize));
+                }
+                else
+                {
+                    output.insert(output.end(), scratch.data(), (scratch.data() + compressedSize));
+                }
+            }
+            offsets[blockCount] = (output.size() - sizeof(SAssetBlockHeader) - tableSize);
+
+            std::memcpy(output.data() + sizeof(SAssetBlockHeader), offsets.data(), tableSize);
+
+            return { EEngineStatus::Ok, std::move(output) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> decompressAssetBlocks(ByteBuffer                    const &aSource
+                                                        , Shared<threading::CJobSystem> const &aJobSystem)
+        {
+            CAssetBlockReader reader(aSource);
+            if(not reader.initialize().successful())
+            {
+                return { EEngineStatus::Error };
+            }
+
+            std::vector<uint8_t> output(reader.size());
+
+            uint32_t const blockCount = reader.blockCount();
+            uint64_t const blockSize  = reader.blockSize();
+
+            if(nullptr == aJobSystem || 1 >= blockCount)
+            {
+                for(uint32_t k=0; k<blockCount; ++k)
+                {
+                    if(not reader.decompressBlock(k, output.data() + (k * blockSize)).successful())
+                    {
+                        return { EEngineStatus::Error };
+                    }
+                }
+            }
+            else
+            {
+                // Blocks are handed out by an atomic counter, so that each job keeps decoding
+                // until all blocks are taken, instead of paying one post per block.
+                std::atomic<uint32_t> nextBlock = 0;
+                std::atomic<bool>     failed    = false;
+
+                auto const decode = [&] () -> void
+                {
+                    for(uint32_t k = nextBlock.fetch_add(1); k < blockCount; k = nextBlock.fetch_add(1))
+                    {
+                        if(not reader.decompressBlock(k, output.data() + (k * blockSize)).successful())
+                        {
+                            failed.store(true);
+                        }
+                    }
+                };
+
+                uint32_t const jobCount = std::min<uint32_t>(aJobSystem->workerCount(), (blockCount - 1));
+
+                std::vector<threading::CJobHandle<void>> jobs {};
+                jobs.reserve(jobCount);
+                for(uint32_t k=0; k<jobCount; ++k)
+                {
+                    jobs.push_back(aJobSystem->post<void>(decode));
+                }
+
+                // The calling thread takes part as well.
+                decode();
+
+                for(threading::CJobHandle<void> const &job : jobs)
+                {
+                    if(job.valid())
+                    {
+                        job.wait();
+                    }
+                }
+
+                if(failed.load())
+                {
+                    return { EEngineStatus::Error };
+                }
+            }
+
+            uint64_t const size = output.size();
+            ByteBuffer buffer(std::move(output), size);
+
+            return { EEngineStatus::Ok, std::move(buffer) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> decompressAssetBlockRange(AssetRangeReader_t const &aReader
+                                                            , uint64_t           const  aOffset
+                                                            , uint64_t           const  aLength)
+        {
+            CEngineResult<ByteBuffer> const headerRead = aReader(0, sizeof(SAssetBlockHeader));
+            if(not headerRead.successful() || sizeof(SAssetBlockHeader) != headerRead.data().size())
+            {
+                CLog::Error(logTag(), "Failed to read the block header.");
+                return { EEngineStatus::Error };
+            }
+
+            SAssetBlockHeader header {};
+            std::memcpy(&header, headerRead.data().data(), sizeof(header));
+            if(not validateBlockHeader(header))
+            {
+                CLog::Error(logTag(), "Block header is invalid.");
+                return { EEngineStatus::Error };
+            }
+
+            if(header.size < aOffset)
+            {
+                CLog::Error(logTag(), "Range offset {} exceeds the payload of {} bytes.", aOffset, header.size);
+                return { EEngineStatus::Error };
+            }
+
+            uint64_t const length = std::min(aLength, (header.size - aOffset));
+            if(0 == length)
+            {
+                return { EEngineStatus::Ok, ByteBuffer() };
+            }
+
+            uint64_t const blockSize  = header.blockSize;
+            uint32_t const firstBlock = static_cast<uint32_t>(aOffset / blockSize);
+            uint32_t const lastBlock  = static_cast<uint32_t>((aOffset + length - 1) / blockSize);
+
+            // Only the table entries of the covered blocks are read.
+            uint64_t const tableOffset = (sizeof(SAssetBlockHeader) + (static_cast<uint64_t>(firstBlock) * sizeof(uint64_t)));
+            uint64_t const entryCount  = (static_cast<uint64_t>(lastBlock - firstBlock) + 2);
+
+            CEngineResult<ByteBuffer> const tableRead = aReader(tableOffset, (entryCount * sizeof(uint64_t)));
+            if(not tableRead.successful() || (entryCount * sizeof(uint64_t)) != tableRead.data().size())
+            {
+                CLog::Error(logTag(), "Failed to read the block table.");
+                return { EEngineStatus::Error };
+            }
+
+            std::vector<uint64_t> offsets(entryCount);
+            std::memcpy(offsets.data(), tableRead.data().data(), (entryCount * sizeof(uint64_t)));
+            for(uint64_t k=0; k<(entryCount - 1); ++k)
+            {
+                if(offsets[k] > offsets[k + 1])
+                {
+                    CLog::Error(logTag(), "Block table is invalid.");
+                    return { EEngineStatus::Error };
+                }
+            }
+
+            // The covered blocks are stored contiguously and read at once.
+            uint64_t const blocksOffset = (sizeof(SAssetBlockHeader) + ((static_cast<uint64_t>(header.blockCount) + 1) * sizeof(uint64_t)));
+            uint64_t const storedSize   = (offsets[entryCount - 1] - offsets[0]);
+
+            CEngineResult<ByteBuffer> const blocksRead = aReader((blocksOffset + offsets[0]), storedSize);
+            if(not blocksRead.successful() || storedSize != blocksRead.data().size())
+            {
+                CLog::Error(logTag(), "Failed to read the blocks {} to {}.", firstBlock, lastBlock);
+                return { EEngineStatus::Error };
+            }
+
+            EAssetCodec const codec = static_cast<EAssetCodec>(header.codec);
+
+            std::vector<uint8_t> output(length);
+            std::vector<uint8_t> window {};
+
+            for(uint32_t k=firstBlock; k<=lastBlock; ++k)
+            {
+                uint64_t const blockStart       = (static_cast<uint64_t>(k) * blockSize);
+                uint64_t const decompressedSize = std::min(blockSize, (header.size - blockStart));
+
+                uint8_t  const *const block          = (blocksRead.data().data() + (offsets[k - firstBlock] - offsets[0]));
+                uint64_t const        blockStoredSize = (offsets[k - firstBlock + 1] - offsets[k - firstBlock]);
+
+                uint64_t const begin = std::max(aOffset, blockStart);
+                uint64_t const end   = std::min((aOffset + length), (blockStart + decompressedSize));
+
+                // Blocks covered entirely are decoded in place. Partially covered ones at the
+                // borders of the range go through a window.
+                bool const covered = (begin == blockStart && end == (blockStart + decompressedSize));
+                if(not covered)
+                {
+                    window.resize(decompressedSize);
+                }
+
+                uint8_t *const target = covered ? (output.data() + (blockStart - aOffset)) : window.data();
+                if(not decodeBlock(codec, block, blockStoredSize, target, decompressedSize))
+                {
+                    CLog::Error(logTag(), "Failed to decompress block {} with codec {}.", k, convert_to_string<EAssetCodec>(codec));
+                    return { EEngineStatus::Error };
+                }
+
+                if(not covered)
+                {
+                    std::memcpy(output.data() + (begin - aOffset), window.data() + (begin - blockStart), (end - begin));
+                }
+            }
+
+            ByteBuffer buffer(std::move(output), length);
+            return { EEngineStatus::Ok, std::move(buffer) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CAssetBlockReader::CAssetBlockReader(ByteBuffer const &aSource)
+            : mSource      (aSource)
+            , mHeader      ()
+            , mBlockOffsets(nullptr)
+            , mBlocks      (nullptr)
+        { }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CAssetBlockReader::initialize()
+        {
+            uint8_t  const *const data = mSource.data();
+            uint64_t const        size = mSource.size();
+
+            if(EAssetCodec::None == assetBlockCodec(data, size))
+            {
+                CLog::Error(logTag(), "Payload is not block compressed.");
+                return { EEngineStatus::Error };
+            }
+
+            std::memcpy(&mHeader, data, sizeof(mHeader));
+
+            uint64_t const tableSize = ((static_cast<uint64_t>(mHeader.blockCount) + 1) * sizeof(uint64_t));
+            if(not validateBlockHeader(mHeader) || (size - sizeof(SAssetBlockHeader)) < tableSize)
+            {
+                CLog::Error(logTag(), "Block header is invalid.");
+                return { EEngineStatus::Error };
+            }
+
+            // The table directly follows the 32 byte header and is 8 byte aligned, if the payload is.
+            mBlockOffsets = reinterpret_cast<uint64_t const *>(data + sizeof(SAssetBlockHeader));
+            mBlocks       = (data + sizeof(SAssetBlockHeader) + tableSize);
+
+            uint64_t const storedSize = (size - sizeof(SAssetBlockHeader) - tableSize);
+            for(uint32_t k=0; k<mHeader.blockCount; ++k)
+            {
+                if(mBlockOffsets[k] > mBlockOffsets[k + 1])
+                {
+                    CLog::Error(logTag(), "Block table is invalid.");
+                    return { EEngineStatus::Error };
+                }
+            }
+
+            if(storedSize < mBlockOffsets[mHeader.blockCount])
+            {
+                CLog::Error(logTag(), "Block table exceeds the payload.");
+                return { EEngineStatus::Error };
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t CAssetBlockReader::blockDecompressedSize(uint32_t aIndex) const
+        {
+            uint64_t const offset = (static_cast<uint64_t>(aIndex) * mHeader.blockSize);
+            return std::min<uint64_t>(mHeader.blockSize, (mHeader.size - offset));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CAssetBlockReader::decompressBlock(uint32_t aIndex, uint8_t *aOutput) const
+        {
+            if(nullptr == mBlockOffsets || mHeader.blockCount <= aIndex)
+            {
+                return { EEngineStatus::Error };
+            }
+
+            uint8_t  const *const block            = (mBlocks + mBlockOffsets[aIndex]);
+            uint64_t const        storedSize       = (mBlockOffsets[aIndex + 1] - mBlockOffsets[aIndex]);
+            uint64_t const        decompressedSize = blockDecompressedSize(aIndex);
+
+            if(not decodeBlock(codec(), block, storedSize, aOutput, decompressedSize))
+            {
+                CLog::Error(logTag(), "Failed to decompress block {} with codec {}.", aIndex, convert_to_string<EAssetCodec>(codec()));
+                return { EEngineStatus::Error };
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
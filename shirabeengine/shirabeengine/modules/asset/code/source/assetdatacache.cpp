@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <limits>
+
+#include "asset/assetdatacache.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CAssetDataCache::CAssetDataCache(uint64_t aCapacity, uint32_t aShardCount)
+            : mCapacity (aCapacity)
+            , mSize     (0)
+            , mHits     (0)
+            , mMisses   (0)
+            , mEvictions(0)
+            , mClock    (0)
+            , mShards   ()
+        {
+            uint32_t const shardCount = std::max<uint32_t>(1, aShardCount);
+            for(uint32_t k=0; k<shardCount; ++k)
+            {
+                mShards.push_back(makeUnique<SShard>());
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CAssetDataCache::insert(AssetId_t const &aAssetId, ByteBuffer const &aData)
+        {
+            if(capacity() < aData.size())
+            {
+                erase(aAssetId);
+                return false;
+            }
+
+            // Owned data is copied behind a shared owner, so that hits only hand out views.
+            ByteBuffer data = share(ByteBuffer(aData));
+
+            {
+                SShard &shard = shardFor(aAssetId);
+                std::lock_guard<std::mutex> guard(shard.mutex);
+
+                auto const existing = shard.entries.find(aAssetId);
+                if(shard.entries.end() != existing)
+                {
+                    remove(shard, existing);
+                }
+
+                bool const pinned = (shard.pins.end() != shard.pins.find(aAssetId));
+
+                SEntry &entry = shard.entries.insert({ aAssetId, SEntry { std::move(data), pinned, 0, shard.usage.end() } }).first->second;
+                if(not pinned)
+                {
+                    shard.usage.push_front(aAssetId);
+                    entry.position = shard.usage.begin();
+                }
+                touch(shard, entry);
+
+                mSize += aData.size();
+            }
+
+            evictToCapacity();
+
+            // Only evicted right away, if everything else is pinned.
+            return contains(aAssetId);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CAssetDataCache::find(AssetId_t const &aAssetId)
+        {
+            SShard &shard = shardFor(aAssetId);
+            std::lock_guard<std::mutex> guard(shard.mutex);
+
+            auto const iterator = shard.entries.find(aAssetId);
+            if(shard.entries.end() == iterator)
+            {
+                ++mMisses;
+                return { EEngineStatus::Error };
+            }
+
+            SEntry &entry = iterator->second;
+            touch(shard, entry);
+
+            ++mHits;
+            return { EEngineStatus::Ok, entry.data };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CAssetDataCache::contains(AssetId_t const &aAssetId) const
+        {
+            SShard &shard = shardFor(aAssetId);
+            std::lock_guard<std::mutex> guard(shard.mutex);
+
+            return (shard.entries.end() != shard.entries.find(aAssetId));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::erase(AssetId_t const &aAssetId)
+        {
+            SShard &shard = shardFor(aAssetId);
+            std::lock_guard<std::mutex> guard(shard.mutex);
+
+            auto const iterator = shard.entries.find(aAssetId);
+            if(shard.entries.end() != iterator)
+            {
+                remove(shard, iterator);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::clear()
+        {
+            for(Unique<SShard> const &shard : mShards)
+            {
+                std::lock_guard<std::mutex> guard(shard->mutex);
+                while(not shard->entries.empty())
+                {
+                    remove(*shard, shard->entries.begin());
+                }
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::pin(AssetId_t const &aAssetId)
+        {
+            SShard &shard = shardFor(aAssetId);
+            std::lock_guard<std::mutex> guard(shard.mutex);
+
+            uint32_t &pinCount = shard.pins[aAssetId];
+            if(1 < ++pinCount)
+            {
+                return;
+            }
+
+            auto const iterator = shard.entries.find(aAssetId);
+            if(shard.entries.end() != iterator)
+            {
+                SEntry &entry = iterator->second;
+                shard.usage.erase(entry.position);
+                entry.position = shard.usage.end();
+                entry.pinned   = true;
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::unpin(AssetId_t const &aAssetId)
+        {
+            {
+                SShard &shard = shardFor(aAssetId);
+                std::lock_guard<std::mutex> guard(shard.mutex);
+
+                auto const pins = shard.pins.find(aAssetId);
+                if(shard.pins.end() == pins)
+                {
+                    CLog::Warning(logTag(), "Asset {} is not pinned.", aAssetId);
+                    return;
+                }
+
+                if(0 < --(pins->second))
+                {
+                    return;
+                }
+                shard.pins.erase(pins);
+
+                auto const iterator = shard.entries.find(aAssetId);
+                if(shard.entries.end() == iterator)
+                {
+                    return;
+                }
+
+                SEntry &entry = iterator->second;
+                shard.usage.push_front(aAssetId);
+                entry.position = shard.usage.begin();
+                entry.pinned   = false;
+                touch(shard, entry);
+            }
+
+            // The budget may have been exceeded, while the asset was pinned.
+            evictToCapacity();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::setCapacity(uint64_t aCapacity)
+        {
+            mCapacity = aCapacity;
+            evictToCapacity();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::size_t CAssetDataCache::entryCount() const
+        {
+            std::size_t count = 0;
+            for(Unique<SShard> const &shard : mShards)
+            {
+                std::lock_guard<std::mutex> guard(shard->mutex);
+                count += shard->entries.size();
+            }
+            return count;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SAssetDataCacheStatistics CAssetDataCache::statistics() const
+        {
+            SAssetDataCacheStatistics statistics {};
+            statistics.hits      = mHits.load();
+            statistics.misses    = mMisses.load();
+            statistics.evictions = mEvictions.load();
+            statistics.size      = mSize.load();
+
+            for(Unique<SShard> const &shard : mShards)
+            {
+                std::lock_guard<std::mutex> guard(shard->mutex);
+                statistics.entryCount  += shard->entries.size();
+                statistics.pinnedCount += (shard->entries.size() - shard->usage.size());
+            }
+            return statistics;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        ByteBuffer CAssetDataCache::share(ByteBuffer &&aData)
+        {
+            if(aData.isView())
+            {
+                return std::move(aData);
+            }
+
+            uint64_t const size  = aData.size();
+            auto     const owner = makeShared<std::vector<uint8_t>>(std::move(aData.mutableDataVector()));
+            return ByteBuffer(owner, owner->data(), size);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::remove(SShard &aShard, std::unordered_map<AssetId_t, SEntry>::iterator const &aIterator)
+        {
+            if(not aIterator->second.pinned)
+            {
+                aShard.usage.erase(aIterator->second.position);
+            }
+
+            mSize -= aIterator->second.data.size();
+            aShard.entries.erase(aIterator);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::touch(SShard &aShard, SEntry &aEntry)
+        {
+            aEntry.lastUse = ++mClock;
+            if(not aEntry.pinned)
+            {
+                aShard.usage.splice(aShard.usage.begin(), aShard.usage, aEntry.position);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetDataCache::evictToCapacity()
+        {
+            while(capacity() < size())
+            {
+                // Find the shard holding the least recently used entry, locking one shard at a time.
+                // Concurrent uses may change the order meanwhile, which is re-checked below.
+                SShard   *oldest  = nullptr;
+                uint64_t  lastUse = std::numeric_limits<uint64_t>::max();
+
+                for(Unique<SShard> const &shard : mShards)
+                {
+                    std::lock_guard<std::mutex> guard(shard->mutex);
+                    if(not shard->usage.empty())
+                    {
+                        uint64_t const candidate = shard->entries.at(shard->usage.back()).lastUse;
+                        if(candidate < lastUse)
+                        {
+                            oldest  = shard.get();
+                            lastUse = candidate;
+                        }
+                    }
+                }
+
+                if(nullptr == oldest)
+                {
+                    // Everything left is pinned.
+                    return;
+                }
+
+                std::lock_guard<std::mutex> guard(oldest->mutex);
+                if(oldest->usage.empty() || lastUse != oldest->entries.at(oldest->usage.back()).lastUse || not (capacity() < size()))
+                {
+                    continue;
+                }
+
+                remove(*oldest, oldest->entries.find(oldest->usage.back()));
+                ++mEvictions;
+            }
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
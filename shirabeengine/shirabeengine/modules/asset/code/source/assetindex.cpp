@@ -1,6 +1,12 @@
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string_view>
 
 #include <base/string.h>
+#include <log/log.h>
 #include "asset/assetindex.h"
 
 namespace engine
@@ -10,6 +16,8 @@ namespace engine
 
         namespace xml = engine::documents;
 
+        SHIRABE_DECLARE_LOG_TAG(AssetIndex);
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -97,6 +105,11 @@ namespace engine
         {
             auto const getProp = [] (xmlNodePtr aNode, char const *aPropId) -> std::string {
                 char const *p = (char const *)xmlGetProp(aNode, (xmlChar const *)aPropId);
+                if(nullptr == p)
+                {
+                    return {};
+                }
+
                 std::size_t l = strlen(p);
                 std::string const value(p, l);
                 xmlFree((void *)p);
@@ -109,6 +122,7 @@ namespace engine
             std::string const type    = CString::format("{}", getProp(aAsset, "type"));
             std::string const subtype = CString::format("{}", getProp(aAsset, "subtype"));
             std::string const uri     = CString::format("{}", getProp(aAsset, "uri"));
+            std::string const codec   = CString::format("{}", getProp(aAsset, "codec"));
 
             std::filesystem::path uriPath     = std::filesystem::path(uri).lexically_normal();
             std::filesystem::path composedURI = aSourceDir.lexically_normal();
@@ -118,11 +132,265 @@ namespace engine
             a.id      = from_string<AssetId_t>(aid);
             a.parent  = from_string<AssetId_t>(parent);
             a.type    = from_string<EAssetType>(type);
-            a.subtype = from_string<EAssetSubtype>(type);
+            a.subtype = from_string<EAssetSubtype>(subtype);
+            a.codec   = from_string<EAssetCodec>(codec);
             a.uri     = composedURI;
 
             aOutRegistry.addAsset(a.id, a);
         }
         //<-----------------------------------------------------------------------------
+
+        /**
+         * Byte offsets of the columns of a binary index with a given asset count.
+         */
+        struct SAssetIndexLayout
+        {
+        public_members:
+            uint64_t ids;
+            uint64_t parents;
+            uint64_t types;
+            uint64_t subtypes;
+            uint64_t codecs;
+            uint64_t uriOffsets;
+            uint64_t strings;
+        };
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        static SAssetIndexLayout computeAssetIndexLayout(uint64_t aAssetCount)
+        {
+            SAssetIndexLayout layout {};
+            layout.ids        = sizeof(SAssetIndexHeader);
+            layout.parents    = layout.ids      + (aAssetCount * sizeof(AssetId_t));
+            layout.types      = layout.parents  + (aAssetCount * sizeof(AssetId_t));
+            layout.subtypes   = layout.types    + aAssetCount;
+            layout.codecs     = layout.subtypes + aAssetCount;
+            layout.uriOffsets = ((layout.codecs + aAssetCount + 3) / 4) * 4;
+            layout.strings    = layout.uriOffsets + ((aAssetCount + 1) * sizeof(uint32_t));
+            return layout;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CAssetIndex::writeBinaryIndex(std::filesystem::path const &aIndexPath, std::vector<SAsset> const &aAssets)
+        {
+            std::vector<SAsset const *> assets {};
+            assets.reserve(aAssets.size());
+            for(SAsset const &asset : aAssets)
+            {
+                assets.push_back(&asset);
+            }
+
+            std::sort(assets.begin(), assets.end(), [] (SAsset const *aLHS, SAsset const *aRHS) -> bool
+            {
+                return (aLHS->id < aRHS->id);
+            });
+
+            auto const duplicate = std::adjacent_find(assets.begin(), assets.end(), [] (SAsset const *aLHS, SAsset const *aRHS) -> bool
+            {
+                return (aLHS->id == aRHS->id);
+            });
+            if(assets.end() != duplicate)
+            {
+                CLog::Error(logTag(), "Duplicate asset id {} for '{}' and '{}'.", (*duplicate)->id, (*duplicate)->uri.string(), (*(duplicate + 1))->uri.string());
+                return { EEngineStatus::Error };
+            }
+
+            uint64_t          const count  = assets.size();
+            SAssetIndexLayout const layout = computeAssetIndexLayout(count);
+
+            std::string strings {};
+            for(SAsset const *asset : assets)
+            {
+                strings += asset->uri.lexically_normal().generic_string();
+            }
+
+            if(std::numeric_limits<uint32_t>::max() < strings.size())
+            {
+                CLog::Error(logTag(), "The uri string table of '{}' exceeds 4GB.", aIndexPath.string());
+                return { EEngineStatus::Error };
+            }
+
+            std::vector<uint8_t> data(layout.strings + strings.size(), 0);
+
+            SAssetIndexHeader header {};
+            std::memcpy(header.magic, kAssetIndexMagic, sizeof(kAssetIndexMagic));
+            header.version         = kAssetIndexVersion;
+            header.assetCount      = static_cast<uint32_t>(count);
+            header.stringTableSize = strings.size();
+            std::memcpy(data.data(), &header, sizeof(header));
+
+            uint32_t stringOffset = 0;
+            for(uint64_t k=0; k<count; ++k)
+            {
+                SAsset const &asset = *(assets[k]);
+
+                uint8_t const type    = static_cast<uint8_t>(asset.type);
+                uint8_t const subtype = static_cast<uint8_t>(asset.subtype);
+                uint8_t const codec   = static_cast<uint8_t>(asset.codec);
+
+                std::memcpy(data.data() + layout.ids        + (k * sizeof(AssetId_t)), &asset.id,     sizeof(AssetId_t));
+                std::memcpy(data.data() + layout.parents    + (k * sizeof(AssetId_t)), &asset.parent, sizeof(AssetId_t));
+                std::memcpy(data.data() + layout.types      + k,                       &type,         sizeof(uint8_t));
+                std::memcpy(data.data() + layout.subtypes   + k,                       &subtype,      sizeof(uint8_t));
+                std::memcpy(data.data() + layout.codecs     + k,                       &codec,        sizeof(uint8_t));
+                std::memcpy(data.data() + layout.uriOffsets + (k * sizeof(uint32_t)),  &stringOffset, sizeof(uint32_t));
+
+                stringOffset += static_cast<uint32_t>(asset.uri.lexically_normal().generic_string().size());
+            }
+            std::memcpy(data.data() + layout.uriOffsets + (count * sizeof(uint32_t)), &stringOffset, sizeof(uint32_t));
+            std::memcpy(data.data() + layout.strings, strings.data(), strings.size());
+
+            std::ofstream output(aIndexPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            output.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(data.size()));
+            if(not output.good())
+            {
+                CLog::Error(logTag(), "Failed to write asset index '{}'.", aIndexPath.string());
+                return { EEngineStatus::Error };
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CBinaryAssetIndex::CBinaryAssetIndex()
+            : mData           ()
+            , mSourceDirectory()
+            , mAssetCount     (0)
+            , mIds            (nullptr)
+            , mParents        (nullptr)
+            , mTypes          (nullptr)
+            , mSubtypes       (nullptr)
+            , mCodecs         (nullptr)
+            , mUriOffsets     (nullptr)
+            , mStrings        (nullptr)
+        { }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<Shared<CBinaryAssetIndex>> CBinaryAssetIndex::load(std::filesystem::path const &aIndexPath)
+        {
+            std::ifstream input(aIndexPath, std::ios::in | std::ios::binary | std::ios::ate);
+            if(not input.good())
+            {
+                return { EEngineStatus::FileNotFound };
+            }
+
+            uint64_t const fileSize = static_cast<uint64_t>(input.tellg());
+            if(sizeof(SAssetIndexHeader) > fileSize)
+            {
+                CLog::Error(logTag(), "Asset index '{}' is truncated.", aIndexPath.string());
+                return { EEngineStatus::InitializationError };
+            }
+
+            Shared<CBinaryAssetIndex> index = makeShared<CBinaryAssetIndex>();
+
+            // The whole index is read at once. All columns are then addressed in place.
+            index->mData.resize(fileSize);
+            input.seekg(0);
+            input.read(reinterpret_cast<char *>(index->mData.data()), static_cast<std::streamsize>(fileSize));
+            if(not input.good())
+            {
+                CLog::Error(logTag(), "Failed to read asset index '{}'.", aIndexPath.string());
+                return { EEngineStatus::InitializationError };
+            }
+
+            SAssetIndexHeader header {};
+            std::memcpy(&header, index->mData.data(), sizeof(header));
+
+            SAssetIndexLayout const layout = computeAssetIndexLayout(header.assetCount);
+            if(0 != std::memcmp(header.magic, kAssetIndexMagic, sizeof(kAssetIndexMagic))
+               || kAssetIndexVersion != header.version
+               || fileSize != (layout.strings + header.stringTableSize))
+            {
+                CLog::Error(logTag(), "Asset index '{}' is invalid.", aIndexPath.string());
+                return { EEngineStatus::InitializationError };
+            }
+
+            uint8_t const *const base = index->mData.data();
+
+            index->mSourceDirectory = aIndexPath.parent_path().lexically_normal();
+            index->mAssetCount      = header.assetCount;
+            index->mIds             = reinterpret_cast<AssetId_t const *>(base + layout.ids);
+            index->mParents         = reinterpret_cast<AssetId_t const *>(base + layout.parents);
+            index->mTypes           = (base + layout.types);
+            index->mSubtypes        = (base + layout.subtypes);
+            index->mCodecs          = (base + layout.codecs);
+            index->mUriOffsets      = reinterpret_cast<uint32_t const *>(base + layout.uriOffsets);
+            index->mStrings         = reinterpret_cast<char const *>(base + layout.strings);
+
+            // Guard lookups against corrupt string offsets once, instead of on every access.
+            for(uint32_t k=0; k<header.assetCount; ++k)
+            {
+                if(index->mUriOffsets[k] > index->mUriOffsets[k + 1])
+                {
+                    CLog::Error(logTag(), "Asset index '{}' has invalid uri offsets.", aIndexPath.string());
+                    return { EEngineStatus::InitializationError };
+                }
+            }
+
+            if(header.stringTableSize != index->mUriOffsets[header.assetCount])
+            {
+                CLog::Error(logTag(), "Asset index '{}' has invalid uri offsets.", aIndexPath.string());
+                return { EEngineStatus::InitializationError };
+            }
+
+            return { EEngineStatus::Ok, index };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<SAsset> CBinaryAssetIndex::findAsset(AssetId_t const &aAssetId) const
+        {
+            AssetId_t const *const end = (mIds + mAssetCount);
+            AssetId_t const *const id  = std::lower_bound(mIds, end, aAssetId);
+            if(end == id || aAssetId != *id)
+            {
+                return { EEngineStatus::Error };
+            }
+
+            return { EEngineStatus::Ok, assetAt(static_cast<uint32_t>(id - mIds)) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SAsset CBinaryAssetIndex::assetAt(uint32_t aIndex) const
+        {
+            SAsset asset {};
+            asset.id      = mIds[aIndex];
+            asset.parent  = mParents[aIndex];
+            asset.type    = static_cast<EAssetType>(mTypes[aIndex]);
+            asset.subtype = static_cast<EAssetSubtype>(mSubtypes[aIndex]);
+            asset.codec   = static_cast<EAssetCodec>(mCodecs[aIndex]);
+            asset.uri     = uriAt(aIndex);
+            return asset;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::filesystem::path CBinaryAssetIndex::uriAt(uint32_t aIndex) const
+        {
+            uint32_t const begin = mUriOffsets[aIndex];
+            uint32_t const end   = mUriOffsets[aIndex + 1];
+
+            std::filesystem::path uri = mSourceDirectory;
+            uri /= std::string_view(mStrings + begin, (end - begin));
+            return uri;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+#include <log/log.h>
+#include "asset/assetcompression.h"
+#include "asset/assetpack.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        SHIRABE_DECLARE_LOG_TAG(AssetPack);
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        static uint64_t alignUp(uint64_t aValue, uint64_t aAlignment)
+        {
+            return ((aValue + aAlignment - 1) / aAlignment) * aAlignment;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        static void writePadding(std::ofstream &aStream, uint64_t aAlignment)
+        {
+            static std::array<char, kAssetPackAlignment> const sZeroes {};
+
+            uint64_t const position = static_cast<uint64_t>(aStream.tellp());
+            uint64_t const padding  = (alignUp(position, aAlignment) - position);
+            aStream.write(sZeroes.data(), static_cast<std::streamsize>(padding));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool validateAssetPackHeader(SAssetPackHeader const &aHeader, uint64_t aFileSize)
+        {
+            if(0 != std::memcmp(aHeader.magic, kAssetPackMagic, sizeof(kAssetPackMagic)))
+            {
+                return false;
+            }
+
+            if(kAssetPackVersion != aHeader.version)
+            {
+                return false;
+            }
+
+            // The TOC is mapped in place. It must be aligned for SAssetPackEntry and lie within the file.
+            uint64_t const tocSize = (static_cast<uint64_t>(aHeader.entryCount) * sizeof(SAssetPackEntry));
+            return (0 == (aHeader.tocOffset % alignof(SAssetPackEntry))
+                    && aHeader.tocOffset <= aFileSize
+                    && tocSize           <= (aFileSize - aHeader.tocOffset));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SAssetPackEntry const *findAssetPackEntry(SAssetPackEntry const *aEntries, uint32_t aEntryCount, AssetId_t aId)
+        {
+            SAssetPackEntry const *const end   = (aEntries + aEntryCount);
+            SAssetPackEntry const *const entry = std::lower_bound(aEntries, end, aId, [] (SAssetPackEntry const &aEntry, AssetId_t aValue) -> bool
+            {
+                return (aEntry.id < aValue);
+            });
+
+            if(end == entry || aId != entry->id)
+            {
+                return nullptr;
+            }
+
+            return entry;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> writeAssetPack(std::filesystem::path const &aPackPath, std::vector<SAssetPackSource> const &aSources)
+        {
+            std::vector<SAssetPackSource> sources = aSources;
+            std::sort(sources.begin(), sources.end(), [] (SAssetPackSource const &aLHS, SAssetPackSource const &aRHS) -> bool
+            {
+                return (aLHS.id < aRHS.id);
+            });
+
+            auto const duplicate = std::adjacent_find(sources.begin(), sources.end(), [] (SAssetPackSource const &aLHS, SAssetPackSource const &aRHS) -> bool
+            {
+                return (aLHS.id == aRHS.id);
+            });
+            if(sources.end() != duplicate)
+            {
+                CLog::Error(logTag(), "Duplicate asset id {} for '{}' and '{}'.", duplicate->id, duplicate->path.string(), (duplicate + 1)->path.string());
+                return { EEngineStatus::Error };
+            }
+
+            std::ofstream output(aPackPath, std::ios::out | std::ios::binary | std::ios::trunc);
+            if(not output.good())
+            {
+                CLog::Error(logTag(), "Failed to open asset pack '{}' for writing.", aPackPath.string());
+                return { EEngineStatus::FileNotFound };
+            }
+
+            SAssetPackHeader header {};
+            std::memcpy(header.magic, kAssetPackMagic, sizeof(kAssetPackMagic));
+            header.version    = kAssetPackVersion;
+            header.entryCount = static_cast<uint32_t>(sources.size());
+            header.alignment  = kAssetPackAlignment;
+            header.tocOffset  = 0;
+
+            // Reserve the header. It is written once the TOC offset is known, so that a
+            // partially written pack never passes validation.
+            SAssetPackHeader const placeholder {};
+            output.write(reinterpret_cast<char const *>(&placeholder), sizeof(placeholder));
+
+            std::vector<SAssetPackEntry> entries {};
+            entries.reserve(sources.size());
+
+            std::vector<char> chunk(1u << 20u);
+
+            for(SAssetPackSource const &source : sources)
+            {
+                std::ifstream input(source.path, std::ios::in | std::ios::binary);
+                if(not input.good())
+                {
+                    CLog::Error(logTag(), "Failed to open '{}' for packing.", source.path.string());
+                    return { EEngineStatus::FileNotFound };
+                }
+
+                writePadding(output, kAssetPackAlignment);
+
+                SAssetPackEntry entry {};
+                entry.id     = source.id;
+                entry.flags  = static_cast<uint16_t>(EAssetPackEntryFlags::None);
+                entry.codec  = static_cast<uint16_t>(source.codec);
+                entry.offset = static_cast<uint64_t>(output.tellp());
+
+                uint64_t size             = 0;
+                uint64_t decompressedSize = 0;
+                while(input)
+                {
+                    input.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+                    std::streamsize const count = input.gcount();
+
+                    // Compressed payloads record their decompressed size in the block header.
+                    if(0 == size && EAssetCodec::None != source.codec)
+                    {
+                        uint8_t const *const data = reinterpret_cast<uint8_t const *>(chunk.data());
+                        if(source.codec != assetBlockCodec(data, static_cast<uint64_t>(count)))
+                        {
+                            CLog::Error(logTag(), "'{}' is not compressed with codec {}.", source.path.string(), convert_to_string<EAssetCodec>(source.codec));
+                            return { EEngineStatus::Error };
+                        }
+
+                        SAssetBlockHeader header {};
+                        std::memcpy(&header, data, sizeof(header));
+                        decompressedSize = header.size;
+                    }
+
+                    output.write(chunk.data(), count);
+                    size += static_cast<uint64_t>(count);
+                }
+
+                if(EAssetCodec::None != source.codec)
+                {
+                    entry.flags = static_cast<uint16_t>(EAssetPackEntryFlags::Compressed);
+                }
+
+                entry.storedSize = size;
+                entry.size       = (EAssetCodec::None != source.codec) ? decompressedSize : size;
+                entries.push_back(entry);
+            }
+
+            writePadding(output, kAssetPackAlignment);
+            header.tocOffset = static_cast<uint64_t>(output.tellp());
+
+            output.write(reinterpret_cast<char const *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(SAssetPackEntry)));
+
+            output.seekp(0);
+            output.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+            if(not output.good())
+            {
+                CLog::Error(logTag(), "Failed to write asset pack '{}'.", aPackPath.string());
+                return { EEngineStatus::Error };
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
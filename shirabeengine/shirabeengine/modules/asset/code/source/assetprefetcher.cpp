@@ -0,0 +1,186 @@
+#include <mutex>
+#include <unordered_set>
+
+#include "asset/assetdatacache.h"
+#include "asset/assetprefetcher.h"
+#include "asset/assetstorage.h"
+
+namespace engine
+{
+    namespace asset
+    {
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CAssetPrefetcher::CAssetPrefetcher(Shared<CAssetStorage> aAssetStorage)
+            : mAssetStorage(std::move(aAssetStorage))
+            , mResolvers   ()
+            , mJobSystem   (nullptr)
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetPrefetcher::registerDependencyResolver(EAssetType const &aAssetType, AssetDependencyResolver_t aResolver)
+        {
+            mResolvers[aAssetType] = std::move(aResolver);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetPrefetcher::setJobSystem(Shared<threading::CJobSystem> const &aJobSystem)
+        {
+            mJobSystem = aJobSystem;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<AssetId_t> CAssetPrefetcher::resolveDependencies(SAsset const &aAsset, ByteBuffer const &aData) const
+        {
+            auto const iterator = mResolvers.find(aAsset.type);
+            if(mResolvers.end() == iterator || not iterator->second)
+            {
+                return {};
+            }
+
+            return iterator->second(aAsset, aData);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<SAssetPrefetchStatistics> CAssetPrefetcher::prefetch(std::vector<AssetId_t> const &aRoots)
+        {
+            Shared<CAssetDataCache> const cache = mAssetStorage->dataCache();
+            if(nullptr == cache)
+            {
+                CLog::Error(logTag(), "Can't prefetch without a data cache assigned to the asset storage.");
+                return { EEngineStatus::Error };
+            }
+
+            SAssetPrefetchStatistics statistics {};
+
+            std::unordered_set<AssetId_t> visited {};
+            std::vector<AssetId_t>        wave    = aRoots;
+
+            while(not wave.empty())
+            {
+                std::vector<AssetId_t> ids          {};
+                std::vector<SAsset>    assets       {};
+                std::vector<AssetId_t> dependencies {};
+
+                for(AssetId_t const &id : wave)
+                {
+                    if(not visited.insert(id).second)
+                    {
+                        continue;
+                    }
+
+                    CEngineResult<SAsset> const assetFetch = mAssetStorage->loadAsset(id);
+                    if(not assetFetch.successful())
+                    {
+                        CLog::Warning(logTag(), "Asset {} to prefetch is not in the index.", id);
+                        ++statistics.failedCount;
+                        continue;
+                    }
+
+                    // Cached assets are not read again, but their dependencies might have been evicted.
+                    // Checked first, so that the lookup isn't counted as a miss by the cache and the storage.
+                    CEngineResult<ByteBuffer> cached = { EEngineStatus::Error };
+                    if(cache->contains(id))
+                    {
+                        cached = cache->find(id);
+                    }
+
+                    if(cached.successful())
+                    {
+                        std::vector<AssetId_t> const resolved = resolveDependencies(assetFetch.data(), cached.data());
+                        dependencies.insert(dependencies.end(), resolved.begin(), resolved.end());
+
+                        ++statistics.cachedCount;
+                        continue;
+                    }
+
+                    ids   .push_back(id);
+                    assets.push_back(assetFetch.data());
+                }
+
+                if(not ids.empty())
+                {
+                    std::mutex                               mutex {};
+                    std::vector<threading::CJobHandle<void>> jobs  {};
+
+                    // Decoding the data may be expensive, e.g. parsing JSON. It is moved off the thread
+                    // completing the read onto the job system, so that further completions aren't held up.
+                    auto const resolve = [&] (std::size_t aIndex, ByteBuffer const &aData) -> void
+                    {
+                        // The storage has inserted the data into the cache already.
+                        std::vector<AssetId_t> const resolved = resolveDependencies(assets[aIndex], aData);
+                        if(not cache->contains(ids[aIndex]))
+                        {
+                            CLog::Warning(logTag(), "Asset {} of {} bytes did not fit into the data cache.", ids[aIndex], aData.size());
+                        }
+
+                        std::lock_guard<std::mutex> guard(mutex);
+                        dependencies.insert(dependencies.end(), resolved.begin(), resolved.end());
+                        statistics.bytesRead += aData.size();
+                        ++statistics.readCount;
+                    };
+
+                    // Invoked concurrently, before the respective future is ready.
+                    auto const onRead = [&] (std::size_t aIndex, CEngineResult<ByteBuffer> const &aResult) -> void
+                    {
+                        if(not aResult.successful())
+                        {
+                            CLog::Warning(logTag(), "Failed to prefetch asset {}.", ids[aIndex]);
+
+                            std::lock_guard<std::mutex> guard(mutex);
+                            ++statistics.failedCount;
+                            return;
+                        }
+
+                        if(nullptr != mJobSystem)
+                        {
+                            ByteBuffer const data = aResult.data();
+
+                            threading::CJobHandle<void> const job = mJobSystem->post<void>([&resolve, aIndex, data] () -> void { resolve(aIndex, data); });
+                            if(job.valid())
+                            {
+                                std::lock_guard<std::mutex> guard(mutex);
+                                jobs.push_back(job);
+                                return;
+                            }
+                        }
+
+                        resolve(aIndex, aResult.data());
+                    };
+
+                    std::vector<AssetReadFuture_t> const futures = mAssetStorage->loadAssetDataBatch(ids, onRead);
+                    for(AssetReadFuture_t const &future : futures)
+                    {
+                        future.wait();
+                    }
+
+                    // All callbacks have run, so no more jobs are added.
+                    for(threading::CJobHandle<void> const &job : jobs)
+                    {
+                        job.wait();
+                    }
+
+                    ++statistics.waveCount;
+                }
+
+                wave = std::move(dependencies);
+            }
+
+            return { EEngineStatus::Ok, statistics };
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,804 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include <platform/platform.h>
+
+#include "asset/assetreadqueue.h"
+
+#if defined SHIRABE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace engine
+{
+    namespace asset
+    {
+        // Single reads are split into chunks of at most 1GiB, since read syscalls cap their length.
+        static constexpr uint64_t const kMaxReadChunkSize = (1ull << 30u);
+
+        /**
+         * A read submitted to the queue and its progress.
+         */
+        struct CAssetReadQueue::SPendingRead
+        {
+        public_members:
+            SAssetReadRequest                       request;
+            AssetReadCallback_t                     callback;
+            std::promise<CEngineResult<ByteBuffer>> promise;
+            int                                     fileDescriptor = -1;
+            std::vector<uint8_t>                    data;
+            uint64_t                                bytesRead      = 0;
+        #if defined SHIRABE_PLATFORM_LINUX
+            struct iovec                            ioVector       = {};
+        #endif
+        };
+
+        /**
+         * The rings of an io_uring instance, mapped from the kernel.
+         *
+         * liburing is not a dependency of the engine, so the rings are set up with the raw
+         * syscalls, following the kernel's io_uring.h.
+         */
+        struct CAssetReadQueue::SIoUring
+        {
+        public_members:
+            int                   ringFileDescriptor  = -1;
+            int                   eventFileDescriptor = -1;
+
+            void                 *sqRing              = nullptr;
+            std::size_t           sqRingSize          = 0;
+            void                 *cqRing              = nullptr;
+            std::size_t           cqRingSize          = 0;
+            void                 *sqes                = nullptr;
+            std::size_t           sqesSize            = 0;
+
+        #if defined SHIRABE_PLATFORM_LINUX
+            unsigned             *sqHead              = nullptr;
+            unsigned             *sqTail              = nullptr;
+            unsigned             *sqMask              = nullptr;
+            unsigned             *sqArray             = nullptr;
+            unsigned              sqEntries           = 0;
+            unsigned              sqPending           = 0;
+
+            unsigned             *cqHead              = nullptr;
+            unsigned             *cqTail              = nullptr;
+            unsigned             *cqMask              = nullptr;
+            struct io_uring_cqe  *cqes                = nullptr;
+        #endif
+
+        public_destructors:
+            ~SIoUring()
+            {
+            #if defined SHIRABE_PLATFORM_LINUX
+                if(nullptr != sqes)
+                {
+                    munmap(sqes, sqesSize);
+                }
+                if(nullptr != cqRing && cqRing != sqRing)
+                {
+                    munmap(cqRing, cqRingSize);
+                }
+                if(nullptr != sqRing)
+                {
+                    munmap(sqRing, sqRingSize);
+                }
+                if(0 <= ringFileDescriptor)
+                {
+                    close(ringFileDescriptor);
+                }
+                if(0 <= eventFileDescriptor)
+                {
+                    close(eventFileDescriptor);
+                }
+            #endif
+            }
+
+        public_methods:
+        #if defined SHIRABE_PLATFORM_LINUX
+            /**
+             * Create the ring with at least aEntries submission entries and map it.
+             *
+             * @return True, if io_uring is available.
+             */
+            bool setup(uint32_t aEntries);
+
+            /**
+             * Claim the next submission entry, zeroed. It is handed to the kernel on commitSqe().
+             *
+             * @return The entry or nullptr, if the submission ring is full.
+             */
+            struct io_uring_sqe *acquireSqe();
+
+            /**
+             * Publish the entry claimed last by acquireSqe(), once it was filled.
+             */
+            void commitSqe();
+
+            /**
+             * Queue a poll on the wakeup eventfd.
+             *
+             * @return True, if successful.
+             */
+            bool queueWakeupPoll();
+        #endif
+
+            /**
+             * Wake the I/O thread waiting on the ring.
+             */
+            void signal()
+            {
+            #if defined SHIRABE_PLATFORM_LINUX
+                uint64_t const wakeup  = 1;
+                ssize_t  const written = write(eventFileDescriptor, &wakeup, sizeof(wakeup));
+                SHIRABE_UNUSED(written); // Only fails, if the counter is saturated, which wakes the thread anyway.
+            #endif
+            }
+        };
+
+    #if defined SHIRABE_PLATFORM_LINUX
+        // user_data of the poll on the wakeup eventfd. Reads use their slot index + 1.
+        static constexpr uint64_t const kWakeupUserData = 0;
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CAssetReadQueue::SIoUring::setup(uint32_t aEntries)
+        {
+            struct io_uring_params parameters {};
+
+            int const descriptor = static_cast<int>(syscall(__NR_io_uring_setup, aEntries, &parameters));
+            if(0 > descriptor)
+            {
+                return false;
+            }
+            ringFileDescriptor = descriptor;
+
+            sqRingSize = (parameters.sq_off.array + (parameters.sq_entries * sizeof(unsigned)));
+            cqRingSize = (parameters.cq_off.cqes  + (parameters.cq_entries * sizeof(struct io_uring_cqe)));
+
+            bool const singleMapping = (0 != (parameters.features & IORING_FEAT_SINGLE_MMAP));
+            if(singleMapping)
+            {
+                sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+            }
+
+            void *const sqAddress = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQ_RING);
+            if(MAP_FAILED == sqAddress)
+            {
+                return false;
+            }
+            sqRing = sqAddress;
+
+            if(singleMapping)
+            {
+                cqRing = sqRing;
+            }
+            else
+            {
+                void *const cqAddress = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_CQ_RING);
+                if(MAP_FAILED == cqAddress)
+                {
+                    return false;
+                }
+                cqRing = cqAddress;
+            }
+
+            sqesSize = (parameters.sq_entries * sizeof(struct io_uring_sqe));
+            void *const sqesAddress = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, descriptor, IORING_OFF_SQES);
+            if(MAP_FAILED == sqesAddress)
+            {
+                return false;
+            }
+            sqes = sqesAddress;
+
+            uint8_t *const sq = static_cast<uint8_t *>(sqRing);
+            uint8_t *const cq = static_cast<uint8_t *>(cqRing);
+
+            sqHead    = reinterpret_cast<unsigned *>(sq + parameters.sq_off.head);
+            sqTail    = reinterpret_cast<unsigned *>(sq + parameters.sq_off.tail);
+            sqMask    = reinterpret_cast<unsigned *>(sq + parameters.sq_off.ring_mask);
+            sqArray   = reinterpret_cast<unsigned *>(sq + parameters.sq_off.array);
+            sqEntries = parameters.sq_entries;
+            cqHead    = reinterpret_cast<unsigned *>(cq + parameters.cq_off.head);
+            cqTail    = reinterpret_cast<unsigned *>(cq + parameters.cq_off.tail);
+            cqMask    = reinterpret_cast<unsigned *>(cq + parameters.cq_off.ring_mask);
+            cqes      = reinterpret_cast<struct io_uring_cqe *>(cq + parameters.cq_off.cqes);
+
+            // Submitters wake the I/O thread through an eventfd polled on the ring, so that it
+            // only ever waits in io_uring_enter.
+            eventFileDescriptor = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+            return (0 <= eventFileDescriptor);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        struct io_uring_sqe *CAssetReadQueue::SIoUring::acquireSqe()
+        {
+            unsigned const head = __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+            unsigned const tail = *sqTail;
+            if(sqEntries <= (tail - head))
+            {
+                return nullptr;
+            }
+
+            unsigned const index = (tail & *sqMask);
+
+            struct io_uring_sqe *sqe = (static_cast<struct io_uring_sqe *>(sqes) + index);
+            std::memset(sqe, 0, sizeof(*sqe));
+
+            return sqe;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetReadQueue::SIoUring::commitSqe()
+        {
+            unsigned const tail  = *sqTail;
+            unsigned const index = (tail & *sqMask);
+
+            // The release store orders the filled entry before the tail the kernel reads it by.
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, (tail + 1), __ATOMIC_RELEASE);
+            ++sqPending;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CAssetReadQueue::SIoUring::queueWakeupPoll()
+        {
+            struct io_uring_sqe *sqe = acquireSqe();
+            if(nullptr == sqe)
+            {
+                return false;
+            }
+
+            sqe->opcode      = IORING_OP_POLL_ADD;
+            sqe->fd          = eventFileDescriptor;
+            sqe->poll_events = POLLIN;
+            sqe->user_data   = kWakeupUserData;
+            commitSqe();
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+    #endif
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CAssetReadQueue::CAssetReadQueue()
+            : mBackend         (EAssetReadBackend::None)
+            , mQueueDepth      (0)
+            , mAbortRequested  (false)
+            , mRequestMutex    ()
+            , mRequestCondition()
+            , mRequests        ()
+            , mRing            (nullptr)
+            , mThreads         ()
+        { }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CAssetReadQueue::~CAssetReadQueue()
+        {
+            deinitialize();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CAssetReadQueue::initialize(uint32_t aQueueDepth, uint32_t aThreadCount, bool aPreferIoUring)
+        {
+            if(EAssetReadBackend::None != mBackend)
+            {
+                return { EEngineStatus::Ok };
+            }
+
+            mQueueDepth = std::max<uint32_t>(1, aQueueDepth);
+            mAbortRequested.store(false);
+
+        #if defined SHIRABE_PLATFORM_LINUX
+            if(aPreferIoUring)
+            {
+                // One entry more than reads in flight for the wakeup poll.
+                Unique<SIoUring> ring = makeUnique<SIoUring>();
+                if(ring->setup(mQueueDepth + 1) && ring->queueWakeupPoll())
+                {
+                    mRing    = std::move(ring);
+                    mBackend = EAssetReadBackend::IoUring;
+                    mThreads.emplace_back(&CAssetReadQueue::runIoUring, this);
+
+                    return { EEngineStatus::Ok };
+                }
+
+                CLog::Warning(logTag(), "io_uring is not available ({}). Falling back to a thread pool.", std::strerror(errno));
+            }
+        #else
+            SHIRABE_UNUSED(aPreferIoUring);
+        #endif
+
+            mBackend = EAssetReadBackend::ThreadPool;
+
+            uint32_t const threadCount = std::max<uint32_t>(1, std::min(aThreadCount, mQueueDepth));
+            for(uint32_t k=0; k<threadCount; ++k)
+            {
+                mThreads.emplace_back(&CAssetReadQueue::runThreadPoolWorker, this);
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetReadQueue::deinitialize()
+        {
+            if(EAssetReadBackend::None == mBackend)
+            {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(mRequestMutex);
+                mAbortRequested.store(true);
+            }
+            mRequestCondition.notify_all();
+
+            if(nullptr != mRing)
+            {
+                mRing->signal();
+            }
+
+            for(std::thread &thread : mThreads)
+            {
+                if(thread.joinable())
+                {
+                    thread.join();
+                }
+            }
+            mThreads.clear();
+            mRing    = nullptr;
+            mBackend = EAssetReadBackend::None;
+
+            std::deque<Unique<SPendingRead>> pending {};
+            {
+                std::lock_guard<std::mutex> guard(mRequestMutex);
+                pending.swap(mRequests);
+            }
+
+            for(Unique<SPendingRead> &read : pending)
+            {
+                complete(*read, EEngineStatus::Error);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        AssetReadFuture_t CAssetReadQueue::submit(SAssetReadRequest const &aRequest, AssetReadCallback_t aCallback)
+        {
+            AssetReadBatchCallback_t callback {};
+            if(aCallback)
+            {
+                callback = [aCallback] (std::size_t, CEngineResult<ByteBuffer> const &aResult) -> void { aCallback(aResult); };
+            }
+
+            return submitBatch({ aRequest }, std::move(callback)).front();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<AssetReadFuture_t> CAssetReadQueue::submitBatch(std::vector<SAssetReadRequest> const &aRequests, AssetReadBatchCallback_t aCallback)
+        {
+            std::vector<AssetReadFuture_t>   futures {};
+            std::vector<Unique<SPendingRead>> reads  {};
+            futures.reserve(aRequests.size());
+            reads  .reserve(aRequests.size());
+
+            for(std::size_t k=0; k<aRequests.size(); ++k)
+            {
+                Unique<SPendingRead> read = makeUnique<SPendingRead>();
+                read->request  = aRequests[k];
+                if(aCallback)
+                {
+                    read->callback = [aCallback, k] (CEngineResult<ByteBuffer> const &aResult) -> void { aCallback(k, aResult); };
+                }
+
+                futures.push_back(read->promise.get_future().share());
+                reads  .push_back(std::move(read));
+            }
+
+            // The I/O thread falls back to the thread pool backend, if the ring fails. Read it under the lock.
+            bool              accepted = false;
+            EAssetReadBackend backend  = EAssetReadBackend::None;
+            {
+                std::lock_guard<std::mutex> guard(mRequestMutex);
+                backend = mBackend.load();
+                if(EAssetReadBackend::None != backend && not mAbortRequested.load())
+                {
+                    for(Unique<SPendingRead> &read : reads)
+                    {
+                        mRequests.push_back(std::move(read));
+                    }
+                    accepted = true;
+                }
+            }
+
+            if(not accepted)
+            {
+                CLog::Error(logTag(), "Read queue is not running.");
+                for(Unique<SPendingRead> &read : reads)
+                {
+                    complete(*read, EEngineStatus::Error);
+                }
+                return futures;
+            }
+
+            if(EAssetReadBackend::IoUring == backend)
+            {
+                mRing->signal();
+            }
+            else
+            {
+                mRequestCondition.notify_all();
+            }
+
+            return futures;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CAssetReadQueue::prepare(SPendingRead &aRead)
+        {
+            std::string const filename = aRead.request.path.string();
+
+        #if defined SHIRABE_PLATFORM_LINUX
+            aRead.fileDescriptor = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+            if(0 > aRead.fileDescriptor)
+            {
+                CLog::Error(logTag(), "Failed to open file '{}'. Error {}.", filename, std::strerror(errno));
+                complete(aRead, EEngineStatus::FileNotFound);
+                return false;
+            }
+
+            struct stat fileStatus {};
+            if(0 != fstat(aRead.fileDescriptor, &fileStatus))
+            {
+                CLog::Error(logTag(), "Failed to stat file '{}'. Error {}.", filename, std::strerror(errno));
+                complete(aRead, EEngineStatus::Error);
+                return false;
+            }
+            uint64_t const fileSize = static_cast<uint64_t>(fileStatus.st_size);
+        #else
+            std::error_code error {};
+            uint64_t const fileSize = std::filesystem::file_size(aRead.request.path, error);
+            if(error)
+            {
+                CLog::Error(logTag(), "Failed to open file '{}'. Error {}.", filename, error.message());
+                complete(aRead, EEngineStatus::FileNotFound);
+                return false;
+            }
+        #endif
+
+            if(fileSize < aRead.request.offset)
+            {
+                CLog::Error(logTag(), "Read offset {} exceeds file '{}' of {} bytes.", aRead.request.offset, filename, fileSize);
+                complete(aRead, EEngineStatus::Error);
+                return false;
+            }
+
+            uint64_t const length = std::min(aRead.request.length, (fileSize - aRead.request.offset));
+            aRead.data.resize(length);
+
+            if(0 == length)
+            {
+                complete(aRead, EEngineStatus::Ok);
+                return false;
+            }
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetReadQueue::complete(SPendingRead &aRead, EEngineStatus aStatus)
+        {
+        #if defined SHIRABE_PLATFORM_LINUX
+            if(0 <= aRead.fileDescriptor)
+            {
+                close(aRead.fileDescriptor);
+                aRead.fileDescriptor = -1;
+            }
+        #endif
+
+            CEngineResult<ByteBuffer> result = { aStatus };
+            if(CheckEngineError(aStatus))
+            {
+                aRead.data.clear();
+            }
+            else
+            {
+                uint64_t const size = aRead.data.size();
+                result = { EEngineStatus::Ok, ByteBuffer(std::move(aRead.data), size) };
+            }
+
+            // The callback runs first, so that it has been invoked once the future is ready.
+            if(aRead.callback)
+            {
+                aRead.callback(result);
+            }
+            aRead.promise.set_value(std::move(result));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetReadQueue::runThreadPoolWorker()
+        {
+            while(true)
+            {
+                Unique<SPendingRead> read = nullptr;
+                {
+                    std::unique_lock<std::mutex> lock(mRequestMutex);
+                    mRequestCondition.wait(lock, [this] () -> bool { return (mAbortRequested.load() || not mRequests.empty()); });
+
+                    if(mAbortRequested.load())
+                    {
+                        return;
+                    }
+
+                    read = std::move(mRequests.front());
+                    mRequests.pop_front();
+                }
+
+                if(not prepare(*read))
+                {
+                    continue;
+                }
+
+                uint64_t const length = read->data.size();
+
+            #if defined SHIRABE_PLATFORM_LINUX
+                while(length > read->bytesRead)
+                {
+                    std::size_t const chunk  = static_cast<std::size_t>(std::min(kMaxReadChunkSize, (length - read->bytesRead)));
+                    ssize_t     const result = pread(read->fileDescriptor
+                                                     , (read->data.data() + read->bytesRead)
+                                                     , chunk
+                                                     , static_cast<off_t>(read->request.offset + read->bytesRead));
+                    if(0 > result && EINTR == errno)
+                    {
+                        continue;
+                    }
+                    if(0 >= result)
+                    {
+                        break;
+                    }
+                    read->bytesRead += static_cast<uint64_t>(result);
+                }
+            #else
+                std::ifstream stream(read->request.path, std::ios::in | std::ios::binary);
+                stream.seekg(static_cast<std::streamoff>(read->request.offset));
+                stream.read(reinterpret_cast<char *>(read->data.data()), static_cast<std::streamsize>(length));
+                read->bytesRead = static_cast<uint64_t>(stream.gcount());
+            #endif
+
+                if(length != read->bytesRead)
+                {
+                    CLog::Error(logTag(), "Failed to read file '{}'.", read->request.path.string());
+                    complete(*read, EEngineStatus::Error);
+                    continue;
+                }
+
+                complete(*read, EEngineStatus::Ok);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetReadQueue::runIoUring()
+        {
+        #if defined SHIRABE_PLATFORM_LINUX
+            SIoUring &ring = *mRing;
+
+            // Reads in flight are owned by their slot. Their slot index + 1 is the user_data of their SQE.
+            std::vector<Unique<SPendingRead>> slots(mQueueDepth);
+            std::vector<uint32_t>             freeSlots {};
+            freeSlots.reserve(mQueueDepth);
+            for(uint32_t k=mQueueDepth; k>0; --k)
+            {
+                freeSlots.push_back(k - 1);
+            }
+
+            auto const queueRead = [&] (uint32_t aSlot) -> void
+            {
+                SPendingRead &read = *slots[aSlot];
+
+                uint64_t const remaining = (read.data.size() - read.bytesRead);
+                read.ioVector.iov_base = (read.data.data() + read.bytesRead);
+                read.ioVector.iov_len  = static_cast<std::size_t>(std::min(kMaxReadChunkSize, remaining));
+
+                // Never fails: The ring has an entry per slot and one for the wakeup poll.
+                struct io_uring_sqe *sqe = ring.acquireSqe();
+                sqe->opcode    = IORING_OP_READV;
+                sqe->fd        = read.fileDescriptor;
+                sqe->addr      = reinterpret_cast<uint64_t>(&read.ioVector);
+                sqe->len       = 1;
+                sqe->off       = (read.request.offset + read.bytesRead);
+                sqe->user_data = (static_cast<uint64_t>(aSlot) + 1);
+                ring.commitSqe();
+            };
+
+            auto const releaseSlot = [&] (uint32_t aSlot, EEngineStatus aStatus) -> void
+            {
+                Unique<SPendingRead> read = std::move(slots[aSlot]);
+                freeSlots.push_back(aSlot);
+                complete(*read, aStatus);
+            };
+
+            bool failed = false;
+            while(not failed)
+            {
+                bool const aborting = mAbortRequested.load();
+
+                // Take as many new requests as there are free slots.
+                if(not aborting)
+                {
+                    std::vector<Unique<SPendingRead>> taken {};
+                    {
+                        std::lock_guard<std::mutex> guard(mRequestMutex);
+                        while(taken.size() < freeSlots.size() && not mRequests.empty())
+                        {
+                            taken.push_back(std::move(mRequests.front()));
+                            mRequests.pop_front();
+                        }
+                    }
+
+                    for(Unique<SPendingRead> &read : taken)
+                    {
+                        if(not prepare(*read))
+                        {
+                            continue;
+                        }
+
+                        uint32_t const slot = freeSlots.back();
+                        freeSlots.pop_back();
+                        slots[slot] = std::move(read);
+                        queueRead(slot);
+                    }
+                }
+
+                if(aborting && mQueueDepth == freeSlots.size())
+                {
+                    break;
+                }
+
+                int const result = static_cast<int>(syscall(__NR_io_uring_enter, ring.ringFileDescriptor, ring.sqPending, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+                if(0 > result)
+                {
+                    if(EINTR == errno || EAGAIN == errno || EBUSY == errno)
+                    {
+                        continue;
+                    }
+
+                    CLog::Error(logTag(), "io_uring_enter failed. Error {}.", std::strerror(errno));
+                    failed = true;
+                    break;
+                }
+                ring.sqPending -= std::min<unsigned>(ring.sqPending, static_cast<unsigned>(result));
+
+                unsigned       head = *ring.cqHead;
+                unsigned const tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+                for(; head != tail; ++head)
+                {
+                    struct io_uring_cqe const cqe = ring.cqes[head & *ring.cqMask];
+
+                    if(kWakeupUserData == cqe.user_data)
+                    {
+                        uint64_t counter = 0;
+                        ssize_t  const bytes   = ::read(ring.eventFileDescriptor, &counter, sizeof(counter));
+                        SHIRABE_UNUSED(bytes); // Nonblocking. The counter is only drained to rearm the poll.
+                        ring.queueWakeupPoll();
+                        continue;
+                    }
+
+                    uint32_t const  slot = static_cast<uint32_t>(cqe.user_data - 1);
+                    SPendingRead   &read = *slots[slot];
+
+                    if(-EINTR == cqe.res || -EAGAIN == cqe.res)
+                    {
+                        queueRead(slot);
+                    }
+                    else if(0 > cqe.res)
+                    {
+                        CLog::Error(logTag(), "Failed to read file '{}'. Error {}.", read.request.path.string(), std::strerror(-cqe.res));
+                        releaseSlot(slot, EEngineStatus::Error);
+                    }
+                    else if(0 == cqe.res)
+                    {
+                        CLog::Error(logTag(), "Unexpected end of file '{}'.", read.request.path.string());
+                        releaseSlot(slot, EEngineStatus::Error);
+                    }
+                    else
+                    {
+                        read.bytesRead += static_cast<uint64_t>(cqe.res);
+                        if(read.data.size() > read.bytesRead)
+                        {
+                            // Short read. Continue with the remainder.
+                            queueRead(slot);
+                        }
+                        else
+                        {
+                            releaseSlot(slot, EEngineStatus::Ok);
+                        }
+                    }
+                }
+                __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+            }
+
+            if(failed)
+            {
+                // Closing the ring cancels or waits for all reads in flight, before their buffers are released.
+                close(ring.ringFileDescriptor);
+                ring.ringFileDescriptor = -1;
+
+                // Fall back to the thread pool backend on this thread. The reads in flight are
+                // restarted from scratch, ahead of the queued ones.
+                {
+                    std::lock_guard<std::mutex> guard(mRequestMutex);
+                    for(uint32_t k=mQueueDepth; k>0; --k)
+                    {
+                        Unique<SPendingRead> &read = slots[k - 1];
+                        if(nullptr == read)
+                        {
+                            continue;
+                        }
+
+                        close(read->fileDescriptor);
+                        read->fileDescriptor = -1;
+                        read->bytesRead      = 0;
+                        mRequests.push_front(std::move(read));
+                    }
+
+                    mBackend.store(EAssetReadBackend::ThreadPool);
+                }
+
+                CLog::Warning(logTag(), "Falling back to a thread pool of a single thread.");
+                runThreadPoolWorker();
+            }
+        #endif
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
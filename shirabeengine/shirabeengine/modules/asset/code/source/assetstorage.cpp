@@ -2,10 +2,13 @@
 // #define STB_IMAGE_IMPLEMENTATION
 // #include <stb/stb_image.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <core/enginetypehelper.h>
 #include <core/helpers.h>
 
+#include "asset/assetcompression.h"
+#include "asset/assetindex.h"
 #include "asset/assetstorage.h"
 
 namespace engine
@@ -18,7 +21,10 @@ namespace engine
         CAssetStorage::CAssetStorage(Unique<IAssetDataSource> &&aAssetDataSource)
             : IAssetStorage()
             , mAssetIndex()
+            , mBinaryAssetIndex(nullptr)
             , mAssetDataSource(std::move(aAssetDataSource))
+            , mJobSystem(nullptr)
+            , mDataCache(nullptr)
         {}
         //<-----------------------------------------------------------------------------
 
@@ -35,6 +41,30 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetStorage::readIndex(Shared<CBinaryAssetIndex> const &aIndex)
+        {
+            mBinaryAssetIndex = aIndex;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<SAsset> CAssetStorage::findAsset(AssetId_t const &aAssetUID)
+        {
+            CEngineResult<SAsset> registered = mAssetIndex.getAsset(aAssetUID);
+            if(registered.successful() || nullptr == mBinaryAssetIndex)
+            {
+                return registered;
+            }
+
+            return mBinaryAssetIndex->findAsset(aAssetUID);
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -48,6 +78,18 @@ namespace engine
                 }
             }
 
+            if(nullptr != mBinaryAssetIndex)
+            {
+                for(uint32_t k=0; k<mBinaryAssetIndex->size(); ++k)
+                {
+                    SAsset const asset = mBinaryAssetIndex->assetAt(k);
+                    if(0 == asset.uri.compare(aUri))
+                    {
+                        return { EEngineStatus::Ok, asset };
+                    }
+                }
+            }
+
             return { EEngineStatus::Error };
         }
         //<-----------------------------------------------------------------------------
@@ -106,7 +148,7 @@ namespace engine
         //<-----------------------------------------------------------------------------
         CEngineResult<SAsset > CAssetStorage::loadAsset(AssetId_t const &aAssetUID)
         {
-            return mAssetIndex.getAsset(aAssetUID);
+            return findAsset(aAssetUID);
         }
         //<-----------------------------------------------------------------------------
 
@@ -117,7 +159,7 @@ namespace engine
         {
             CEngineResult<ByteBuffer> data = { EEngineStatus::Error };
 
-            CEngineResult<SAsset> assetFetch = mAssetIndex.getAsset(aAssetUID);
+            CEngineResult<SAsset> assetFetch = findAsset(aAssetUID);
             if(not assetFetch.successful())
             {
                 return { EEngineStatus::Error };
@@ -137,7 +179,7 @@ namespace engine
         {
             CEngineResult<ByteBuffer> data = { EEngineStatus::Error };
 
-            CEngineResult<SAsset> assetFetch = mAssetIndex.getAsset(aAssetUID);
+            CEngineResult<SAsset> assetFetch = findAsset(aAssetUID);
             if(not assetFetch.successful())
             {
                 return { EEngineStatus::Error };
@@ -145,7 +187,300 @@ namespace engine
 
             SAsset const asset = assetFetch.data();
 
-            return mAssetDataSource->readAsset(asset.uri);
+            return fetchAssetData(aAssetUID, asset.uri, asset.codec);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CAssetStorage::loadAssetDataRange(AssetId_t const &aAssetUID, uint64_t aOffset, uint64_t aLength)
+        {
+            CEngineResult<SAsset> assetFetch = findAsset(aAssetUID);
+            if(not assetFetch.successful())
+            {
+                return { EEngineStatus::Error };
+            }
+
+            if(nullptr != mDataCache)
+            {
+                // Cached data is decompressed already and shared, so a view of it can be handed out.
+                CEngineResult<ByteBuffer> const cached = mDataCache->find(aAssetUID);
+                if(cached.successful() && aOffset <= cached.data().size())
+                {
+                    uint64_t const length = std::min(aLength, (cached.data().size() - aOffset));
+                    return { EEngineStatus::Ok, cached.data().createView(aOffset, length) };
+                }
+            }
+
+            SAsset const asset = assetFetch.data();
+            if(EAssetCodec::None == asset.codec)
+            {
+                return mAssetDataSource->readAssetRange(asset.uri, aOffset, aLength);
+            }
+
+            AssetRangeReader_t const reader = [this, &asset] (uint64_t aStoredOffset, uint64_t aStoredLength) -> CEngineResult<ByteBuffer>
+            {
+                return mAssetDataSource->readAssetRange(asset.uri, aStoredOffset, aStoredLength);
+            };
+
+            CEngineResult<ByteBuffer> range = decompressAssetBlockRange(reader, aOffset, aLength);
+            if(not range.successful())
+            {
+                CLog::Error(logTag(), "Failed to load range [{}, +{}) of asset data '{}'.", aOffset, aLength, asset.uri.string());
+            }
+            return range;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CAssetStorage::readAssetData(std::filesystem::path const &aUri, EAssetCodec const &aCodec)
+        {
+            CEngineResult<ByteBuffer> read = mAssetDataSource->readAsset(aUri);
+            if(not read.successful() || EAssetCodec::None == aCodec)
+            {
+                return read;
+            }
+
+            // Blocks are decompressed in parallel, if a job system is assigned.
+            CEngineResult<ByteBuffer> decompressed = decompressAssetBlocks(read.data(), mJobSystem);
+            if(not decompressed.successful())
+            {
+                CLog::Error(logTag(), "Failed to decompress asset data '{}'.", aUri.string());
+            }
+            return decompressed;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CAssetStorage::fetchAssetData(AssetId_t const &aAssetUID, std::filesystem::path const &aUri, EAssetCodec const &aCodec)
+        {
+            Shared<CAssetDataCache> const cache = mDataCache;
+            if(nullptr == cache)
+            {
+                return readAssetData(aUri, aCodec);
+            }
+
+            CEngineResult<ByteBuffer> cached = cache->find(aAssetUID);
+            if(cached.successful())
+            {
+                return cached;
+            }
+
+            CEngineResult<ByteBuffer> read = readAssetData(aUri, aCodec);
+            if(read.successful())
+            {
+                // Shared first, so that the data is neither copied into the cache nor out of it.
+                ByteBuffer data = CAssetDataCache::share(std::move(read.data()));
+                cache->insert(aAssetUID, data);
+                return { EEngineStatus::Ok, std::move(data) };
+            }
+            return read;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetStorage::setDataCache(Shared<CAssetDataCache> const &aDataCache)
+        {
+            mDataCache = aDataCache;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetStorage::pinAssetData(AssetId_t const &aAssetUID)
+        {
+            if(nullptr != mDataCache)
+            {
+                mDataCache->pin(aAssetUID);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetStorage::unpinAssetData(AssetId_t const &aAssetUID)
+        {
+            if(nullptr != mDataCache)
+            {
+                mDataCache->unpin(aAssetUID);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CAssetStorage::setJobSystem(Shared<threading::CJobSystem> const &aJobSystem)
+        {
+            mJobSystem = aJobSystem;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        threading::CJobHandle<CEngineResult<ByteBuffer>> CAssetStorage::loadAssetDataAsync(AssetId_t const &aAssetUID)
+        {
+            if(nullptr == mJobSystem)
+            {
+                CLog::Error(logTag(), "Cannot load asset data asynchronously. No job system assigned.");
+                return {};
+            }
+
+            // The index is resolved on the calling thread, the data source is read on the worker.
+            CEngineResult<SAsset> assetFetch = findAsset(aAssetUID);
+            if(not assetFetch.successful())
+            {
+                return {};
+            }
+
+            std::filesystem::path const uri   = assetFetch.data().uri;
+            EAssetCodec           const codec = assetFetch.data().codec;
+
+            return mJobSystem->post<CEngineResult<ByteBuffer>>([this, aAssetUID, uri, codec] () -> CEngineResult<ByteBuffer>
+            {
+                return fetchAssetData(aAssetUID, uri, codec);
+            });
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<AssetReadFuture_t> CAssetStorage::loadAssetDataBatch(std::vector<AssetId_t> const &aAssetUIDs, AssetReadBatchCallback_t aCallback)
+        {
+            using Promise_t = std::promise<CEngineResult<ByteBuffer>>;
+
+            /**
+             * A read of the batch. Compressed data is handed out through its own promise,
+             * which is fulfilled after decompression.
+             */
+            struct SRead
+            {
+                std::size_t           slot;
+                AssetId_t             id;
+                std::filesystem::path uri;
+                Shared<Promise_t>     promise;
+            };
+
+            Shared<CAssetDataCache> const cache = mDataCache;
+
+            std::vector<AssetReadFuture_t>     futures(aAssetUIDs.size());
+            std::vector<SRead>                 reads   {};
+            std::vector<std::filesystem::path> paths   {};
+
+            for(std::size_t k=0; k<aAssetUIDs.size(); ++k)
+            {
+                CEngineResult<SAsset> assetFetch = findAsset(aAssetUIDs[k]);
+
+                // Unknown and cached assets are completed right away.
+                CEngineResult<ByteBuffer> cached = { EEngineStatus::Error };
+                if(assetFetch.successful() && nullptr != cache)
+                {
+                    cached = cache->find(aAssetUIDs[k]);
+                }
+
+                if(not assetFetch.successful() || cached.successful())
+                {
+                    Promise_t promise {};
+                    futures[k] = promise.get_future().share();
+
+                    CEngineResult<ByteBuffer> result = std::move(cached);
+                    if(aCallback)
+                    {
+                        aCallback(k, result);
+                    }
+                    promise.set_value(std::move(result));
+                    continue;
+                }
+
+                SAsset const &asset = assetFetch.data();
+
+                SRead read { k, aAssetUIDs[k], asset.uri, nullptr };
+                if(EAssetCodec::None != asset.codec)
+                {
+                    read.promise = makeShared<Promise_t>();
+                    futures[k]   = read.promise->get_future().share();
+                }
+
+                reads.push_back(read);
+                paths.push_back(asset.uri);
+            }
+
+            Shared<threading::CJobSystem> const jobSystem = mJobSystem;
+
+            // Decompression is moved off the completing thread onto the job system, so that
+            // completions of the data source are never held up.
+            auto const onRead = [reads, jobSystem, cache, aCallback] (std::size_t aIndex, CEngineResult<ByteBuffer> const &aResult) -> void
+            {
+                SRead const &read = reads[aIndex];
+                if(nullptr == read.promise)
+                {
+                    if(aResult.successful() && nullptr != cache)
+                    {
+                        cache->insert(read.id, aResult.data());
+                    }
+
+                    if(aCallback)
+                    {
+                        aCallback(read.slot, aResult);
+                    }
+                    return;
+                }
+
+                auto const decompress = [read, jobSystem, cache, aCallback, aResult] () -> void
+                {
+                    CEngineResult<ByteBuffer> result = { EEngineStatus::Error };
+                    if(aResult.successful())
+                    {
+                        result = decompressAssetBlocks(aResult.data(), jobSystem);
+                        if(not result.successful())
+                        {
+                            CLog::Error(logTag(), "Failed to decompress asset data '{}'.", read.uri.string());
+                        }
+                        else if(nullptr != cache)
+                        {
+                            result = { EEngineStatus::Ok, CAssetDataCache::share(std::move(result.data())) };
+                            cache->insert(read.id, result.data());
+                        }
+                    }
+
+                    if(aCallback)
+                    {
+                        aCallback(read.slot, result);
+                    }
+                    read.promise->set_value(std::move(result));
+                };
+
+                if(nullptr != jobSystem)
+                {
+                    jobSystem->post<void>(decompress);
+                }
+                else
+                {
+                    decompress();
+                }
+            };
+
+            std::vector<AssetReadFuture_t> const stored = mAssetDataSource->readAssetsBatch(paths, onRead);
+            for(std::size_t k=0; k<reads.size(); ++k)
+            {
+                if(nullptr == reads[k].promise)
+                {
+                    futures[reads[k].slot] = stored[k];
+                }
+            }
+
+            return futures;
         }
         //<-----------------------------------------------------------------------------
 
@@ -155,6 +490,10 @@ namespace engine
         CEngineResult<> CAssetStorage::removeAsset(AssetId_t const &aAssetUID)
         {
             mAssetIndex.removeAsset(aAssetUID);
+            if(nullptr != mDataCache)
+            {
+                mDataCache->erase(aAssetUID);
+            }
 
             return { EEngineStatus::Ok };
         }
@@ -91,6 +91,21 @@ namespace engine
     }
     //<-----------------------------------------------------------------------------
 
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    template <>
+    asset::EAssetCodec from_string<asset::EAssetCodec>(std::string const &aInput)
+    {
+        using namespace asset;
+
+        if("LZ4"  == aInput || "lz4"  == aInput) return EAssetCodec::LZ4;
+        if("Zstd" == aInput || "zstd" == aInput) return EAssetCodec::Zstd;
+
+        return EAssetCodec::None;
+    }
+    //<-----------------------------------------------------------------------------
+
     //<-----------------------------------------------------------------------------
     //
     //<-----------------------------------------------------------------------------
@@ -133,4 +148,21 @@ namespace engine
         }
     }
     //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    template <>
+    std::string convert_to_string<asset::EAssetCodec>(asset::EAssetCodec const &aInput)
+    {
+        using namespace asset;
+
+        switch(aInput)
+        {
+            case EAssetCodec::LZ4:  return "LZ4";
+            case EAssetCodec::Zstd: return "Zstd";
+            default:                return "None";
+        }
+    }
+    //<-----------------------------------------------------------------------------
 }
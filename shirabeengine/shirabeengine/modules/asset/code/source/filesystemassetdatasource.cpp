@@ -1,15 +1,60 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
 #include "asset/filesystemassetdatasource.h"
+#include <platform/platform.h>
 #include <core/helpers.h>
 
+#if defined SHIRABE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace engine
 {
     namespace asset
     {
+        /**
+         * A read-only mapping of a file. Unmapped on destruction.
+         */
+        struct CFileSystemAssetDataSource::SFileMapping
+        {
+        public_constructors:
+            SFileMapping(void const *aAddress, uint64_t aSize, int64_t aModificationTime)
+                : address         (aAddress)
+                , size            (aSize)
+                , modificationTime(aModificationTime)
+            {}
+
+            SFileMapping(SFileMapping const &)            = delete;
+            SFileMapping &operator=(SFileMapping const &) = delete;
+
+        public_destructors:
+            ~SFileMapping()
+            {
+            #if defined SHIRABE_PLATFORM_LINUX
+                munmap(const_cast<void *>(address), size);
+            #endif
+            }
+
+        public_members:
+            void     const *address;
+            uint64_t        size;
+            int64_t         modificationTime; // Nanoseconds. Used to detect stale mappings.
+        };
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
-        CFileSystemAssetDataSource::CFileSystemAssetDataSource(std::filesystem::path const &aAssetSourcePath)
-            : mAssetSourcePath(aAssetSourcePath)
+        CFileSystemAssetDataSource::CFileSystemAssetDataSource(std::filesystem::path const &aAssetSourcePath, bool aUseMemoryMapping)
+            : mAssetSourcePath (aAssetSourcePath)
+            , mUseMemoryMapping(aUseMemoryMapping)
+            , mReadQueue       (nullptr)
+            , mMappingMutex    ()
+            , mMappings        ()
         { }
         //<-----------------------------------------------------------------------------
 
@@ -18,13 +63,92 @@ namespace engine
         //<-----------------------------------------------------------------------------
         CEngineResult<ByteBuffer> CFileSystemAssetDataSource::readAsset(std::filesystem::path const &aPath)
         {
+        #if defined SHIRABE_PLATFORM_LINUX
+            if(mUseMemoryMapping)
+            {
+                Shared<SFileMapping> const mapping = fetchMapping(aPath);
+                if(nullptr == mapping)
+                {
+                    return { EEngineStatus::Error };
+                }
+
+                // Assets are consumed front to back right after loading: Read ahead aggressively.
+                madvise(const_cast<void *>(mapping->address), mapping->size, MADV_SEQUENTIAL);
+                madvise(const_cast<void *>(mapping->address), mapping->size, MADV_WILLNEED);
+
+                // The view shares ownership of the mapping. No bytes are copied.
+                uint8_t const *const data = static_cast<uint8_t const *>(mapping->address);
+                ByteBuffer buffer(mapping, data, mapping->size);
+
+                return { EEngineStatus::Ok, std::move(buffer) };
+            }
+        #endif
+
             std::vector<uint8_t> fileContents = readFileBytes(aPath);
             if(fileContents.empty())
             {
                 return { EEngineStatus::Error };
             }
 
-            ByteBuffer buffer(std::move(fileContents), fileContents.size());
+            uint64_t const size = fileContents.size();
+            ByteBuffer buffer(std::move(fileContents), size);
+
+            return { EEngineStatus::Ok, std::move(buffer) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CFileSystemAssetDataSource::readAssetRange(std::filesystem::path const &aPath, uint64_t aOffset, uint64_t aLength)
+        {
+        #if defined SHIRABE_PLATFORM_LINUX
+            if(mUseMemoryMapping)
+            {
+                Shared<SFileMapping> const mapping = fetchMapping(aPath);
+                if(nullptr == mapping || mapping->size < aOffset)
+                {
+                    return { EEngineStatus::Error };
+                }
+
+                uint64_t const length = std::min(aLength, (mapping->size - aOffset));
+
+                uint8_t const *const data = (static_cast<uint8_t const *>(mapping->address) + aOffset);
+                if(0 < length)
+                {
+                    // Only fault in the pages of the range, not the whole file.
+                    uint64_t const pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+                    uint64_t const begin    = ((aOffset / pageSize) * pageSize);
+                    madvise(const_cast<uint8_t *>(static_cast<uint8_t const *>(mapping->address) + begin), ((aOffset + length) - begin), MADV_WILLNEED);
+                }
+
+                ByteBuffer buffer(mapping, data, length);
+
+                return { EEngineStatus::Ok, std::move(buffer) };
+            }
+        #endif
+
+            std::error_code error {};
+            uint64_t const size = std::filesystem::file_size(aPath, error);
+            if(error || size < aOffset)
+            {
+                return { EEngineStatus::Error };
+            }
+
+            uint64_t const length = std::min(aLength, (size - aOffset));
+
+            std::vector<uint8_t> range(length);
+
+            std::ifstream stream(aPath, std::ios::in | std::ios::binary);
+            stream.seekg(static_cast<std::streamoff>(aOffset));
+            stream.read(reinterpret_cast<char *>(range.data()), static_cast<std::streamsize>(length));
+            if(not stream.good() && 0 < length)
+            {
+                CLog::Error(logTag(), "Failed to read {} bytes at {} of '{}'.", length, aOffset, aPath.string());
+                return { EEngineStatus::Error };
+            }
+
+            ByteBuffer buffer(std::move(range), length);
 
             return { EEngineStatus::Ok, std::move(buffer) };
         }
@@ -39,5 +163,138 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        AssetReadFuture_t CFileSystemAssetDataSource::readAssetAsync(std::filesystem::path const &aPath, AssetReadCallback_t aCallback)
+        {
+            if(nullptr == mReadQueue)
+            {
+                return IAssetDataSource::readAssetAsync(aPath, std::move(aCallback));
+            }
+
+            SAssetReadRequest request {};
+            request.path = aPath;
+
+            return mReadQueue->submit(request, std::move(aCallback));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<AssetReadFuture_t> CFileSystemAssetDataSource::readAssetsBatch(std::vector<std::filesystem::path> const &aPaths, AssetReadBatchCallback_t aCallback)
+        {
+            if(nullptr == mReadQueue)
+            {
+                return IAssetDataSource::readAssetsBatch(aPaths, std::move(aCallback));
+            }
+
+            std::vector<SAssetReadRequest> requests(aPaths.size());
+            for(std::size_t k=0; k<aPaths.size(); ++k)
+            {
+                requests[k].path = aPaths[k];
+            }
+
+            return mReadQueue->submitBatch(requests, std::move(aCallback));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CFileSystemAssetDataSource::setReadQueue(Shared<CAssetReadQueue> const &aReadQueue)
+        {
+            mReadQueue = aReadQueue;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CFileSystemAssetDataSource::releaseMappings()
+        {
+            std::lock_guard<std::mutex> guard(mMappingMutex);
+            mMappings.clear();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t CFileSystemAssetDataSource::mappedByteCount() const
+        {
+            std::lock_guard<std::mutex> guard(mMappingMutex);
+
+            uint64_t count = 0;
+            for(auto const &[path, mapping] : mMappings)
+            {
+                count += mapping->size;
+            }
+            return count;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        Shared<CFileSystemAssetDataSource::SFileMapping> CFileSystemAssetDataSource::fetchMapping(std::filesystem::path const &aPath)
+        {
+        #if defined SHIRABE_PLATFORM_LINUX
+            std::string const key = aPath.string();
+
+            int const fileDescriptor = open(key.c_str(), O_RDONLY | O_CLOEXEC);
+            if(0 > fileDescriptor)
+            {
+                CLog::Error(logTag(), "Failed to open file '{}'. Error {}.", key, std::strerror(errno));
+                return nullptr;
+            }
+
+            struct stat fileStatus {};
+            if(0 != fstat(fileDescriptor, &fileStatus) || 0 == fileStatus.st_size)
+            {
+                close(fileDescriptor);
+                return nullptr;
+            }
+
+            uint64_t const size             = static_cast<uint64_t>(fileStatus.st_size);
+            int64_t  const modificationTime = (static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * 1000000000ll) + fileStatus.st_mtim.tv_nsec;
+
+            {
+                std::lock_guard<std::mutex> guard(mMappingMutex);
+
+                auto const iterator = mMappings.find(key);
+                if(mMappings.end() != iterator
+                   && size             == iterator->second->size
+                   && modificationTime == iterator->second->modificationTime)
+                {
+                    close(fileDescriptor);
+                    return iterator->second;
+                }
+            }
+
+            void *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            close(fileDescriptor); // The mapping keeps its own reference to the file.
+
+            if(MAP_FAILED == address)
+            {
+                CLog::Error(logTag(), "Failed to map file '{}'. Error {}.", key, std::strerror(errno));
+                return nullptr;
+            }
+
+            Shared<SFileMapping> mapping = makeShared<SFileMapping>(address, size, modificationTime);
+
+            std::lock_guard<std::mutex> guard(mMappingMutex);
+            // A stale mapping stays valid for buffers still referring to it.
+            mMappings[key] = mapping;
+
+            return mapping;
+        #else
+            SHIRABE_UNUSED(aPath);
+            return nullptr;
+        #endif
+        }
+        //<-----------------------------------------------------------------------------
+
     }
 }
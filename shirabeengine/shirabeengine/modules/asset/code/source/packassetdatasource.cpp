@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <platform/platform.h>
+#include "asset/packassetdatasource.h"
+
+#if defined SHIRABE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace engine
+{
+    namespace asset
+    {
+        /**
+         * A read-only mapping of the entire pack. Unmapped on destruction.
+         */
+        struct CPackAssetDataSource::SPackMapping
+        {
+        public_constructors:
+            SPackMapping(void const *aAddress, uint64_t aSize)
+                : address(aAddress)
+                , size   (aSize)
+            {}
+
+            SPackMapping(SPackMapping const &)            = delete;
+            SPackMapping &operator=(SPackMapping const &) = delete;
+
+        public_destructors:
+            ~SPackMapping()
+            {
+            #if defined SHIRABE_PLATFORM_LINUX
+                munmap(const_cast<void *>(address), size);
+            #endif
+            }
+
+        public_members:
+            void     const *address;
+            uint64_t        size;
+        };
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CPackAssetDataSource::CPackAssetDataSource(std::filesystem::path const &aPackPath, std::filesystem::path const &aAssetSourcePath)
+            : mPackPath       (aPackPath)
+            , mAssetSourcePath(aAssetSourcePath.lexically_normal())
+            , mMapping        (nullptr)
+            , mEntries        (nullptr)
+            , mEntryCount     (0)
+            , mEntryStorage   ()
+            , mMutex          ()
+            , mStream         ()
+        { }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        CPackAssetDataSource::~CPackAssetDataSource()
+        {
+            CEngineResult<> const deinitialization = deinitialize();
+            SHIRABE_UNUSED(deinitialization); // Always successful.
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CPackAssetDataSource::initialize()
+        {
+        #if defined SHIRABE_PLATFORM_LINUX
+            std::string const path = mPackPath.string();
+
+            int const fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if(0 > fileDescriptor)
+            {
+                CLog::Error(logTag(), "Failed to open asset pack '{}'. Error {}.", path, std::strerror(errno));
+                return { EEngineStatus::FileNotFound };
+            }
+
+            struct stat fileStatus {};
+            if(0 != fstat(fileDescriptor, &fileStatus) || sizeof(SAssetPackHeader) > static_cast<uint64_t>(fileStatus.st_size))
+            {
+                close(fileDescriptor);
+                CLog::Error(logTag(), "Asset pack '{}' is truncated.", path);
+                return { EEngineStatus::InitializationError };
+            }
+
+            uint64_t const size    = static_cast<uint64_t>(fileStatus.st_size);
+            void          *address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+            close(fileDescriptor); // The mapping keeps its own reference to the file.
+
+            if(MAP_FAILED == address)
+            {
+                CLog::Error(logTag(), "Failed to map asset pack '{}'. Error {}.", path, std::strerror(errno));
+                return { EEngineStatus::InitializationError };
+            }
+
+            // Accesses follow the load order of the assets, not the pack order.
+            madvise(address, size, MADV_RANDOM);
+
+            Shared<SPackMapping>     const mapping = makeShared<SPackMapping>(address, size);
+            SAssetPackHeader const *const header  = static_cast<SAssetPackHeader const *>(address);
+            if(not validateAssetPackHeader(*header, size))
+            {
+                CLog::Error(logTag(), "Asset pack '{}' has an invalid header.", path);
+                return { EEngineStatus::InitializationError };
+            }
+
+            uint8_t const *const base = static_cast<uint8_t const *>(address);
+
+            // The TOC is hit by every lookup. Fault it in right away.
+            madvise(const_cast<uint8_t *>(base + (header->tocOffset & ~(kAssetPackAlignment - 1))),
+                    (header->tocOffset % kAssetPackAlignment) + (header->entryCount * sizeof(SAssetPackEntry)),
+                    MADV_WILLNEED);
+
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            mMapping    = mapping;
+            mEntries    = reinterpret_cast<SAssetPackEntry const *>(base + header->tocOffset);
+            mEntryCount = header->entryCount;
+
+            return { EEngineStatus::Ok };
+        #else
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            mStream.open(mPackPath, std::ios::in | std::ios::binary);
+            if(not mStream.good())
+            {
+                CLog::Error(logTag(), "Failed to open asset pack '{}'.", mPackPath.string());
+                return { EEngineStatus::FileNotFound };
+            }
+
+            uint64_t const size = std::filesystem::file_size(mPackPath);
+
+            SAssetPackHeader header {};
+            mStream.read(reinterpret_cast<char *>(&header), sizeof(header));
+            if(not mStream.good() || not validateAssetPackHeader(header, size))
+            {
+                CLog::Error(logTag(), "Asset pack '{}' has an invalid header.", mPackPath.string());
+                mStream.close();
+                return { EEngineStatus::InitializationError };
+            }
+
+            mEntryStorage.resize(header.entryCount);
+            mStream.seekg(static_cast<std::streamoff>(header.tocOffset));
+            mStream.read(reinterpret_cast<char *>(mEntryStorage.data()), static_cast<std::streamsize>(header.entryCount * sizeof(SAssetPackEntry)));
+            if(not mStream.good())
+            {
+                CLog::Error(logTag(), "Failed to read the TOC of asset pack '{}'.", mPackPath.string());
+                mStream.close();
+                return { EEngineStatus::InitializationError };
+            }
+
+            mEntries    = mEntryStorage.data();
+            mEntryCount = header.entryCount;
+
+            return { EEngineStatus::Ok };
+        #endif
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CPackAssetDataSource::deinitialize()
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            mEntries    = nullptr;
+            mEntryCount = 0;
+            mMapping    = nullptr;
+            mEntryStorage.clear();
+            if(mStream.is_open())
+            {
+                mStream.close();
+            }
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CPackAssetDataSource::readAsset(std::filesystem::path const &aPath)
+        {
+            // Asset ids are derived from the path relative to the asset root.
+            std::filesystem::path const relativePath = aPath.lexically_normal().lexically_relative(mAssetSourcePath);
+            AssetId_t             const assetId      = assetIdFromUri(relativePath);
+
+            return readAssetById(assetId);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CPackAssetDataSource::readAssetRange(std::filesystem::path const &aPath, uint64_t aOffset, uint64_t aLength)
+        {
+            std::filesystem::path const relativePath = aPath.lexically_normal().lexically_relative(mAssetSourcePath);
+            AssetId_t             const assetId      = assetIdFromUri(relativePath);
+
+            auto const [lookupResult, entry] = findEntry(assetId);
+            if(CheckEngineError(lookupResult))
+            {
+                return { lookupResult };
+            }
+
+            return readEntry(entry, aOffset, aLength);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CPackAssetDataSource::writeAsset(std::filesystem::path const &aPath, ByteBuffer const &aBuffer)
+        {
+            SHIRABE_UNUSED(aPath);
+            SHIRABE_UNUSED(aBuffer);
+
+            // Packs are read-only. They are written by the resource compiler.
+            return { EEngineStatus::Error };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CPackAssetDataSource::readAssetById(AssetId_t const &aAssetId)
+        {
+            auto const [lookupResult, entry] = findEntry(aAssetId);
+            if(CheckEngineError(lookupResult))
+            {
+                return { lookupResult };
+            }
+
+            return readEntry(entry, 0, entry.storedSize);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<SAssetPackEntry> CPackAssetDataSource::findEntry(AssetId_t const &aAssetId)
+        {
+            std::lock_guard<std::mutex> guard(mMutex);
+
+            // Copy the entry. The TOC is released on deinitialization.
+            SAssetPackEntry const *const entry = findAssetPackEntry(mEntries, mEntryCount, aAssetId);
+            if(nullptr == entry)
+            {
+                CLog::Error(logTag(), "Asset {} not found in asset pack '{}'.", aAssetId, mPackPath.string());
+                return { EEngineStatus::FileNotFound };
+            }
+
+            return { EEngineStatus::Ok, *entry };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CPackAssetDataSource::readEntry(SAssetPackEntry const &aEntry, uint64_t aOffset, uint64_t aLength)
+        {
+            if(aEntry.storedSize < aOffset)
+            {
+                return { EEngineStatus::Error };
+            }
+
+            uint64_t const length = std::min(aLength, (aEntry.storedSize - aOffset));
+            uint64_t const offset = (aEntry.offset + aOffset);
+
+            // Compressed payloads are returned as stored. The asset storage decompresses them
+            // according to the codec recorded in the asset index.
+        #if defined SHIRABE_PLATFORM_LINUX
+            Shared<SPackMapping> mapping = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(mMutex);
+                mapping = mMapping;
+            }
+
+            if(nullptr == mapping || mapping->size < offset || (mapping->size - offset) < length)
+            {
+                return { EEngineStatus::Error };
+            }
+
+            uint8_t const *const data = (static_cast<uint8_t const *>(mapping->address) + offset);
+
+            // The range is consumed front to back. Advise from the page it starts on.
+            uint64_t const pageSize  = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+            uint64_t const pageBegin = ((offset / pageSize) * pageSize);
+            madvise(const_cast<uint8_t *>(static_cast<uint8_t const *>(mapping->address) + pageBegin), ((offset + length) - pageBegin), MADV_WILLNEED);
+
+            // The view shares ownership of the mapping. No bytes are copied.
+            ByteBuffer buffer(mapping, data, length);
+
+            return { EEngineStatus::Ok, std::move(buffer) };
+        #else
+            std::vector<uint8_t> data(length);
+            {
+                std::lock_guard<std::mutex> guard(mMutex);
+
+                mStream.seekg(static_cast<std::streamoff>(offset));
+                mStream.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(length));
+                if(not mStream.good())
+                {
+                    mStream.clear();
+                    return { EEngineStatus::Error };
+                }
+            }
+
+            ByteBuffer buffer(std::move(data), length);
+
+            return { EEngineStatus::Ok, std::move(buffer) };
+        #endif
+        }
+        //<-----------------------------------------------------------------------------
+
+    }
+}
@@ -4,12 +4,17 @@
 #include <vector>
 #include <functional>
 #include <cstdint>
+#include <memory>
 #include <base/declaration.h>
 
 namespace engine {
 
     /**
+     * A CDataBuffer either owns its data in a vector or refers to external memory.
      *
+     * External memory may be kept alive by a ref-counted owner, e.g. a file mapping.
+     * Copies and views of such a buffer share the owner instead of copying the data,
+     * so the memory stays valid as long as any buffer refers to it.
      */
     template <typename T>
     class CDataBuffer
@@ -33,6 +38,15 @@ namespace engine {
         CDataBuffer( std::vector<T> &&aData, uint64_t const aSize);
         CDataBuffer( T const *const aData, uint64_t const aSize);
 
+        /**
+         * Create a read-only view of external memory, which is kept alive by aOwner.
+         *
+         * @param aOwner Ref-counted owner of the memory.
+         * @param aData  Pointer to the first element.
+         * @param aSize  Number of elements.
+         */
+        CDataBuffer( std::shared_ptr<void const> aOwner, T const *const aData, uint64_t const aSize);
+
     public_destructors:
         ~CDataBuffer()
         {
@@ -88,21 +102,41 @@ namespace engine {
             return mSize;
         }
 
+        /**
+         * Check, whether this buffer refers to external memory instead of owning a vector.
+         * The data of such a buffer is read-only and dataVector() is empty.
+         *
+         * @return See brief.
+         */
+        inline bool isView() const
+        {
+            return mUseRawData;
+        }
+
+        /**
+         * Create a view of a subrange of this buffer. The view shares the owner of this buffer.
+         * Views of vector backed buffers don't keep the vector alive.
+         *
+         * @param aOffset Index of the first element.
+         * @param aSize   Number of elements.
+         * @return        The view or an empty buffer, if the range exceeds this buffer.
+         */
         CDataBuffer<T> const createView(uint64_t const &aOffset, uint64_t const &aSize) const
         {
-            if(mSize <= (aOffset + aSize))
+            if(mSize < (aOffset + aSize))
             {
                 return {}; // Empty view...
             }
 
-            return CDataBuffer(mRawData + aOffset, aSize);
+            return CDataBuffer(mOwner, data() + aOffset, aSize);
         }
 
     private_members:
-        std::vector<T> mVectorData;
-        T       const *mRawData;
-        uint64_t       mSize;
-        bool           mUseRawData;
+        std::vector<T>              mVectorData;
+        T                   const  *mRawData;
+        uint64_t                    mSize;
+        bool                        mUseRawData;
+        std::shared_ptr<void const> mOwner;
     };
     //<-----------------------------------------------------------------------------
 
@@ -130,6 +164,7 @@ namespace engine {
         , mRawData(nullptr)
         , mSize(0)
         , mUseRawData(false)
+        , mOwner()
     {}
     //<-----------------------------------------------------------------------------
 
@@ -142,6 +177,7 @@ namespace engine {
         , mRawData(aOther.mRawData)
         , mSize(aOther.mSize)
         , mUseRawData(aOther.mUseRawData)
+        , mOwner(aOther.mOwner)
     { }
     //<-----------------------------------------------------------------------------
 
@@ -154,6 +190,7 @@ namespace engine {
         , mRawData(std::move(aOther.mRawData))
         , mSize(std::move(aOther.mSize))
         , mUseRawData(aOther.mUseRawData)
+        , mOwner(std::move(aOther.mOwner))
     { }
     //<-----------------------------------------------------------------------------
 
@@ -168,6 +205,7 @@ namespace engine {
         , mRawData(nullptr)
         , mSize(aSize)
         , mUseRawData(false)
+        , mOwner()
     {}
     //<-----------------------------------------------------------------------------
 
@@ -182,6 +220,23 @@ namespace engine {
             , mRawData(std::move(aData))
             , mSize(aSize)
             , mUseRawData(true)
+            , mOwner()
+    {}
+    //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    template <typename T>
+    CDataBuffer<T>::CDataBuffer(
+            std::shared_ptr<void const>       aOwner,
+            T                   const * const aData,
+            uint64_t                    const aSize)
+            : mVectorData(0)
+            , mRawData(aData)
+            , mSize(aSize)
+            , mUseRawData(true)
+            , mOwner(std::move(aOwner))
     {}
     //<-----------------------------------------------------------------------------
 
@@ -195,6 +250,7 @@ namespace engine {
         mRawData    = aOther.mRawData;
         mSize       = aOther.mSize;
         mUseRawData = aOther.mUseRawData;
+        mOwner      = aOther.mOwner;
 
         return (*this);
     }
@@ -206,6 +262,7 @@ namespace engine {
         mRawData    = std::move(aOther.mRawData);
         mSize       = std::move(aOther.mSize);
         mUseRawData = std::move(aOther.mUseRawData);
+        mOwner      = std::move(aOther.mOwner);
 
         return (*this);
     }
@@ -0,0 +1,225 @@
+#ifndef __SHIRABE_THREADING_ASYNCRESULT_H__
+#define __SHIRABE_THREADING_ASYNCRESULT_H__
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <base/declaration.h>
+#include "core/enginetypehelper.h"
+#include "core/enginestatus.h"
+#include "core/threading/taskgraph.h"
+
+namespace engine
+{
+    namespace threading
+    {
+        /**
+         * Storage of the value produced by a task of a CAsyncResult.
+         * Written by the task before its node is marked finished and read-only afterwards.
+         */
+        template <typename T>
+        struct SAsyncValue
+        {
+        public_members:
+            CEngineResult<T> result;
+        };
+
+        /**
+         * A CAsyncResult refers to a value of type T produced by a node of a CTaskGraph.
+         *
+         * Stages of a pipeline, e.g. "read bytes" -> "deserialize" -> "create instance", are
+         * chained with then(...). Each stage runs as soon as its predecessor finished, on any
+         * worker of the graph's job system, so that the stages of many pipelines overlap.
+         * An error result of a stage skips all following stages.
+         *
+         * @tparam T The value type.
+         */
+        template <typename T>
+        class CAsyncResult
+        {
+        public_typedefs:
+            using Value_t = T;
+
+        public_constructors:
+            /**
+             * Create an invalid result.
+             */
+            CAsyncResult()
+                : mGraph(nullptr)
+                , mHandle()
+                , mValue(nullptr)
+            {}
+
+            /**
+             * Create a result for a node writing aValue.
+             *
+             * @param aGraph  The graph owning the node.
+             * @param aHandle The node producing the value.
+             * @param aValue  The value storage written by the node.
+             */
+            CAsyncResult(
+                    CTaskGraph                    *aGraph,
+                    CTaskHandle            const  &aHandle,
+                    Shared<SAsyncValue<T>> const  &aValue)
+                : mGraph(aGraph)
+                , mHandle(aHandle)
+                , mValue(aValue)
+            {}
+
+        public_methods:
+            /**
+             * Check, whether this result refers to a node.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool valid() const
+            {
+                return (nullptr != mGraph && mHandle.valid() && nullptr != mValue);
+            }
+
+            /**
+             * Check, whether the value is available or the producing stage failed or was skipped.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool finished() const
+            {
+                return mHandle.finished();
+            }
+
+            /**
+             * Return the handle of the producing node, e.g. to join it with other tasks.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE CTaskHandle const &handle() const
+            {
+                return mHandle;
+            }
+
+            /**
+             * Wait for the value, executing other pending jobs in the meantime.
+             *
+             * @return The value or an error, if any stage of the chain failed.
+             */
+            CEngineResult<T> get() const
+            {
+                if(not valid())
+                {
+                    return { EEngineStatus::Error };
+                }
+
+                CEngineResult<> const status = mHandle.wait();
+                if(not status.successful())
+                {
+                    return { status.result() };
+                }
+
+                return mValue->result;
+            }
+
+            /**
+             * Chain a stage consuming the value once available.
+             *
+             * @tparam TFunction Callable of signature CEngineResult<U>(T const &).
+             * @param aFunction  The stage to run.
+             * @return           A result referring to the value of the new stage.
+             */
+            template <typename TFunction>
+            auto then(TFunction &&aFunction) const
+                -> CAsyncResult<typename std::invoke_result_t<TFunction, T const &>::value_type>
+            {
+                using Next_t = typename std::invoke_result_t<TFunction, T const &>::value_type;
+
+                if(not valid())
+                {
+                    return {};
+                }
+
+                Shared<SAsyncValue<T>> const input = mValue;
+
+                return CAsyncResult<Next_t>::async(*mGraph, [input, function = std::forward<TFunction>(aFunction)] () -> CEngineResult<Next_t>
+                {
+                    return function(input->result.data());
+                }, { mHandle });
+            }
+
+        public_static_functions:
+            /**
+             * Add a task producing a value of type T to aGraph.
+             *
+             * @param aGraph        The graph to add the task to.
+             * @param aFunction     The task producing the value.
+             * @param aDependencies Further tasks to wait for.
+             * @return              A result referring to the value.
+             */
+            template <typename TFunction>
+            static CAsyncResult<T> async(
+                    CTaskGraph                     &aGraph,
+                    TFunction                     &&aFunction,
+                    std::vector<CTaskHandle> const &aDependencies = {})
+            {
+                Shared<SAsyncValue<T>> value = makeShared<SAsyncValue<T>>();
+
+                // std::function requires copyable targets. Keep move-only captures working.
+                Shared<std::decay_t<TFunction>> function = makeShared<std::decay_t<TFunction>>(std::forward<TFunction>(aFunction));
+
+                CTaskHandle const handle = aGraph.add([value, function] () -> CEngineResult<>
+                {
+                    value->result = (*function)();
+                    return { value->result.result() };
+                }, aDependencies);
+
+                return CAsyncResult<T>(&aGraph, handle, value);
+            }
+
+        private_members:
+            CTaskGraph             *mGraph;
+            CTaskHandle             mHandle;
+            Shared<SAsyncValue<T>>  mValue;
+        };
+
+        /**
+         * Add a task producing a value of type T to aGraph.
+         *
+         * @tparam T            The value type.
+         * @param aGraph        The graph to add the task to.
+         * @param aFunction     Callable of signature CEngineResult<T>().
+         * @param aDependencies Further tasks to wait for.
+         * @return              A result referring to the value.
+         */
+        template <typename T, typename TFunction>
+        CAsyncResult<T> async(
+                CTaskGraph                     &aGraph,
+                TFunction                     &&aFunction,
+                std::vector<CTaskHandle> const &aDependencies = {})
+        {
+            return CAsyncResult<T>::async(aGraph, std::forward<TFunction>(aFunction), aDependencies);
+        }
+
+        /**
+         * Create a result, which is immediately available.
+         *
+         * @tparam T      The value type.
+         * @param aGraph  The graph to add the task to.
+         * @param aValue  The value.
+         * @return        A result referring to the value.
+         */
+        template <typename T>
+        CAsyncResult<T> ready(
+                CTaskGraph             &aGraph,
+                CEngineResult<T> const &aValue)
+        {
+            Shared<SAsyncValue<T>> value = makeShared<SAsyncValue<T>>();
+            value->result = aValue;
+
+            CTaskHandle const handle = aGraph.add([value] () -> CEngineResult<> { return { value->result.result() }; });
+
+            return CAsyncResult<T>(&aGraph, handle, value);
+        }
+    }
+}
+
+#endif
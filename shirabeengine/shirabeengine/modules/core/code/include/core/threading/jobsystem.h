@@ -0,0 +1,472 @@
+#ifndef __SHIRABE_THREADING_JOBSYSTEM_H__
+#define __SHIRABE_THREADING_JOBSYSTEM_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <base/declaration.h>
+#include <log/log.h>
+#include "core/enginetypehelper.h"
+#include "core/enginestatus.h"
+#include "core/threading/looper.h"
+
+namespace engine
+{
+    namespace threading
+    {
+        class CJobSystem;
+
+        /**
+         * The SJobState struct holds the completion state of a posted job, shared
+         * between the job system and all handles referring to the job.
+         */
+        struct SJobState
+        {
+        public_constructors:
+            SJobState()
+                : finished(false)
+            {}
+
+        public_members:
+            std::atomic_bool finished;
+        };
+
+        /**
+         * A CJobHandle refers to a job posted to a CJobSystem and permits to wait for
+         * its completion and to fetch its result.
+         *
+         * Waiting on a handle does not block the calling thread idle. Instead it executes
+         * other pending jobs of the job system until the awaited job is finished, so that
+         * workers waiting for each other can't starve the system.
+         *
+         * @tparam TResult The result type of the job.
+         */
+        template <typename TResult>
+        class CJobHandle
+        {
+        public_constructors:
+            /**
+             * Create an invalid handle.
+             */
+            CJobHandle()
+                : mSystem(nullptr)
+                , mState (nullptr)
+                , mFuture()
+            {}
+
+            /**
+             * Create a handle for a posted job.
+             *
+             * @param aSystem The job system the job was posted to.
+             * @param aState  The completion state of the job.
+             * @param aFuture The future receiving the job result.
+             */
+            CJobHandle(
+                    CJobSystem                        *aSystem,
+                    Shared<SJobState>           const &aState,
+                    std::shared_future<TResult> const &aFuture)
+                : mSystem(aSystem)
+                , mState (aState)
+                , mFuture(aFuture)
+            {}
+
+        public_methods:
+            /**
+             * Check, whether this handle refers to a successfully posted job.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool valid() const
+            {
+                return (nullptr != mState && mFuture.valid());
+            }
+
+            /**
+             * Check, whether the job was executed.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool finished() const
+            {
+                return (valid() && mState->finished.load(std::memory_order_acquire));
+            }
+
+            /**
+             * Wait for the job to finish or to be discarded, executing other pending jobs in the meantime.
+             */
+            void wait() const;
+
+            /**
+             * Wait for the job to finish and return its result.
+             *
+             * @return The job result.
+             * @throw  std::future_error, if the job was discarded without being executed.
+             */
+            TResult get() const
+            {
+                wait();
+                return mFuture.get();
+            }
+
+            /**
+             * Return the underlying future, e.g. to hand it over to APIs expecting one.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE std::shared_future<TResult> const &future() const
+            {
+                return mFuture;
+            }
+
+        private_members:
+            CJobSystem                  *mSystem;
+            Shared<SJobState>            mState;
+            std::shared_future<TResult>  mFuture;
+        };
+
+        /**
+         * The CJobSystem runs jobs on a fixed set of worker threads.
+         *
+         * Each worker owns a deque of jobs. Jobs posted from a worker are pushed to and popped
+         * from the back of its own deque (LIFO, cache friendly for nested jobs), while idle
+         * workers steal from the front of other workers' deques (FIFO, oldest and usually
+         * largest work first). Jobs posted from non-worker threads are distributed round robin.
+         *
+         * The lifecycle mirrors the one of CLooper: initialize, run, abortAndJoin, deinitialize.
+         */
+        class SHIRABE_TEST_EXPORT CJobSystem
+        {
+            SHIRABE_DECLARE_LOG_TAG(CJobSystem)
+
+        public_typedefs:
+            using JobFn_t = std::function<void()>;
+
+        public_classes:
+            /**
+             * The CDispatcher provides the same posting interface as CLooper<TTaskResult>::CDispatcher,
+             * so that looper clients can submit their tasks to the job system without changes.
+             *
+             * @tparam TTaskResult The result type of the tasks posted.
+             */
+            template <typename TTaskResult>
+            class CDispatcher
+            {
+            public_typedefs:
+                using TaskType = typename ILooper<TTaskResult>::CTask;
+
+            public_constructors:
+                SHIRABE_INLINE explicit CDispatcher(CJobSystem &aJobSystem)
+                    : mAssignedJobSystem(aJobSystem)
+                {}
+
+            public_methods:
+                /**
+                 * Immediately append the task provided to the job system.
+                 *
+                 * @return True, if successful. False otherwise.
+                 */
+                bool post(TaskType &&aTask);
+
+                /**
+                 * Append the task provided to the job system, once the timeout elapsed.
+                 *
+                 * @param aTask
+                 * @param aTimeoutMilliseconds
+                 * @return                     True, if successful. False otherwise.
+                 */
+                bool postDelayed(
+                        TaskType      &&aTask,
+                        uint64_t const &aTimeoutMilliseconds = 0);
+
+            private_members:
+                CJobSystem &mAssignedJobSystem;
+            };
+
+        public_constructors:
+            CJobSystem();
+
+            CJobSystem(CJobSystem const &)            = delete;
+            CJobSystem(CJobSystem &&)                 = delete;
+            CJobSystem &operator=(CJobSystem const &) = delete;
+            CJobSystem &operator=(CJobSystem &&)      = delete;
+
+        public_destructors:
+            ~CJobSystem();
+
+        public_methods:
+            /**
+             * Initialize the worker queues.
+             *
+             * @param aWorkerCount The number of workers to spawn. If 0, one per hardware thread.
+             * @return             True, if successful. False otherwise.
+             */
+            bool initialize(uint32_t const &aWorkerCount = 0);
+
+            /**
+             * Discard all pending jobs and release the worker queues.
+             * Discarded jobs are marked finished and their futures receive a broken promise.
+             *
+             * @return True, if successful. False, if still running.
+             */
+            bool deinitialize();
+
+            /**
+             * Start all worker threads.
+             *
+             * @return True, if successful. False otherwise.
+             */
+            bool run();
+
+            /**
+             * Check, whether the workers are running.
+             *
+             * @return See brief.
+             */
+            bool running() const;
+
+            /**
+             * Stop all workers and join them.
+             *
+             * @return True, if successful. False otherwise.
+             */
+            bool abortAndJoin();
+
+            /**
+             * Return the number of workers.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint32_t workerCount() const
+            {
+                return static_cast<uint32_t>(mWorkers.size());
+            }
+
+            /**
+             * Post a function returning TResult to the job system.
+             *
+             * @tparam TResult  The result type of the function.
+             * @param aFunction The function to execute.
+             * @return          A handle to wait for and fetch the result. Invalid on error.
+             */
+            template <typename TResult>
+            CJobHandle<TResult> post(std::function<TResult()> aFunction);
+
+            /**
+             * Post a function to the job system, which will be enqueued once the delay elapsed.
+             * Delayed jobs are released by the workers, no additional threads are involved.
+             *
+             * @param aFunction            The function to execute.
+             * @param aTimeoutMilliseconds The delay in milliseconds.
+             * @return                     True, if successful. False otherwise.
+             */
+            bool postDelayed(
+                    JobFn_t         aFunction,
+                    uint64_t const &aTimeoutMilliseconds);
+
+            /**
+             * Execute a single pending job on the calling thread, if any.
+             * Used to help out while waiting for other jobs.
+             *
+             * @return True, if a job was executed. False otherwise.
+             */
+            bool tryRunPendingJob();
+
+            /**
+             * Block for a short period of time or until any job finished.
+             * Used by waiters, if there was no job to help out with. Jobs only signal
+             * their completion, while there are waiters blocked in here.
+             */
+            void waitForProgress();
+
+            /**
+             * Return a looper compatible dispatcher for tasks returning TTaskResult.
+             *
+             * @return See brief.
+             */
+            template <typename TTaskResult>
+            SHIRABE_INLINE CDispatcher<TTaskResult> getDispatcher()
+            {
+                return CDispatcher<TTaskResult>(*this);
+            }
+
+        private_structs:
+            struct SJob
+            {
+                JobFn_t           function;
+                Shared<SJobState> state;
+            };
+
+            struct SWorker
+            {
+                std::mutex              mutex;
+                std::deque<SJob>        jobs;
+                std::thread             thread;
+            };
+
+            struct SDelayedJob
+            {
+                std::chrono::steady_clock::time_point deadline;
+                JobFn_t                               function;
+
+                bool operator>(SDelayedJob const &aOther) const
+                {
+                    return (deadline > aOther.deadline);
+                }
+            };
+
+        private_methods:
+            /**
+             * Push a job to the own deque, if called from a worker, or to the next deque in round robin order.
+             *
+             * @param aJob The job to enqueue.
+             * @return     True, if successful. False otherwise.
+             */
+            bool enqueue(SJob &&aJob);
+
+            /**
+             * Pop a job from the back of the own deque or steal one from the front of another deque.
+             *
+             * @param aOutJob The job fetched.
+             * @return        True, if a job was fetched. False otherwise.
+             */
+            bool fetch(SJob &aOutJob);
+
+            /**
+             * Execute a job and signal its completion.
+             *
+             * @param aJob The job to execute.
+             */
+            void execute(SJob &aJob);
+
+            /**
+             * Move all delayed jobs with elapsed deadline into the worker deques.
+             */
+            void releaseDelayedJobs();
+
+            /**
+             * Thread func to be executed on each worker thread.
+             *
+             * @param aWorkerIndex The index of the worker.
+             */
+            void runFunc(uint32_t aWorkerIndex);
+
+        private_members:
+            std::vector<Unique<SWorker>> mWorkers;
+            std::atomic_bool             mRunning;
+            std::atomic_bool             mAbortRequested;
+            std::atomic<uint64_t>        mNextWorker;
+            std::atomic<uint64_t>        mPendingJobCount;
+            std::atomic<uint32_t>        mWaiterCount;
+
+            std::mutex                   mWakeMutex;
+            std::condition_variable      mWakeCondition;
+            std::condition_variable      mProgressCondition;
+
+            std::mutex                   mDelayedJobsMutex;
+            std::priority_queue<SDelayedJob, std::vector<SDelayedJob>, std::greater<SDelayedJob>> mDelayedJobs;
+        };
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TResult>
+        void CJobHandle<TResult>::wait() const
+        {
+            if(not valid())
+            {
+                return;
+            }
+
+            if(nullptr == mSystem)
+            {
+                mFuture.wait();
+                return;
+            }
+
+            // A discarded job never finishes, but its broken promise readies the future.
+            auto const discarded = [this] () -> bool
+            {
+                return (std::future_status::ready == mFuture.wait_for(std::chrono::seconds(0)));
+            };
+
+            while(not finished() && not discarded())
+            {
+                if(not mSystem->tryRunPendingJob())
+                {
+                    mSystem->waitForProgress();
+                }
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TResult>
+        CJobHandle<TResult> CJobSystem::post(std::function<TResult()> aFunction)
+        {
+            try
+            {
+                Shared<std::packaged_task<TResult()>> task   = makeShared<std::packaged_task<TResult()>>(std::move(aFunction));
+                std::shared_future<TResult>           future = task->get_future().share();
+
+                SJob job {};
+                job.function = [task] () -> void { (*task)(); };
+                job.state    = makeShared<SJobState>();
+
+                Shared<SJobState> state = job.state;
+
+                if(not enqueue(std::move(job)))
+                {
+                    return {};
+                }
+
+                return CJobHandle<TResult>(this, state, future);
+            }
+            catch(...)
+            {
+                CLog::Error(logTag(), "Failed to post job.");
+                return {};
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CJobSystem::CDispatcher<TTaskResult>::post(TaskType &&aTask)
+        {
+            // CTask is move-only, while std::function requires copyable targets.
+            Shared<TaskType> task = makeShared<TaskType>(std::move(aTask));
+
+            CJobHandle<void> const handle = mAssignedJobSystem.post<void>([task] () -> void { task->run(); });
+            return handle.valid();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CJobSystem::CDispatcher<TTaskResult>::postDelayed(
+                TaskType      &&aTask,
+                uint64_t const &aTimeoutMilliseconds)
+        {
+            Shared<TaskType> task = makeShared<TaskType>(std::move(aTask));
+
+            return mAssignedJobSystem.postDelayed([task] () -> void { task->run(); }, aTimeoutMilliseconds);
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
+
+#endif
@@ -1,6 +1,11 @@
 #ifndef __SHIRABE_THREADING_LOOPER_H__
 #define __SHIRABE_THREADING_LOOPER_H__
 
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <type_traits>
 #include <thread>
 #include <future>
@@ -10,6 +15,8 @@
 #include <log/log.h>
 #include "core/enginetypehelper.h"
 #include "core/enginestatus.h"
+#include "core/threading/mpscqueue.h"
+#include "core/threading/timerwheel.h"
 
 namespace engine
 {
@@ -28,6 +35,73 @@ namespace engine
             TonyStark = 1337 // 04/10/2017 - 04:49: Now i want to watch Avengers...
         };
 
+        /**
+         * Number of distinct ETaskPriority levels.
+         */
+        static constexpr std::size_t const kTaskPriorityLevelCount = 6;
+
+        /**
+         * Map a task priority to a dense level index in [0, kTaskPriorityLevelCount),
+         * where higher priorities map to higher indices.
+         *
+         * @param aPriority The priority to map.
+         * @return          The level index of aPriority.
+         */
+        SHIRABE_INLINE std::size_t taskPriorityLevel(ETaskPriority const &aPriority)
+        {
+            switch(aPriority)
+            {
+            case ETaskPriority::Least:     return 0;
+            case ETaskPriority::Less:      return 1;
+            case ETaskPriority::Normal:    return 2;
+            case ETaskPriority::Higher:    return 3;
+            case ETaskPriority::Highest:   return 4;
+            case ETaskPriority::TonyStark: return 5;
+            }
+
+            return 2;
+        }
+
+        /**
+         * The SLooperPriorityStatistics struct collects queue depth and wait time
+         * figures of a single priority level of a looper.
+         */
+        struct SLooperPriorityStatistics
+        {
+        public_members:
+            uint64_t enqueued;
+            uint64_t dequeued;
+            uint64_t queueDepth;
+            uint64_t maxQueueDepth;
+            uint64_t totalWaitMicroseconds;
+            uint64_t maxWaitMicroseconds;
+
+        public_methods:
+            /**
+             * Return the average time in microseconds a task of this level spent in the queue.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint64_t averageWaitMicroseconds() const
+            {
+                return (0 == dequeued) ? 0 : (totalWaitMicroseconds / dequeued);
+            }
+        };
+
+        /**
+         * Default interval after which a waiting looper task is promoted by one priority level.
+         *
+         * Aging only guards against starvation, it must not flatten the priorities under regular load.
+         * At 500ms a fresh task keeps precedence over lower levels for about 30 frames at 60Hz per level,
+         * while a Least task still outranks a fresh Normal task after 1s and a fresh TonyStark task after 2.5s.
+         */
+        static constexpr std::chrono::milliseconds const kDefaultLooperAgingInterval = std::chrono::milliseconds(500);
+
+        /**
+         * Statistics of all priority levels, indexed by taskPriorityLevel(...).
+         */
+        using LooperStatistics_t = std::array<SLooperPriorityStatistics, kTaskPriorityLevelCount>;
+
         /**
          * Interface and Task-Implementation for tasks returning a TTaskResult.
          *
@@ -201,6 +275,7 @@ namespace engine
 
                 /**
                  * Delay insert the task provided into the looper queue.
+                 * The delay is tracked by the looper thread itself, no additional threads are spawned.
                  *
                  * @param aOther
                  * @param aTimeoutMilliseconds
@@ -210,42 +285,40 @@ namespace engine
                         TaskType      &&aOther,
                         uint64_t const &aTimeoutMilliseconds = 0);
 
-            private_constructors:
                 /**
-                 * Create a handler based on the provided looper.
+                 * Delay insert the task provided into the looper queue and return a timer id,
+                 * which permits to cancel the task before it is due.
                  *
-                 * @param aLooper
+                 * @param aOther
+                 * @param aTimeoutMilliseconds
+                 * @param aOutTimerId          The id of the timer scheduled.
+                 * @return                     True, if successful. False otherwise.
                  */
-                SHIRABE_INLINE CDispatcher(LooperType &aLooper)
-                    : mAssignedLooper(aLooper)
-                {}
+                bool postDelayed(
+                        TaskType       &&aOther,
+                        uint64_t const  &aTimeoutMilliseconds,
+                        TimerId_t       &aOutTimerId);
 
-            private_methods:
                 /**
-                 * Check, if the task was executed and finished, indicated by
-                 * the future having received any kind of result.
+                 * Cancel a delayed task, which is not yet due.
                  *
-                 * @param f
-                 * @return
-                 */
-                bool is_ready(std::future<TTaskResult> const& f);
-
-                /**
-                 * In case of a delayed post, store the future in a list.
-                 * @param f
+                 * @param aTimerId The id returned by postDelayed.
+                 * @return         True, if the task was cancelled. False, if it is already due or unknown.
                  */
-                void storeDelayedPostFuture(std::future<TTaskResult>& f);
+                bool cancelDelayed(TimerId_t const &aTimerId);
 
+            private_constructors:
                 /**
-                 * Review the list of delayed post handles and check if results
-                 * have been returned already.
+                 * Create a handler based on the provided looper.
+                 *
+                 * @param aLooper
                  */
-                void checkDelayedPostFutures();
+                SHIRABE_INLINE CDispatcher(LooperType &aLooper)
+                    : mAssignedLooper(aLooper)
+                {}
 
-            private_methods:
-                LooperType                            &mAssignedLooper;
-                std::recursive_mutex                   mDelayedPostFuturesMutex;
-                std::vector<std::future<TTaskResult>>  mDelayedPostFutures;
+            private_members:
+                LooperType &mAssignedLooper;
             };
 
         public_constructors:
@@ -316,6 +389,33 @@ namespace engine
                 return mDispatcher;
             }
 
+            /**
+             * Set the interval after which a waiting task is promoted by one priority level.
+             * This prevents low priority tasks from starving behind a steady stream of high
+             * priority tasks. A task of level k competes with level k+n after n intervals.
+             * Defaults to kDefaultLooperAgingInterval.
+             *
+             * @param aAgingInterval The aging interval. Zero disables aging.
+             */
+            void setAgingInterval(std::chrono::milliseconds const &aAgingInterval);
+
+            /**
+             * Return a snapshot of the per priority queue statistics.
+             *
+             * @return See brief.
+             */
+            LooperStatistics_t statistics();
+
+        private_structs:
+            /**
+             * A task in the priority queues, stamped with the time it was enqueued.
+             */
+            struct SQueuedTask
+            {
+                TaskType                              task;
+                std::chrono::steady_clock::time_point enqueueTime;
+            };
+
          private_methods:
             /**
              * Signal the worker thread, that shutdown is required.
@@ -336,7 +436,9 @@ namespace engine
             }
 
             /**
-             * Fetch the next task from the queue.
+             * Fetch the next task from the queue with the highest effective priority.
+             * The effective priority is the task's priority level raised by one level per
+             * elapsed aging interval. On ties, the higher base priority wins.
              *
              * @return
              */
@@ -362,6 +464,48 @@ namespace engine
              */
             bool post(TaskType &&aTask);
 
+            /**
+             * Schedule a task in the timer wheel. Invoked exclusively by the attached handler.
+             *
+             * @param aTask
+             * @param aTimeoutMilliseconds
+             * @param aOutTimerId
+             * @return
+             */
+            bool postDelayed(
+                    TaskType       &&aTask,
+                    uint64_t const  &aTimeoutMilliseconds,
+                    TimerId_t       &aOutTimerId);
+
+            /**
+             * Remove a task from the timer wheel. Invoked exclusively by the attached handler.
+             *
+             * @param aTimerId
+             * @return
+             */
+            bool cancelDelayed(TimerId_t const &aTimerId);
+
+            /**
+             * Advance the timer wheel and move all due tasks into the submission queue.
+             */
+            void releaseDelayedRunnables();
+
+            /**
+             * Move all submitted tasks into the priority queues. Invoked exclusively by the looper thread.
+             */
+            void drainSubmissions();
+
+            /**
+             * Block the looper thread until a task is submitted, the next delayed task is due
+             * or shutdown is requested.
+             */
+            void park();
+
+            /**
+             * Wake the looper thread, if it is parked.
+             */
+            void wake();
+
         private_members:
             std::thread           mThread;
             std::atomic_bool      mRunning;
@@ -369,8 +513,21 @@ namespace engine
 
             CDispatcher mDispatcher;
 
-            std::recursive_mutex  mRunnablesMutex;
-            std::queue<TaskType>  mRunnables;
+            CMpscQueue<SQueuedTask>                                     mSubmissions;
+            std::atomic_bool                                            mParked;
+            bool                                                        mWakeupPending;
+            std::mutex                                                  mParkMutex;
+            std::condition_variable                                     mParkCondition;
+
+            // Guards the consumer side priority queues against statistics() and deinitialize().
+            // Uncontended while running, since only the looper thread touches the queues.
+            std::mutex                                                  mRunnablesMutex;
+            std::array<std::deque<SQueuedTask>, kTaskPriorityLevelCount> mRunnables;
+            LooperStatistics_t                                          mStatistics;
+            std::chrono::milliseconds                                   mAgingInterval;
+
+            std::mutex                                                  mDelayedRunnablesMutex;
+            CTimerWheel<TaskType>                                       mDelayedRunnables;
         };
 
         //<-----------------------------------------------------------------------------
@@ -400,11 +557,23 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        void CLooper<TTaskResult>::CDispatcher::storeDelayedPostFuture(std::future<TTaskResult> &aFunction)
+        bool CLooper<TTaskResult>::CDispatcher::post(TaskType &&aRunnable)
         {
-            std::lock_guard<std::recursive_mutex> guard(mDelayedPostFuturesMutex);
+            return mAssignedLooper.post(std::move(aRunnable));
+        }
+        //<-----------------------------------------------------------------------------
 
-            mDelayedPostFutures.push_back(std::move(aFunction));
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CLooper<TTaskResult>::CDispatcher
+        ::postDelayed(
+                TaskType      &&aRunnable,
+                uint64_t const &aTimeoutMilliseconds)
+        {
+            TimerId_t timerId = 0;
+            return mAssignedLooper.postDelayed(std::move(aRunnable), aTimeoutMilliseconds, timerId);
         }
         //<-----------------------------------------------------------------------------
 
@@ -412,12 +581,23 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        bool CLooper<TTaskResult>::CDispatcher::is_ready(std::future<TTaskResult> const &aFunction)
+        bool CLooper<TTaskResult>::CDispatcher
+        ::postDelayed(
+                TaskType       &&aRunnable,
+                uint64_t const  &aTimeoutMilliseconds,
+                TimerId_t       &aOutTimerId)
         {
-            std::future_status const status = aFunction.wait_for(std::chrono::seconds(0));
-            bool               const ready  = (status == std::future_status::ready);
+            return mAssignedLooper.postDelayed(std::move(aRunnable), aTimeoutMilliseconds, aOutTimerId);
+        }
+        //<-----------------------------------------------------------------------------
 
-            return ready;
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CLooper<TTaskResult>::CDispatcher::cancelDelayed(TimerId_t const &aTimerId)
+        {
+            return mAssignedLooper.cancelDelayed(aTimerId);
         }
         //<-----------------------------------------------------------------------------
 
@@ -425,37 +605,85 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        void CLooper<TTaskResult>::CDispatcher::checkDelayedPostFutures()
+        bool CLooper<TTaskResult>::post(TaskType &&aRunnable)
         {
-            std::lock_guard<std::recursive_mutex> guard(mDelayedPostFuturesMutex);
+            try
+            {
+                SQueuedTask queued {};
+                queued.task        = std::move(aRunnable);
+                queued.enqueueTime = std::chrono::steady_clock::now();
+
+                mSubmissions.push(std::move(queued));
+            }
+            catch(...) {
+                return false;
+            }
+
+            wake();
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
 
-            if(mDelayedPostFutures.empty())
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CLooper<TTaskResult>::postDelayed(
+                TaskType       &&aRunnable,
+                uint64_t const  &aTimeoutMilliseconds,
+                TimerId_t       &aOutTimerId)
+        {
+            try
             {
-                return;
+                std::lock_guard<std::mutex> guard(mDelayedRunnablesMutex);
+
+                aOutTimerId = mDelayedRunnables.schedule(std::move(aRunnable), aTimeoutMilliseconds);
             }
+            catch(...) {
+                return false;
+            }
+
+            // The new task might be due earlier than the one the looper is parked for.
+            wake();
 
-            // Convenience
-            using future_type = std::future<TTaskResult>;
-            using future_list = std::vector<future_type>;
-            using f_it        = typename future_list::const_iterator;
-            using f_it_list   = std::vector<typename future_list::const_iterator>;
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
 
-            f_it      it;
-            f_it_list readyFutures;
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        bool CLooper<TTaskResult>::cancelDelayed(TimerId_t const &aTimerId)
+        {
+            std::lock_guard<std::mutex> guard(mDelayedRunnablesMutex);
+
+            return mDelayedRunnables.cancel(aTimerId);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        void CLooper<TTaskResult>::releaseDelayedRunnables()
+        {
+            std::vector<TaskType> due {};
 
-            for(it  = mDelayedPostFutures.begin();
-                it != mDelayedPostFutures.end();
-                ++ it)
             {
-                if( is_ready(*it))
+                std::lock_guard<std::mutex> guard(mDelayedRunnablesMutex);
+                if(mDelayedRunnables.empty())
                 {
-                    readyFutures.push_back(it);
+                    return;
                 }
+
+                mDelayedRunnables.advance(std::chrono::steady_clock::now(), due);
             }
 
-            for(f_it& readyIt : readyFutures)
+            for(TaskType &task : due)
             {
-                mDelayedPostFutures.erase(readyIt);
+                post(std::move(task));
             }
         }
         //<-----------------------------------------------------------------------------
@@ -464,11 +692,28 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        bool CLooper<TTaskResult>::CDispatcher::post(TaskType &&aRunnable)
+        void CLooper<TTaskResult>::drainSubmissions()
         {
-            checkDelayedPostFutures();
+            SQueuedTask queued {};
+            if(not mSubmissions.pop(queued))
+            {
+                return;
+            }
 
-            return mAssignedLooper.post(std::move(aRunnable));
+            std::lock_guard<std::mutex> guard(mRunnablesMutex);
+
+            do
+            {
+                std::size_t const level = taskPriorityLevel(queued.task.priority());
+
+                mRunnables[level].push_back(std::move(queued));
+
+                SLooperPriorityStatistics &statistics = mStatistics[level];
+                ++(statistics.enqueued);
+                statistics.queueDepth    = mRunnables[level].size();
+                statistics.maxQueueDepth = std::max(statistics.maxQueueDepth, statistics.queueDepth);
+            }
+            while(mSubmissions.pop(queued));
         }
         //<-----------------------------------------------------------------------------
 
@@ -476,34 +721,35 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        bool CLooper<TTaskResult>::CDispatcher
-        ::postDelayed(
-                TaskType      &&aRunnable,
-                uint64_t const &aTimeoutMilliseconds)
+        void CLooper<TTaskResult>::park()
         {
-            std::function<bool()> fn = [=] () -> bool
-            {
-                std::this_thread::sleep_for(std::chrono::milliseconds(aTimeoutMilliseconds));
-                return mAssignedLooper.post(std::move(aRunnable));
-            };
+            using namespace std::chrono;
 
-            try
+            steady_clock::time_point const now = steady_clock::now();
+
+            // Wake up at least once a second, as a safety net only.
+            uint64_t timeoutMilliseconds = 1000;
             {
-                std::future<bool> f = std::async(std::launch::async, fn);
-                storeDelayedPostFuture(std::move(f));
-                checkDelayedPostFutures();
-            }
-            catch(std::bad_alloc &ba) {
-                return false;
+                std::lock_guard<std::mutex> guard(mDelayedRunnablesMutex);
+                timeoutMilliseconds = std::min(timeoutMilliseconds, mDelayedRunnables.millisecondsUntilNextTick(now));
             }
-            catch(std::system_error &se) {
-                return false;
-            }
-            catch(...) {
-                return false;
+
+            if(0 == timeoutMilliseconds)
+            {
+                return;
             }
 
-            return true;
+            std::unique_lock<std::mutex> lock(mParkMutex);
+
+            // Announce parking before the final emptiness check. Producers publish their task
+            // before checking mParked, so either they observe the flag or we observe the task.
+            mParked.store(true);
+            mParkCondition.wait_until(lock, now + milliseconds(timeoutMilliseconds), [this] () -> bool
+            {
+                return (mAbortRequested.load() || mWakeupPending || not mSubmissions.empty());
+            });
+            mParked.store(false);
+            mWakeupPending = false;
         }
         //<-----------------------------------------------------------------------------
 
@@ -511,19 +757,20 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
-        bool CLooper<TTaskResult>::post(TaskType &&aRunnable)
+        void CLooper<TTaskResult>::wake()
         {
-            try
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(not mParked.load())
             {
-                std::lock_guard<std::recursive_mutex> guard(mRunnablesMutex);
-
-                mRunnables.push(std::move(aRunnable));
-            }
-            catch(...) {
-                return false;
+                return;
             }
 
-            return true;
+            // Lock to avoid a lost wakeup between the looper's predicate check and its wait.
+            {
+                std::lock_guard<std::mutex> guard(mParkMutex);
+                mWakeupPending = true;
+            }
+            mParkCondition.notify_one();
         }
         //<-----------------------------------------------------------------------------
 
@@ -536,6 +783,17 @@ namespace engine
             , mRunning(false)
             , mAbortRequested(false)
             , mDispatcher(*this)
+            , mSubmissions()
+            , mParked(false)
+            , mWakeupPending(false)
+            , mParkMutex()
+            , mParkCondition()
+            , mRunnablesMutex()
+            , mRunnables()
+            , mStatistics()
+            , mAgingInterval(kDefaultLooperAgingInterval)
+            , mDelayedRunnablesMutex()
+            , mDelayedRunnables()
         { }
         //<-----------------------------------------------------------------------------
 
@@ -556,33 +814,107 @@ namespace engine
                 return false;
             }
 
-            std::lock_guard<std::recursive_mutex> guard(mRunnablesMutex);
-            if(!mRunnables.empty())
-                mRunnables.clear();
+            SQueuedTask discarded {};
+            while(mSubmissions.pop(discarded))
+            {
+                discarded = SQueuedTask();
+            }
+
+            std::lock_guard<std::mutex> guard(mRunnablesMutex);
+            for(std::deque<SQueuedTask> &queue : mRunnables)
+            {
+                queue.clear();
+            }
+
+            for(SLooperPriorityStatistics &statistics : mStatistics)
+            {
+                statistics.queueDepth = 0;
+            }
+
+            std::lock_guard<std::mutex> delayedGuard(mDelayedRunnablesMutex);
+            mDelayedRunnables.clear();
 
             return true;
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        void CLooper<TTaskResult>::setAgingInterval(std::chrono::milliseconds const &aAgingInterval)
+        {
+            std::lock_guard<std::mutex> guard(mRunnablesMutex);
+            mAgingInterval = aAgingInterval;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename TTaskResult>
+        LooperStatistics_t CLooper<TTaskResult>::statistics()
+        {
+            std::lock_guard<std::mutex> guard(mRunnablesMutex);
+            return mStatistics;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
         template <typename TTaskResult>
         CEngineResult<> CLooper<TTaskResult>::nextRunnable(TaskType &aOutTask)
         {
-            std::lock_guard<std::recursive_mutex> guard(mRunnablesMutex);
+            std::lock_guard<std::mutex> guard(mRunnablesMutex);
 
-            if(mRunnables.empty())
+            std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+
+            // Each queue is FIFO, so its front is its oldest and thus most aged task.
+            // Iterate from the highest level down, so that ties are won by the higher base priority.
+            std::size_t selectedLevel    = kTaskPriorityLevelCount;
+            uint64_t    selectedPriority = 0;
+
+            for(std::size_t k=kTaskPriorityLevelCount; k>0; --k)
+            {
+                std::size_t              const level = (k - 1);
+                std::deque<SQueuedTask> const &queue = mRunnables[level];
+                if(queue.empty())
+                {
+                    continue;
+                }
+
+                uint64_t effectivePriority = level;
+                if(0 < mAgingInterval.count())
+                {
+                    effectivePriority += static_cast<uint64_t>((now - queue.front().enqueueTime) / mAgingInterval);
+                }
+
+                if(kTaskPriorityLevelCount == selectedLevel || effectivePriority > selectedPriority)
+                {
+                    selectedLevel    = level;
+                    selectedPriority = effectivePriority;
+                }
+            }
+
+            if(kTaskPriorityLevelCount == selectedLevel)
             {
                 return CEngineResult<>(EEngineStatus::Error);
             }
 
-            // Implement dequeueing by priority with proper
-            // load balancing here.
-            typename CLooper<TTaskResult>::TaskType runnable = std::move(mRunnables.front());
-            mRunnables.pop();
+            std::deque<SQueuedTask> &queue  = mRunnables[selectedLevel];
+            SQueuedTask              queued = std::move(queue.front());
+            queue.pop_front();
+
+            uint64_t const waitMicroseconds = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - queued.enqueueTime).count());
 
-            aOutTask = std::move(runnable);
+            SLooperPriorityStatistics &statistics = mStatistics[selectedLevel];
+            ++(statistics.dequeued);
+            statistics.queueDepth             = queue.size();
+            statistics.totalWaitMicroseconds += waitMicroseconds;
+            statistics.maxWaitMicroseconds    = std::max(statistics.maxWaitMicroseconds, waitMicroseconds);
+
+            aOutTask = std::move(queued.task);
             return CEngineResult<>(EEngineStatus::Ok);
         }
         //<-----------------------------------------------------------------------------
@@ -599,6 +931,9 @@ namespace engine
             {
                 try
                 {
+                    releaseDelayedRunnables();
+                    drainSubmissions();
+
                     TaskType task;
                     CEngineResult<> fetch = nextRunnable(task);
                     if(fetch.successful())
@@ -609,6 +944,10 @@ namespace engine
                             // throw std::runtime_error("Failed to execute loop function.");
                         }
                     }
+                    else if(mSubmissions.empty())
+                    {
+                        park();
+                    }
                 }
                 catch(std::runtime_error& e) {
                     //CLog::Error(logTag(), e.what());
@@ -659,7 +998,11 @@ namespace engine
         {
             SHIRABE_UNUSED(aTimeoutMilliseconds);
 
-            mAbortRequested.store(true);
+            {
+                std::lock_guard<std::mutex> guard(mParkMutex);
+                mAbortRequested.store(true);
+            }
+            mParkCondition.notify_all();
 
             // If the thread was detached, it won't be joinable.
             // Consequently it should check for abortRequested().
@@ -0,0 +1,215 @@
+#ifndef __SHIRABE_THREADING_MPSCQUEUE_H__
+#define __SHIRABE_THREADING_MPSCQUEUE_H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <base/declaration.h>
+
+namespace engine
+{
+    namespace threading
+    {
+        /**
+         * Size used to separate data written by different threads onto distinct cache lines.
+         */
+        static constexpr std::size_t const kCacheLineSize = 64;
+
+        /**
+         * Multi-producer/single-consumer queue.
+         *
+         * The fast path is a bounded lock-free ring. Each cell carries a sequence number,
+         * which tells producers whether the cell is free and the consumer whether it is
+         * published (D. Vyukov's bounded queue). Producers claim a cell by a CAS on the
+         * enqueue position. The single consumer needs no CAS at all.
+         *
+         * If the ring is full, items go to a mutex protected overflow deque, so that
+         * push never fails. While the overflow holds items, all producers append to it,
+         * so the items of a single producer are always popped in the order pushed.
+         *
+         * @tparam T         The item type. Must be default constructible and movable.
+         * @tparam TCapacity The capacity of the ring. Must be a power of two.
+         */
+        template <typename T, std::size_t TCapacity = 1024>
+        class CMpscQueue
+        {
+            static_assert(0 == (TCapacity & (TCapacity - 1)), "TCapacity must be a power of two.");
+            static_assert(2 <= TCapacity,                     "TCapacity must be at least 2.");
+
+        public_constructors:
+            CMpscQueue()
+                : mEnqueuePosition(0)
+                , mDequeuePosition(0)
+                , mOverflowCount(0)
+                , mOverflowMutex()
+                , mOverflow()
+                , mCells()
+            {
+                for(std::size_t k=0; k<TCapacity; ++k)
+                {
+                    mCells[k].sequence.store(k, std::memory_order_relaxed);
+                }
+            }
+
+            CMpscQueue(CMpscQueue const &)            = delete;
+            CMpscQueue(CMpscQueue &&)                 = delete;
+            CMpscQueue &operator=(CMpscQueue const &) = delete;
+            CMpscQueue &operator=(CMpscQueue &&)      = delete;
+
+        public_methods:
+            /**
+             * Append an item. Safe to be called from any number of threads.
+             *
+             * @param aItem The item to append.
+             * @return      True, if the item was stored in the lock-free ring.
+             *              False, if it was stored in the overflow.
+             */
+            bool push(T &&aItem)
+            {
+                if(0 == mOverflowCount.load(std::memory_order_acquire) && tryPushRing(aItem))
+                {
+                    return true;
+                }
+
+                std::lock_guard<std::mutex> guard(mOverflowMutex);
+                mOverflow.push_back(std::move(aItem));
+                mOverflowCount.fetch_add(1, std::memory_order_release);
+
+                return false;
+            }
+
+            /**
+             * Remove the oldest item. Must only be called from the consumer thread.
+             *
+             * A false return may be transient: A producer might have claimed the next cell,
+             * but not yet published its item.
+             *
+             * @param aOutItem Receives the item.
+             * @return         True, if an item was removed. False otherwise.
+             */
+            bool pop(T &aOutItem)
+            {
+                uint64_t const position = mDequeuePosition.load(std::memory_order_relaxed);
+                SCell         &cell     = mCells[position & kMask];
+                uint64_t const sequence = cell.sequence.load(std::memory_order_acquire);
+
+                if(sequence == (position + 1))
+                {
+                    aOutItem = std::move(cell.item);
+                    mDequeuePosition.store(position + 1, std::memory_order_relaxed);
+                    cell.sequence.store(position + TCapacity, std::memory_order_release);
+                    return true;
+                }
+
+                // The ring must be fully drained before taking from the overflow.
+                // Otherwise items pushed to the ring earlier could be overtaken.
+                if(mEnqueuePosition.load(std::memory_order_acquire) != position)
+                {
+                    return false;
+                }
+
+                if(0 == mOverflowCount.load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> guard(mOverflowMutex);
+                if(mOverflow.empty())
+                {
+                    return false;
+                }
+
+                aOutItem = std::move(mOverflow.front());
+                mOverflow.pop_front();
+                mOverflowCount.fetch_sub(1, std::memory_order_release);
+
+                return true;
+            }
+
+            /**
+             * Check, whether no items are queued. Exact only, if no producer is active.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool empty() const
+            {
+                return (mEnqueuePosition.load() == mDequeuePosition.load()
+                        && 0 == mOverflowCount.load());
+            }
+
+            /**
+             * Return the capacity of the lock-free ring.
+             *
+             * @return See brief.
+             */
+            static constexpr std::size_t capacity()
+            {
+                return TCapacity;
+            }
+
+        private_static_fields:
+            static constexpr uint64_t const kMask = (TCapacity - 1);
+
+        private_structs:
+            struct alignas(kCacheLineSize) SCell
+            {
+                std::atomic<uint64_t> sequence;
+                T                     item;
+            };
+
+        private_methods:
+            /**
+             * Try to store aItem in the ring.
+             *
+             * @param aItem The item to store. Moved from only on success.
+             * @return      True, if successful. False, if the ring is full.
+             */
+            bool tryPushRing(T &aItem)
+            {
+                uint64_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+
+                while(true)
+                {
+                    SCell         &cell       = mCells[position & kMask];
+                    uint64_t const sequence   = cell.sequence.load(std::memory_order_acquire);
+                    int64_t  const difference = (static_cast<int64_t>(sequence) - static_cast<int64_t>(position));
+
+                    if(0 == difference)
+                    {
+                        if(mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            cell.item = std::move(aItem);
+                            cell.sequence.store(position + 1, std::memory_order_release);
+                            return true;
+                        }
+                    }
+                    else if(0 > difference)
+                    {
+                        // The consumer has not yet freed this cell: Full.
+                        return false;
+                    }
+                    else
+                    {
+                        position = mEnqueuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+            }
+
+        private_members:
+            alignas(kCacheLineSize) std::atomic<uint64_t> mEnqueuePosition;
+            alignas(kCacheLineSize) std::atomic<uint64_t> mDequeuePosition;
+            alignas(kCacheLineSize) std::atomic<uint64_t> mOverflowCount;
+            std::mutex                                    mOverflowMutex;
+            std::deque<T>                                 mOverflow;
+            std::array<SCell, TCapacity>                  mCells;
+        };
+    }
+}
+
+#endif
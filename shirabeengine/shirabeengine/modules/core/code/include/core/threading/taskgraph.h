@@ -0,0 +1,251 @@
+#ifndef __SHIRABE_THREADING_TASKGRAPH_H__
+#define __SHIRABE_THREADING_TASKGRAPH_H__
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <base/declaration.h>
+#include <log/log.h>
+#include "core/enginetypehelper.h"
+#include "core/enginestatus.h"
+#include "core/threading/jobsystem.h"
+
+namespace engine
+{
+    namespace threading
+    {
+        class CTaskGraph;
+
+        /**
+         * Function type of a task graph node.
+         */
+        using TaskGraphFn_t = std::function<CEngineResult<>()>;
+
+        /**
+         * The STaskNode struct holds the state of a single task in a CTaskGraph.
+         *
+         * A node becomes runnable, once its dependency counter drops to zero. The counter
+         * starts at one, which is released after all dependencies were attached, so that
+         * a node can't start while it is still being wired up.
+         */
+        struct STaskNode
+        {
+        public_constructors:
+            STaskNode()
+                : function()
+                , pendingDependencies(1)
+                , dependencyFailed(false)
+                , finished(false)
+                , status(EEngineStatus::Ok)
+                , mutex()
+                , completed(false)
+                , successors()
+            {}
+
+        public_members:
+            TaskGraphFn_t                   function;
+            std::atomic<uint32_t>           pendingDependencies;
+            std::atomic_bool                dependencyFailed;
+            std::atomic_bool                finished;
+            EEngineStatus                   status;     // Valid, once finished is set.
+
+            std::mutex                      mutex;      // Guards completed and successors.
+            bool                            completed;
+            std::vector<Shared<STaskNode>>  successors;
+        };
+
+        /**
+         * A CTaskHandle refers to a node in a CTaskGraph and permits to chain continuations,
+         * to wait for the node and to fetch its result.
+         */
+        class SHIRABE_TEST_EXPORT CTaskHandle
+        {
+            friend class CTaskGraph;
+
+        public_constructors:
+            /**
+             * Create an invalid handle.
+             */
+            CTaskHandle();
+
+            /**
+             * Create a handle for a node of aGraph.
+             *
+             * @param aGraph The graph owning the node.
+             * @param aNode  The node referred to.
+             */
+            CTaskHandle(
+                    CTaskGraph              *aGraph,
+                    Shared<STaskNode> const &aNode);
+
+        public_methods:
+            /**
+             * Check, whether this handle refers to a node.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool valid() const
+            {
+                return (nullptr != mGraph && nullptr != mNode);
+            }
+
+            /**
+             * Check, whether the node was executed or skipped.
+             *
+             * @return See brief.
+             */
+            bool finished() const;
+
+            /**
+             * Return the result of the node. Only meaningful, once finished.
+             * A node is failed, if its function failed or any of its dependencies failed.
+             *
+             * @return See brief.
+             */
+            CEngineResult<> result() const;
+
+            /**
+             * Wait for the node to finish, executing other pending jobs in the meantime.
+             *
+             * @return The result of the node.
+             */
+            CEngineResult<> wait() const;
+
+            /**
+             * Add a continuation, which runs after this node finished successfully.
+             *
+             * @param aFunction The continuation.
+             * @return          A handle to the continuation.
+             */
+            CTaskHandle then(TaskGraphFn_t aFunction) const;
+
+        private_members:
+            CTaskGraph        *mGraph;
+            Shared<STaskNode>  mNode;
+        };
+
+        /**
+         * The CTaskGraph executes tasks in dependency order, running independent tasks in parallel.
+         *
+         * The graph is built dynamically: Tasks can be added at any time, also from within running
+         * tasks, and start as soon as all of their dependencies finished. Adding a dependency on an
+         * already finished node is allowed. If a task fails, all of its direct and indirect dependents
+         * are skipped and report an error.
+         *
+         * Tasks are executed on a CJobSystem. If none is provided, tasks run on the thread resolving
+         * their last dependency, which is useful for tests and single threaded setups.
+         */
+        class SHIRABE_TEST_EXPORT CTaskGraph
+        {
+            SHIRABE_DECLARE_LOG_TAG(CTaskGraph)
+
+            friend class CTaskHandle;
+
+        public_constructors:
+            /**
+             * Create a task graph.
+             *
+             * @param aJobSystem The job system to execute the tasks on. May be null.
+             */
+            explicit CTaskGraph(Shared<CJobSystem> aJobSystem = nullptr);
+
+            CTaskGraph(CTaskGraph const &)            = delete;
+            CTaskGraph(CTaskGraph &&)                 = delete;
+            CTaskGraph &operator=(CTaskGraph const &) = delete;
+            CTaskGraph &operator=(CTaskGraph &&)      = delete;
+
+        public_destructors:
+            /**
+             * Wait for all tasks to finish, since they refer to this graph.
+             */
+            ~CTaskGraph();
+
+        public_methods:
+            /**
+             * Add a task, which runs after all aDependencies finished successfully.
+             *
+             * @param aFunction     The task function.
+             * @param aDependencies Handles to the nodes the task depends on. Invalid handles are ignored.
+             * @return              A handle to the new node.
+             */
+            CTaskHandle add(
+                    TaskGraphFn_t                    aFunction,
+                    std::vector<CTaskHandle> const  &aDependencies = {});
+
+            /**
+             * Add a join node, which finishes once all aHandles finished.
+             *
+             * @param aHandles The nodes to join.
+             * @return         A handle to the join node. Failed, if any of aHandles failed.
+             */
+            CTaskHandle whenAll(std::vector<CTaskHandle> const &aHandles);
+
+            /**
+             * Wait for all tasks added so far to finish, executing pending jobs in the meantime.
+             */
+            void waitAll();
+
+            /**
+             * Return the number of tasks added, but not yet finished.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE uint64_t pendingTaskCount() const
+            {
+                return mPendingTaskCount.load();
+            }
+
+        private_methods:
+            /**
+             * Register aNode as a successor of aDependency.
+             *
+             * @param aDependency The node depended upon.
+             * @param aNode       The dependent node.
+             */
+            void connect(
+                    Shared<STaskNode> const &aDependency,
+                    Shared<STaskNode> const &aNode);
+
+            /**
+             * Decrement the dependency counter of aNode and schedule it, if it drops to zero.
+             *
+             * @param aNode The node to release.
+             */
+            void release(Shared<STaskNode> const &aNode);
+
+            /**
+             * Hand a runnable node to the job system or the inline queue.
+             *
+             * @param aNode The node to schedule.
+             */
+            void schedule(Shared<STaskNode> const &aNode);
+
+            /**
+             * Run the function of aNode, unless a dependency failed, and release its successors.
+             *
+             * @param aNode The node to execute.
+             */
+            void execute(Shared<STaskNode> const &aNode);
+
+            /**
+             * Block until aPredicate holds, helping out with pending jobs in the meantime.
+             *
+             * @param aPredicate The condition to wait for.
+             */
+            void waitUntil(std::function<bool()> const &aPredicate);
+
+        private_members:
+            Shared<CJobSystem>              mJobSystem;
+            std::atomic<uint64_t>           mPendingTaskCount;
+
+            std::mutex                      mInlineMutex;
+            std::deque<Shared<STaskNode>>   mInlineQueue;
+            bool                            mInlineDraining;
+        };
+    }
+}
+
+#endif
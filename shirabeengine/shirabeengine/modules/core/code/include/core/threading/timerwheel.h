@@ -0,0 +1,268 @@
+#ifndef __SHIRABE_THREADING_TIMERWHEEL_H__
+#define __SHIRABE_THREADING_TIMERWHEEL_H__
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include <base/declaration.h>
+
+namespace engine
+{
+    namespace threading
+    {
+        /**
+         * Identifies a timer scheduled in a CTimerWheel. 0 is never assigned.
+         */
+        using TimerId_t = uint64_t;
+
+        /**
+         * Hashed timer wheel with millisecond ticks.
+         *
+         * Timers are stored in one of TSlotCount slots, selected by their expiry tick modulo
+         * the slot count, together with the number of full wheel revolutions left until expiry.
+         * Scheduling and cancellation are O(1). Advancing the wheel visits one slot per elapsed
+         * tick and touches only the timers stored in it.
+         *
+         * The wheel is not synchronized. It is meant to be owned and driven by a single thread,
+         * e.g. a looper, with insertions guarded by the owner.
+         *
+         * @tparam TPayload   The payload to be returned on expiry. Must be movable.
+         * @tparam TSlotCount The number of slots. Must be a power of two.
+         */
+        template <typename TPayload, std::size_t TSlotCount = 1024>
+        class CTimerWheel
+        {
+            static_assert(0 == (TSlotCount & (TSlotCount - 1)), "TSlotCount must be a power of two.");
+
+        public_typedefs:
+            using Clock_t     = std::chrono::steady_clock;
+            using TimePoint_t = Clock_t::time_point;
+
+        public_constructors:
+            /**
+             * Create an empty wheel starting at aStart.
+             *
+             * @param aStart The time point of tick 0.
+             */
+            explicit CTimerWheel(TimePoint_t const &aStart = Clock_t::now())
+                : mStart(aStart)
+                , mCurrentTick(0)
+                , mNextTimerId(1)
+                , mSlots()
+                , mTimers()
+            {}
+
+        public_methods:
+            /**
+             * Schedule aPayload to expire aDelayMilliseconds from aNow.
+             *
+             * @param aPayload           The payload to return on expiry.
+             * @param aDelayMilliseconds The delay in milliseconds.
+             * @param aNow               The current time.
+             * @return                   The id of the timer for cancellation.
+             */
+            TimerId_t schedule(
+                    TPayload          &&aPayload,
+                    uint64_t    const  &aDelayMilliseconds,
+                    TimePoint_t const  &aNow = Clock_t::now())
+            {
+                // Round up, so that a timer never fires early. Expired ticks are processed on the next advance.
+                uint64_t const nowTick    = std::max(ticksSinceStart(aNow, true), mCurrentTick);
+                uint64_t const expiryTick = std::max(nowTick + aDelayMilliseconds, mCurrentTick + 1);
+                uint64_t const distance   = (expiryTick - mCurrentTick - 1);
+
+                TimerId_t const id = mNextTimerId++;
+
+                SSlot &slot = mSlots[expiryTick & kSlotMask];
+                slot.entries.push_back({ id, (distance / TSlotCount), std::move(aPayload) });
+                mTimers[id] = { (expiryTick & kSlotMask), std::prev(slot.entries.end()) };
+
+                return id;
+            }
+
+            /**
+             * Cancel a scheduled timer.
+             *
+             * @param aTimerId The id of the timer to cancel.
+             * @return         True, if the timer was pending and is cancelled. False otherwise.
+             */
+            bool cancel(TimerId_t const &aTimerId)
+            {
+                typename std::unordered_map<TimerId_t, SLocation>::iterator const it = mTimers.find(aTimerId);
+                if(mTimers.end() == it)
+                {
+                    return false;
+                }
+
+                mSlots[it->second.slot].entries.erase(it->second.entry);
+                mTimers.erase(it);
+
+                return true;
+            }
+
+            /**
+             * Advance the wheel to aNow and move the payloads of all expired timers to aOutExpired,
+             * in order of expiry.
+             *
+             * @param aNow        The current time.
+             * @param aOutExpired Receives the payloads of all expired timers.
+             */
+            void advance(
+                    TimePoint_t           const &aNow,
+                    std::vector<TPayload>       &aOutExpired)
+            {
+                uint64_t const targetTick = ticksSinceStart(aNow);
+
+                while(mCurrentTick < targetTick)
+                {
+                    // Nothing scheduled: Skip ahead without visiting the slots.
+                    if(mTimers.empty())
+                    {
+                        mCurrentTick = targetTick;
+                        break;
+                    }
+
+                    ++mCurrentTick;
+
+                    std::list<SEntry> &entries = mSlots[mCurrentTick & kSlotMask].entries;
+                    for(typename std::list<SEntry>::iterator it = entries.begin(); it != entries.end(); )
+                    {
+                        if(0 < it->rounds)
+                        {
+                            --(it->rounds);
+                            ++it;
+                            continue;
+                        }
+
+                        aOutExpired.push_back(std::move(it->payload));
+                        mTimers.erase(it->id);
+                        it = entries.erase(it);
+                    }
+                }
+            }
+
+            /**
+             * Return the number of milliseconds until the wheel has to be advanced next,
+             * i.e. until the next slot holding a timer is reached. Used to park the owning thread.
+             *
+             * @param aNow The current time.
+             * @return     The milliseconds until the next relevant tick or the max. value, if empty.
+             */
+            uint64_t millisecondsUntilNextTick(TimePoint_t const &aNow) const
+            {
+                if(mTimers.empty())
+                {
+                    return std::numeric_limits<uint64_t>::max();
+                }
+
+                uint64_t const nowTick = ticksSinceStart(aNow);
+
+                for(uint64_t k=1; k<=TSlotCount; ++k)
+                {
+                    uint64_t const tick = (mCurrentTick + k);
+                    if(not mSlots[tick & kSlotMask].entries.empty())
+                    {
+                        return (tick > nowTick) ? (tick - nowTick) : 0;
+                    }
+                }
+
+                return 0;
+            }
+
+            /**
+             * Return the number of pending timers.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE std::size_t size() const
+            {
+                return mTimers.size();
+            }
+
+            /**
+             * Check, whether no timers are pending.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE bool empty() const
+            {
+                return mTimers.empty();
+            }
+
+            /**
+             * Drop all pending timers.
+             */
+            void clear()
+            {
+                for(SSlot &slot : mSlots)
+                {
+                    slot.entries.clear();
+                }
+                mTimers.clear();
+            }
+
+        private_static_fields:
+            static constexpr uint64_t const kSlotMask = (TSlotCount - 1);
+
+        private_structs:
+            struct SEntry
+            {
+                TimerId_t id;
+                uint64_t  rounds;
+                TPayload  payload;
+            };
+
+            struct SSlot
+            {
+                std::list<SEntry> entries;
+            };
+
+            struct SLocation
+            {
+                uint64_t                              slot;
+                typename std::list<SEntry>::iterator  entry;
+            };
+
+        private_methods:
+            /**
+             * Convert a time point to ticks since the start of the wheel.
+             *
+             * @param aTimePoint The time point to convert.
+             * @param aRoundUp   If true, partially elapsed ticks are counted as well.
+             * @return           The number of elapsed milliseconds since the start of the wheel.
+             */
+            SHIRABE_INLINE uint64_t ticksSinceStart(
+                    TimePoint_t const &aTimePoint,
+                    bool        const  aRoundUp = false) const
+            {
+                if(aTimePoint <= mStart)
+                {
+                    return 0;
+                }
+
+                if(aRoundUp)
+                {
+                    return static_cast<uint64_t>(std::chrono::ceil<std::chrono::milliseconds>(aTimePoint - mStart).count());
+                }
+
+                return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(aTimePoint - mStart).count());
+            }
+
+        private_members:
+            TimePoint_t                              mStart;
+            uint64_t                                 mCurrentTick;
+            TimerId_t                                mNextTimerId;
+            std::array<SSlot, TSlotCount>            mSlots;
+            std::unordered_map<TimerId_t, SLocation> mTimers;
+        };
+    }
+}
+
+#endif
@@ -0,0 +1,441 @@
+#include <algorithm>
+#include "core/threading/jobsystem.h"
+
+namespace engine
+{
+    namespace threading
+    {
+        namespace
+        {
+            /**
+             * Identifies the job system and worker index of the current thread.
+             * Non-worker threads have no job system assigned.
+             */
+            thread_local CJobSystem *sCurrentJobSystem   = nullptr;
+            thread_local uint32_t    sCurrentWorkerIndex = 0;
+        }
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CJobSystem::CJobSystem()
+            : mWorkers()
+            , mRunning(false)
+            , mAbortRequested(false)
+            , mNextWorker(0)
+            , mPendingJobCount(0)
+            , mWaiterCount(0)
+            , mWakeMutex()
+            , mWakeCondition()
+            , mProgressCondition()
+            , mDelayedJobsMutex()
+            , mDelayedJobs()
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CJobSystem::~CJobSystem()
+        {
+            abortAndJoin();
+            deinitialize();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::initialize(uint32_t const &aWorkerCount)
+        {
+            if(running() || not mWorkers.empty())
+            {
+                return false;
+            }
+
+            uint32_t workerCount = aWorkerCount;
+            if(0 == workerCount)
+            {
+                workerCount = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            mWorkers.reserve(workerCount);
+            for(uint32_t k=0; k<workerCount; ++k)
+            {
+                mWorkers.push_back(makeUnique<SWorker>());
+            }
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::deinitialize()
+        {
+            if(running())
+            {
+                return false;
+            }
+
+            // Destroying the jobs breaks the promises of their futures. Mark them finished as well,
+            // so that no waiter blocks forever.
+            for(Unique<SWorker> &worker : mWorkers)
+            {
+                std::lock_guard<std::mutex> guard(worker->mutex);
+                for(SJob &job : worker->jobs)
+                {
+                    if(nullptr != job.state)
+                    {
+                        job.state->finished.store(true, std::memory_order_release);
+                    }
+                }
+            }
+
+            mWorkers.clear();
+            mPendingJobCount.store(0);
+            mProgressCondition.notify_all();
+
+            {
+                std::lock_guard<std::mutex> guard(mDelayedJobsMutex);
+                while(not mDelayedJobs.empty())
+                {
+                    mDelayedJobs.pop();
+                }
+            }
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::run()
+        {
+            if(mWorkers.empty() || running())
+            {
+                return false;
+            }
+
+            mAbortRequested.store(false);
+            mRunning       .store(true);
+
+            try
+            {
+                for(uint32_t k=0; k<mWorkers.size(); ++k)
+                {
+                    mWorkers[k]->thread = std::thread(&CJobSystem::runFunc, this, k);
+                }
+            }
+            catch(...)
+            {
+                CLog::Error(logTag(), "Failed to start worker thread.");
+                abortAndJoin();
+                return false;
+            }
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::running() const
+        {
+            return mRunning.load();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::abortAndJoin()
+        {
+            {
+                std::lock_guard<std::mutex> guard(mWakeMutex);
+                mAbortRequested.store(true);
+            }
+            mWakeCondition.notify_all();
+
+            for(Unique<SWorker> &worker : mWorkers)
+            {
+                if(worker->thread.joinable())
+                {
+                    worker->thread.join();
+                }
+            }
+
+            mRunning.store(false);
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::postDelayed(
+                JobFn_t         aFunction,
+                uint64_t const &aTimeoutMilliseconds)
+        {
+            if(0 == aTimeoutMilliseconds)
+            {
+                return enqueue({ std::move(aFunction), makeShared<SJobState>() });
+            }
+
+            try
+            {
+                std::lock_guard<std::mutex> guard(mDelayedJobsMutex);
+
+                SDelayedJob job {};
+                job.deadline = (std::chrono::steady_clock::now() + std::chrono::milliseconds(aTimeoutMilliseconds));
+                job.function = std::move(aFunction);
+
+                mDelayedJobs.push(std::move(job));
+            }
+            catch(...)
+            {
+                return false;
+            }
+
+            // Make sure at least one worker observes the new deadline.
+            mWakeCondition.notify_one();
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::enqueue(SJob &&aJob)
+        {
+            if(mWorkers.empty())
+            {
+                CLog::Error(logTag(), "Cannot enqueue job. Job system is not initialized.");
+                return false;
+            }
+
+            uint32_t workerIndex = 0;
+            if(this == sCurrentJobSystem)
+            {
+                workerIndex = sCurrentWorkerIndex;
+            }
+            else
+            {
+                workerIndex = static_cast<uint32_t>(mNextWorker.fetch_add(1) % mWorkers.size());
+            }
+
+            {
+                // Count the job before it becomes visible, so that a fetch can never take the count below zero.
+                // Lock to avoid a lost wakeup between a worker's predicate check and its wait.
+                std::lock_guard<std::mutex> guard(mWakeMutex);
+                mPendingJobCount.fetch_add(1);
+            }
+
+            try
+            {
+                SWorker &worker = *(mWorkers[workerIndex]);
+
+                std::lock_guard<std::mutex> guard(worker.mutex);
+                worker.jobs.push_back(std::move(aJob));
+            }
+            catch(...)
+            {
+                mPendingJobCount.fetch_sub(1);
+                return false;
+            }
+
+            mWakeCondition.notify_one();
+
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::fetch(SJob &aOutJob)
+        {
+            if(0 == mPendingJobCount.load() || mWorkers.empty())
+            {
+                return false;
+            }
+
+            bool     const isWorker    = (this == sCurrentJobSystem);
+            uint32_t const ownIndex    = (isWorker ? sCurrentWorkerIndex : static_cast<uint32_t>(mNextWorker.load() % mWorkers.size()));
+            uint32_t const workerCount = static_cast<uint32_t>(mWorkers.size());
+
+            // Own deque first: Most recently pushed job, likely still hot in cache.
+            if(isWorker)
+            {
+                SWorker &own = *(mWorkers[ownIndex]);
+
+                std::lock_guard<std::mutex> guard(own.mutex);
+                if(not own.jobs.empty())
+                {
+                    aOutJob = std::move(own.jobs.back());
+                    own.jobs.pop_back();
+                    mPendingJobCount.fetch_sub(1);
+                    return true;
+                }
+            }
+
+            // Steal the oldest job from any other deque.
+            for(uint32_t k=(isWorker ? 1 : 0); k<workerCount; ++k)
+            {
+                SWorker &victim = *(mWorkers[(ownIndex + k) % workerCount]);
+
+                std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+                if(not lock.owns_lock() || victim.jobs.empty())
+                {
+                    continue;
+                }
+
+                aOutJob = std::move(victim.jobs.front());
+                victim.jobs.pop_front();
+                mPendingJobCount.fetch_sub(1);
+                return true;
+            }
+
+            return false;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CJobSystem::execute(SJob &aJob)
+        {
+            try
+            {
+                if(aJob.function)
+                {
+                    aJob.function();
+                }
+            }
+            catch(std::exception &aException)
+            {
+                CLog::Error(logTag(), std::string("Exception in CJobSystem::execute(...): ") + aException.what());
+            }
+            catch(...)
+            {
+                CLog::Error(logTag(), "Unknown error in CJobSystem::execute(...)...");
+            }
+
+            if(nullptr != aJob.state)
+            {
+                aJob.state->finished.store(true, std::memory_order_release);
+            }
+
+            // Wake waiters, which found nothing to help out with. Parked workers are not affected.
+            // A notification racing a waiter's wait is caught up by the waiter's timeout.
+            if(0 < mWaiterCount.load())
+            {
+                mProgressCondition.notify_all();
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CJobSystem::tryRunPendingJob()
+        {
+            releaseDelayedJobs();
+
+            SJob job {};
+            if(not fetch(job))
+            {
+                return false;
+            }
+
+            execute(job);
+            return true;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CJobSystem::waitForProgress()
+        {
+            mWaiterCount.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(mWakeMutex);
+                mProgressCondition.wait_for(lock, std::chrono::milliseconds(1));
+            }
+            mWaiterCount.fetch_sub(1);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CJobSystem::releaseDelayedJobs()
+        {
+            std::vector<JobFn_t> released {};
+
+            {
+                std::unique_lock<std::mutex> lock(mDelayedJobsMutex, std::try_to_lock);
+                if(not lock.owns_lock() || mDelayedJobs.empty())
+                {
+                    return;
+                }
+
+                std::chrono::steady_clock::time_point const now = std::chrono::steady_clock::now();
+                while(not mDelayedJobs.empty() && mDelayedJobs.top().deadline <= now)
+                {
+                    // priority_queue::top is const, the function is copied once on release.
+                    released.push_back(mDelayedJobs.top().function);
+                    mDelayedJobs.pop();
+                }
+            }
+
+            for(JobFn_t &function : released)
+            {
+                enqueue({ std::move(function), makeShared<SJobState>() });
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CJobSystem::runFunc(uint32_t aWorkerIndex)
+        {
+            sCurrentJobSystem   = this;
+            sCurrentWorkerIndex = aWorkerIndex;
+
+            while(not mAbortRequested.load())
+            {
+                if(tryRunPendingJob())
+                {
+                    continue;
+                }
+
+                // Park until new work arrives. Wake periodically to release delayed jobs.
+                std::chrono::steady_clock::time_point wakeup = (std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+                {
+                    std::lock_guard<std::mutex> guard(mDelayedJobsMutex);
+                    if(not mDelayedJobs.empty())
+                    {
+                        wakeup = std::min(wakeup, mDelayedJobs.top().deadline);
+                    }
+                }
+
+                std::unique_lock<std::mutex> lock(mWakeMutex);
+                mWakeCondition.wait_until(lock, wakeup, [this] () -> bool
+                {
+                    return (mAbortRequested.load() || 0 < mPendingJobCount.load());
+                });
+            }
+
+            sCurrentJobSystem = nullptr;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
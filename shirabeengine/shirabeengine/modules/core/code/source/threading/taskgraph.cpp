@@ -0,0 +1,310 @@
+#include <thread>
+#include "core/threading/taskgraph.h"
+
+namespace engine
+{
+    namespace threading
+    {
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskHandle::CTaskHandle()
+            : mGraph(nullptr)
+            , mNode (nullptr)
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskHandle::CTaskHandle(
+                CTaskGraph              *aGraph,
+                Shared<STaskNode> const &aNode)
+            : mGraph(aGraph)
+            , mNode (aNode)
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CTaskHandle::finished() const
+        {
+            return (valid() && mNode->finished.load(std::memory_order_acquire));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CTaskHandle::result() const
+        {
+            if(not finished())
+            {
+                return { EEngineStatus::Error };
+            }
+
+            return { mNode->status };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CTaskHandle::wait() const
+        {
+            if(not valid())
+            {
+                return { EEngineStatus::Error };
+            }
+
+            Shared<STaskNode> const node = mNode;
+            mGraph->waitUntil([node] () -> bool { return node->finished.load(std::memory_order_acquire); });
+
+            return result();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskHandle CTaskHandle::then(TaskGraphFn_t aFunction) const
+        {
+            if(not valid())
+            {
+                return {};
+            }
+
+            return mGraph->add(std::move(aFunction), { *this });
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskGraph::CTaskGraph(Shared<CJobSystem> aJobSystem)
+            : mJobSystem(std::move(aJobSystem))
+            , mPendingTaskCount(0)
+            , mInlineMutex()
+            , mInlineQueue()
+            , mInlineDraining(false)
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskGraph::~CTaskGraph()
+        {
+            waitAll();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskHandle CTaskGraph::add(
+                TaskGraphFn_t                   aFunction,
+                std::vector<CTaskHandle> const &aDependencies)
+        {
+            Shared<STaskNode> node = makeShared<STaskNode>();
+            node->function = std::move(aFunction);
+
+            mPendingTaskCount.fetch_add(1);
+
+            for(CTaskHandle const &dependency : aDependencies)
+            {
+                if(not dependency.valid())
+                {
+                    continue;
+                }
+
+                if(this != dependency.mGraph)
+                {
+                    CLog::Error(logTag(), "Cannot depend on a task of another graph. Dependency ignored.");
+                    continue;
+                }
+
+                connect(dependency.mNode, node);
+            }
+
+            // Drop the initial hold. Schedules the node, if all dependencies are finished already.
+            release(node);
+
+            return CTaskHandle(this, node);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CTaskHandle CTaskGraph::whenAll(std::vector<CTaskHandle> const &aHandles)
+        {
+            return add(nullptr, aHandles);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::waitAll()
+        {
+            waitUntil([this] () -> bool { return (0 == mPendingTaskCount.load()); });
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::connect(
+                Shared<STaskNode> const &aDependency,
+                Shared<STaskNode> const &aNode)
+        {
+            std::lock_guard<std::mutex> guard(aDependency->mutex);
+
+            if(aDependency->completed)
+            {
+                if(EEngineStatus::Ok != aDependency->status)
+                {
+                    aNode->dependencyFailed.store(true);
+                }
+                return;
+            }
+
+            aNode->pendingDependencies.fetch_add(1);
+            aDependency->successors.push_back(aNode);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::release(Shared<STaskNode> const &aNode)
+        {
+            if(1 == aNode->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel))
+            {
+                schedule(aNode);
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::schedule(Shared<STaskNode> const &aNode)
+        {
+            // Join nodes and skipped nodes have nothing to run. Finish them right away,
+            // instead of paying for a round trip through the job system.
+            bool const runInline = (nullptr == mJobSystem || nullptr == aNode->function || aNode->dependencyFailed.load());
+            if(not runInline)
+            {
+                CJobHandle<void> const handle = mJobSystem->post<void>([this, aNode] () -> void { execute(aNode); });
+                if(handle.valid())
+                {
+                    return;
+                }
+
+                CLog::Warning(logTag(), "Failed to post task to the job system. Executing inline.");
+            }
+
+            // Drain iteratively, so that long dependency chains don't exhaust the stack.
+            std::unique_lock<std::mutex> lock(mInlineMutex);
+            mInlineQueue.push_back(aNode);
+            if(mInlineDraining)
+            {
+                return;
+            }
+
+            mInlineDraining = true;
+            while(not mInlineQueue.empty())
+            {
+                Shared<STaskNode> node = std::move(mInlineQueue.front());
+                mInlineQueue.pop_front();
+
+                lock.unlock();
+                execute(node);
+                lock.lock();
+            }
+            mInlineDraining = false;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::execute(Shared<STaskNode> const &aNode)
+        {
+            EEngineStatus status = EEngineStatus::Ok;
+
+            if(aNode->dependencyFailed.load())
+            {
+                status = EEngineStatus::Error;
+            }
+            else if(nullptr != aNode->function)
+            {
+                try
+                {
+                    status = aNode->function().result();
+                }
+                catch(std::exception &aException)
+                {
+                    CLog::Error(logTag(), std::string("Exception in CTaskGraph::execute(...): ") + aException.what());
+                    status = EEngineStatus::Error;
+                }
+                catch(...)
+                {
+                    CLog::Error(logTag(), "Unknown error in CTaskGraph::execute(...)...");
+                    status = EEngineStatus::Error;
+                }
+            }
+
+            // Release captured resources early, the node itself may be referenced by handles for long.
+            aNode->function = nullptr;
+
+            std::vector<Shared<STaskNode>> successors {};
+            {
+                std::lock_guard<std::mutex> guard(aNode->mutex);
+                aNode->status    = status;
+                aNode->completed = true;
+                successors.swap(aNode->successors);
+            }
+
+            aNode->finished.store(true, std::memory_order_release);
+
+            bool const failed = (EEngineStatus::Ok != status);
+            for(Shared<STaskNode> const &successor : successors)
+            {
+                if(failed)
+                {
+                    successor->dependencyFailed.store(true);
+                }
+                release(successor);
+            }
+
+            mPendingTaskCount.fetch_sub(1);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CTaskGraph::waitUntil(std::function<bool()> const &aPredicate)
+        {
+            while(not aPredicate())
+            {
+                if(nullptr == mJobSystem)
+                {
+                    // Another thread is draining the inline queue.
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                if(not mJobSystem->tryRunPendingJob())
+                {
+                    mJobSystem->waitForProgress();
+                }
+            }
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
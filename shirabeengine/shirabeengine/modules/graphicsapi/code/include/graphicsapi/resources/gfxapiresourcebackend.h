@@ -1,7 +1,7 @@
 #ifndef __SHIRABE_GFXAPIRESOURCEBACKEND_H__
 #define __SHIRABE_GFXAPIRESOURCEBACKEND_H__
 
-#include <core/threading/looper.h>
+#include <core/threading/jobsystem.h>
 #include <base/string.h>
 
 #include "graphicsapi/resources/gfxapiresourcetaskbackend.h"
@@ -87,16 +87,14 @@ namespace engine
 
         public_methods:
             /**
-             * Initialize the resource task backend, which will create and start
-             * a separate resource operation thread.
+             * Initialize the resource task backend.
              *
              * @return A result containing EEngineStatus::Ok, if successful.
              * @return A result containing an EEngineStatus error value on error.
              */
             CEngineResult<> initialize();
             /**
-             * Deinitialize the resource task backend, stopping the resource
-             * operation thread and joining it.
+             * Deinitialize the resource task backend.
              * All resource will be removed beforehand.
              *
              * @return A result containing EEngineStatus::Ok, if successful.
@@ -164,6 +162,14 @@ namespace engine
              */
             CEngineResult<> setResourceTaskBackend(Shared<ResourceTaskBackend_t> const &aBackend);
 
+            /**
+             * Assign the engine's job system, which resource tasks are posted to.
+             * Without a job system, resource tasks are executed on the calling thread.
+             *
+             * @param aJobSystem The job system to post resource tasks to.
+             */
+            void setJobSystem(Shared<threading::CJobSystem> const &aJobSystem);
+
         private_methods:
             /**
              * Implementation of the load operation.
@@ -199,7 +205,7 @@ namespace engine
                     SDeferredResourceOperationHandle              &aOutHandle);
 
             /**
-             * Enqueues a new resource operation task into the resource operation thread.
+             * Enqueues a new resource operation task into the job system.
              *
              * @param aTask            The task to be enqueued.
              * @param aOutSharedFuture The future handle for the tasks to fetch the results.
@@ -211,10 +217,10 @@ namespace engine
                     std::future<ResourceTaskFn_t::result_type> &aOutSharedFuture);
 
         private_members:
-            Shared<ResourceTaskBackend_t>                                  mResourceTaskBackend;
-            ResolvedDependencyCollection_t                                 mStorage;
-            threading::CLooper<ResourceTaskFn_t::result_type>              mResourceThread;
-            threading::CLooper<ResourceTaskFn_t::result_type>::CDispatcher &mResourceThreadHandler;
+            Shared<ResourceTaskBackend_t>  mResourceTaskBackend;
+            ResolvedDependencyCollection_t mStorage;
+            std::mutex                     mStorageMutex;
+            Shared<threading::CJobSystem>  mJobSystem;
         };
         //<-----------------------------------------------------------------------------
 
@@ -224,16 +230,22 @@ namespace engine
         template <typename T>
         CEngineResult<Shared<T>> const CGFXAPIResourceBackend::getResource(PublicResourceId_t const &aId)
         {
-            // Check, whether the resource is available.
-            bool const contained = (mStorage.end() != mStorage.find(aId));
-            if(not contained)
+            Shared<void> resource = nullptr;
             {
-                CLog::Warning(logTag(), "Resource '{}' not found.", aId);
-                return { EEngineStatus::ResourceError_NotFound };
+                std::lock_guard<std::mutex> guard(mStorageMutex);
+
+                // Check, whether the resource is available.
+                bool const contained = (mStorage.end() != mStorage.find(aId));
+                if(not contained)
+                {
+                    CLog::Warning(logTag(), "Resource '{}' not found.", aId);
+                    return { EEngineStatus::ResourceError_NotFound };
+                }
+
+                resource = mStorage.at(aId);
             }
 
             // Check, whether the resoruce is of correct type.
-            Shared<void> resource = mStorage.at(aId);
             Shared<T>    result   = std::static_pointer_cast<T>(resource);
             if(nullptr == result)
             {
@@ -264,9 +276,12 @@ namespace engine
 
             // Resolve dependencies...
             ResolvedDependencyCollection_t resolvedDependencies = {};
-            for(PublicResourceIdList_t::value_type const &dependency : aDependencies)
             {
-                resolvedDependencies[dependency] = mStorage[dependency];
+                std::lock_guard<std::mutex> guard(mStorageMutex);
+                for(PublicResourceIdList_t::value_type const &dependency : aDependencies)
+                {
+                    resolvedDependencies[dependency] = mStorage[dependency];
+                }
             }
 
             try
@@ -335,7 +350,12 @@ namespace engine
             CEngineResult<> unloadOp = EEngineStatus::Ok;
             try
             {
-                Shared<void> resource = mStorage[aRequest.publicResourceId()];
+                Shared<void> resource = nullptr;
+                {
+                    std::lock_guard<std::mutex> guard(mStorageMutex);
+                    resource = mStorage[aRequest.publicResourceId()];
+                }
+
                 unloadOp = unloadImpl<TResource>(
                             aRequest,
                             {
@@ -350,6 +370,7 @@ namespace engine
                     resourceHandleFetch = handle.futureHandle.get(); // Wait for it ALWAYS!
                     if(resourceHandleFetch.successful())
                     {
+                        std::lock_guard<std::mutex> guard(mStorageMutex);
                         mStorage.erase(resourceHandleFetch.data().publicResourceHandle);
                         unloadOp = CEngineResult<>(EEngineStatus::Ok);
                     }
@@ -14,6 +14,7 @@
 #include <future>
 #include <assert.h>
 #include <map>
+#include <mutex>
 
 #include <core/enginetypehelper.h>
 #include <core/enginestatus.h>
@@ -263,6 +264,19 @@ namespace engine
              */
             virtual CEngineResult<> deinitialize() = 0;
 
+            /**
+             * Lock the graphics API objects shared by all tasks, which require external
+             * synchronization, e.g. command pools and descriptor pools.
+             * Tasks run in parallel and must only hold the lock while allocating from or
+             * recording into those objects.
+             *
+             * @return A lock held until destroyed.
+             */
+            SHIRABE_INLINE std::unique_lock<std::mutex> lockSharedPools()
+            {
+                return std::unique_lock<std::mutex>(mSharedPoolMutex);
+            }
+
         protected_methods:
             template <typename TResource>
             CEngineResult<> addCreator(CreatorFn_t<TResource> const &aCreator);
@@ -281,6 +295,7 @@ namespace engine
             Map<std::type_index, Any_t> mUpdateFunctions;
             Map<std::type_index, Any_t> mQueryFunctions;
             Map<std::type_index, Any_t> mDestructorFunctions;
+            std::mutex                  mSharedPoolMutex;
         };
         //<-----------------------------------------------------------------------------
 
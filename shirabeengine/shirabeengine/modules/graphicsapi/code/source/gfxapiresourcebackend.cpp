@@ -8,8 +8,10 @@ namespace engine
         //
         //<-----------------------------------------------------------------------------
         CGFXAPIResourceBackend::CGFXAPIResourceBackend()
-            : mResourceThread()
-            , mResourceThreadHandler(mResourceThread.getHandler())
+            : mResourceTaskBackend(nullptr)
+            , mStorage()
+            , mStorageMutex()
+            , mJobSystem(nullptr)
         {}
         //<-----------------------------------------------------------------------------
 
@@ -18,21 +20,6 @@ namespace engine
         //<-----------------------------------------------------------------------------
         CEngineResult<> CGFXAPIResourceBackend::initialize()
         {
-            // Do not catch those as it will prevent all iteration.
-            bool const initialized = mResourceThread.initialize();
-            if(not initialized)
-            {
-                EngineStatusPrintOnError(EEngineStatus::Error, logTag(), "Cannot initialize resource backend thread.");
-                return { EEngineStatus::Error };
-            }
-
-            bool const ran = mResourceThread.run();
-            if(not ran)
-            {
-                EngineStatusPrintOnError(EEngineStatus::Error, logTag(), "Cannot run resource backend thread.");
-                return { EEngineStatus::Error };
-            }
-
             return { EEngineStatus::Ok };
         }
         //<-----------------------------------------------------------------------------
@@ -42,13 +29,10 @@ namespace engine
         //<-----------------------------------------------------------------------------
         CEngineResult<> CGFXAPIResourceBackend::deinitialize()
         {
-            if(mResourceThread.running())
-            {
-                mResourceThread.abortAndJoin();
-            }
+            // The job system is owned by the engine. Pending resource tasks are awaited by their callers.
+            mJobSystem = nullptr;
 
-            bool const deinitialized = mResourceThread.deinitialize();
-            return ( deinitialized ? EEngineStatus::Ok : EEngineStatus::Error );
+            return { EEngineStatus::Ok };
         }
         //<-----------------------------------------------------------------------------
 
@@ -60,6 +44,8 @@ namespace engine
                 Shared<void> const &aResource,
                 EImportStorageMode    const &aImportStorageMode)
         {
+            std::lock_guard<std::mutex> guard(mStorageMutex);
+
             bool const alreadyRegistered = (mStorage.end() != mStorage.find(aId));
             if(alreadyRegistered && (EImportStorageMode::NoOverwrite == aImportStorageMode))
             {
@@ -87,7 +73,15 @@ namespace engine
             looperTaskFuture = looperTask.bind(aTask);
             aOutSharedFuture = std::move(looperTaskFuture);
 
-            bool          const enqueued = mResourceThreadHandler.post(std::move(looperTask));
+            // Tasks run in parallel on the shared job system. Sections requiring external synchronization
+            // are serialized by the task backend, see CGFXAPIResourceTaskBackend::lockSharedPools.
+            if(nullptr == mJobSystem)
+            {
+                looperTask.run();
+                return { EEngineStatus::Ok };
+            }
+
+            bool          const enqueued = mJobSystem->getDispatcher<ResourceTaskFn_t::result_type>().post(std::move(looperTask));
             EEngineStatus const status   = (enqueued ? EEngineStatus::Ok : EEngineStatus::GFXAPI_SubsystemThreadEnqueueFailed);
 
             return status;
@@ -110,5 +104,14 @@ namespace engine
             }
         }
         //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CGFXAPIResourceBackend::setJobSystem(Shared<threading::CJobSystem> const &aJobSystem)
+        {
+            mJobSystem = aJobSystem;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
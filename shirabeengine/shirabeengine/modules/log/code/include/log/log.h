@@ -187,7 +187,27 @@ namespace engine
             LogImpl(ELogLevel::WTF, aLogTag, aFormat, std::forward<TArguments>(aArguments)...);
         }
 
+        /**
+         * Redirect all log output of the calling thread into aStream instead of the console,
+         * e.g. to print the output of jobs running in parallel one after another.
+         *
+         * @param aStream The stream to write to or nullptr to write to the console again.
+         * @return        The stream previously written to, to restore it afterwards.
+         */
+        static std::ostream *captureThreadOutput(std::ostream *aStream)
+        {
+            std::ostream *const previous = threadOutput();
+            threadOutput() = aStream;
+            return previous;
+        }
+
     private_static_functions:
+        static std::ostream *&threadOutput()
+        {
+            static thread_local std::ostream *sOutput = nullptr;
+            return sOutput;
+        }
+
         template <typename... TArguments>
         static void LogImpl(
                 ELogLevel       const &aLevel,
@@ -225,6 +245,13 @@ namespace engine
 
             std::string const formatted = ss.str();
 
+            std::ostream *const output = threadOutput();
+            if(nullptr != output)
+            {
+                (*output) << formatted << "\n";
+                return;
+            }
+
             #ifdef SHIRABE_PLATFORM_WINDOWS
             #ifdef _UNICODE
                     std::wstring wmsg = String::toWideString(msg);
@@ -1,8 +1,10 @@
 ﻿#ifndef __SHIARBE_MATERIAL_LOADER_H__
 #define __SHIARBE_MATERIAL_LOADER_H__
 
+#include <mutex>
 #include <log/log.h>
 #include <core/enginestatus.h>
+#include <core/threading/asyncresult.h>
 #include <resources/resourcedescriptions.h>
 
 namespace engine
@@ -36,6 +38,17 @@ namespace engine
              */
             explicit CMaterialLoader();
 
+        public_static_functions:
+            /**
+             * Return the assets a material meta or signature file refers to, so that they can be prefetched.
+             * Matches asset::AssetDependencyResolver_t.
+             *
+             * @param aAsset The material file.
+             * @param aData  The data of the material file.
+             * @return       See brief. Empty, if the data can't be decoded.
+             */
+            static std::vector<asset::AssetId_t> resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData);
+
         public_methods:
 
             /**
@@ -69,6 +82,27 @@ namespace engine
                                                                           , asset::AssetID_t             const &aMaterialInstanceAssetId
                                                                           , bool                                aAutoCreateConfiguration);
 
+            /**
+             * Load a material instance on aTaskGraph.
+             *
+             * Reading and deserializing the meta and signature files are separate stages, so that
+             * the I/O of many materials overlaps with the decoding of others. Concurrent requests
+             * for the same master share a single pipeline, each request gets its own instance.
+             * The loader must outlive the returned result.
+             *
+             * @param aTaskGraph               The graph to run the stages on.
+             * @param aAssetStorage            The storage to read the files from.
+             * @param aMaterialInstanceAssetId The material asset to load.
+             * @param aAutoCreateConfiguration Create the configuration of the instance.
+             * @param aIncludeSystemBuffers    Include system buffers in the configuration.
+             * @return                         A result referring to the instance.
+             */
+            threading::CAsyncResult<Shared<CMaterialInstance>> loadMaterialInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                                        , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                                        , asset::AssetID_t              const &aMaterialInstanceAssetId
+                                                                                        , bool                                 aAutoCreateConfiguration
+                                                                                        , bool                                 aIncludeSystemBuffers = false);
+
             /**
              * @brief destroyMaterialInstance
              * @param aMaterialInstanceAssetId
@@ -77,10 +111,23 @@ namespace engine
             CEngineResult<> destroyMaterialInstance(asset::AssetID_t const &aMaterialInstanceAssetId);
 
         private_methods:
+            /**
+             * Load or join the pipeline loading the master aMasterIndexId. Requires mMutex to be held.
+             *
+             * @param aTaskGraph     The graph to run the stages on.
+             * @param aAssetStorage  The storage to read the files from.
+             * @param aMasterIndexId The master asset to load.
+             * @return               A result referring to the master.
+             */
+            threading::CAsyncResult<Shared<CMaterialMaster>> loadMaterialMasterAsync( threading::CTaskGraph              &aTaskGraph
+                                                                                    , Shared<asset::IAssetStorage> const &aAssetStorage
+                                                                                    , asset::AssetID_t             const &aMasterIndexId);
 
         private_members:
-            Map <asset::AssetID_t, Shared<CMaterialMaster>>          mInstantiatedMaterialMasters;
-            Map <resources::ResourceId_t, Shared<CMaterialInstance>> mInstantiatedMaterialInstances;
+            std::recursive_mutex                                                          mMutex; // Guards the maps below. Recursive, since stages may run inline.
+            Map <asset::AssetID_t, Shared<CMaterialMaster>>                               mInstantiatedMaterialMasters;
+            Map <resources::ResourceId_t, Shared<CMaterialInstance>>                      mInstantiatedMaterialInstances;
+            Map <asset::AssetID_t, threading::CAsyncResult<Shared<CMaterialMaster>>>     mPendingMaterialMasters;
         };
 
     }
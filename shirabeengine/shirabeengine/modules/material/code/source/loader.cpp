@@ -1,4 +1,5 @@
-﻿#include <core/enginetypehelper.h>
+﻿#include <atomic>
+#include <core/enginetypehelper.h>
 #include <core/helpers.h>
 #include <asset/assetstorage.h>
 #include <resources/resourcedescriptions.h>
@@ -28,25 +29,18 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename T>
-        CEngineResult<T> readMaterialFile(  std::string                  const &aLogTag
-                                          , Shared<asset::IAssetStorage> const &aAssetStorage
-                                          , asset::AssetId_t             const &aAssetUID)
+        CEngineResult<T> decodeMaterialFile(  std::string      const &aLogTag
+                                            , asset::AssetId_t const &aAssetUID
+                                            , ByteBuffer       const &aDataBuffer)
         {
             using namespace documents;
 
             CJSONDeserializer<T> deserializer {};
             deserializer.initialize();
 
-            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
-            {
-                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
-                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
-            }
-
-            std::string rawInput(reinterpret_cast<char const *>(dataBuffer.data()),
-                                                                dataBuffer.size());
-
-            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(rawInput);
+            // Parse in place. The buffer may be a view of a memory mapped file.
+            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(reinterpret_cast<char const *>(aDataBuffer.data()),
+                                                                                          aDataBuffer.size());
             {
                 PrintEngineError(not deserializationSuccessful, aLogTag, "Could not load material file '{}'", aAssetUID);
                 SHIRABE_RETURN_RESULT_ON_ERROR(not deserializationSuccessful);
@@ -60,6 +54,48 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        CEngineResult<T> readMaterialFile(  std::string                  const &aLogTag
+                                          , Shared<asset::IAssetStorage> const &aAssetStorage
+                                          , asset::AssetId_t             const &aAssetUID)
+        {
+            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
+            {
+                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
+            }
+
+            return decodeMaterialFile<T>(aLogTag, aAssetUID, dataBuffer);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        threading::CAsyncResult<T> readMaterialFileAsync(  threading::CTaskGraph              &aTaskGraph
+                                                         , std::string                  const &aLogTag
+                                                         , Shared<asset::IAssetStorage> const &aAssetStorage
+                                                         , asset::AssetId_t             const &aAssetUID)
+        {
+            // Stage 1: I/O. Stage 2: Deserialization.
+            threading::CAsyncResult<ByteBuffer> const data = threading::async<ByteBuffer>(aTaskGraph, [=] () -> CEngineResult<ByteBuffer>
+            {
+                CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetData(aAssetUID);
+                PrintEngineError(dataFetch.result(), aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                return dataFetch;
+            });
+
+            return data.then([=] (ByteBuffer const &aDataBuffer) -> CEngineResult<T>
+            {
+                return decodeMaterialFile<T>(aLogTag, aAssetUID, aDataBuffer);
+            });
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -176,6 +212,73 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        static Shared<CMaterialInstance> instantiateMaterial(Shared<CMaterialMaster> const &aMaster
+                                                           , bool                           aAutoCreateConfiguration
+                                                           , bool                           aIncludeSystemBuffers)
+        {
+            static std::atomic<uint64_t> sInstanceIndex(0);
+            std::string instanceName = fmt::format("{}_instance_{}", aMaster->name(), ++sInstanceIndex);
+
+            Shared<CMaterialInstance> instance = makeShared<CMaterialInstance>(instanceName, aMaster);
+
+            if(aAutoCreateConfiguration)
+            {
+                instance->createConfiguration(aIncludeSystemBuffers);
+            }
+
+            return instance;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<asset::AssetId_t> CMaterialLoader::resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData)
+        {
+            std::vector<asset::AssetId_t> dependencies {};
+
+            if(EAssetSubtype::Meta == aAsset.subtype)
+            {
+                auto const [result, meta] = decodeMaterialFile<SMaterialMeta>(logTag(), aAsset.id, aData);
+                if(CheckEngineError(result))
+                {
+                    return {};
+                }
+
+                dependencies.push_back(meta.signatureAssetUid);
+                for(auto const &[stage, metaStage] : meta.stages)
+                {
+                    if(0_uid != metaStage.spvModuleAssetId)
+                    {
+                        dependencies.push_back(metaStage.spvModuleAssetId);
+                    }
+                }
+            }
+            else if(EAssetSubtype::Signature == aAsset.subtype)
+            {
+                auto const [result, signature] = decodeMaterialFile<SMaterialSignature>(logTag(), aAsset.id, aData);
+                if(CheckEngineError(result))
+                {
+                    return {};
+                }
+
+                // The SPIR-V modules are referenced by filename, see deriveResourceDescriptions.
+                for(auto const &[stage, signatureStage] : signature.stages)
+                {
+                    if(not signatureStage.filename.empty())
+                    {
+                        dependencies.push_back(asset::assetIdFromUri(signatureStage.filename));
+                    }
+                }
+            }
+
+            return dependencies;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -211,9 +314,12 @@ namespace engine
                                                                                       , asset::AssetID_t             const &aMaterialInstanceAssetId
                                                                                       , bool                                aAutoCreateConfiguration)
         {
-            if(mInstantiatedMaterialInstances.end() != mInstantiatedMaterialInstances.find(aMaterialInstanceId))
             {
-                return { EEngineStatus::Ok, mInstantiatedMaterialInstances.at(aMaterialInstanceId) };
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                if(mInstantiatedMaterialInstances.end() != mInstantiatedMaterialInstances.find(aMaterialInstanceId))
+                {
+                    return { EEngineStatus::Ok, mInstantiatedMaterialInstances.at(aMaterialInstanceId) };
+                }
             }
 
             return loadMaterialInstance(aAssetStorage, aMaterialInstanceAssetId, aAutoCreateConfiguration);
@@ -253,20 +359,31 @@ namespace engine
             //
             Shared<CMaterialMaster> master = nullptr;
 
+            std::unique_lock<std::recursive_mutex> lock(mMutex);
             if(mInstantiatedMaterialMasters.end() != mInstantiatedMaterialMasters.find(masterIndexId))
             {
                 master = mInstantiatedMaterialMasters.at(masterIndexId);
+                lock.unlock();
             }
             else
             {
+                lock.unlock();
+
                 auto[successful, masterName, masterMeta, masterSignature, masterConfig] = loadMasterMaterialFiles(logTag(), aAssetStorage, mInstantiatedMaterialMasters, masterIndexId);
                 {
                     PrintEngineError(not successful, logTag(), "Couldn't fetch master material data.");
                     SHIRABE_RETURN_RESULT_ON_ERROR(not successful);
                 }
 
-                master = makeShared<CMaterialMaster>(masterIndexId, masterName, std::move(masterSignature), std::move(masterConfig));
-                mInstantiatedMaterialMasters[master->getAssetId()] = master;
+                lock.lock();
+                // An asynchronous load might have finished in the meantime. Keep the first master.
+                auto const [iterator, inserted] = mInstantiatedMaterialMasters.insert({ masterIndexId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CMaterialMaster>(masterIndexId, masterName, std::move(masterSignature), std::move(masterConfig));
+                }
+                master = iterator->second;
+                lock.unlock();
             }
 
             if(nullptr == master)
@@ -274,21 +391,124 @@ namespace engine
                 return { EEngineStatus::Error, nullptr };
             }
 
-            static uint64_t sInstanceIndex = 0;
-            std::string instanceName = fmt::format("{}_instance_{}", master->name(), ++sInstanceIndex);
+            Shared<CMaterialInstance> instance = instantiateMaterial(master, aAutoCreateConfiguration, aIncludeSystemBuffers);
 
-            Shared<CMaterialInstance> instance = makeShared<CMaterialInstance>(instanceName, master);
+            lock.lock();
+            mInstantiatedMaterialInstances.insert({ instance->name(), instance });
 
-            if(aAutoCreateConfiguration)
+            return { EEngineStatus::Ok, instance };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        threading::CAsyncResult<Shared<CMaterialMaster>> CMaterialLoader::loadMaterialMasterAsync( threading::CTaskGraph              &aTaskGraph
+                                                                                                , Shared<asset::IAssetStorage> const &aAssetStorage
+                                                                                                , asset::AssetID_t             const &aMasterIndexId)
+        {
+            using namespace threading;
+
+            std::string const tag           = logTag();
+            AssetID_t   const masterIndexId = aMasterIndexId;
+
+            if(mInstantiatedMaterialMasters.end() != mInstantiatedMaterialMasters.find(masterIndexId))
             {
-                instance->createConfiguration(aIncludeSystemBuffers);
+                return ready<Shared<CMaterialMaster>>(aTaskGraph, { EEngineStatus::Ok, mInstantiatedMaterialMasters.at(masterIndexId) });
+            }
+
+            // Join a pending load. Failed loads are retried.
+            auto const pending = mPendingMaterialMasters.find(masterIndexId);
+            if(mPendingMaterialMasters.end() != pending)
+            {
+                bool const failed = (pending->second.finished() && not pending->second.get().successful());
+                if(not failed)
+                {
+                    return pending->second;
+                }
+                mPendingMaterialMasters.erase(pending);
             }
 
-            mInstantiatedMaterialInstances.insert({ instanceName, instance });
+            CAsyncResult<SMaterialMeta> const meta = readMaterialFileAsync<SMaterialMeta>(aTaskGraph, tag, aAssetStorage, masterIndexId);
 
-            return { EEngineStatus::Ok, instance };
+            CAsyncResult<ByteBuffer> const signatureData = meta.then([=] (SMaterialMeta const &aMeta) -> CEngineResult<ByteBuffer>
+            {
+                auto const [signatureAssetFetchResult, signatureAsset] = aAssetStorage->loadAsset(aMeta.signatureAssetUid);
+                {
+                    PrintEngineError(signatureAssetFetchResult, tag, "Could not fetch signature asset data.");
+                    SHIRABE_RETURN_RESULT_ON_ERROR(signatureAssetFetchResult);
+                }
+
+                CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetData(signatureAsset.id);
+                PrintEngineError(dataFetch.result(), tag, "Could not load asset data for asset {}", signatureAsset.id);
+                return dataFetch;
+            });
+
+            CAsyncResult<SMaterialSignature> const signature = signatureData.then([=] (ByteBuffer const &aDataBuffer) -> CEngineResult<SMaterialSignature>
+            {
+                return decodeMaterialFile<SMaterialSignature>(tag, masterIndexId, aDataBuffer);
+            });
+
+            // The meta stage precedes the signature stages, so its value is available here.
+            CAsyncResult<Shared<CMaterialMaster>> const master = signature.then([this, meta, masterIndexId] (SMaterialSignature const &aSignature) -> CEngineResult<Shared<CMaterialMaster>>
+            {
+                std::string const masterName = meta.get().data().name;
+
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                auto const [iterator, inserted] = mInstantiatedMaterialMasters.insert({ masterIndexId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CMaterialMaster>(masterIndexId, masterName, SMaterialSignature(aSignature), CMaterialConfig {});
+                }
+                mPendingMaterialMasters.erase(masterIndexId);
+
+                return { EEngineStatus::Ok, iterator->second };
+            });
+
+            // The last stage can't finish while the lock is held, unless it ran inline already.
+            if(not master.finished())
+            {
+                mPendingMaterialMasters[masterIndexId] = master;
+            }
+
+            return master;
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        threading::CAsyncResult<Shared<CMaterialInstance>> CMaterialLoader::loadMaterialInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                                                    , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                                                    , asset::AssetID_t              const &aMaterialInstanceAssetId
+                                                                                                    , bool                                 aAutoCreateConfiguration
+                                                                                                    , bool                                 aIncludeSystemBuffers)
+        {
+            using namespace threading;
+
+            CTaskGraph &graph = *aTaskGraph;
+
+            if(0_uid == aMaterialInstanceAssetId)
+            {
+                return ready<Shared<CMaterialInstance>>(graph, { EEngineStatus::Error });
+            }
+
+            CAsyncResult<Shared<CMaterialMaster>> master = {};
+            {
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                master = loadMaterialMasterAsync(graph, aAssetStorage, aMaterialInstanceAssetId); // instanceIndexAsset.parent;
+            }
+
+            return master.then([this, aAutoCreateConfiguration, aIncludeSystemBuffers] (Shared<CMaterialMaster> const &aMaster) -> CEngineResult<Shared<CMaterialInstance>>
+            {
+                Shared<CMaterialInstance> instance = instantiateMaterial(aMaster, aAutoCreateConfiguration, aIncludeSystemBuffers);
+
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                mInstantiatedMaterialInstances.insert({ instance->name(), instance });
+
+                return { EEngineStatus::Ok, instance };
+            });
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
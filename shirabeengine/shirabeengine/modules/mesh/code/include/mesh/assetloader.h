@@ -5,6 +5,8 @@
 #ifndef __SHIRABEDEVELOPMENT_MESH_ASSETLOADER_H__
 #define __SHIRABEDEVELOPMENT_MESH_ASSETLOADER_H__
 
+#include <algorithm>
+
 #include <asset/assetstorage.h>
 #include <resources/resourcedescriptions.h>
 #include <resources/resourcetypes.h>
@@ -31,23 +33,19 @@ namespace engine::mesh
     {
         using namespace resources;
 
-        uint64_t accumulatedVertexDataSize = 0;
-        for(auto const &attributeDescription : aDataFile.attributes)
-        {
-            accumulatedVertexDataSize += (attributeDescription.length * attributeDescription.bytesPerSample);
-        }
+        asset::SAssetDataRange const vertexDataRange = aDataFile.vertexDataRange();
+        asset::SAssetDataRange const indexDataRange  = aDataFile.indexDataRange();
 
         DataSourceAccessor_t dataAccessor = [=] () -> ByteBuffer
         {
-            asset::AssetID_t const assetUid = asset::assetIdFromUri(aDataFile.dataBinaryFilename);
-            auto const [result, buffer] = aAssetStorage->loadAssetData(assetUid);
+            asset::AssetID_t const assetUid = aDataFile.assetId;
+            auto const [result, buffer] = aAssetStorage->loadAssetDataRange(assetUid, vertexDataRange.offset, vertexDataRange.length);
             if(CheckEngineError(result))
             {
                 CLog::Error("DataSourceAccessor_t::MeshBinaryData", "Failed to load binary data for mesh. Result: {}", result);
                 return {};
             }
 
-            ByteBuffer bufferView = buffer.createView(0, accumulatedVertexDataSize);
             return buffer;
         };
 
@@ -57,7 +55,7 @@ namespace engine::mesh
         dataBufferDescription.createInfo.sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         dataBufferDescription.createInfo.pNext                 = nullptr;
         dataBufferDescription.createInfo.flags                 = 0;
-        dataBufferDescription.createInfo.size                  = accumulatedVertexDataSize;
+        dataBufferDescription.createInfo.size                  = vertexDataRange.length;
         dataBufferDescription.createInfo.pQueueFamilyIndices   = nullptr;
         dataBufferDescription.createInfo.queueFamilyIndexCount = 0;
         dataBufferDescription.createInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
@@ -65,15 +63,14 @@ namespace engine::mesh
 
         DataSourceAccessor_t indexDataAccessor = [=] () -> ByteBuffer
         {
-            asset::AssetID_t const assetUid = asset::assetIdFromUri(aDataFile.indexBinaryFilename);
-            auto const [result, buffer] = aAssetStorage->loadAssetData(assetUid);
+            asset::AssetID_t const assetUid = aDataFile.assetId;
+            auto const [result, buffer] = aAssetStorage->loadAssetDataRange(assetUid, indexDataRange.offset, indexDataRange.length);
             if(CheckEngineError(result))
             {
                 CLog::Error("DataSourceAccessor_t::MeshBinaryData", "Failed to load binary data for mesh. Result: {}", result);
                 return {};
             }
 
-            ByteBuffer bufferView = buffer.createView(aDataFile.indices.offset, aDataFile.indices.length);
             return buffer;
         };
 
@@ -83,7 +80,7 @@ namespace engine::mesh
         indexBufferDescription.createInfo.pNext                 = nullptr;
         indexBufferDescription.createInfo.flags                 = 0;
         indexBufferDescription.dataSource                       = indexDataAccessor;
-        indexBufferDescription.createInfo.size                  = (aDataFile.indices.length * aDataFile.indices.bytesPerSample);
+        indexBufferDescription.createInfo.size                  = indexDataRange.length;
         indexBufferDescription.createInfo.pQueueFamilyIndices   = nullptr;
         indexBufferDescription.createInfo.queueFamilyIndexCount = 0;
         indexBufferDescription.createInfo.sharingMode           = VK_SHARING_MODE_EXCLUSIVE;
@@ -93,6 +90,25 @@ namespace engine::mesh
     };
     //<-----------------------------------------------------------------------------
 
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    static VkFormat vkFormatOf(EMeshAttributeFormat const &aFormat)
+    {
+        switch(aFormat)
+        {
+            case EMeshAttributeFormat::Float32x2: return VkFormat::VK_FORMAT_R32G32_SFLOAT;
+            case EMeshAttributeFormat::Float32x3: return VkFormat::VK_FORMAT_R32G32B32_SFLOAT;
+            case EMeshAttributeFormat::Float32x4: return VkFormat::VK_FORMAT_R32G32B32A32_SFLOAT;
+            case EMeshAttributeFormat::Float16x2: return VkFormat::VK_FORMAT_R16G16_SFLOAT;
+            case EMeshAttributeFormat::Snorm16x2: return VkFormat::VK_FORMAT_R16G16_SNORM;
+            case EMeshAttributeFormat::Snorm16x4: return VkFormat::VK_FORMAT_R16G16B16A16_SNORM;
+            case EMeshAttributeFormat::Unorm16x4: return VkFormat::VK_FORMAT_R16G16B16A16_UNORM;
+            default:                              return VkFormat::VK_FORMAT_UNDEFINED;
+        }
+    }
+    //<-----------------------------------------------------------------------------
+
     //<-----------------------------------------------------------------------------
     //
     //<-----------------------------------------------------------------------------
@@ -120,18 +136,53 @@ namespace engine::mesh
 
             meshDescriptor.attributeCount         = dataFile.attributeSampleCount;
             meshDescriptor.indexSampleCount       = dataFile.indexSampleCount;
+            meshDescriptor.indexBytesPerSample    = static_cast<uint32_t>(dataFile.indices.bytesPerSample);
+
+            for(SMeshLod const &lod : dataFile.lods)
+            {
+                meshDescriptor.lods.push_back({ lod.firstIndex, lod.indexCount });
+            }
 
-            Vector<VkDeviceSize> offsets;
-            offsets.resize(4);
+            // Stream k is bound to binding k at its offset. Attribute k is fetched from location k
+            // at its offset within the vertex of its stream.
+            std::vector<SMeshStream> const streams = dataFile.streams();
+            for(uint32_t k=0; k<streams.size(); ++k)
+            {
+                VkVertexInputBindingDescription binding {};
+                binding.binding   = k;
+                binding.stride    = static_cast<uint32_t>(streams[k].stride);
+                binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
-            VkDeviceSize currentOffset = 0;
-            for(uint64_t k=0; k<4; ++k)
+                meshDescriptor.offsets            .push_back(streams[k].offset);
+                meshDescriptor.bindingDescriptions.push_back(binding);
+            }
+
+            for(uint32_t k=0; k<dataFile.attributes.size(); ++k)
             {
-                offsets[k] = currentOffset;
-                VkDeviceSize length = (dataFile.attributes[k].length * dataFile.attributes[k].bytesPerSample);
-                currentOffset += length;
+                SMeshAttributeDescription const &attribute = dataFile.attributes[k];
+
+                auto const stream = std::find_if(streams.begin(), streams.end(), [&attribute] (SMeshStream const &aStream) { return (aStream.index == attribute.index); });
+
+                VkVertexInputAttributeDescription attributeDescription {};
+                attributeDescription.binding  = static_cast<uint32_t>(std::distance(streams.begin(), stream));
+                attributeDescription.location = k;
+                attributeDescription.offset   = static_cast<uint32_t>(attribute.offset - stream->offset);
+                attributeDescription.format   = vkFormatOf(attribute.format);
+
+                meshDescriptor.attributeDescriptions.push_back(attributeDescription);
+            }
+
+            // Quantized positions are relative to the bounds of the mesh. Float positions pass through.
+            meshDescriptor.drawConstants = { {{ 1.0f, 1.0f, 1.0f, 0.0f }}, {{ 0.0f, 0.0f, 0.0f, 1.0f }} };
+
+            auto const position = std::find_if(dataFile.attributes.begin(), dataFile.attributes.end(), [] (SMeshAttributeDescription const &aAttribute) { return ("POSITION" == aAttribute.name); });
+            if(dataFile.attributes.end() != position && EMeshAttributeFormat::Unorm16x4 == position->format)
+            {
+                SMeshBounds const &bounds = dataFile.bounds;
+
+                meshDescriptor.drawConstants.positionScale  = { (bounds.maximum[0] - bounds.minimum[0]), (bounds.maximum[1] - bounds.minimum[1]), (bounds.maximum[2] - bounds.minimum[2]), 0.0f };
+                meshDescriptor.drawConstants.positionOffset = { bounds.minimum[0], bounds.minimum[1], bounds.minimum[2], 1.0f };
             }
-            meshDescriptor.offsets = offsets;
 
             CEngineResult<Shared<ILogicalResourceObject>> bufferResourceObject = aResourceManager->useDynamicResource<SBuffer>(meshDescriptor.dataBufferDescription.name, meshDescriptor.dataBufferDescription);
             EngineStatusPrintOnError(bufferResourceObject.result(),  "Mesh::AssetLoader", "Failed to create vertex buffer.");
@@ -21,6 +21,8 @@
 #include <asset/assettypes.h>
 #include <resources/resourcedescriptions.h>
 
+#include "mesh/meshcontainer.h"
+
 namespace engine
 {
     namespace documents
@@ -34,15 +36,6 @@ namespace engine
 
     namespace mesh
     {
-        struct SMeshAttributeDescription
-        {
-            std::string name;
-            uint64_t    index;
-            uint64_t    offset;
-            uint64_t    length;
-            uint64_t    bytesPerSample;
-        };
-
         /**
          * The SMaterialIndex describes all necessary data for a basic material composition
          * in the engine.
@@ -122,115 +115,6 @@ namespace engine
             bool acceptDeserializer(documents::IJSONDeserializer<SMeshMeta> &aDeserializer) final;
         };
 
-        /**
-         * The SMaterialIndex describes all necessary data for a basic material composition
-         * in the engine.
-         * The specific implementation will be provided in files referenced by the stages member.
-         */
-        struct SMeshDataFile
-                : engine::serialization::ISerializable<documents::IJSONSerializer<SMeshDataFile>>
-                  , engine::serialization::IDeserializable<documents::IJSONDeserializer<SMeshDataFile>>
-        {
-        public_constructors:
-            SHIRABE_INLINE
-            SMeshDataFile()
-                    : serialization::ISerializable<documents::IJSONSerializer<SMeshDataFile>>()
-                      , serialization::IDeserializable<documents::IJSONDeserializer<SMeshDataFile>>()
-                      , uid                  (0 )
-                      , name                 ({})
-                      , attributes           ({})
-                      , indices              ({})
-                      , dataBinaryFilename   ()
-                      , indexBinaryFilename  ()
-                      , attributeSampleCount (0)
-                      , indexSampleCount     (0)
-            {}
-
-            SHIRABE_INLINE
-            SMeshDataFile(SMeshDataFile const &aOther)
-                    : serialization::ISerializable<documents::IJSONSerializer<SMeshDataFile>>()
-                      , serialization::IDeserializable<documents::IJSONDeserializer<SMeshDataFile>>()
-                      , uid                  (aOther.uid                  )
-                      , name                 (aOther.name                 )
-                      , attributes           (aOther.attributes           )
-                      , indices              (aOther.indices              )
-                      , dataBinaryFilename   (aOther.dataBinaryFilename   )
-                      , indexBinaryFilename  (aOther.indexBinaryFilename  )
-                      , attributeSampleCount (aOther.attributeSampleCount )
-                      , indexSampleCount     (aOther.indexSampleCount     )
-            {}
-
-            SHIRABE_INLINE
-            SMeshDataFile(SMeshDataFile &&aOther) noexcept
-                    : serialization::ISerializable<documents::IJSONSerializer<SMeshDataFile>>()
-                      , serialization::IDeserializable<documents::IJSONDeserializer<SMeshDataFile>>()
-                      , uid                  (aOther.uid                  )
-                      , name                 (std::move(aOther.name      ))
-                      , attributes           (std::move(aOther.attributes))
-                      , indices              (aOther.indices              )
-                      , dataBinaryFilename   (aOther.dataBinaryFilename   )
-                      , indexBinaryFilename  (aOther.indexBinaryFilename  )
-                      , attributeSampleCount (aOther.attributeSampleCount )
-                      , indexSampleCount     (aOther.indexSampleCount     )
-            {}
-
-        public_operators:
-            SHIRABE_INLINE
-            SMeshDataFile &operator=(SMeshDataFile const &aOther)
-            {
-                uid                  = aOther.uid;
-                name                 = aOther.name;
-                attributes           = aOther.attributes;
-                indices              = aOther.indices;
-                dataBinaryFilename   = aOther.dataBinaryFilename;
-                indexBinaryFilename  = aOther.indexBinaryFilename;
-                attributeSampleCount = aOther.attributeSampleCount;
-                indexSampleCount     = aOther.indexSampleCount;
-
-                return (*this);
-            }
-
-            SHIRABE_INLINE
-            SMeshDataFile &operator=(SMeshDataFile &&aOther) noexcept
-            {
-                uid                  = aOther.uid;
-                name                 = std::move(aOther.name);
-                attributes           = std::move(aOther.attributes);
-                indices              = aOther.indices;
-                dataBinaryFilename   = aOther.dataBinaryFilename;
-                indexBinaryFilename  = aOther.indexBinaryFilename;
-                attributeSampleCount = aOther.attributeSampleCount;
-                indexSampleCount     = aOther.indexSampleCount;
-
-                return (*this);
-            }
-
-        public_members:
-            uint64_t                               uid;
-            std::string                            name;
-            std::vector<SMeshAttributeDescription> attributes;
-            SMeshAttributeDescription              indices;
-            uint32_t                               attributeSampleCount;
-            uint32_t                               indexSampleCount;
-            std::filesystem::path                  dataBinaryFilename;
-            std::filesystem::path                  indexBinaryFilename;
-
-        public_methods:
-            /**
-             * @brief acceptSerializer
-             * @param aSerializer
-             * @return
-             */
-            bool acceptSerializer(documents::IJSONSerializer<SMeshDataFile> &aSerializer) const final;
-
-            /**
-             * @brief acceptDeserializer
-             * @param aSerializer
-             * @return
-             */
-            bool acceptDeserializer(documents::IJSONDeserializer<SMeshDataFile> &aDeserializer) final;
-        };
-
         class CMeshInstance
             : public asset::CAssetReference
         {
@@ -1,8 +1,10 @@
 ﻿#ifndef __SHIARBE_MESH_LOADER_H__
 #define __SHIARBE_MESH_LOADER_H__
 
+#include <mutex>
 #include <log/log.h>
 #include <core/enginestatus.h>
+#include <core/threading/asyncresult.h>
 #include <resources/resourcedescriptions.h>
 
 namespace engine
@@ -35,6 +37,18 @@ namespace engine
              */
             explicit CMeshLoader();
 
+        public_static_functions:
+            /**
+             * Return the assets a mesh meta file refers to, so that they can be prefetched.
+             * Mesh containers are self-contained and refer to nothing.
+             * Matches asset::AssetDependencyResolver_t.
+             *
+             * @param aAsset The mesh file.
+             * @param aData  The data of the mesh file.
+             * @return       See brief. Empty, if the data can't be decoded.
+             */
+            static std::vector<asset::AssetId_t> resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData);
+
         public_methods:
 
             CEngineResult <Shared<CMeshInstance>> createMeshInstance(asset::AssetID_t const &aMeshAssetId);
@@ -52,6 +66,22 @@ namespace engine
                                                                       , Shared<asset::IAssetStorage> const &aAssetStorage
                                                                       , asset::AssetID_t             const &aMeshAssetId);
 
+            /**
+             * Load a mesh instance on aTaskGraph.
+             *
+             * Reading and deserializing the meta and data files are separate stages, so that the
+             * I/O of many meshes overlaps with the decoding of others. Concurrent requests for the
+             * same asset share a single pipeline. The loader must outlive the returned result.
+             *
+             * @param aTaskGraph    The graph to run the stages on.
+             * @param aAssetStorage The storage to read the files from.
+             * @param aMeshAssetId  The mesh asset to load.
+             * @return              A result referring to the instance.
+             */
+            threading::CAsyncResult<Shared<CMeshInstance>> loadMeshInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                                , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                                , asset::AssetID_t              const &aMeshAssetId);
+
             /**
              * @brief destroyMaterialInstance
              * @param aMaterialInstanceAssetId
@@ -62,7 +92,9 @@ namespace engine
         private_methods:
 
         private_members:
-            Map <asset::AssetID_t, Shared<CMeshInstance>> mInstantiatedMeshes;
+            std::recursive_mutex                                                      mMutex; // Guards the maps below. Recursive, since stages may run inline.
+            Map <asset::AssetID_t, Shared<CMeshInstance>>                             mInstantiatedMeshes;
+            Map <asset::AssetID_t, threading::CAsyncResult<Shared<CMeshInstance>>>   mPendingMeshes;
         };
 
     }
@@ -0,0 +1,280 @@
+#ifndef __SHIRABE_MESH_MESHCONTAINER_H__
+#define __SHIRABE_MESH_MESHCONTAINER_H__
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <platform/platform.h>
+#include <base/declaration.h>
+#include <core/enginestatus.h>
+#include <core/databuffer.h>
+#include <asset/assettypes.h>
+
+namespace engine
+{
+    namespace mesh
+    {
+        /*
+         * Layout of a mesh container file (little endian):
+         *
+         *   [SMeshContainerHeader]                 at offset 0
+         *   [SMeshContainerAttribute x N]          the attribute descriptors
+         *   [SMeshContainerLod x L]                the LOD descriptors, finest first
+         *   [padding]                              to a multiple of kMeshContainerSectionAlignment
+         *   [vertex section]                       streams back to back, each starting at a multiple
+         *                                          of kMeshContainerAttributeAlignment within the section
+         *   [padding]                              to a multiple of kMeshContainerSectionAlignment
+         *   [index section]                        the indices of all LODs back to back
+         *
+         * The sections are uploaded as they are, so that a mapped container is handed to the
+         * vertex and index buffers without a copy. All LODs share the vertex section and only
+         * differ in their range of the index section.
+         *
+         * A stream is a vertex buffer binding and holds the attributes sharing an index, interleaved
+         * per vertex in the order of their descriptors. A stream of a single attribute is planar.
+         */
+
+        static constexpr char     const kMeshContainerMagic[8]            = { 'S', 'H', 'R', 'B', 'M', 'E', 'S', 'H' };
+        static constexpr uint32_t const kMeshContainerVersion             = 4;
+        static constexpr uint64_t const kMeshContainerSectionAlignment    = 64;
+        static constexpr uint64_t const kMeshContainerAttributeAlignment  = 16;
+        static constexpr uint64_t const kMeshContainerAttributeNameLength = 32;
+
+        /**
+         * The encoding of the samples of an attribute. Matches a vertex input format of the graphics API.
+         */
+        enum class EMeshAttributeFormat
+            : uint32_t
+        {
+            Undefined = 0, // Raw samples of bytesPerSample bytes, e.g. the indices.
+            Float32x2,
+            Float32x3,
+            Float32x4,
+            Float16x2,
+            Snorm16x2,     // E.g. octahedral unit vectors.
+            Snorm16x4,     // E.g. octahedral tangents with their handedness in z.
+            Unorm16x4,     // E.g. positions relative to the bounds of the mesh. w is unused.
+        };
+
+        /**
+         * Return the size of a sample of aFormat in bytes.
+         *
+         * @param aFormat The format.
+         * @return        See brief. 0 for EMeshAttributeFormat::Undefined and unknown formats.
+         */
+        SHIRABE_TEST_EXPORT uint64_t meshAttributeFormatSize(EMeshAttributeFormat aFormat);
+
+        /**
+         * Return the size of an index of a mesh in bytes. The graphics API binds 16 or 32 bit
+         * indices only, the narrower ones whenever they address all vertices.
+         *
+         * @param aVertexCount The number of vertices.
+         * @return             2 for up to 65535 vertices, 4 otherwise.
+         */
+        SHIRABE_TEST_EXPORT uint64_t meshIndexBytesPerSample(uint32_t aVertexCount);
+
+        /**
+         * The SMeshContainerHeader struct is stored at the very beginning of a mesh container.
+         */
+        struct SMeshContainerHeader
+        {
+        public_members:
+            char     magic[8];
+            uint32_t version;
+            uint32_t attributeCount;
+            uint32_t attributeSampleCount;
+            uint32_t indexSampleCount;
+            uint64_t indexBytesPerSample; // 2 or 4.
+            uint64_t vertexDataOffset;
+            uint64_t vertexDataSize;
+            uint64_t indexDataOffset;
+            uint64_t indexDataSize;
+            uint32_t lodCount;
+            uint32_t reserved;
+            float    boundsMinimum[3]; // Object space bounding box of all vertices.
+            float    boundsMaximum[3];
+        };
+        static_assert(96 == sizeof(SMeshContainerHeader), "SMeshContainerHeader must be 96 bytes.");
+
+        /**
+         * The SMeshContainerAttribute struct describes a single attribute of a mesh container.
+         */
+        struct SMeshContainerAttribute
+        {
+        public_members:
+            char     name[kMeshContainerAttributeNameLength]; // Zero padded, not necessarily terminated.
+            uint32_t index;          // The stream.
+            uint32_t format;         // EMeshAttributeFormat
+            uint64_t offset;         // Bytes from the start of the vertex section to the first sample.
+            uint64_t length;         // Samples.
+            uint32_t bytesPerSample;
+            uint32_t stride;         // Bytes from one sample to the next, i.e. the vertex size of the stream.
+        };
+        static_assert(64 == sizeof(SMeshContainerAttribute), "SMeshContainerAttribute must be 64 bytes.");
+
+        /**
+         * The SMeshContainerLod struct describes a single level of detail of a mesh container.
+         */
+        struct SMeshContainerLod
+        {
+        public_members:
+            uint32_t firstIndex; // Samples from the start of the index section.
+            uint32_t indexCount;
+            float    error;      // Object space distance error against the finest LOD.
+            uint32_t reserved;
+        };
+        static_assert(16 == sizeof(SMeshContainerLod), "SMeshContainerLod must be 16 bytes.");
+
+        /**
+         * Describes an attribute or the indices of a mesh.
+         */
+        struct SMeshAttributeDescription
+        {
+            std::string          name;
+            uint64_t             index;  // The stream. Attributes of the same stream are interleaved.
+            uint64_t             offset; // Bytes from the start of the vertex section to the first sample. 0 for indices.
+            uint64_t             length; // Samples.
+            uint64_t             bytesPerSample;
+            EMeshAttributeFormat format; // If not undefined, bytesPerSample matches its size.
+            uint64_t             stride; // Bytes from one sample to the next. Assigned by the container layout.
+        };
+
+        /**
+         * Describes a stream of a mesh, i.e. a vertex buffer binding.
+         */
+        struct SMeshStream
+        {
+            uint64_t index;
+            uint64_t offset; // Bytes from the start of the vertex section, i.e. the binding offset.
+            uint64_t stride; // Bytes per vertex.
+        };
+
+        /**
+         * Describes a level of detail as a range of the indices of a mesh.
+         */
+        struct SMeshLod
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+            float    error; // Object space distance error against the finest LOD.
+        };
+
+        /**
+         * Object space axis aligned bounding box of a mesh.
+         * Positions of EMeshAttributeFormat::Unorm16x4 dequantize to minimum + position * (maximum - minimum).
+         */
+        struct SMeshBounds
+        {
+            std::array<float, 3> minimum;
+            std::array<float, 3> maximum;
+        };
+
+        /**
+         * The SMeshDataFile struct describes the content of a mesh container, decoded from its
+         * header and attribute descriptors.
+         */
+        struct SMeshDataFile
+        {
+        public_members:
+            asset::AssetId_t                       assetId; // The container, to read the sections from.
+            std::vector<SMeshAttributeDescription> attributes;
+            SMeshAttributeDescription              indices;
+            std::vector<SMeshLod>                  lods;    // Finest first. At least one.
+            SMeshBounds                            bounds;
+            uint32_t                               attributeSampleCount;
+            uint32_t                               indexSampleCount;
+            uint64_t                               vertexDataOffset;
+            uint64_t                               vertexDataSize;
+            uint64_t                               indexDataOffset;
+            uint64_t                               indexDataSize;
+
+        public_methods:
+            /**
+             * Return the byte range of the vertex section within the container.
+             *
+             * @return See brief.
+             */
+            asset::SAssetDataRange vertexDataRange() const;
+
+            /**
+             * Return the byte range of a single attribute within the vertex section, from its first
+             * to the end of its last sample. Spans the other attributes of an interleaved stream.
+             *
+             * @param aAttributeIndex Index into attributes.
+             * @return                See brief.
+             */
+            asset::SAssetDataRange attributeDataRange(std::size_t aAttributeIndex) const;
+
+            /**
+             * Return the streams of the attributes, ordered by their index.
+             *
+             * @return See brief.
+             */
+            std::vector<SMeshStream> streams() const;
+
+            /**
+             * Return the byte range of the index section within the container.
+             *
+             * @return See brief.
+             */
+            asset::SAssetDataRange indexDataRange() const;
+
+            /**
+             * Return the radius of a sphere around the object space origin, which encloses all vertices.
+             *
+             * @return See brief.
+             */
+            float boundingRadius() const;
+        };
+
+        /**
+         * Write a mesh container.
+         *
+         * @param aAttributes           The attributes. Their offsets and strides are assigned by the layout.
+         *                              Attributes sharing an index are interleaved into one stream.
+         * @param aAttributeData        The planar samples of each attribute, in the order of aAttributes.
+         * @param aIndices              The description of the indices, 2 or 4 bytes per sample.
+         *                              The offset is ignored.
+         * @param aIndexData            The index samples of all LODs.
+         * @param aAttributeSampleCount The number of vertices.
+         * @param aLods                 The LODs, finest first. If empty, a single LOD spans all indices.
+         * @param aBounds               The bounding box of the vertices.
+         * @return                      The container. EEngineStatus::Error, if the data doesn't
+         *                              match the descriptions or their formats, the attributes of
+         *                              a stream differ in length, a LOD exceeds the indices or a name
+         *                              is too long.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<std::vector<uint8_t>> encodeMeshContainer(std::vector<SMeshAttributeDescription> const &aAttributes
+                                                                                  , std::vector<std::vector<uint8_t>>       const &aAttributeData
+                                                                                  , SMeshAttributeDescription               const &aIndices
+                                                                                  , std::vector<uint8_t>                    const &aIndexData
+                                                                                  , uint32_t                                       aAttributeSampleCount
+                                                                                  , std::vector<SMeshLod>                   const &aLods
+                                                                                  , SMeshBounds                             const &aBounds);
+
+        /**
+         * Decode the header and attribute descriptors of a mesh container.
+         * The sections are not touched.
+         *
+         * @param aAssetId The asset aData was read from.
+         * @param aData    The container.
+         * @return         The description. EEngineStatus::Error, if aData is not a valid container.
+         */
+        SHIRABE_TEST_EXPORT CEngineResult<SMeshDataFile> decodeMeshContainer(asset::AssetId_t const &aAssetId, ByteBuffer const &aData);
+
+        /**
+         * Select the coarsest LOD, whose error covers at most aMaximumPixelError pixels on screen.
+         *
+         * @param aLods              The LODs, finest first, with increasing errors.
+         * @param aPixelsPerUnit     The number of pixels a unit of object space length covers at the
+         *                           mesh's distance, e.g. see CCamera::pixelsPerUnit(...).
+         * @param aMaximumPixelError The tolerated error in pixels.
+         * @return                   The index of the LOD. 0, if aLods is empty.
+         */
+        SHIRABE_TEST_EXPORT uint32_t selectMeshLod(std::vector<SMeshLod> const &aLods, float aPixelsPerUnit, float aMaximumPixelError);
+    }
+}
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef __SHIRABE_MESH_MESHOPTIMIZATION_H__
+#define __SHIRABE_MESH_MESHOPTIMIZATION_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <platform/platform.h>
+
+namespace engine
+{
+    namespace mesh
+    {
+        /**
+         * A planar vertex attribute stream, owned by the caller.
+         */
+        struct SVertexStream
+        {
+            std::vector<uint8_t> *data;
+            uint64_t              stride;
+        };
+
+        /**
+         * Vertex transform statistics of an indexed triangle list, simulated for a FIFO post-transform cache.
+         */
+        struct SVertexCacheStatistics
+        {
+            uint32_t vertexCount;
+            uint32_t triangleCount;
+            uint32_t transformCount; // Cache misses.
+            double   acmr;           // Average cache miss ratio: Transforms per triangle. 0.5 at best, 3 at worst.
+            double   atvr;           // Average transform to vertex ratio: Transforms per vertex. 1 at best.
+        };
+
+        /**
+         * Vertex fetch statistics of an indexed triangle list, simulated for an LRU cache of memory lines.
+         */
+        struct SVertexFetchStatistics
+        {
+            uint64_t bytesFetched;   // Cache misses times the line size.
+            double   bytesPerVertex; // Bytes fetched per referenced vertex.
+            double   overfetch;      // Bytes fetched per byte of the referenced vertices. 1 at best.
+        };
+
+        /**
+         * The statistics of a mesh before and after optimizeMesh(...).
+         */
+        struct SMeshOptimizationReport
+        {
+            SVertexCacheStatistics before;
+            SVertexCacheStatistics after;
+        };
+
+        /**
+         * Simulate the transforms of aIndices for a FIFO cache of aCacheSize entries.
+         *
+         * @param aIndices     The triangle list.
+         * @param aVertexCount The number of vertices aIndices refers to.
+         * @param aCacheSize   The number of cache entries.
+         * @return             See SVertexCacheStatistics.
+         */
+        SHIRABE_TEST_EXPORT SVertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const &aIndices, uint32_t aVertexCount, uint32_t aCacheSize = 16);
+
+        /**
+         * Simulate the memory fetches of the vertices aIndices refers to, with the vertices stored in
+         * a stream per entry of aStreamStrides, each starting at a line. Compares vertex layouts, e.g.
+         * planar streams against a single interleaved one.
+         *
+         * @param aIndices       The triangle list.
+         * @param aVertexCount   The number of vertices aIndices refers to.
+         * @param aStreamStrides The bytes per vertex of each stream.
+         * @param aLineSize      The bytes per cache line.
+         * @param aLineCount     The number of cache lines.
+         * @return               See SVertexFetchStatistics.
+         */
+        SHIRABE_TEST_EXPORT SVertexFetchStatistics analyzeVertexFetch(std::vector<uint32_t> const &aIndices
+                                                                    , uint32_t                     aVertexCount
+                                                                    , std::vector<uint64_t> const &aStreamStrides
+                                                                    , uint64_t                     aLineSize  = 64
+                                                                    , uint32_t                     aLineCount = 256);
+
+        /**
+         * Merge vertices, which are bitwise equal in all streams, and remap aInOutIndices.
+         * The first occurrence of a vertex is kept, so the order of the remaining vertices is stable.
+         *
+         * @param aStreams      The attribute streams, each holding aVertexCount samples. Compacted in place.
+         * @param aInOutIndices The triangle list to remap.
+         * @param aVertexCount  The number of vertices.
+         * @return              The number of vertices after welding.
+         */
+        SHIRABE_TEST_EXPORT uint32_t weldVertices(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount);
+
+        /**
+         * Reorder the triangles of aInOutIndices for post-transform cache locality, following
+         * Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+         *
+         * @param aInOutIndices The triangle list to reorder.
+         * @param aVertexCount  The number of vertices aInOutIndices refers to.
+         */
+        SHIRABE_TEST_EXPORT void optimizeVertexCache(std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount);
+
+        /**
+         * Reorder the vertices in the order of their first use in aInOutIndices, so that fetches
+         * walk the streams linearly, and remap aInOutIndices. Unreferenced vertices are dropped.
+         *
+         * @param aStreams      The attribute streams, each holding aVertexCount samples. Reordered in place.
+         * @param aInOutIndices The triangle list to remap.
+         * @param aVertexCount  The number of vertices.
+         * @return              The number of vertices referenced.
+         */
+        SHIRABE_TEST_EXPORT uint32_t optimizeVertexFetch(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount);
+
+        /**
+         * Simplify a triangle list by quadric error edge collapses (Garland, Heckbert), until at most
+         * aTargetIndexCount indices remain or no collapse within aTargetError is left.
+         * Vertices are only collapsed onto other vertices, so that the result indexes the same streams.
+         * Vertices on open borders and attribute seams are never moved.
+         *
+         * @param aPositions        Float3 positions, aVertexCount samples of aPositionStride bytes.
+         * @param aPositionStride   The stride of aPositions.
+         * @param aIndices          The triangle list to simplify.
+         * @param aVertexCount      The number of vertices aIndices refers to.
+         * @param aTargetIndexCount The number of indices to reduce to.
+         * @param aTargetError      The maximum distance error of a collapse, in units of the positions.
+         * @param aOutError         Receives the largest distance error of the applied collapses.
+         * @return                  The simplified triangle list.
+         */
+        SHIRABE_TEST_EXPORT std::vector<uint32_t> simplifyMesh(uint8_t               const *aPositions
+                                                             , uint64_t                     aPositionStride
+                                                             , std::vector<uint32_t> const &aIndices
+                                                             , uint32_t                     aVertexCount
+                                                             , std::size_t                  aTargetIndexCount
+                                                             , float                        aTargetError
+                                                             , float                       &aOutError);
+
+        /**
+         * Weld duplicate vertices, reorder the triangles for the post-transform cache and then the
+         * vertices for fetch locality.
+         *
+         * @param aStreams           The attribute streams, each holding aInOutVertexCount samples.
+         * @param aInOutIndices      The triangle list.
+         * @param aInOutVertexCount  The number of vertices. Receives the number after optimization.
+         * @return                   The statistics before and after.
+         */
+        SHIRABE_TEST_EXPORT SMeshOptimizationReport optimizeMesh(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t &aInOutVertexCount);
+    }
+}
+
+#endif //__SHIRABE_MESH_MESHOPTIMIZATION_H__
@@ -0,0 +1,74 @@
+#ifndef __SHIRABE_MESH_MESHQUANTIZATION_H__
+#define __SHIRABE_MESH_MESHQUANTIZATION_H__
+
+#include <array>
+#include <cstdint>
+
+#include <platform/platform.h>
+
+namespace engine
+{
+    namespace mesh
+    {
+        /*
+         * Encoders of the quantized attribute formats written by the resource compiler, see
+         * EMeshAttributeFormat, and their decoders. The vertex shaders decode the same way.
+         */
+
+        /**
+         * Convert aValue to an IEEE 754 half, rounding to nearest even.
+         * Values beyond the half range become infinite.
+         *
+         * @param aValue The value to convert.
+         * @return       The bits of the half.
+         */
+        SHIRABE_TEST_EXPORT uint16_t floatToHalf(float aValue);
+
+        /**
+         * Convert the IEEE 754 half aValue to a float. Exact.
+         *
+         * @param aValue The bits of the half.
+         * @return       See brief.
+         */
+        SHIRABE_TEST_EXPORT float halfToFloat(uint16_t aValue);
+
+        /**
+         * Map a unit vector onto the octahedron, unfolded onto [-1, 1]^2, and store it
+         * as two 16 bit normalized integers.
+         *
+         * @param aDirection The unit vector. Needn't be normalized exactly.
+         * @return           See brief. (32767, 0) for a zero vector.
+         */
+        SHIRABE_TEST_EXPORT std::array<int16_t, 2> encodeOctahedral(std::array<float, 3> const &aDirection);
+
+        /**
+         * Inverse of encodeOctahedral(...).
+         *
+         * @param aEncoded The encoded vector.
+         * @return         The normalized unit vector.
+         */
+        SHIRABE_TEST_EXPORT std::array<float, 3> decodeOctahedral(std::array<int16_t, 2> const &aEncoded);
+
+        /**
+         * Map aValue from [aMinimum, aMaximum] to a 16 bit normalized unsigned integer.
+         *
+         * @param aValue   The value to quantize. Clamped to the range.
+         * @param aMinimum The lower bound of the range.
+         * @param aMaximum The upper bound of the range.
+         * @return         See brief. 0 for an empty range.
+         */
+        SHIRABE_TEST_EXPORT uint16_t quantizeUnorm16(float aValue, float aMinimum, float aMaximum);
+
+        /**
+         * Inverse of quantizeUnorm16(...).
+         *
+         * @param aValue   The quantized value.
+         * @param aMinimum The lower bound of the range.
+         * @param aMaximum The upper bound of the range.
+         * @return         See brief.
+         */
+        SHIRABE_TEST_EXPORT float dequantizeUnorm16(uint16_t aValue, float aMinimum, float aMaximum);
+    }
+}
+
+#endif
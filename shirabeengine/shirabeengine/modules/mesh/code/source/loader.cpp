@@ -7,6 +7,7 @@
 #include <util/documents/json.h>
 
 #include "mesh/declaration.h"
+#include "mesh/meshcontainer.h"
 #include "mesh/serialization.h"
 #include "mesh/loader.h"
 
@@ -27,25 +28,18 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename T>
-        CEngineResult<T> readMeshFile(  std::string                  const &aLogTag
-                                      , Shared<asset::IAssetStorage> const &aAssetStorage
-                                      , asset::AssetId_t             const &aAssetUID)
+        CEngineResult<T> decodeMeshFile(  std::string      const &aLogTag
+                                        , asset::AssetId_t const &aAssetUID
+                                        , ByteBuffer       const &aDataBuffer)
         {
             using namespace serialization;
 
             CJSONDeserializer<T> deserializer {};
             deserializer.initialize();
 
-            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
-            {
-                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
-                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
-            }
-
-            std::string rawInput(reinterpret_cast<char const *>(dataBuffer.data()),
-                                                                dataBuffer.size());
-
-            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(rawInput);
+            // Parse in place. The buffer may be a view of a memory mapped file.
+            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(reinterpret_cast<char const *>(aDataBuffer.data()),
+                                                                                          aDataBuffer.size());
             {
                 PrintEngineError(not deserializationSuccessful, aLogTag, "Could not load material file '{}'", aAssetUID);
                 SHIRABE_RETURN_RESULT_ON_ERROR(not deserializationSuccessful);
@@ -59,6 +53,48 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        CEngineResult<T> readMeshFile(  std::string                  const &aLogTag
+                                      , Shared<asset::IAssetStorage> const &aAssetStorage
+                                      , asset::AssetId_t             const &aAssetUID)
+        {
+            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
+            {
+                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
+            }
+
+            return decodeMeshFile<T>(aLogTag, aAssetUID, dataBuffer);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        threading::CAsyncResult<T> readMeshFileAsync(  threading::CTaskGraph              &aTaskGraph
+                                                     , std::string                  const &aLogTag
+                                                     , Shared<asset::IAssetStorage> const &aAssetStorage
+                                                     , asset::AssetId_t             const &aAssetUID)
+        {
+            // Stage 1: I/O. Stage 2: Deserialization.
+            threading::CAsyncResult<ByteBuffer> const data = threading::async<ByteBuffer>(aTaskGraph, [=] () -> CEngineResult<ByteBuffer>
+            {
+                CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetData(aAssetUID);
+                PrintEngineError(dataFetch.result(), aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                return dataFetch;
+            });
+
+            return data.then([=] (ByteBuffer const &aDataBuffer) -> CEngineResult<T>
+            {
+                return decodeMeshFile<T>(aLogTag, aAssetUID, aDataBuffer);
+            });
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -73,7 +109,14 @@ namespace engine
         //<-----------------------------------------------------------------------------
         CEngineResult<SMeshDataFile> readMeshData(std::string const &aLogTag, Shared<asset::IAssetStorage> const &aAssetStorage, asset::AssetId_t const &aAssetUID)
         {
-            return readMeshFile<SMeshDataFile>(aLogTag, aAssetStorage, aAssetUID);
+            // Reads the whole container, so that the sections are cached or mapped, when the buffers upload them.
+            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
+            {
+                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
+            }
+
+            return decodeMeshContainer(aAssetUID, dataBuffer);
         }
         //<-----------------------------------------------------------------------------
 
@@ -131,6 +174,28 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<asset::AssetId_t> CMeshLoader::resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData)
+        {
+            if(EAssetSubtype::Meta == aAsset.subtype)
+            {
+                auto const [result, meta] = decodeMeshFile<SMeshMeta>(logTag(), aAsset.id, aData);
+                if(CheckEngineError(result))
+                {
+                    return {};
+                }
+
+                return { meta.dataFileId };
+            }
+
+            // The data file is a self-contained mesh container.
+
+            return {};
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -168,9 +233,12 @@ namespace engine
                                                                           , Shared<asset::IAssetStorage> const &aAssetStorage
                                                                           , asset::AssetID_t             const &aMeshInstanceAssetId)
         {
-            if(mInstantiatedMeshes.end() != mInstantiatedMeshes.find(aMeshInstanceAssetId))
             {
-                return { EEngineStatus::Ok, mInstantiatedMeshes.at(aMeshInstanceAssetId) };
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                if(mInstantiatedMeshes.end() != mInstantiatedMeshes.find(aMeshInstanceAssetId))
+                {
+                    return { EEngineStatus::Ok, mInstantiatedMeshes.at(aMeshInstanceAssetId) };
+                }
             }
 
             return loadMeshInstance(aAssetStorage, aMeshInstanceAssetId);
@@ -198,20 +266,29 @@ namespace engine
             //
             Shared<CMeshInstance> instance = nullptr;
 
+            std::unique_lock<std::recursive_mutex> lock(mMutex);
             if(mInstantiatedMeshes.end() != mInstantiatedMeshes.find(aMeshInstanceAssetId))
             {
                 instance = mInstantiatedMeshes.at(aMeshInstanceAssetId);
             }
             else
             {
+                lock.unlock();
+
                 auto[successful, meshName, meshMeta, meshDataFile] = loadMeshFiles(logTag(), aAssetStorage, mInstantiatedMeshes, aMeshInstanceAssetId);
                 {
                     PrintEngineError(not successful, logTag(), "Couldn't fetch master material data.");
                     SHIRABE_RETURN_RESULT_ON_ERROR(not successful);
                 }
 
-                instance = makeShared<CMeshInstance>(aMeshInstanceAssetId, meshName, std::move(meshDataFile));
-                mInstantiatedMeshes[instance->getAssetId()] = instance;
+                lock.lock();
+                // An asynchronous load might have finished in the meantime. Keep the first instance.
+                auto const [iterator, inserted] = mInstantiatedMeshes.insert({ aMeshInstanceAssetId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CMeshInstance>(aMeshInstanceAssetId, meshName, std::move(meshDataFile));
+                }
+                instance = iterator->second;
             }
 
             if(nullptr == instance)
@@ -223,5 +300,87 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        threading::CAsyncResult<Shared<CMeshInstance>> CMeshLoader::loadMeshInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                                        , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                                        , asset::AssetID_t              const &aMeshInstanceAssetId)
+        {
+            using namespace threading;
+
+            CTaskGraph        &graph  = *aTaskGraph;
+            std::string const  tag    = logTag();
+            AssetID_t   const  meshId = aMeshInstanceAssetId;
+
+            if(0_uid == meshId)
+            {
+                return ready<Shared<CMeshInstance>>(graph, { EEngineStatus::Error });
+            }
+
+            std::lock_guard<std::recursive_mutex> guard(mMutex);
+
+            if(mInstantiatedMeshes.end() != mInstantiatedMeshes.find(meshId))
+            {
+                return ready<Shared<CMeshInstance>>(graph, { EEngineStatus::Ok, mInstantiatedMeshes.at(meshId) });
+            }
+
+            // Join a pending load. Failed loads are retried.
+            auto const pending = mPendingMeshes.find(meshId);
+            if(mPendingMeshes.end() != pending)
+            {
+                bool const failed = (pending->second.finished() && not pending->second.get().successful());
+                if(not failed)
+                {
+                    return pending->second;
+                }
+                mPendingMeshes.erase(pending);
+            }
+
+            CAsyncResult<SMeshMeta> const meta = readMeshFileAsync<SMeshMeta>(graph, tag, aAssetStorage, meshId);
+
+            CAsyncResult<ByteBuffer> const data = meta.then([=] (SMeshMeta const &aMeta) -> CEngineResult<ByteBuffer>
+            {
+                auto const [meshAssetFetchResult, meshAsset] = aAssetStorage->loadAsset(aMeta.dataFileId);
+                {
+                    PrintEngineError(meshAssetFetchResult, tag, "Could not fetch data file asset.");
+                    SHIRABE_RETURN_RESULT_ON_ERROR(meshAssetFetchResult);
+                }
+
+                CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetData(meshAsset.id);
+                PrintEngineError(dataFetch.result(), tag, "Could not load asset data for asset {}", meshAsset.id);
+                return dataFetch;
+            });
+
+            CAsyncResult<SMeshDataFile> const dataFile = data.then([=] (ByteBuffer const &aDataBuffer) -> CEngineResult<SMeshDataFile>
+            {
+                return decodeMeshContainer(meta.get().data().dataFileId, aDataBuffer);
+            });
+
+            // The meta stage precedes the data file stage, so its value is available here.
+            CAsyncResult<Shared<CMeshInstance>> const instance = dataFile.then([this, meta, meshId] (SMeshDataFile const &aDataFile) -> CEngineResult<Shared<CMeshInstance>>
+            {
+                std::string const meshName = meta.get().data().name;
+
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                auto const [iterator, inserted] = mInstantiatedMeshes.insert({ meshId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CMeshInstance>(meshId, meshName, SMeshDataFile(aDataFile));
+                }
+                mPendingMeshes.erase(meshId);
+
+                return { EEngineStatus::Ok, iterator->second };
+            });
+
+            // The last stage can't finish while the lock is held, unless it ran inline already.
+            if(not instance.finished())
+            {
+                mPendingMeshes[meshId] = instance;
+            }
+
+            return instance;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
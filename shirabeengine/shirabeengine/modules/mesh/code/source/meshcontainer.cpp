@@ -0,0 +1,428 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+
+#include <log/log.h>
+
+#include "mesh/meshcontainer.h"
+
+namespace engine
+{
+    namespace mesh
+    {
+        SHIRABE_DECLARE_LOG_TAG(MeshContainer);
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        static uint64_t alignUp(uint64_t aValue, uint64_t aAlignment)
+        {
+            return ((aValue + aAlignment - 1) / aAlignment) * aAlignment;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t meshAttributeFormatSize(EMeshAttributeFormat aFormat)
+        {
+            switch(aFormat)
+            {
+                case EMeshAttributeFormat::Float32x2: return 8;
+                case EMeshAttributeFormat::Float32x3: return 12;
+                case EMeshAttributeFormat::Float32x4: return 16;
+                case EMeshAttributeFormat::Float16x2: return 4;
+                case EMeshAttributeFormat::Snorm16x2: return 4;
+                case EMeshAttributeFormat::Snorm16x4: return 8;
+                case EMeshAttributeFormat::Unorm16x4: return 8;
+                default:                              return 0;
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t meshIndexBytesPerSample(uint32_t aVertexCount)
+        {
+            return (std::numeric_limits<uint16_t>::max() >= aVertexCount) ? sizeof(uint16_t) : sizeof(uint32_t);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        asset::SAssetDataRange SMeshDataFile::vertexDataRange() const
+        {
+            return { vertexDataOffset, vertexDataSize };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        asset::SAssetDataRange SMeshDataFile::attributeDataRange(std::size_t aAttributeIndex) const
+        {
+            if(aAttributeIndex >= attributes.size())
+            {
+                return { vertexDataSize, 0 };
+            }
+
+            SMeshAttributeDescription const &attribute = attributes[aAttributeIndex];
+            if(0 == attribute.length)
+            {
+                return { attribute.offset, 0 };
+            }
+            return { attribute.offset, (((attribute.length - 1) * attribute.stride) + attribute.bytesPerSample) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<SMeshStream> SMeshDataFile::streams() const
+        {
+            // The first attribute of a stream starts it.
+            std::map<uint64_t, SMeshStream> streams {};
+            for(SMeshAttributeDescription const &attribute : attributes)
+            {
+                auto const [iterator, inserted] = streams.insert({ attribute.index, { attribute.index, attribute.offset, attribute.stride } });
+                iterator->second.offset = std::min(iterator->second.offset, attribute.offset);
+            }
+
+            std::vector<SMeshStream> result {};
+            result.reserve(streams.size());
+            for(auto const &[index, stream] : streams)
+            {
+                result.push_back(stream);
+            }
+            return result;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        asset::SAssetDataRange SMeshDataFile::indexDataRange() const
+        {
+            return { indexDataOffset, indexDataSize };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        float SMeshDataFile::boundingRadius() const
+        {
+            float squaredRadius = 0.0f;
+            for(std::size_t k=0; k<3; ++k)
+            {
+                float const extent = std::max(std::fabs(bounds.minimum[k]), std::fabs(bounds.maximum[k]));
+                squaredRadius += (extent * extent);
+            }
+            return std::sqrt(squaredRadius);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<std::vector<uint8_t>> encodeMeshContainer(std::vector<SMeshAttributeDescription> const &aAttributes
+                                                              , std::vector<std::vector<uint8_t>>       const &aAttributeData
+                                                              , SMeshAttributeDescription               const &aIndices
+                                                              , std::vector<uint8_t>                    const &aIndexData
+                                                              , uint32_t                                       aAttributeSampleCount
+                                                              , std::vector<SMeshLod>                   const &aLods
+                                                              , SMeshBounds                             const &aBounds)
+        {
+            if(aAttributes.size() != aAttributeData.size())
+            {
+                CLog::Error(logTag(), "{} attributes described, but {} given.", aAttributes.size(), aAttributeData.size());
+                return { EEngineStatus::Error };
+            }
+
+            std::vector<SMeshContainerAttribute>         descriptors(aAttributes.size());
+            std::map<uint64_t, std::vector<std::size_t>> streams {};
+
+            for(std::size_t k=0; k<aAttributes.size(); ++k)
+            {
+                SMeshAttributeDescription const &attribute = aAttributes[k];
+
+                if(kMeshContainerAttributeNameLength < attribute.name.size())
+                {
+                    CLog::Error(logTag(), "Attribute name '{}' exceeds {} characters.", attribute.name, kMeshContainerAttributeNameLength);
+                    return { EEngineStatus::Error };
+                }
+
+                if((attribute.length * attribute.bytesPerSample) != aAttributeData[k].size())
+                {
+                    CLog::Error(logTag(), "Attribute '{}' is described with {} bytes, but {} given.", attribute.name, (attribute.length * attribute.bytesPerSample), aAttributeData[k].size());
+                    return { EEngineStatus::Error };
+                }
+
+                if(EMeshAttributeFormat::Undefined != attribute.format && meshAttributeFormatSize(attribute.format) != attribute.bytesPerSample)
+                {
+                    CLog::Error(logTag(), "Attribute '{}' has {} bytes per sample, which doesn't match its format {}.", attribute.name, attribute.bytesPerSample, static_cast<uint32_t>(attribute.format));
+                    return { EEngineStatus::Error };
+                }
+
+                streams[attribute.index].push_back(k);
+            }
+
+            uint64_t vertexDataSize = 0;
+            for(auto const &[index, members] : streams)
+            {
+                uint64_t const length = aAttributes[members.front()].length;
+                uint64_t       stride = 0;
+                for(std::size_t const k : members)
+                {
+                    if(length != aAttributes[k].length)
+                    {
+                        CLog::Error(logTag(), "Attribute '{}' has {} samples, but stream {} has {}.", aAttributes[k].name, aAttributes[k].length, index, length);
+                        return { EEngineStatus::Error };
+                    }
+                    stride += aAttributes[k].bytesPerSample;
+                }
+
+                if(std::numeric_limits<uint32_t>::max() < stride)
+                {
+                    CLog::Error(logTag(), "Stream {} has {} bytes per vertex, which exceed the descriptor.", index, stride);
+                    return { EEngineStatus::Error };
+                }
+
+                vertexDataSize = alignUp(vertexDataSize, kMeshContainerAttributeAlignment);
+
+                uint64_t offsetInVertex = 0;
+                for(std::size_t const k : members)
+                {
+                    SMeshAttributeDescription const &attribute  = aAttributes[k];
+                    SMeshContainerAttribute         &descriptor = descriptors[k];
+
+                    std::memset(&descriptor, 0, sizeof(descriptor));
+                    std::memcpy(descriptor.name, attribute.name.data(), attribute.name.size());
+                    descriptor.index          = static_cast<uint32_t>(attribute.index);
+                    descriptor.format         = static_cast<uint32_t>(attribute.format);
+                    descriptor.offset         = vertexDataSize + offsetInVertex;
+                    descriptor.length         = attribute.length;
+                    descriptor.bytesPerSample = static_cast<uint32_t>(attribute.bytesPerSample);
+                    descriptor.stride         = static_cast<uint32_t>(stride);
+
+                    offsetInVertex += attribute.bytesPerSample;
+                }
+
+                vertexDataSize += (length * stride);
+            }
+
+            if(sizeof(uint16_t) != aIndices.bytesPerSample && sizeof(uint32_t) != aIndices.bytesPerSample)
+            {
+                CLog::Error(logTag(), "Indices of {} bytes per sample can't be bound. 2 or 4 expected.", aIndices.bytesPerSample);
+                return { EEngineStatus::Error };
+            }
+
+            if((aIndices.length * aIndices.bytesPerSample) != aIndexData.size())
+            {
+                CLog::Error(logTag(), "The indices are described with {} bytes, but {} given.", (aIndices.length * aIndices.bytesPerSample), aIndexData.size());
+                return { EEngineStatus::Error };
+            }
+
+            std::vector<SMeshContainerLod> lods {};
+            if(aLods.empty())
+            {
+                lods.push_back({ 0, static_cast<uint32_t>(aIndices.length), 0.0f, 0 });
+            }
+            for(SMeshLod const &lod : aLods)
+            {
+                if(lod.firstIndex > aIndices.length || lod.indexCount > (aIndices.length - lod.firstIndex))
+                {
+                    CLog::Error(logTag(), "LOD [{}, {}) exceeds the {} indices.", lod.firstIndex, (static_cast<uint64_t>(lod.firstIndex) + lod.indexCount), aIndices.length);
+                    return { EEngineStatus::Error };
+                }
+                lods.push_back({ lod.firstIndex, lod.indexCount, lod.error, 0 });
+            }
+
+            uint64_t const descriptorsSize  = (descriptors.size() * sizeof(SMeshContainerAttribute));
+            uint64_t const lodsSize         = (lods.size()        * sizeof(SMeshContainerLod));
+            uint64_t const vertexDataOffset = alignUp(sizeof(SMeshContainerHeader) + descriptorsSize + lodsSize, kMeshContainerSectionAlignment);
+            uint64_t const indexDataOffset  = alignUp(vertexDataOffset + vertexDataSize,              kMeshContainerSectionAlignment);
+
+            SMeshContainerHeader header {};
+            std::memcpy(header.magic, kMeshContainerMagic, sizeof(kMeshContainerMagic));
+            header.version              = kMeshContainerVersion;
+            header.attributeCount       = static_cast<uint32_t>(descriptors.size());
+            header.attributeSampleCount = aAttributeSampleCount;
+            header.indexSampleCount     = static_cast<uint32_t>(aIndices.length);
+            header.indexBytesPerSample  = aIndices.bytesPerSample;
+            header.vertexDataOffset     = vertexDataOffset;
+            header.vertexDataSize       = vertexDataSize;
+            header.indexDataOffset      = indexDataOffset;
+            header.indexDataSize        = aIndexData.size();
+            header.lodCount             = static_cast<uint32_t>(lods.size());
+            std::copy(aBounds.minimum.begin(), aBounds.minimum.end(), header.boundsMinimum);
+            std::copy(aBounds.maximum.begin(), aBounds.maximum.end(), header.boundsMaximum);
+
+            // Zero initialized, so that all padding is deterministic.
+            std::vector<uint8_t> data(indexDataOffset + aIndexData.size(), 0);
+            std::memcpy(data.data(),                  &header,            sizeof(header));
+            std::memcpy(data.data() + sizeof(header), descriptors.data(), descriptorsSize);
+            std::memcpy(data.data() + sizeof(header) + descriptorsSize, lods.data(), lodsSize);
+
+            // Interleave the planar samples into their streams.
+            for(std::size_t k=0; k<descriptors.size(); ++k)
+            {
+                SMeshContainerAttribute const &descriptor = descriptors[k];
+                for(uint64_t v=0; v<descriptor.length; ++v)
+                {
+                    std::memcpy(data.data() + vertexDataOffset + descriptor.offset + (v * descriptor.stride)
+                              , aAttributeData[k].data() + (v * descriptor.bytesPerSample)
+                              , descriptor.bytesPerSample);
+                }
+            }
+            std::copy(aIndexData.begin(), aIndexData.end(), data.begin() + static_cast<std::ptrdiff_t>(indexDataOffset));
+
+            return { EEngineStatus::Ok, std::move(data) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<SMeshDataFile> decodeMeshContainer(asset::AssetId_t const &aAssetId, ByteBuffer const &aData)
+        {
+            uint64_t const size = aData.size();
+
+            SMeshContainerHeader header {};
+            if(sizeof(header) > size)
+            {
+                CLog::Error(logTag(), "Mesh container {} is truncated.", aAssetId);
+                return { EEngineStatus::Error };
+            }
+            std::memcpy(&header, aData.data(), sizeof(header));
+
+            if(0 != std::memcmp(header.magic, kMeshContainerMagic, sizeof(kMeshContainerMagic))
+               || kMeshContainerVersion != header.version)
+            {
+                CLog::Error(logTag(), "Asset {} is not a mesh container of version {}.", aAssetId, kMeshContainerVersion);
+                return { EEngineStatus::Error };
+            }
+
+            // Overflow safe bounds checks, since the sizes are read from the file.
+            auto const fits = [size] (uint64_t aOffset, uint64_t aLength) -> bool
+            {
+                return (aOffset <= size && aLength <= (size - aOffset));
+            };
+
+            uint64_t const descriptorsSize = (static_cast<uint64_t>(header.attributeCount) * sizeof(SMeshContainerAttribute));
+            uint64_t const lodsSize        = (static_cast<uint64_t>(header.lodCount)       * sizeof(SMeshContainerLod));
+            if(not fits(sizeof(header), (descriptorsSize + lodsSize))
+               || not fits(header.vertexDataOffset, header.vertexDataSize)
+               || not fits(header.indexDataOffset,  header.indexDataSize)
+               || (sizeof(uint16_t) != header.indexBytesPerSample && sizeof(uint32_t) != header.indexBytesPerSample)
+               || (static_cast<uint64_t>(header.indexSampleCount) * header.indexBytesPerSample) != header.indexDataSize)
+            {
+                CLog::Error(logTag(), "Mesh container {} is truncated or corrupt.", aAssetId);
+                return { EEngineStatus::Error };
+            }
+
+            SMeshDataFile dataFile {};
+            dataFile.assetId              = aAssetId;
+            dataFile.attributeSampleCount = header.attributeSampleCount;
+            dataFile.indexSampleCount     = header.indexSampleCount;
+            dataFile.vertexDataOffset     = header.vertexDataOffset;
+            dataFile.vertexDataSize       = header.vertexDataSize;
+            dataFile.indexDataOffset      = header.indexDataOffset;
+            dataFile.indexDataSize        = header.indexDataSize;
+            std::copy(header.boundsMinimum, header.boundsMinimum + 3, dataFile.bounds.minimum.begin());
+            std::copy(header.boundsMaximum, header.boundsMaximum + 3, dataFile.bounds.maximum.begin());
+
+            dataFile.indices.name           = "Indices";
+            dataFile.indices.index          = 0;
+            dataFile.indices.offset         = 0;
+            dataFile.indices.length         = header.indexSampleCount;
+            dataFile.indices.bytesPerSample = header.indexBytesPerSample;
+            dataFile.indices.format         = EMeshAttributeFormat::Undefined;
+
+            dataFile.attributes.reserve(header.attributeCount);
+            for(uint32_t k=0; k<header.attributeCount; ++k)
+            {
+                SMeshContainerAttribute descriptor {};
+                std::memcpy(&descriptor, aData.data() + sizeof(header) + (k * sizeof(descriptor)), sizeof(descriptor));
+
+                // The last sample ends (length - 1) strides and a sample behind the offset.
+                bool valid = (descriptor.bytesPerSample <= descriptor.stride && descriptor.offset <= header.vertexDataSize);
+                if(valid && 0 < descriptor.length)
+                {
+                    uint64_t const available = (header.vertexDataSize - descriptor.offset);
+                    valid = (0 < descriptor.stride
+                             && descriptor.bytesPerSample <= available
+                             && (descriptor.length - 1) <= ((available - descriptor.bytesPerSample) / descriptor.stride));
+                }
+
+                if(not valid)
+                {
+                    CLog::Error(logTag(), "Attribute {} of mesh container {} exceeds the vertex section.", k, aAssetId);
+                    return { EEngineStatus::Error };
+                }
+
+                EMeshAttributeFormat const format = static_cast<EMeshAttributeFormat>(descriptor.format);
+                if(EMeshAttributeFormat::Undefined != format && meshAttributeFormatSize(format) != descriptor.bytesPerSample)
+                {
+                    CLog::Error(logTag(), "Attribute {} of mesh container {} has an unknown format or doesn't match it.", k, aAssetId);
+                    return { EEngineStatus::Error };
+                }
+
+                SMeshAttributeDescription attribute {};
+                attribute.name           = std::string(descriptor.name, ::strnlen(descriptor.name, kMeshContainerAttributeNameLength));
+                attribute.index          = descriptor.index;
+                attribute.offset         = descriptor.offset;
+                attribute.length         = descriptor.length;
+                attribute.bytesPerSample = descriptor.bytesPerSample;
+                attribute.format         = format;
+                attribute.stride         = descriptor.stride;
+                dataFile.attributes.push_back(attribute);
+            }
+
+            dataFile.lods.reserve(header.lodCount);
+            for(uint32_t k=0; k<header.lodCount; ++k)
+            {
+                SMeshContainerLod descriptor {};
+                std::memcpy(&descriptor, aData.data() + sizeof(header) + descriptorsSize + (k * sizeof(descriptor)), sizeof(descriptor));
+
+                if(descriptor.firstIndex > header.indexSampleCount || descriptor.indexCount > (header.indexSampleCount - descriptor.firstIndex))
+                {
+                    CLog::Error(logTag(), "LOD {} of mesh container {} exceeds the index section.", k, aAssetId);
+                    return { EEngineStatus::Error };
+                }
+
+                dataFile.lods.push_back({ descriptor.firstIndex, descriptor.indexCount, descriptor.error });
+            }
+
+            if(dataFile.lods.empty())
+            {
+                dataFile.lods.push_back({ 0, header.indexSampleCount, 0.0f });
+            }
+
+            return { EEngineStatus::Ok, dataFile };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint32_t selectMeshLod(std::vector<SMeshLod> const &aLods, float aPixelsPerUnit, float aMaximumPixelError)
+        {
+            uint32_t selected = 0;
+            for(uint32_t k=1; k<aLods.size(); ++k)
+            {
+                if((aLods[k].error * aPixelsPerUnit) > aMaximumPixelError)
+                {
+                    break;
+                }
+                selected = k;
+            }
+            return selected;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,771 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <string_view>
+#include <unordered_map>
+
+#include "mesh/meshoptimization.h"
+
+namespace engine
+{
+    namespace mesh
+    {
+        namespace
+        {
+            constexpr uint32_t const kUnassigned = std::numeric_limits<uint32_t>::max();
+
+            // Parameters of Forsyth's vertex scoring, as given in the paper.
+            constexpr uint32_t const kForsythCacheSize         = 32;
+            constexpr float    const kForsythCacheDecayPower   = 1.5f;
+            constexpr float    const kForsythLastTriangleScore = 0.75f;
+            constexpr float    const kForsythValenceBoostScale = 2.0f;
+            constexpr float    const kForsythValenceBoostPower = 0.5f;
+
+            /**
+             * Score a vertex by its position in the simulated LRU cache and its number of remaining triangles.
+             */
+            float forsythVertexScore(int32_t aCachePosition, uint32_t aRemainingTriangles)
+            {
+                if(0 == aRemainingTriangles)
+                {
+                    return -1.0f;
+                }
+
+                float score = 0.0f;
+                if(0 <= aCachePosition)
+                {
+                    if(3 > aCachePosition)
+                    {
+                        // The vertices of the last triangle get a fixed score, so that the order
+                        // in which they were used doesn't matter.
+                        score = kForsythLastTriangleScore;
+                    }
+                    else
+                    {
+                        float const scale = 1.0f / static_cast<float>(kForsythCacheSize - 3);
+                        score = std::pow(1.0f - (static_cast<float>(aCachePosition - 3) * scale), kForsythCacheDecayPower);
+                    }
+                }
+
+                // Prefer vertices with few triangles left, to finish them off and avoid lone triangles.
+                score += kForsythValenceBoostScale * std::pow(static_cast<float>(aRemainingTriangles), -kForsythValenceBoostPower);
+                return score;
+            }
+
+            struct SVector3
+            {
+                double x, y, z;
+            };
+
+            SVector3 operator-(SVector3 const &aLHS, SVector3 const &aRHS) { return { (aLHS.x - aRHS.x), (aLHS.y - aRHS.y), (aLHS.z - aRHS.z) }; }
+            double   dot      (SVector3 const &aLHS, SVector3 const &aRHS) { return ((aLHS.x * aRHS.x) + (aLHS.y * aRHS.y) + (aLHS.z * aRHS.z)); }
+            SVector3 cross    (SVector3 const &aLHS, SVector3 const &aRHS)
+            {
+                return { ((aLHS.y * aRHS.z) - (aLHS.z * aRHS.y))
+                       , ((aLHS.z * aRHS.x) - (aLHS.x * aRHS.z))
+                       , ((aLHS.x * aRHS.y) - (aLHS.y * aRHS.x)) };
+            }
+
+            /**
+             * Symmetric 4x4 error quadric of the planes around a vertex, weighted by triangle area.
+             * The weight is kept to express errors as mean squared distances.
+             */
+            struct SQuadric
+            {
+                double a2, ab, ac, ad, b2, bc, bd, c2, cd, d2;
+                double weight;
+
+                static SQuadric fromPlane(SVector3 const &aNormal, double aDistance, double aWeight)
+                {
+                    SQuadric const q = { (aNormal.x * aNormal.x), (aNormal.x * aNormal.y), (aNormal.x * aNormal.z), (aNormal.x * aDistance)
+                                       , (aNormal.y * aNormal.y), (aNormal.y * aNormal.z), (aNormal.y * aDistance)
+                                       , (aNormal.z * aNormal.z), (aNormal.z * aDistance)
+                                       , (aDistance * aDistance)
+                                       , 1.0 };
+                    return q * aWeight;
+                }
+
+                SQuadric operator*(double aFactor) const
+                {
+                    return { (a2 * aFactor), (ab * aFactor), (ac * aFactor), (ad * aFactor), (b2 * aFactor), (bc * aFactor), (bd * aFactor), (c2 * aFactor), (cd * aFactor), (d2 * aFactor), (weight * aFactor) };
+                }
+
+                SQuadric &operator+=(SQuadric const &aOther)
+                {
+                    a2 += aOther.a2; ab += aOther.ab; ac += aOther.ac; ad += aOther.ad;
+                    b2 += aOther.b2; bc += aOther.bc; bd += aOther.bd;
+                    c2 += aOther.c2; cd += aOther.cd;
+                    d2 += aOther.d2;
+                    weight += aOther.weight;
+                    return (*this);
+                }
+
+                /**
+                 * The mean squared distance of aPoint to the planes.
+                 */
+                double error(SVector3 const &aPoint) const
+                {
+                    double const x = aPoint.x, y = aPoint.y, z = aPoint.z;
+                    double const sum = (a2 * x * x) + (2.0 * ab * x * y) + (2.0 * ac * x * z) + (2.0 * ad * x)
+                                     + (b2 * y * y) + (2.0 * bc * y * z) + (2.0 * bd * y)
+                                     + (c2 * z * z) + (2.0 * cd * z)
+                                     + d2;
+                    return (0.0 < weight) ? std::max(0.0, (sum / weight)) : 0.0;
+                }
+            };
+
+            struct SCollapse
+            {
+                uint32_t source;
+                uint32_t target;
+                double   error; // Mean squared distance.
+            };
+        }
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SVertexCacheStatistics analyzeVertexCache(std::vector<uint32_t> const &aIndices, uint32_t aVertexCount, uint32_t aCacheSize)
+        {
+            SVertexCacheStatistics statistics {};
+            statistics.triangleCount = static_cast<uint32_t>(aIndices.size() / 3);
+
+            // A vertex is cached, if less than aCacheSize misses happened since its own transform.
+            std::vector<uint32_t> timestamps(aVertexCount, 0);
+            uint32_t              timestamp = aCacheSize + 1;
+
+            for(uint32_t const index : aIndices)
+            {
+                if(0 == timestamps[index])
+                {
+                    ++statistics.vertexCount;
+                }
+
+                if(aCacheSize < (timestamp - timestamps[index]))
+                {
+                    timestamps[index] = timestamp++;
+                    ++statistics.transformCount;
+                }
+            }
+
+            if(0 < statistics.triangleCount)
+            {
+                statistics.acmr = static_cast<double>(statistics.transformCount) / statistics.triangleCount;
+            }
+            if(0 < statistics.vertexCount)
+            {
+                statistics.atvr = static_cast<double>(statistics.transformCount) / statistics.vertexCount;
+            }
+            return statistics;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SVertexFetchStatistics analyzeVertexFetch(std::vector<uint32_t> const &aIndices
+                                                , uint32_t                     aVertexCount
+                                                , std::vector<uint64_t> const &aStreamStrides
+                                                , uint64_t                     aLineSize
+                                                , uint32_t                     aLineCount)
+        {
+            SVertexFetchStatistics statistics {};
+
+            std::vector<uint64_t> streamOffsets {};
+            uint64_t              vertexSize = 0;
+            uint64_t              offset     = 0;
+            for(uint64_t const stride : aStreamStrides)
+            {
+                streamOffsets.push_back(offset);
+                offset     += (((static_cast<uint64_t>(aVertexCount) * stride) + aLineSize - 1) / aLineSize) * aLineSize;
+                vertexSize += stride;
+            }
+
+            // Most recently used first.
+            std::list<uint64_t>                                         lines {};
+            std::unordered_map<uint64_t, std::list<uint64_t>::iterator> cached {};
+            std::vector<bool>                                           referenced(aVertexCount, false);
+            uint32_t                                                    referencedCount = 0;
+
+            for(uint32_t const index : aIndices)
+            {
+                if(not referenced[index])
+                {
+                    referenced[index] = true;
+                    ++referencedCount;
+                }
+
+                for(std::size_t s=0; s<aStreamStrides.size(); ++s)
+                {
+                    if(0 == aStreamStrides[s])
+                    {
+                        continue;
+                    }
+
+                    uint64_t const first = (streamOffsets[s] + (index * aStreamStrides[s]));
+                    uint64_t const last  = (first + aStreamStrides[s] - 1);
+                    for(uint64_t line=(first / aLineSize); line<=(last / aLineSize); ++line)
+                    {
+                        auto const hit = cached.find(line);
+                        if(cached.end() != hit)
+                        {
+                            lines.splice(lines.begin(), lines, hit->second);
+                            continue;
+                        }
+
+                        statistics.bytesFetched += aLineSize;
+                        if(aLineCount <= lines.size())
+                        {
+                            cached.erase(lines.back());
+                            lines.pop_back();
+                        }
+                        lines.push_front(line);
+                        cached[line] = lines.begin();
+                    }
+                }
+            }
+
+            if(0 < referencedCount)
+            {
+                statistics.bytesPerVertex = static_cast<double>(statistics.bytesFetched) / referencedCount;
+            }
+            if(0 < vertexSize && 0 < referencedCount)
+            {
+                statistics.overfetch = static_cast<double>(statistics.bytesFetched) / (static_cast<double>(vertexSize) * referencedCount);
+            }
+            return statistics;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint32_t weldVertices(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount)
+        {
+            uint64_t keySize = 0;
+            for(SVertexStream const &stream : aStreams)
+            {
+                keySize += stream.stride;
+            }
+
+            // All attributes of a vertex back to back, so that a vertex is compared with a single key.
+            std::vector<char> keys(aVertexCount * keySize);
+            {
+                uint64_t keyOffset = 0;
+                for(SVertexStream const &stream : aStreams)
+                {
+                    for(uint32_t v=0; v<aVertexCount; ++v)
+                    {
+                        std::memcpy(keys.data() + (v * keySize) + keyOffset, stream.data->data() + (v * stream.stride), stream.stride);
+                    }
+                    keyOffset += stream.stride;
+                }
+            }
+
+            std::unordered_map<std::string_view, uint32_t> unique {};
+            unique.reserve(aVertexCount);
+
+            std::vector<uint32_t> remap(aVertexCount);
+            std::vector<uint32_t> kept  {};
+            kept.reserve(aVertexCount);
+
+            for(uint32_t v=0; v<aVertexCount; ++v)
+            {
+                std::string_view const key(keys.data() + (v * keySize), keySize);
+
+                auto const [iterator, inserted] = unique.emplace(key, static_cast<uint32_t>(kept.size()));
+                if(inserted)
+                {
+                    kept.push_back(v);
+                }
+                remap[v] = iterator->second;
+            }
+
+            uint32_t const weldedCount = static_cast<uint32_t>(kept.size());
+            if(weldedCount == aVertexCount)
+            {
+                return aVertexCount;
+            }
+
+            // Kept vertices only move towards the front, so the streams are compacted in place.
+            for(SVertexStream const &stream : aStreams)
+            {
+                uint8_t *data = stream.data->data();
+                for(uint32_t k=0; k<weldedCount; ++k)
+                {
+                    std::memmove(data + (k * stream.stride), data + (kept[k] * stream.stride), stream.stride);
+                }
+                stream.data->resize(weldedCount * stream.stride);
+            }
+
+            for(uint32_t &index : aInOutIndices)
+            {
+                index = remap[index];
+            }
+
+            return weldedCount;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void optimizeVertexCache(std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount)
+        {
+            uint32_t const triangleCount = static_cast<uint32_t>(aInOutIndices.size() / 3);
+            if(0 == triangleCount)
+            {
+                return;
+            }
+
+            // Triangles per vertex, in compressed rows. remaining[v] is the number of not yet emitted
+            // triangles of v, which are kept at the front of its row.
+            std::vector<uint32_t> adjacencyOffsets(aVertexCount + 1, 0);
+            std::vector<uint32_t> remaining(aVertexCount, 0);
+            for(uint32_t const index : aInOutIndices)
+            {
+                ++remaining[index];
+            }
+            for(uint32_t v=0; v<aVertexCount; ++v)
+            {
+                adjacencyOffsets[v + 1] = adjacencyOffsets[v] + remaining[v];
+            }
+
+            std::vector<uint32_t> adjacency(aInOutIndices.size());
+            {
+                std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                for(uint32_t t=0; t<triangleCount; ++t)
+                {
+                    for(uint32_t k=0; k<3; ++k)
+                    {
+                        adjacency[fill[aInOutIndices[(3 * t) + k]]++] = t;
+                    }
+                }
+            }
+
+            std::vector<float> vertexScores(aVertexCount);
+            for(uint32_t v=0; v<aVertexCount; ++v)
+            {
+                vertexScores[v] = forsythVertexScore(-1, remaining[v]);
+            }
+
+            std::vector<float> triangleScores(triangleCount);
+            std::vector<bool>  emitted       (triangleCount, false);
+
+            uint32_t best = 0;
+            for(uint32_t t=0; t<triangleCount; ++t)
+            {
+                uint32_t const *triangle = aInOutIndices.data() + (3 * t);
+                triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+                if(triangleScores[t] > triangleScores[best])
+                {
+                    best = t;
+                }
+            }
+
+            std::vector<uint32_t> cache    {};
+            std::vector<uint32_t> newCache {};
+            cache   .reserve(kForsythCacheSize + 3);
+            newCache.reserve(kForsythCacheSize + 3);
+
+            std::vector<uint32_t> output(aInOutIndices.size());
+            uint32_t              outputTriangles = 0;
+            uint32_t              scanCursor      = 0;
+
+            while(outputTriangles < triangleCount)
+            {
+                uint32_t const *triangle = aInOutIndices.data() + (3 * best);
+                std::copy(triangle, triangle + 3, output.begin() + (3 * outputTriangles));
+                ++outputTriangles;
+                emitted[best] = true;
+
+                // Move the emitted triangle out of the remaining triangles of its vertices.
+                for(uint32_t k=0; k<3; ++k)
+                {
+                    uint32_t const vertex = triangle[k];
+                    uint32_t      *row    = adjacency.data() + adjacencyOffsets[vertex];
+                    uint32_t      *end    = row + remaining[vertex];
+                    std::iter_swap(std::find(row, end, best), end - 1);
+                    --remaining[vertex];
+                }
+
+                // LRU: The triangle's vertices to the front, followed by the previous entries.
+                newCache.assign(triangle, triangle + 3);
+                for(uint32_t const vertex : cache)
+                {
+                    if(vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                    {
+                        newCache.push_back(vertex);
+                    }
+                }
+                std::swap(cache, newCache);
+
+                // Rescore all vertices, which entered, moved within or left the cache.
+                for(uint32_t k=0; k<cache.size(); ++k)
+                {
+                    uint32_t const vertex   = cache[k];
+                    int32_t  const position = (kForsythCacheSize > k) ? static_cast<int32_t>(k) : -1;
+                    float    const score    = forsythVertexScore(position, remaining[vertex]);
+                    float    const delta    = score - vertexScores[vertex];
+
+                    vertexScores[vertex] = score;
+
+                    uint32_t const *row = adjacency.data() + adjacencyOffsets[vertex];
+                    for(uint32_t r=0; r<remaining[vertex]; ++r)
+                    {
+                        triangleScores[row[r]] += delta;
+                    }
+                }
+                if(kForsythCacheSize < cache.size())
+                {
+                    cache.resize(kForsythCacheSize);
+                }
+
+                // The next triangle is the best one adjacent to the cache.
+                float bestScore = -1.0f;
+                for(uint32_t const vertex : cache)
+                {
+                    uint32_t const *row = adjacency.data() + adjacencyOffsets[vertex];
+                    for(uint32_t r=0; r<remaining[vertex]; ++r)
+                    {
+                        if(triangleScores[row[r]] > bestScore)
+                        {
+                            bestScore = triangleScores[row[r]];
+                            best      = row[r];
+                        }
+                    }
+                }
+
+                if(0.0f > bestScore)
+                {
+                    // Nothing left around the cache. Continue with the next remaining triangle.
+                    while(scanCursor < triangleCount && emitted[scanCursor])
+                    {
+                        ++scanCursor;
+                    }
+                    best = scanCursor;
+                }
+            }
+
+            aInOutIndices.swap(output);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint32_t optimizeVertexFetch(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t aVertexCount)
+        {
+            std::vector<uint32_t> remap(aVertexCount, kUnassigned);
+
+            uint32_t referencedCount = 0;
+            for(uint32_t &index : aInOutIndices)
+            {
+                if(kUnassigned == remap[index])
+                {
+                    remap[index] = referencedCount++;
+                }
+                index = remap[index];
+            }
+
+            for(SVertexStream const &stream : aStreams)
+            {
+                std::vector<uint8_t> reordered(referencedCount * stream.stride);
+                for(uint32_t v=0; v<aVertexCount; ++v)
+                {
+                    if(kUnassigned != remap[v])
+                    {
+                        std::memcpy(reordered.data() + (remap[v] * stream.stride), stream.data->data() + (v * stream.stride), stream.stride);
+                    }
+                }
+                stream.data->swap(reordered);
+            }
+
+            return referencedCount;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<uint32_t> simplifyMesh(uint8_t               const *aPositions
+                                         , uint64_t                     aPositionStride
+                                         , std::vector<uint32_t> const &aIndices
+                                         , uint32_t                     aVertexCount
+                                         , std::size_t                  aTargetIndexCount
+                                         , float                        aTargetError
+                                         , float                       &aOutError)
+        {
+            aOutError = 0.0f;
+
+            std::vector<SVector3> positions(aVertexCount);
+            for(uint32_t v=0; v<aVertexCount; ++v)
+            {
+                float xyz[3] = { 0.0f, 0.0f, 0.0f };
+                std::memcpy(xyz, aPositions + (v * aPositionStride), sizeof(xyz));
+                positions[v] = { xyz[0], xyz[1], xyz[2] };
+            }
+
+            // Vertices sharing a position with another vertex differ in other attributes. Moving them
+            // would tear the seam open, so they are locked, as are vertices on open borders.
+            std::vector<uint32_t> positionClass(aVertexCount);
+            std::vector<bool>     locked       (aVertexCount, false);
+            {
+                std::unordered_map<std::string_view, uint32_t> unique {};
+                unique.reserve(aVertexCount);
+
+                for(uint32_t v=0; v<aVertexCount; ++v)
+                {
+                    std::string_view const key(reinterpret_cast<char const *>(aPositions + (v * aPositionStride)), (3 * sizeof(float)));
+
+                    auto const [iterator, inserted] = unique.emplace(key, v);
+                    positionClass[v] = iterator->second;
+                    if(not inserted)
+                    {
+                        locked[v]                = true;
+                        locked[iterator->second] = true;
+                    }
+                }
+
+                // An edge used by a single triangle is on an open border.
+                std::unordered_map<uint64_t, uint32_t> edgeUses {};
+                edgeUses.reserve(aIndices.size());
+
+                auto const edgeKey = [&positionClass] (uint32_t aA, uint32_t aB) -> uint64_t
+                {
+                    uint64_t const a = positionClass[aA];
+                    uint64_t const b = positionClass[aB];
+                    return (std::min(a, b) << 32u) | std::max(a, b);
+                };
+
+                for(std::size_t t=0; (t + 2)<aIndices.size(); t += 3)
+                {
+                    for(uint32_t k=0; k<3; ++k)
+                    {
+                        ++edgeUses[edgeKey(aIndices[t + k], aIndices[t + ((k + 1) % 3)])];
+                    }
+                }
+                for(std::size_t t=0; (t + 2)<aIndices.size(); t += 3)
+                {
+                    for(uint32_t k=0; k<3; ++k)
+                    {
+                        uint32_t const a = aIndices[t + k];
+                        uint32_t const b = aIndices[t + ((k + 1) % 3)];
+                        if(1 == edgeUses[edgeKey(a, b)])
+                        {
+                            locked[a] = true;
+                            locked[b] = true;
+                        }
+                    }
+                }
+            }
+
+            std::vector<SQuadric> quadrics(aVertexCount, SQuadric {});
+            for(std::size_t t=0; (t + 2)<aIndices.size(); t += 3)
+            {
+                SVector3 const &p0 = positions[aIndices[t + 0]];
+                SVector3 const &p1 = positions[aIndices[t + 1]];
+                SVector3 const &p2 = positions[aIndices[t + 2]];
+
+                SVector3     normal = cross((p1 - p0), (p2 - p0));
+                double const length = std::sqrt(dot(normal, normal));
+                if(0.0 == length)
+                {
+                    continue;
+                }
+                normal = { (normal.x / length), (normal.y / length), (normal.z / length) };
+
+                SQuadric const quadric = SQuadric::fromPlane(normal, -dot(normal, p0), (0.5 * length));
+                for(uint32_t k=0; k<3; ++k)
+                {
+                    quadrics[aIndices[t + k]] += quadric;
+                }
+            }
+
+            double const targetError = (static_cast<double>(aTargetError) * aTargetError);
+            double       maximumError = 0.0;
+
+            std::vector<uint32_t> indices = aIndices;
+
+            std::vector<uint32_t>  adjacencyOffsets(aVertexCount + 1);
+            std::vector<uint32_t>  adjacency       {};
+            std::vector<uint32_t>  remap           (aVertexCount);
+            std::vector<bool>      touched         (aVertexCount);
+            std::vector<SCollapse> collapses       {};
+
+            // Collapse in passes of independent edges, cheapest first, and rebuild the topology in between.
+            while(aTargetIndexCount < indices.size())
+            {
+                uint32_t const triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+                std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+                for(uint32_t const index : indices)
+                {
+                    ++adjacencyOffsets[index + 1];
+                }
+                for(uint32_t v=0; v<aVertexCount; ++v)
+                {
+                    adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+                }
+                adjacency.resize(indices.size());
+                {
+                    std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                    for(uint32_t t=0; t<triangleCount; ++t)
+                    {
+                        for(uint32_t k=0; k<3; ++k)
+                        {
+                            adjacency[fill[indices[(3 * t) + k]]++] = t;
+                        }
+                    }
+                }
+
+                collapses.clear();
+                for(uint32_t t=0; t<triangleCount; ++t)
+                {
+                    for(uint32_t k=0; k<3; ++k)
+                    {
+                        uint32_t const a = indices[(3 * t) + k];
+                        uint32_t const b = indices[(3 * t) + ((k + 1) % 3)];
+
+                        for(auto const &[source, target] : { std::pair(a, b), std::pair(b, a) })
+                        {
+                            if(locked[source] || source == target)
+                            {
+                                continue;
+                            }
+
+                            SQuadric combined = quadrics[source];
+                            combined += quadrics[target];
+
+                            double const error = combined.error(positions[target]);
+                            if(targetError >= error)
+                            {
+                                collapses.push_back({ source, target, error });
+                            }
+                        }
+                    }
+                }
+
+                std::sort(collapses.begin(), collapses.end(), [] (SCollapse const &aLHS, SCollapse const &aRHS) { return (aLHS.error < aRHS.error); });
+
+                for(uint32_t v=0; v<aVertexCount; ++v)
+                {
+                    remap[v] = v;
+                }
+                std::fill(touched.begin(), touched.end(), false);
+
+                // Each collapse of an inner edge removes two triangles.
+                std::size_t const removableTriangles = ((indices.size() - aTargetIndexCount) + 2) / 3;
+                std::size_t       removedTriangles   = 0;
+
+                for(SCollapse const &collapse : collapses)
+                {
+                    if(removableTriangles <= removedTriangles)
+                    {
+                        break;
+                    }
+
+                    if(touched[collapse.source] || touched[collapse.target])
+                    {
+                        continue;
+                    }
+
+                    uint32_t const *begin = adjacency.data() + adjacencyOffsets[collapse.source];
+                    uint32_t const *end   = adjacency.data() + adjacencyOffsets[collapse.source + 1];
+
+                    // Reject collapses, which flip or degenerate a remaining triangle.
+                    bool        flips    = false;
+                    std::size_t vanishes = 0;
+                    for(uint32_t const *t = begin; t != end; ++t)
+                    {
+                        uint32_t const *triangle = indices.data() + (3 * (*t));
+                        if(collapse.target == triangle[0] || collapse.target == triangle[1] || collapse.target == triangle[2])
+                        {
+                            ++vanishes;
+                            continue;
+                        }
+
+                        SVector3 corners[3] = { positions[triangle[0]], positions[triangle[1]], positions[triangle[2]] };
+                        SVector3 const before = cross((corners[1] - corners[0]), (corners[2] - corners[0]));
+                        for(uint32_t k=0; k<3; ++k)
+                        {
+                            if(collapse.source == triangle[k])
+                            {
+                                corners[k] = positions[collapse.target];
+                            }
+                        }
+                        SVector3 const after = cross((corners[1] - corners[0]), (corners[2] - corners[0]));
+
+                        if(0.0 >= dot(before, after))
+                        {
+                            flips = true;
+                            break;
+                        }
+                    }
+
+                    if(flips)
+                    {
+                        continue;
+                    }
+
+                    remap[collapse.source]    = collapse.target;
+                    quadrics[collapse.target] += quadrics[collapse.source];
+                    maximumError              = std::max(maximumError, collapse.error);
+                    removedTriangles         += vanishes;
+
+                    // The triangles around the source change shape, so their vertices are done for this pass.
+                    for(uint32_t const *t = begin; t != end; ++t)
+                    {
+                        uint32_t const *triangle = indices.data() + (3 * (*t));
+                        touched[triangle[0]] = touched[triangle[1]] = touched[triangle[2]] = true;
+                    }
+                }
+
+                if(0 == removedTriangles)
+                {
+                    break;
+                }
+
+                std::size_t kept = 0;
+                for(std::size_t t=0; t<indices.size(); t += 3)
+                {
+                    uint32_t const a = remap[indices[t + 0]];
+                    uint32_t const b = remap[indices[t + 1]];
+                    uint32_t const c = remap[indices[t + 2]];
+                    if(a == b || b == c || c == a)
+                    {
+                        continue;
+                    }
+
+                    indices[kept++] = a;
+                    indices[kept++] = b;
+                    indices[kept++] = c;
+                }
+                indices.resize(kept);
+            }
+
+            aOutError = static_cast<float>(std::sqrt(maximumError));
+            return indices;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SMeshOptimizationReport optimizeMesh(std::vector<SVertexStream> const &aStreams, std::vector<uint32_t> &aInOutIndices, uint32_t &aInOutVertexCount)
+        {
+            SMeshOptimizationReport report {};
+            report.before = analyzeVertexCache(aInOutIndices, aInOutVertexCount);
+
+            aInOutVertexCount = weldVertices(aStreams, aInOutIndices, aInOutVertexCount);
+            optimizeVertexCache(aInOutIndices, aInOutVertexCount);
+            aInOutVertexCount = optimizeVertexFetch(aStreams, aInOutIndices, aInOutVertexCount);
+
+            report.after = analyzeVertexCache(aInOutIndices, aInOutVertexCount);
+            return report;
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "mesh/meshquantization.h"
+
+namespace engine
+{
+    namespace mesh
+    {
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        static float signNotZero(float aValue)
+        {
+            return (0.0f <= aValue) ? 1.0f : -1.0f;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint16_t floatToHalf(float aValue)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &aValue, sizeof(bits));
+
+            uint16_t const sign     = static_cast<uint16_t>((bits >> 16u) & 0x8000u);
+            uint32_t const absolute = (bits & 0x7fffffffu);
+
+            // Infinity and NaN, keeping NaNs quiet.
+            if(0x7f800000u <= absolute)
+            {
+                return static_cast<uint16_t>(sign | 0x7c00u | ((0x7f800000u < absolute) ? 0x0200u : 0u));
+            }
+
+            // 65520 and beyond round to infinity.
+            if(0x477ff000u <= absolute)
+            {
+                return static_cast<uint16_t>(sign | 0x7c00u);
+            }
+
+            // Below 2^-14 the half is subnormal, i.e. a multiple of 2^-24.
+            if(0x38800000u > absolute)
+            {
+                float magnitude = 0.0f;
+                std::memcpy(&magnitude, &absolute, sizeof(magnitude));
+                return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(magnitude * 16777216.0f)));
+            }
+
+            // Rebias the exponent from 127 to 15 and round the mantissa from 23 to 10 bits, ties to even.
+            uint32_t const rebiased = (absolute - 0x38000000u);
+            uint32_t const rounded  = (rebiased + 0x0fffu + ((rebiased >> 13u) & 1u));
+            return static_cast<uint16_t>(sign | (rounded >> 13u));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        float halfToFloat(uint16_t aValue)
+        {
+            uint32_t const sign     = (static_cast<uint32_t>(aValue & 0x8000u) << 16u);
+            uint32_t const exponent = ((aValue >> 10u) & 0x1fu);
+            uint32_t const mantissa = (aValue & 0x03ffu);
+
+            if(0 == exponent)
+            {
+                float const magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+                return (0 != sign) ? -magnitude : magnitude;
+            }
+
+            uint32_t const bits = (0x1fu == exponent)
+                                  ? (sign | 0x7f800000u | (mantissa << 13u))
+                                  : (sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+
+            float value = 0.0f;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::array<int16_t, 2> encodeOctahedral(std::array<float, 3> const &aDirection)
+        {
+            float const norm = (std::fabs(aDirection[0]) + std::fabs(aDirection[1]) + std::fabs(aDirection[2]));
+            if(0.0f >= norm)
+            {
+                return { 32767, 0 };
+            }
+
+            float x = (aDirection[0] / norm);
+            float y = (aDirection[1] / norm);
+
+            // Fold the lower hemisphere over the diagonals.
+            if(0.0f > aDirection[2])
+            {
+                float const foldedX = ((1.0f - std::fabs(y)) * signNotZero(x));
+                float const foldedY = ((1.0f - std::fabs(x)) * signNotZero(y));
+                x = foldedX;
+                y = foldedY;
+            }
+
+            auto const toSnorm16 = [] (float aValue) -> int16_t
+            {
+                return static_cast<int16_t>(std::lround(std::clamp(aValue, -1.0f, 1.0f) * 32767.0f));
+            };
+
+            return { toSnorm16(x), toSnorm16(y) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::array<float, 3> decodeOctahedral(std::array<int16_t, 2> const &aEncoded)
+        {
+            // As the graphics API converts snorm: -32768 maps to -1 as well.
+            float x = std::max((static_cast<float>(aEncoded[0]) / 32767.0f), -1.0f);
+            float y = std::max((static_cast<float>(aEncoded[1]) / 32767.0f), -1.0f);
+            float z = (1.0f - std::fabs(x) - std::fabs(y));
+
+            if(0.0f > z)
+            {
+                float const unfoldedX = ((1.0f - std::fabs(y)) * signNotZero(x));
+                float const unfoldedY = ((1.0f - std::fabs(x)) * signNotZero(y));
+                x = unfoldedX;
+                y = unfoldedY;
+            }
+
+            float const length = std::sqrt((x * x) + (y * y) + (z * z));
+            return { (x / length), (y / length), (z / length) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint16_t quantizeUnorm16(float aValue, float aMinimum, float aMaximum)
+        {
+            float const extent = (aMaximum - aMinimum);
+            if(not (0.0f < extent))
+            {
+                return 0;
+            }
+
+            float const normalized = std::clamp(((aValue - aMinimum) / extent), 0.0f, 1.0f);
+            return static_cast<uint16_t>(std::lround(normalized * 65535.0f));
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        float dequantizeUnorm16(uint16_t aValue, float aMinimum, float aMaximum)
+        {
+            return (aMinimum + ((static_cast<float>(aValue) / 65535.0f) * (aMaximum - aMinimum)));
+        }
+        //<-----------------------------------------------------------------------------
+    }
+}
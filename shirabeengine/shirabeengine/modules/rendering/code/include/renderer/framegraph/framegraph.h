@@ -72,6 +72,7 @@ namespace engine
                 EGraphMode                                                   graphMode()               const;
                 bool                                                         renderToBackBuffer()      const;
                 FrameGraphResourceId_t                                const &outputTextureResourceId() const;
+                SFrameGraphTransientMemoryReport                      const &transientMemoryReport()   const;
 
             private_members:
                 CGraph const *m_graph;
@@ -104,6 +105,7 @@ namespace engine
                 EGraphMode                                            &mutableGraphMode();
                 bool                                                  &mutableRenderToBackBuffer();
                 FrameGraphResourceId_t                                &mutableOutputTextureResourceId();
+                SFrameGraphTransientMemoryReport                      &mutableTransientMemoryReport();
 
                 /**
                  * Create a new pass of type TPass given a uid and name.
@@ -188,6 +190,15 @@ namespace engine
              */
             CEngineResult<> execute(Shared<IFrameGraphRenderContext>&);
 
+            /**
+             * Replace the content of all renderable lists of the graph, so that a cached graph
+             * renders the per frame state, e.g. the selected mesh LODs, of aRenderables.
+             * The structure of aRenderables must match the one the graph was built with.
+             *
+             * @param aRenderables The renderables of the current frame.
+             */
+            void updateRenderables(rendering::RenderableList const &aRenderables);
+
 #if defined SHIRABE_FRAMEGRAPH_ENABLE_SERIALIZATION
             /**
              * Double-Dispatch accept for the graph to accept any kind of frame graph serializer instance.
@@ -222,6 +233,22 @@ namespace engine
             PassMap const&passes() const;
 
         private_methods:
+            /**
+             * Resource reference counts are consumed by the resource deinitialization at the
+             * end of each execution. Store them on first execution and restore them on each
+             * subsequent one, so that a compiled graph can be executed repeatedly.
+             */
+            void restoreResourceReferenceCounts();
+
+            /**
+             * Transient textures may share a backing texture with other textures of disjoint lifetime.
+             * Resolve the texture, which is actually created in the render context.
+             *
+             * @param aTexture The texture to resolve.
+             * @return         The backing texture or aTexture, if it is not aliased.
+             */
+            Shared<SFrameGraphTexture> resolveBackingTexture(Shared<SFrameGraphTexture> const &aTexture);
+
             /**
              * Initialize all resources required for execution.
              *
@@ -409,10 +436,12 @@ namespace engine
             FrameGraphResourceIdList              mResources;
             CFrameGraphMutableResources           mResourceData;
             FrameGraphResourceIdList              mInstantiatedResources;
+            Map<FrameGraphResourceId_t, uint32_t> mCompiledReferenceCounts;
 
             EGraphMode                            mGraphMode;
             bool                                  mRenderToBackBuffer;
             FrameGraphResourceId_t                mOutputTextureResourceId;
+            SFrameGraphTransientMemoryReport      mTransientMemoryReport;
 
 #if defined SHIRABE_FRAMEGRAPH_ENABLE_SERIALIZATION
             AdjacencyListMap_t<FrameGraphResourceId_t>            mResourceAdjacency;
@@ -339,11 +339,39 @@ namespace engine
             EFrameGraphResourceInitState        initialState;
             CBitField<EFrameGraphResourceUsage> permittedUsage;
             CBitField<EFrameGraphResourceUsage> requestedUsage;
+            // Set on graph compilation, if the texture's memory is shared with other transient textures.
+            // aliasedResource is the id of the texture providing the backing memory, or
+            // SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE, if the texture is backed by itself.
+            FrameGraphResourceId_t              aliasedResource;
+            bool                                isAliased;
         };
 
         SHIRABE_DECLARE_LIST_OF_TYPE(SFrameGraphTexture, SFrameGraphTexture);
         SHIRABE_DECLARE_MAP_OF_TYPES(FrameGraphResourceId_t, SFrameGraphTexture, SFrameGraphTexture);
 
+        /**
+         * Estimate the memory footprint of a texture in bytes, including all array layers
+         * and mip levels, based on the bit range encoded in its format.
+         *
+         * @param aTexture The texture to estimate the size for.
+         * @return         The estimated size in bytes.
+         */
+        SHIRABE_TEST_EXPORT uint64_t estimateTextureMemorySize(SFrameGraphTexture const &aTexture);
+
+        /**
+         * The SFrameGraphTransientMemoryReport struct summarizes the transient texture memory
+         * requirements of a compiled graph before and after resource aliasing.
+         */
+        struct SHIRABE_TEST_EXPORT SFrameGraphTransientMemoryReport
+        {
+        public_members:
+            uint32_t transientTextureCount;
+            uint32_t backingTextureCount;
+            uint64_t bytesWithoutAliasing;  // Every transient texture has its own allocation.
+            uint64_t bytesWithAliasing;     // Sum of all shared backing allocations.
+            uint64_t peakLiveBytes;         // Lower bound: Max. sum of textures alive at the same pass.
+        };
+
         /**
          * The SFrameGraphTextureView struct describes any kind of frame graph texture view in the framegraph
          */
@@ -446,6 +474,15 @@ namespace engine
                     FrameGraphResourceId_t const &aImageResourceID,
                     FrameGraphResourceId_t const &aImageViewResourceID);
 
+        public_methods:
+            /**
+             * Remove all attachments, which are exclusively accessed by the given passes,
+             * and compact the attachment indices of the remaining ones.
+             *
+             * @param aPassUIDs The UIDs of the passes to remove.
+             */
+            void removePasses(std::vector<PassUID_t> const &aPassUIDs);
+
         private_members:
             Vector<FrameGraphResourceId_t>
                 mAttachmentImageResourceIds,
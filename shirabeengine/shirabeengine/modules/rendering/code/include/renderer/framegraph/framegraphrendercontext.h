@@ -1,6 +1,8 @@
 ﻿#ifndef __SHIRABE_FRAMEGRAPH_RENDERCONTEXT_H__
 #define __SHIRABE_FRAMEGRAPH_RENDERCONTEXT_H__
 
+#include <unordered_set>
+
 #include <log/log.h>
 #include <core/enginetypehelper.h>
 #include <asset/assetstorage.h>
@@ -448,11 +450,13 @@ namespace engine
              *
              * @param aMesh     The renderable mesh to process.
              * @param aMaterial The renderable material to process.
+             * @param aLodIndex The LOD of aMesh to draw. Clamped to the coarsest one.
              * @return          EEngineStatus::Ok if successful.
              * @return          EEngineStatus::Error otherwise.
              */
             CEngineResult<> render(SFrameGraphMesh     const &aMesh,
-                                   SFrameGraphMaterial const &aMaterial) override;
+                                   SFrameGraphMaterial const &aMaterial,
+                                   uint32_t                   aLodIndex) override;
 
             CEngineResult<> drawFullscreenQuadWithMaterial(SFrameGraphMaterial const &aMaterial) override;
 
@@ -520,6 +524,10 @@ namespace engine
             std::string mCurrentFrameBufferHandle;
             std::string mCurrentRenderPassHandle;
             uint32_t    mCurrentSubpass;
+            std::string mCurrentMeshHandle; // The mesh drawn by render(...), whose vertex layout bindMaterial(...) creates the pipeline with.
+            std::string mCurrentPipelineHandle; // The pipeline bound by bindMaterial(...), one per material and vertex layout.
+
+            std::unordered_set<std::string> mTransferredTextures; // Sampled images created, loaded and transferred by bindMaterial(...). Erased on unload.
         };
 
     }
@@ -253,6 +253,40 @@ EST_EXPORT CGraphBuilder
              */
             CEngineResult<> validate(std::stack<PassUID_t> const &aPassOrder);
 
+            /**
+             * Reference count all passes by their consumers, starting with the pass producing the
+             * output resource, and remove all passes and resources from the execution, which
+             * do not contribute to the output.
+             *
+             * @param aInOutPassOrder The stack containing the pass execution order. Culled passes will be removed.
+             * @return                True, if successful. False otherwise.
+             */
+            CEngineResult<> cullPasses(std::stack<PassUID_t> &aInOutPassOrder);
+
+            /**
+             * Determine the first and last use of each transient (i.e. non-external) texture along
+             * the pass execution order and assign textures with non-overlapping lifetimes and
+             * compatible descriptors to shared backing textures.
+             *
+             * @param aPassOrder The stack containing the pass execution order.
+             * @param aOutReport Transient memory requirements before and after aliasing.
+             * @return           True, if successful. False otherwise.
+             */
+            CEngineResult<> aliasTransientResources(
+                    std::stack<PassUID_t>            const &aPassOrder,
+                    SFrameGraphTransientMemoryReport       &aOutReport);
+
+            /**
+             * Check, whether two transient textures may share the same backing texture.
+             *
+             * @param aTexture The texture to alias.
+             * @param aBacking The texture providing the backing memory.
+             * @return         True, if compatible. False otherwise.
+             */
+            bool isAliasingCompatible(
+                    SFrameGraphTexture const &aTexture,
+                    SFrameGraphTexture const &aBacking);
+
             /**
              * Validate, whether the textureview tries to access the subjacent texture in
              * correct bounds, i.e. format, array ranges and mip slices.
@@ -437,11 +437,13 @@ namespace engine
              *
              * @param aMesh     The renderable mesh to process.
              * @param aMaterial The renderable material to process.
+             * @param aLodIndex The LOD of aMesh to draw. Clamped to the coarsest one.
              * @return          EEngineStatus::Ok if successful.
              * @return          EEngineStatus::Error otherwise.
              */
             virtual CEngineResult<> render(SFrameGraphMesh     const &aMesh,
-                                           SFrameGraphMaterial const &aMaterial) = 0;
+                                           SFrameGraphMaterial const &aMaterial,
+                                           uint32_t                   aLodIndex) = 0;
 
             virtual CEngineResult<> drawFullscreenQuadWithMaterial(SFrameGraphMaterial const &aMaterial) = 0;
         };
@@ -38,6 +38,7 @@ namespace engine
              */
             struct SGBufferGenerationImportData
             {
+                FrameGraphResourceId_t            renderableListId; // Per frame state of the renderables, in the order of renderables.
                 std::vector<SRenderableResources> renderables;
             };
 
@@ -142,7 +142,7 @@ namespace engine
              */
             virtual EEngineStatus present() = 0;
 
-            virtual EEngineStatus bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets) = 0;
+            virtual EEngineStatus bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets, VkIndexType aIndexType) = 0;
 
             /**
              * Bind a pipeline instance  in the GPU.
@@ -162,6 +162,17 @@ namespace engine
              */
             virtual EEngineStatus unbindPipeline(GpuApiHandle_t const &aPipelineUID) = 0;
 
+            /**
+             * Push per draw data to the vertex stage of a bound pipeline instance.
+             *
+             * @param aPipelineUID The uid of the bound pipeline instance.
+             * @param aData        The data to push at offset 0.
+             * @param aSize        The size of aData in bytes.
+             * @return             EEngineStatus::Ok, if successful.
+             * @return             EEngineStatus::Error, if failed.
+             */
+            virtual EEngineStatus pushVertexConstants(GpuApiHandle_t const &aPipelineUID, void const *aData, uint32_t aSize) = 0;
+
             /**
              * Bind a resource to the pipeline of the respective graphics API used.
              *
@@ -185,7 +196,14 @@ namespace engine
              */
             virtual EEngineStatus render(SRenderable const &aRenderable) = 0;
 
-            virtual EEngineStatus drawIndex(uint32_t const aIndexCount) = 0;
+            /**
+             * Draw aIndexCount indices of the bound index buffer, starting at aFirstIndex.
+             *
+             * @param aIndexCount The number of indices to draw.
+             * @param aFirstIndex The first index to draw.
+             * @return            EEngineStatus::Ok, if successful. An error code otherwise.
+             */
+            virtual EEngineStatus drawIndex(uint32_t const aIndexCount, uint32_t const aFirstIndex) = 0;
 
             virtual EEngineStatus drawQuad() = 0;
 
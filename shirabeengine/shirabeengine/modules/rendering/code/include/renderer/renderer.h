@@ -2,7 +2,9 @@
 #define __SHIRABE_RENDERER_H__
 
 #include <atomic>
+#include <functional>
 #include "renderer/irenderer.h"
+#include "renderer/framegraph/framegraph.h"
 
 namespace engine
 {
@@ -10,6 +12,79 @@ namespace engine
     {
         using engine::framegraph::IFrameGraphRenderContext;
 
+        /**
+         * The SFrameGraphCacheStatistics struct counts, how often a compiled framegraph
+         * could be reused across frames and how often it had to be rebuilt.
+         */
+        struct SFrameGraphCacheStatistics
+        {
+        public_members:
+            uint64_t hits;
+            uint64_t misses;
+        };
+
+        /**
+         * The CFrameGraphCache class keeps the compiled framegraph across frames and only
+         * rebuilds it, if the structure key of the frame differs from the cached one.
+         */
+        class SHIRABE_TEST_EXPORT CFrameGraphCache
+        {
+        public_typedefs:
+            using BuildFn_t = std::function<CEngineResult<Unique<framegraph::CGraph>>()>;
+
+        public_constructors:
+            CFrameGraphCache();
+
+        public_methods:
+            /**
+             * Return the cached graph, if it was built for aStructureKey. Build and cache a new
+             * one with aBuild otherwise.
+             *
+             * @param aStructureKey See deriveStructureKey(...).
+             * @param aBuild        Builds and compiles the graph on a miss.
+             * @return              The graph. nullptr, if aBuild failed.
+             */
+            framegraph::CGraph *acquire(uint64_t aStructureKey, BuildFn_t const &aBuild);
+
+            /**
+             * Drop the cached graph, forcing a rebuild on the next acquire.
+             */
+            void invalidate();
+
+            /**
+             * Return the hit and miss counters.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE SFrameGraphCacheStatistics const &statistics() const
+            {
+                return mStatistics;
+            }
+
+        public_static_functions:
+            /**
+             * Derive a structural hash of all inputs, which determine the passes and
+             * resources of the framegraph, i.e. the backbuffer size, the graph mode
+             * and the renderables (whose meshes and materials are baked into the passes).
+             *
+             * @param aWidth                 Backbuffer width.
+             * @param aHeight                Backbuffer height.
+             * @param aGraphMode             The mode the graph is built in.
+             * @param aRenderableCollection  The renderables to be rendered.
+             * @return                       A hash, which changes whenever the graph structure would change.
+             */
+            static uint64_t deriveStructureKey(
+                    uint32_t                       const &aWidth,
+                    uint32_t                       const &aHeight,
+                    framegraph::CGraph::EGraphMode const &aGraphMode,
+                    RenderableList                 const &aRenderableCollection);
+
+        private_members:
+            Unique<framegraph::CGraph> mGraph;
+            uint64_t                   mStructureKey;
+            SFrameGraphCacheStatistics mStatistics;
+        };
+
         /**
          * @brief The CRenderer class
          */
@@ -86,6 +161,32 @@ namespace engine
              */
             EEngineStatus renderScene(RenderableList const &aRenderableCollection) final;
 
+            /**
+             * Return the hit and miss counters of the compiled framegraph cache.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE SFrameGraphCacheStatistics const &frameGraphCacheStatistics() const
+            {
+                return mFrameGraphCache.statistics();
+            }
+
+        private_methods:
+            /**
+             * Build and compile a new framegraph for the provided renderables.
+             *
+             * @param aWidth                 Backbuffer width.
+             * @param aHeight                Backbuffer height.
+             * @param aGraphMode             The mode to build the graph in.
+             * @param aRenderableCollection  The renderables to be rendered.
+             * @return                       A compiled graph or an error.
+             */
+            CEngineResult<Unique<framegraph::CGraph>> buildFrameGraph(
+                    uint32_t                       const &aWidth,
+                    uint32_t                       const &aHeight,
+                    framegraph::CGraph::EGraphMode const &aGraphMode,
+                    RenderableList                 const &aRenderableCollection);
+
         private_members:
             SRendererConfiguration           mConfiguration;
             Shared<SApplicationEnvironment>  mAppEnvironment;
@@ -94,6 +195,7 @@ namespace engine
             Shared<IRenderContext>           mGpuApiRenderContext;
             std::atomic<bool>                mPaused;
 
+            CFrameGraphCache                 mFrameGraphCache;
         };
 
     }
@@ -25,6 +25,7 @@ namespace engine
             asset::AssetId_t meshInstanceAssetId;
             std::string      materialInstanceId;
             asset::AssetId_t materialInstanceAssetId;
+            uint32_t         meshLodIndex; // Selected per frame. Clamped to the LODs of the mesh.
         };
         SHIRABE_DECLARE_LIST_OF_TYPE(SRenderable, Renderable);
     }
@@ -42,9 +43,11 @@ namespace engine
                 CString::format(
                     "  Renderable: {}\n"
                     "    MeshId:     {}\n"
+                    "    MeshLod:    {}\n"
                     "    MaterialId: {}\n",
                     aRenderable.name,
                     aRenderable.meshInstanceId,
+                    aRenderable.meshLodIndex,
                     aRenderable.materialInstanceId);
         return message;
     }
@@ -109,6 +109,15 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SFrameGraphTransientMemoryReport const &CGraph::CAccessor::transientMemoryReport() const
+        {
+            return m_graph->mTransientMemoryReport;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -212,6 +221,15 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        SFrameGraphTransientMemoryReport &CGraph::CMutableAccessor::mutableTransientMemoryReport()
+        {
+            return mGraph->mTransientMemoryReport;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -259,6 +277,8 @@ namespace engine
         {
             assert(aRenderContext != nullptr);
 
+            restoreResourceReferenceCounts();
+
             std::vector<PassUID_t> executionOrder {};
             {
                 std::stack<PassUID_t> copy = mPassExecutionOrder;
@@ -347,7 +367,7 @@ namespace engine
                     return {sourceResourceFetch.result()};
                 }
 
-                aRenderContext->copyImageToBackBuffer(*(parentResourceFetch.data()));
+                aRenderContext->copyImageToBackBuffer(*(resolveBackingTexture(parentResourceFetch.data())));
             }
 
             // In any case...
@@ -369,6 +389,79 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CGraph::updateRenderables(rendering::RenderableList const &aRenderables)
+        {
+            for(RefIndex_t::value_type const &id : mResourceData.renderablesLists())
+            {
+                CEngineResult<Shared<SFrameGraphRenderableList>> list = mResourceData.getMutable<SFrameGraphRenderableList>(id);
+                if(list.successful() && nullptr != list.data())
+                {
+                    list.data()->renderableList = aRenderables;
+                }
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CGraph::restoreResourceReferenceCounts()
+        {
+            Index_t const &resources = mResourceData.resources();
+
+            if(mCompiledReferenceCounts.empty())
+            {
+                for(Shared<SFrameGraphResource> const &resource : resources)
+                {
+                    if(nullptr != resource)
+                    {
+                        mCompiledReferenceCounts[resource->resourceId] = resource->referenceCount;
+                    }
+                }
+
+                return;
+            }
+
+            for(Shared<SFrameGraphResource> const &resource : resources)
+            {
+                if(nullptr == resource)
+                {
+                    continue;
+                }
+
+                auto const it = mCompiledReferenceCounts.find(resource->resourceId);
+                if(mCompiledReferenceCounts.end() != it)
+                {
+                    resource->referenceCount = it->second;
+                }
+            }
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        Shared<SFrameGraphTexture> CGraph::resolveBackingTexture(Shared<SFrameGraphTexture> const &aTexture)
+        {
+            if(nullptr == aTexture || SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE == aTexture->aliasedResource)
+            {
+                return aTexture;
+            }
+
+            CEngineResult<Shared<SFrameGraphTexture>> backingFetch = mResourceData.getMutable<SFrameGraphTexture>(aTexture->aliasedResource);
+            if(not backingFetch.successful() || nullptr == backingFetch.data())
+            {
+                CLog::Error(logTag(), CString::format("Failed to resolve backing texture w/ id {} of texture {}.", aTexture->aliasedResource, aTexture->readableName));
+                return aTexture;
+            }
+
+            return backingFetch.data();
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -394,7 +487,7 @@ namespace engine
                 {
                 case EFrameGraphResourceType::Texture:
                 {
-                    texture = std::static_pointer_cast<SFrameGraphTexture>(resource);
+                    texture = resolveBackingTexture(std::static_pointer_cast<SFrameGraphTexture>(resource));
 
                     it = std::find(mInstantiatedResources.begin(), mInstantiatedResources.end(), texture->resourceId);
                     if(mInstantiatedResources.end() == it)
@@ -423,7 +516,7 @@ namespace engine
                     }
 
                     subjacent   = subjacentFetch.data();
-                    texture     = std::static_pointer_cast<SFrameGraphTexture>(subjacent);
+                    texture     = resolveBackingTexture(std::static_pointer_cast<SFrameGraphTexture>(subjacent));
                     textureView = std::static_pointer_cast<SFrameGraphTextureView>(resource);                    
 
                     it = std::find(mInstantiatedResources.begin(), mInstantiatedResources.end(), textureView->resourceId);
@@ -662,7 +755,9 @@ namespace engine
                         texture     = std::static_pointer_cast<SFrameGraphTexture>(subjacent);
                         textureView = std::static_pointer_cast<SFrameGraphTextureView>(resource);
 
-                        deinitialized = deinitializeTextureView(aRenderContext, texture, textureView);
+                        // Views are created against the backing texture of an alias (see initializeResources),
+                        // so they have to be released against it, too. The reference count stays with the alias.
+                        deinitialized = deinitializeTextureView(aRenderContext, resolveBackingTexture(texture), textureView);
 
                         auto const condition = [&] (FrameGraphResourceId_t const &aId) -> bool
                         {
@@ -672,6 +767,7 @@ namespace engine
                         auto const iterator = std::remove_if(mInstantiatedResources.begin(),
                                                              mInstantiatedResources.end(),
                                                              condition);
+                        mInstantiatedResources.erase(iterator, mInstantiatedResources.end());
 
                         --(texture->referenceCount);
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "renderer/framegraph/framegraphdata.h"
 #include <core/basictypes.h>
 
@@ -241,6 +242,8 @@ namespace engine
             , initialState(EFrameGraphResourceInitState::Undefined)
             , permittedUsage(EFrameGraphResourceUsage::Undefined)
             , requestedUsage(EFrameGraphResourceUsage::Undefined)
+            , aliasedResource(SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE)
+            , isAliased(false)
         {}
         //<-----------------------------------------------------------------------------
 
@@ -257,6 +260,43 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t estimateTextureMemorySize(SFrameGraphTexture const &aTexture)
+        {
+            using FormatValue_t = std::underlying_type_t<FrameGraphFormat_t>;
+
+            // The format enumeration is grouped into bit ranges, flagged by the *RangeFlag values.
+            FormatValue_t const value        = static_cast<FormatValue_t>(aTexture.format);
+            uint64_t            bitsPerTexel = 0;
+
+            if     (value >= static_cast<FormatValue_t>(FrameGraphFormat_t::FormatCompressedFormatRangeFlag)) bitsPerTexel =   8;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format128BitFormatRangeFlag))     bitsPerTexel = 128;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format96BitFormatRangeFlag))      bitsPerTexel =  96;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format64BitFormatRangeFlag))      bitsPerTexel =  64;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format32BitFormatRangeFlag))      bitsPerTexel =  32;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format16BitFormatRangeFlag))      bitsPerTexel =  16;
+            else if(value >= static_cast<FormatValue_t>(FrameGraphFormat_t::Format8BitFormatRangeFlag))       bitsPerTexel =   8;
+
+            uint64_t size   = 0;
+            uint64_t width  = std::max(1u, aTexture.width);
+            uint64_t height = std::max(1u, aTexture.height);
+            uint64_t depth  = std::max(1u, aTexture.depth);
+
+            for(uint16_t k=0; k<std::max<uint16_t>(1, aTexture.mipLevels); ++k)
+            {
+                size += ((width * height * depth * bitsPerTexel) / 8);
+
+                width  = std::max<uint64_t>(1, (width  / 2));
+                height = std::max<uint64_t>(1, (height / 2));
+                depth  = std::max<uint64_t>(1, (depth  / 2));
+            }
+
+            return (size * std::max<uint16_t>(1, aTexture.arraySize));
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -354,6 +394,77 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void SFrameGraphAttachmentCollection::removePasses(std::vector<PassUID_t> const &aPassUIDs)
+        {
+            for(PassUID_t const &passUID : aPassUIDs)
+            {
+                mAttachmentPassAssignment.erase(passUID);
+            }
+
+            // Determine the attachments still referenced by any remaining pass.
+            std::vector<bool> referenced(mAttachmentImageViewResourceIds.size(), false);
+            for(auto const &[passUID, indices] : mAttachmentPassAssignment)
+            {
+                SHIRABE_UNUSED(passUID);
+
+                for(uint64_t const &index : indices)
+                {
+                    referenced[index] = true;
+                }
+            }
+
+            std::vector<uint64_t>          remappedIndices(mAttachmentImageViewResourceIds.size(), 0);
+            Vector<FrameGraphResourceId_t> imageResourceIds     {};
+            Vector<FrameGraphResourceId_t> imageViewResourceIds {};
+
+            mViewToImageAssignment.clear();
+
+            for(uint64_t k=0; k<mAttachmentImageViewResourceIds.size(); ++k)
+            {
+                if(not referenced[k])
+                {
+                    continue;
+                }
+
+                remappedIndices[k] = imageViewResourceIds.size();
+
+                imageViewResourceIds.push_back(mAttachmentImageViewResourceIds[k]);
+                imageResourceIds    .push_back(mAttachmentImageResourceIds[k]);
+
+                mViewToImageAssignment[mAttachmentImageViewResourceIds[k]] = (imageResourceIds.size() - 1);
+            }
+
+            auto const remap = [&] (Vector<uint64_t> &aIndices) -> void
+            {
+                Vector<uint64_t> remapped {};
+                for(uint64_t const &index : aIndices)
+                {
+                    if(referenced[index])
+                    {
+                        remapped.push_back(remappedIndices[index]);
+                    }
+                }
+                aIndices = std::move(remapped);
+            };
+
+            remap(mColorAttachments);
+            remap(mDepthAttachments);
+            remap(mInputAttachments);
+
+            for(auto &[passUID, indices] : mAttachmentPassAssignment)
+            {
+                SHIRABE_UNUSED(passUID);
+                remap(indices);
+            }
+
+            mAttachmentImageResourceIds     = std::move(imageResourceIds);
+            mAttachmentImageViewResourceIds = std::move(imageViewResourceIds);
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
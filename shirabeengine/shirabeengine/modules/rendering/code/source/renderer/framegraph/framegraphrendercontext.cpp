@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 
 #include <fmt/format.h>
@@ -15,6 +16,25 @@ namespace engine::framegraph
     using namespace engine::rendering;
     using namespace engine::material;
 
+    //<-----------------------------------------------------------------------------
+    //
+    //<-----------------------------------------------------------------------------
+    static uint64_t vertexLayoutKey(SMeshDescriptor const &aMesh)
+    {
+        std::string layout {};
+        for(VkVertexInputBindingDescription const &binding : aMesh.bindingDescriptions)
+        {
+            layout += fmt::format("b{}:{}:{};", binding.binding, binding.stride, static_cast<uint32_t>(binding.inputRate));
+        }
+        for(VkVertexInputAttributeDescription const &attribute : aMesh.attributeDescriptions)
+        {
+            layout += fmt::format("a{}:{}:{}:{};", attribute.location, attribute.binding, static_cast<uint32_t>(attribute.format), attribute.offset);
+        }
+
+        return std::hash<std::string>()(layout);
+    }
+    //<-----------------------------------------------------------------------------
+
     //<-----------------------------------------------------------------------------
     //
     //<-----------------------------------------------------------------------------
@@ -61,6 +81,9 @@ namespace engine::framegraph
         , mCurrentFrameBufferHandle({})
         , mCurrentRenderPassHandle ({})
         , mCurrentSubpass          (0)
+        , mCurrentMeshHandle       ({})
+        , mCurrentPipelineHandle   ({})
+        , mTransferredTextures     ()
     {}
     //<-----------------------------------------------------------------------------
 
@@ -526,6 +549,7 @@ namespace engine::framegraph
                     attachmentDesc.initialLayout  = EImageLayout::UNDEFINED;
                     attachmentDesc.finalLayout    = EImageLayout::TRANSFER_SRC_OPTIMAL; // For now we just assume everything to be presentable...
                     attachmentDesc.format         = texture.format;
+                    attachmentDesc.mayAlias       = texture.isAliased;
 
                     if(isColorAttachment)
                     {
@@ -779,7 +803,8 @@ namespace engine::framegraph
     //<-----------------------------------------------------------------------------
     CEngineResult<> CFrameGraphRenderContext::unloadTextureAsset(AssetId_t const &aAssetUID)
     {
-        SHIRABE_UNUSED(aAssetUID);
+        // Sampled images are keyed by their asset id, see bindMaterial(...). Once unloaded, they have to be transferred again.
+        mTransferredTextures.erase(fmt::format("{}", aAssetUID));
         return EEngineStatus::Ok;
     }
     //<-----------------------------------------------------------------------------
@@ -853,6 +878,8 @@ namespace engine::framegraph
 
         Shared<STexture> resource = getUsedResourceTyped<STexture>(aTexture.readableName);
         resource->unload();
+        mTransferredTextures.erase(aTexture.readableName);
+
         return resource->deinitialize(*(resource->getCurrentDependencies()));
     }
     //<-----------------------------------------------------------------------------
@@ -1107,7 +1134,9 @@ namespace engine::framegraph
         mGraphicsAPIRenderContext->transferBufferData(attributeBuffer->getDescription().dataSource(), attributeBuffer->getGpuApiResourceHandle());
         mGraphicsAPIRenderContext->transferBufferData(indexBuffer    ->getDescription().dataSource(), indexBuffer    ->getGpuApiResourceHandle());
 
-        return mGraphicsAPIRenderContext->bindAttributeAndIndexBuffers(attributeBuffer->getGpuApiResourceHandle(), indexBuffer->getGpuApiResourceHandle(), mesh->getDescription().offsets);
+        VkIndexType const indexType = (sizeof(uint32_t) == mesh->getDescription().indexBytesPerSample) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+
+        return mGraphicsAPIRenderContext->bindAttributeAndIndexBuffers(attributeBuffer->getGpuApiResourceHandle(), indexBuffer->getGpuApiResourceHandle(), mesh->getDescription().offsets, indexType);
     }
     //<-----------------------------------------------------------------------------
 
@@ -1154,12 +1183,41 @@ namespace engine::framegraph
         dependencies.pipelineDependencies.subpass               = mCurrentSubpass;
         dependencies.pipelineDependencies.shaderModuleId        = material->shaderModuleResource->getDescription().name;
 
+        // The vertex formats are baked into the pipeline. Meshes of different layouts drawn with the
+        // same material thus each get a pipeline of their own, keyed by the layout.
+        Shared<SPipeline> pipeline = material->pipelineResource;
+
+        Shared<SMesh> mesh = mCurrentMeshHandle.empty() ? nullptr : std::static_pointer_cast<SMesh>(getUsedResource(mCurrentMeshHandle));
+        if(nullptr != mesh)
+        {
+            dependencies.pipelineDependencies.vertexInputBindings   = mesh->getDescription().bindingDescriptions;
+            dependencies.pipelineDependencies.vertexInputAttributes = mesh->getDescription().attributeDescriptions;
+
+            std::string const pipelineId = fmt::format("{}_{:016x}", pipeline->getDescription().name, vertexLayoutKey(mesh->getDescription()));
+
+            auto const [result, pipelineObject] = mResourceManager->useDynamicResource<SPipeline>(pipelineId, pipeline->getDescription());
+            if(CheckEngineError(result))
+            {
+                CLog::Error(logTag(), "Failed to create pipeline {} of material {}.", pipelineId, material->getDescription().name);
+                return result;
+            }
+
+            pipeline = std::static_pointer_cast<SPipeline>(pipelineObject);
+            registerUsedResource(pipelineId, pipeline);
+            mCurrentPipelineHandle = pipelineId;
+        }
+        else
+        {
+            registerUsedResource(pipeline->getDescription().name, pipeline);
+            mCurrentPipelineHandle = pipeline->getDescription().name;
+        }
+
         for(auto const &buffer : material->bufferResources)
         {
             buffer->initialize({});
         }
         material->shaderModuleResource->initialize({});
-        material->pipelineResource    ->initialize(dependencies.pipelineDependencies);
+        pipeline                      ->initialize(dependencies.pipelineDependencies);
 
         EEngineStatus const status = material->initialize(dependencies).result();
 
@@ -1187,56 +1245,132 @@ namespace engine::framegraph
             gpuInputAttachmentTextureViewIds.push_back(attachmentTextureView->getGpuApiResourceHandle());
         }
 
-        for(auto const &sampledImageAssetId : material->getDescription().sampledImages)
+        //
+        // On first use, express texture -> view -> descriptor update as a DAG:
+        //   - Textures and their views are created in parallel, each view after its texture.
+        //   - Transfers record into the shared transfer command buffer and are thus chained.
+        //   - The descriptor update runs once all views and transfers are done.
+        // Once a texture was transferred, only its view is created on bind. This runs inline.
+        //
+        Shared<threading::CTaskGraph> const &taskGraph = mResourceManager->getTaskGraph();
+
+        Vector<threading::CTaskHandle> sampledImageTasks {};
+        Vector<std::string>            scheduledTextures {};
+        threading::CTaskHandle         previousTransfer  {};
+
+        gpuTextureViewIds.resize(material->getDescription().sampledImages.size());
+
+        for(std::size_t k=0; k<material->getDescription().sampledImages.size(); ++k)
         {
-            std::string const sampledImageResourceId = fmt::format("{}", sampledImageAssetId);
+            auto        const &sampledImageAssetId    = material->getDescription().sampledImages.at(k);
+            std::string const  sampledImageResourceId = fmt::format("{}", sampledImageAssetId);
 
             Shared<ILogicalResourceObject> logicalTexture      = mResourceManager->useAssetResource(sampledImageResourceId, sampledImageAssetId).data();
             Shared<STexture>               sampledImageTexture = std::static_pointer_cast<STexture>(logicalTexture);
-            if(nullptr != sampledImageTexture)
+            if(nullptr == sampledImageTexture)
+            {
+                continue; // Keep the default binding to fill the gap.
+            }
+
+            STextureViewDescription desc {};
+            desc.name                 = fmt::format("{}_{}_view", material->getDescription().name, sampledImageTexture->getDescription().name);
+            desc.subjacentTextureInfo = sampledImageTexture->getDescription().textureInfo;
+            desc.arraySlices          = { 0, 1 };
+            desc.mipMapSlices         = { 0, 1 };
+            desc.textureFormat        = sampledImageTexture->getDescription().textureInfo.format;
+
+            auto const [result, viewData] = mResourceManager->useDynamicResource<STextureView>(desc.name, desc);
+            if(CheckEngineError(result))
             {
-                sampledImageTexture->initialize({}); // No-Op if loaded already...
-                sampledImageTexture->load();
-                sampledImageTexture->transfer();     // No-Op if transferred already...
-
-                STextureViewDescription desc {};
-                desc.name                 = fmt::format("{}_{}_view", material->getDescription().name, sampledImageTexture->getDescription().name);
-                desc.subjacentTextureInfo = sampledImageTexture->getDescription().textureInfo;
-                desc.arraySlices          = { 0, 1 };
-                desc.mipMapSlices         = { 0, 1 };
-                desc.textureFormat        = sampledImageTexture->getDescription().textureInfo.format;
-
-                auto const [result, viewData] = mResourceManager->useDynamicResource<STextureView>(desc.name, desc);
-                if(CheckEngineError(result))
+                // ...
+                break;
+            }
+
+            Shared<STextureView> view = std::static_pointer_cast<STextureView>(viewData);
+
+            STextureViewDependencies deps {};
+            deps.subjacentTextureId = sampledImageResourceId;
+
+            if(mTransferredTextures.end() != mTransferredTextures.find(sampledImageResourceId))
+            {
+                CEngineResult<> const viewCreation = view->initialize(deps);
+                if(CheckEngineError(viewCreation.result()))
                 {
-                    // ...
-                    break;
+                    CLog::Error(logTag(), "Failed to create texture view {} of material {}.", desc.name, material->getDescription().name);
+                    return viewCreation.result();
                 }
 
-                Shared<STextureView> view = std::static_pointer_cast<STextureView>(viewData);
+                SSampledImageBinding &imageBinding = gpuTextureViewIds[k];
+                imageBinding.image     = sampledImageTexture->getGpuApiResourceHandle();
+                imageBinding.imageView = view->getGpuApiResourceHandle();
+                continue;
+            }
+
+            // No-Op if initialized already...
+            threading::CTaskHandle const textureCreation = mResourceManager->initializeResourceAsync<STexture>(sampledImageResourceId, {});
 
-                STextureViewDependencies deps {};
-                deps.subjacentTextureId = sampledImageResourceId;
-                view->initialize(deps);
+            threading::CTaskHandle const textureLoad = textureCreation.then([sampledImageTexture] () -> CEngineResult<>
+            {
+                return sampledImageTexture->load();
+            });
 
-                SSampledImageBinding binding {};
-                binding.image     = sampledImageTexture->getGpuApiResourceHandle();
-                binding.imageView = view->getGpuApiResourceHandle();
+            threading::CTaskHandle const textureTransfer = taskGraph->add([sampledImageTexture] () -> CEngineResult<>
+            {
+                return sampledImageTexture->transfer(); // No-Op if transferred already...
+            }, { textureLoad, previousTransfer });
+            previousTransfer = textureTransfer;
 
-                gpuTextureViewIds.push_back(binding);
-            }
-            else
+            // Depends on the texture creation through deps.subjacentTextureId.
+            threading::CTaskHandle const viewCreation = mResourceManager->initializeResourceAsync<STextureView>(desc.name, deps);
+
+            threading::CTaskHandle const binding = viewCreation.then([&gpuTextureViewIds, k, sampledImageTexture, view] () -> CEngineResult<>
+            {
+                SSampledImageBinding &imageBinding = gpuTextureViewIds[k];
+                imageBinding.image     = sampledImageTexture->getGpuApiResourceHandle();
+                imageBinding.imageView = view->getGpuApiResourceHandle();
+
+                return EEngineStatus::Ok;
+            });
+
+            sampledImageTasks.push_back(binding);
+            sampledImageTasks.push_back(textureTransfer);
+            scheduledTextures.push_back(sampledImageResourceId);
+        }
+
+        auto const updateResourceBindings = [&, pipeline] () -> CEngineResult<>
+        {
+            mGraphicsAPIRenderContext->updateResourceBindings(  pipeline->getGpuApiResourceHandle()
+                                                              , gpuBufferIds
+                                                              , gpuInputAttachmentTextureViewIds
+                                                              , gpuTextureViewIds);
+            return EEngineStatus::Ok;
+        };
+
+        if(sampledImageTasks.empty())
+        {
+            CEngineResult<> const update = updateResourceBindings();
+            if(CheckEngineError(update.result()))
             {
-                gpuTextureViewIds.push_back( {}); // Fill gaps
+                CLog::Error(logTag(), "Failed to update the resource bindings of material {}.", material->getDescription().name);
+                return update.result();
             }
         }
+        else
+        {
+            threading::CTaskHandle const descriptorUpdate = taskGraph->whenAll(sampledImageTasks).then(updateResourceBindings);
+
+            // The bindings refer to locals of this frame. Wait for the update to complete.
+            CEngineResult<> const update = descriptorUpdate.wait();
+            if(CheckEngineError(update.result()))
+            {
+                CLog::Error(logTag(), "Failed to create sampled images or update the resource bindings of material {}.", material->getDescription().name);
+                return update.result();
+            }
 
-        mGraphicsAPIRenderContext->updateResourceBindings(  material->pipelineResource->getGpuApiResourceHandle()
-                                                          , gpuBufferIds
-                                                          , gpuInputAttachmentTextureViewIds
-                                                          , gpuTextureViewIds);
+            mTransferredTextures.insert(scheduledTextures.begin(), scheduledTextures.end());
+        }
 
-        auto const result = mGraphicsAPIRenderContext->bindPipeline(material->pipelineResource->getGpuApiResourceHandle());
+        auto const result = mGraphicsAPIRenderContext->bindPipeline(pipeline->getGpuApiResourceHandle());
         return result;
     }
     //<-----------------------------------------------------------------------------
@@ -1263,7 +1397,10 @@ namespace engine::framegraph
             }
         }
 
-        auto const result = mGraphicsAPIRenderContext->unbindPipeline(material->pipelineResource->getGpuApiResourceHandle());
+        Shared<SPipeline> pipeline = getUsedResourceTyped<SPipeline>(mCurrentPipelineHandle);
+        mCurrentPipelineHandle = {};
+
+        auto const result = mGraphicsAPIRenderContext->unbindPipeline(pipeline->getGpuApiResourceHandle());
         return result;
     }
     //<-----------------------------------------------------------------------------
@@ -1284,17 +1421,41 @@ namespace engine::framegraph
     //<
     //<-----------------------------------------------------------------------------
     CEngineResult<> CFrameGraphRenderContext::render(SFrameGraphMesh     const &aMesh,
-                                                     SFrameGraphMaterial const &aMaterial)
+                                                     SFrameGraphMaterial const &aMaterial,
+                                                     uint32_t                   aLodIndex)
     {
+        bool const hasMesh = (EFrameGraphResourceType::Undefined != aMesh.type);
+
+        // The mesh is loaded first, so that the pipeline is created with its vertex formats.
+        if(hasMesh)
+        {
+            loadMeshAsset(aMesh);
+            mCurrentMeshHandle = aMesh.readableName;
+        }
+
         loadMaterialAsset(aMaterial);
         bindMaterial(aMaterial, mCurrentRenderPassHandle);
+        mCurrentMeshHandle = {};
 
-        if(EFrameGraphResourceType::Undefined != aMesh.type)
+        if(hasMesh)
         {
-            loadMeshAsset(aMesh);
-            bindMesh     (aMesh);
-            Shared<SMesh> mesh = std::static_pointer_cast<SMesh>(getUsedResource(aMesh.readableName));
-            mGraphicsAPIRenderContext->drawIndex(mesh->getDescription().indexSampleCount);
+            bindMesh(aMesh);
+            Shared<SMesh>     mesh     = std::static_pointer_cast<SMesh>(getUsedResource(aMesh.readableName));
+            Shared<SPipeline> pipeline = getUsedResourceTyped<SPipeline>(mCurrentPipelineHandle);
+
+            SMeshDrawConstants const &drawConstants = mesh->getDescription().drawConstants;
+            mGraphicsAPIRenderContext->pushVertexConstants(pipeline->getGpuApiResourceHandle(), &drawConstants, sizeof(SMeshDrawConstants));
+
+            Vector<SMeshLodRange> const &lods = mesh->getDescription().lods;
+            if(lods.empty())
+            {
+                mGraphicsAPIRenderContext->drawIndex(mesh->getDescription().indexSampleCount, 0);
+            }
+            else
+            {
+                SMeshLodRange const &lod = lods[std::min<std::size_t>(aLodIndex, (lods.size() - 1))];
+                mGraphicsAPIRenderContext->drawIndex(lod.indexCount, lod.firstIndex);
+            }
             unbindMesh     (aMesh);
             unloadMeshAsset(aMesh);
         }
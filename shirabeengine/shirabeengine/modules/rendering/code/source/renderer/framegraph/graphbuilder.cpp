@@ -1,4 +1,6 @@
 ﻿#include <assert.h>
+#include <algorithm>
+#include <map>
 #include "renderer/framegraph/graphbuilder.h"
 
 namespace engine
@@ -292,9 +294,25 @@ namespace engine
                 return { EEngineStatus::Error };
             }
 
+            // Fourth: Remove all passes and resources, which don't contribute to the output.
+            CEngineResult<> const culling = cullPasses(accessor->mutablePassExecutionOrder());
+            if(not culling.successful())
+            {
+                CLog::Error(logTag(), "Failed to perform cullPasses(...) on graph compilation.");
+                return { EEngineStatus::Error };
+            }
+
+            // Fifth: Share memory between transient resources, which are never alive at the same time.
+            CEngineResult<> const aliasing = aliasTransientResources(accessor->passExecutionOrder(), accessor->mutableTransientMemoryReport());
+            if(not aliasing.successful())
+            {
+                CLog::Error(logTag(), "Failed to perform aliasTransientResources(...) on graph compilation.");
+                return { EEngineStatus::Error };
+            }
+
 #if defined SHIRABE_FRAMEGRAPH_ENABLE_SERIALIZATION
 
-            // Fourth: Sort the resources by their relationships and dependencies.
+            // Sixth: Sort the resources by their relationships and dependencies.
             bool const topologicalResourceSortSuccessful = topologicalSort<FrameGraphResourceId_t>(accessor->mutableResourceOrder());
             if(!topologicalResourceSortSuccessful)
             {
@@ -543,6 +561,342 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CGraphBuilder::cullPasses(std::stack<PassUID_t> &aInOutPassOrder)
+        {
+            // Without a designated output, every pass is considered to have side effects.
+            if(SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE == mOutputResourceId)
+            {
+                return { EEngineStatus::Ok };
+            }
+
+            CEngineResult<Shared<SFrameGraphResource> const> outputFetch = mResourceData.get<SFrameGraphResource>(mOutputResourceId);
+            if(not outputFetch.successful() || nullptr == outputFetch.data())
+            {
+                CLog::Error(logTag(), CString::format("Failed to fetch output resource w/ id {} for culling.", mOutputResourceId));
+                return { EEngineStatus::Error };
+            }
+
+            PassUID_t const outputPassUID = outputFetch.data()->assignedPassUID;
+
+            // First: Count the consumers of each pass and store the reverse edges.
+            Map<PassUID_t, uint32_t>               passReferenceCounts {};
+            Map<PassUID_t, std::vector<PassUID_t>> producers           {};
+
+            for(auto const &[passUID, pass] : graph()->passes())
+            {
+                SHIRABE_UNUSED(pass);
+                passReferenceCounts[passUID] = 0;
+            }
+
+            for(auto const &[passUID, adjacentUIDs] : mPassAdjacency)
+            {
+                for(PassUID_t const &adjacentUID : adjacentUIDs)
+                {
+                    ++(passReferenceCounts[passUID]);
+                    producers[adjacentUID].push_back(passUID);
+                }
+            }
+
+            // The output is consumed by the backbuffer copy or the caller. The pseudo pass is always kept.
+            ++(passReferenceCounts[outputPassUID]);
+            ++(passReferenceCounts[0]);
+
+            // Second: Cull all unreferenced passes and release their references on their producers.
+            std::vector<PassUID_t> unreferenced {};
+            for(auto const &[passUID, referenceCount] : passReferenceCounts)
+            {
+                if(0 == referenceCount)
+                {
+                    unreferenced.push_back(passUID);
+                }
+            }
+
+            std::vector<PassUID_t> culledPasses {};
+            while(not unreferenced.empty())
+            {
+                PassUID_t const passUID = unreferenced.back();
+                unreferenced.pop_back();
+
+                culledPasses.push_back(passUID);
+
+                for(PassUID_t const &producerUID : producers[passUID])
+                {
+                    if(0 == --(passReferenceCounts[producerUID]))
+                    {
+                        unreferenced.push_back(producerUID);
+                    }
+                }
+            }
+
+            if(culledPasses.empty())
+            {
+                return { EEngineStatus::Ok };
+            }
+
+            auto const isCulled = [&culledPasses] (PassUID_t const &aPassUID) -> bool
+            {
+                return (culledPasses.end() != std::find(culledPasses.begin(), culledPasses.end(), aPassUID));
+            };
+
+            // Third: Remove the culled passes from the execution order, keeping the order of the remaining ones.
+            std::vector<PassUID_t> remainingPasses {};
+            while(not aInOutPassOrder.empty())
+            {
+                if(not isCulled(aInOutPassOrder.top()))
+                {
+                    remainingPasses.push_back(aInOutPassOrder.top());
+                }
+                aInOutPassOrder.pop();
+            }
+
+            for(auto it = remainingPasses.rbegin(); it != remainingPasses.rend(); ++it)
+            {
+                aInOutPassOrder.push(*it);
+            }
+
+            // Fourth: Release all texture views created by culled passes, so that neither they nor
+            //         textures exclusively used by them will be initialized on execution.
+            uint32_t culledResourceCount = 0;
+            for(RefIndex_t::value_type const &textureViewId : mResourceData.textureViews())
+            {
+                Shared<SFrameGraphTextureView> textureView = mResourceData.getMutable<SFrameGraphTextureView>(textureViewId).data();
+                if(nullptr == textureView || not isCulled(textureView->assignedPassUID))
+                {
+                    continue;
+                }
+
+                Shared<SFrameGraphResource> subjacent = mResourceData.getMutable<SFrameGraphResource>(textureView->subjacentResource).data();
+                if(nullptr != subjacent && 0 < subjacent->referenceCount)
+                {
+                    --(subjacent->referenceCount);
+                }
+
+                textureView->referenceCount = 0;
+                ++culledResourceCount;
+            }
+
+            mResourceData.getAttachments().removePasses(culledPasses);
+
+            CLog::Debug(logTag(), CString::format("Culled {} passes and {} texture views not contributing to the output.", culledPasses.size(), culledResourceCount));
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        bool CGraphBuilder::isAliasingCompatible(
+                SFrameGraphTexture const &aTexture,
+                SFrameGraphTexture const &aBacking)
+        {
+            bool const compatible =
+                    (aTexture.width          == aBacking.width         ) &&
+                    (aTexture.height         == aBacking.height        ) &&
+                    (aTexture.depth          == aBacking.depth         ) &&
+                    (aTexture.format         == aBacking.format        ) &&
+                    (aTexture.arraySize      == aBacking.arraySize     ) &&
+                    (aTexture.mipLevels      == aBacking.mipLevels     ) &&
+                    (aTexture.initialState   == aBacking.initialState  ) &&
+                    (aTexture.permittedUsage.check(aBacking.permittedUsage)) &&
+                    (aBacking.permittedUsage.check(aTexture.permittedUsage));
+
+            return compatible;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<> CGraphBuilder::aliasTransientResources(
+                std::stack<PassUID_t>            const &aPassOrder,
+                SFrameGraphTransientMemoryReport       &aOutReport)
+        {
+            /**
+             * Lifetime of a transient texture in pass execution order indices.
+             */
+            struct SLifetime
+            {
+                FrameGraphResourceId_t textureId;
+                uint64_t               firstUse;
+                uint64_t               lastUse;
+            };
+
+            /**
+             * A backing texture and the last pass index it is occupied until.
+             */
+            struct SBackingSlot
+            {
+                Shared<SFrameGraphTexture> backing;
+                uint64_t                   occupiedUntil;
+            };
+
+            aOutReport = {};
+
+            std::vector<PassUID_t> executionOrder {};
+            {
+                std::stack<PassUID_t> copy = aPassOrder;
+                while(not copy.empty())
+                {
+                    executionOrder.push_back(copy.top());
+                    copy.pop();
+                }
+            }
+
+            // First: Derive the lifetime of each transient texture from all textures and views referenced per pass.
+            std::map<FrameGraphResourceId_t, SLifetime> lifetimes {};
+
+            auto const touch = [&] (FrameGraphResourceId_t const &aTextureId, uint64_t const &aPassIndex) -> void
+            {
+                auto const it = lifetimes.find(aTextureId);
+                if(lifetimes.end() == it)
+                {
+                    lifetimes[aTextureId] = { aTextureId, aPassIndex, aPassIndex };
+                    return;
+                }
+
+                it->second.firstUse = std::min(it->second.firstUse, aPassIndex);
+                it->second.lastUse  = std::max(it->second.lastUse,  aPassIndex);
+            };
+
+            for(uint64_t k=0; k<executionOrder.size(); ++k)
+            {
+                PassMap::const_iterator const passIt = graph()->passes().find(executionOrder[k]);
+                if(graph()->passes().end() == passIt)
+                {
+                    continue;
+                }
+
+                Unique<CPassBase::CAccessor> const passAccessor = passIt->second->getAccessor(CPassKey<CGraphBuilder>());
+                for(FrameGraphResourceId_t const &resourceId : passAccessor->resourceReferences())
+                {
+                    CEngineResult<Shared<SFrameGraphResource> const> resourceFetch = mResourceData.get<SFrameGraphResource>(resourceId);
+                    if(not resourceFetch.successful() || nullptr == resourceFetch.data())
+                    {
+                        continue;
+                    }
+
+                    SFrameGraphResource const &resource = *(resourceFetch.data());
+                    if(EFrameGraphResourceType::Texture     != resource.type &&
+                       EFrameGraphResourceType::TextureView != resource.type)
+                    {
+                        continue;
+                    }
+
+                    touch(resource.subjacentResource, k);
+                }
+            }
+
+            // The output texture is copied to the backbuffer after the last pass.
+            if(SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE != mOutputResourceId)
+            {
+                CEngineResult<Shared<SFrameGraphResource> const> outputFetch = mResourceData.get<SFrameGraphResource>(mOutputResourceId);
+                if(outputFetch.successful() && nullptr != outputFetch.data())
+                {
+                    touch(outputFetch.data()->subjacentResource, executionOrder.size());
+                }
+            }
+
+            // Second: Filter out external textures and sort by first use.
+            std::vector<SLifetime> transientLifetimes {};
+            for(auto const &[textureId, lifetime] : lifetimes)
+            {
+                CEngineResult<Shared<SFrameGraphTexture>> textureFetch = mResourceData.getMutable<SFrameGraphTexture>(textureId);
+                if(not textureFetch.successful() || nullptr == textureFetch.data())
+                {
+                    continue;
+                }
+
+                Shared<SFrameGraphTexture> const &texture = textureFetch.data();
+                if(EFrameGraphResourceType::Texture != texture->type || texture->isExternalResource)
+                {
+                    continue;
+                }
+
+                texture->aliasedResource = SHIRABE_FRAMEGRAPH_UNDEFINED_RESOURCE;
+                texture->isAliased       = false;
+
+                transientLifetimes.push_back(lifetime);
+            }
+
+            std::sort(transientLifetimes.begin(), transientLifetimes.end(), [] (SLifetime const &aLHS, SLifetime const &aRHS) -> bool
+            {
+                return (aLHS.firstUse < aRHS.firstUse) || (aLHS.firstUse == aRHS.firstUse && aLHS.textureId < aRHS.textureId);
+            });
+
+            // Third: Greedy interval assignment. Reuse the first compatible slot, which is free again.
+            std::vector<SBackingSlot> slots {};
+
+            for(SLifetime const &lifetime : transientLifetimes)
+            {
+                Shared<SFrameGraphTexture> texture = mResourceData.getMutable<SFrameGraphTexture>(lifetime.textureId).data();
+
+                uint64_t const size = estimateTextureMemorySize(*texture);
+                aOutReport.bytesWithoutAliasing += size;
+                ++(aOutReport.transientTextureCount);
+
+                SBackingSlot *assignedSlot = nullptr;
+                for(SBackingSlot &slot : slots)
+                {
+                    if(slot.occupiedUntil < lifetime.firstUse && isAliasingCompatible(*texture, *(slot.backing)))
+                    {
+                        assignedSlot = &slot;
+                        break;
+                    }
+                }
+
+                if(nullptr == assignedSlot)
+                {
+                    slots.push_back({ texture, lifetime.lastUse });
+                    aOutReport.bytesWithAliasing += size;
+                    continue;
+                }
+
+                Shared<SFrameGraphTexture> &backing = assignedSlot->backing;
+
+                texture->aliasedResource = backing->resourceId;
+                texture->isAliased       = true;
+                backing->isAliased       = true;
+                // The backing texture has to support all usages requested by its aliases.
+                backing->requestedUsage.set(texture->requestedUsage);
+
+                assignedSlot->occupiedUntil = lifetime.lastUse;
+
+                CLog::Verbose(logTag(), CString::format("Transient texture '{}' aliases '{}'.", texture->readableName, backing->readableName));
+            }
+
+            aOutReport.backingTextureCount = static_cast<uint32_t>(slots.size());
+
+            // Lower bound for comparison: The max. amount of memory alive at any pass.
+            for(uint64_t k=0; k<=executionOrder.size(); ++k)
+            {
+                uint64_t liveBytes = 0;
+                for(SLifetime const &lifetime : transientLifetimes)
+                {
+                    if(lifetime.firstUse <= k && k <= lifetime.lastUse)
+                    {
+                        liveBytes += estimateTextureMemorySize(*(mResourceData.get<SFrameGraphTexture>(lifetime.textureId).data()));
+                    }
+                }
+
+                aOutReport.peakLiveBytes = std::max(aOutReport.peakLiveBytes, liveBytes);
+            }
+
+            CLog::Debug(logTag(),
+                        CString::format("Transient textures: {} in {} allocations. Memory w/o aliasing: {} bytes, w/ aliasing: {} bytes, peak live: {} bytes.",
+                                        aOutReport.transientTextureCount,
+                                        aOutReport.backingTextureCount,
+                                        aOutReport.bytesWithoutAliasing,
+                                        aOutReport.bytesWithAliasing,
+                                        aOutReport.peakLiveBytes));
+
+            return { EEngineStatus::Ok };
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
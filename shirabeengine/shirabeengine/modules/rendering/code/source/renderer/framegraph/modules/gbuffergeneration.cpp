@@ -143,6 +143,7 @@ namespace engine
                 aOutPassData.exportData.depthStencil = aBuilder.writeAttachment(aOutPassData.state.depthStencilTextureId, depthFlags).data();
 
                 // Register all meshes and materials for use.
+                aOutPassData.importData.renderableListId = aRenderableInput.resourceId;
                 for(SRenderable const &renderable : aRenderableInput.renderableList)
                 {
                     SRenderableResources resources {};
@@ -181,8 +182,18 @@ namespace engine
 
                // aRenderContext->clearAttachments("DefaultRenderPass");
 
-                for(SRenderableResources const &renderableResources : aPassData.importData.renderables)
+                auto const &[listResult, renderableList] = aFrameGraphResources.get<SFrameGraphRenderableList>(aPassData.importData.renderableListId);
+                if(CheckEngineError(listResult) || nullptr == renderableList)
                 {
+                    CLog::Error(logTag(), "Failed to fetch renderable list for id {}", aPassData.importData.renderableListId);
+                    return { EEngineStatus::Error };
+                }
+
+                for(std::size_t k=0; k<aPassData.importData.renderables.size(); ++k)
+                {
+                    SRenderableResources const &renderableResources = aPassData.importData.renderables[k];
+                    uint32_t             const  meshLodIndex        = (k < renderableList->renderableList.size()) ? renderableList->renderableList[k].meshLodIndex : 0;
+
                     auto const &[result, materialPointer] = aFrameGraphResources.get<SFrameGraphMaterial>(renderableResources.materialResource.resourceId);
                     if(CheckEngineError(result) || nullptr == materialPointer)
                     {
@@ -197,7 +208,7 @@ namespace engine
                         continue;
                     }
 
-                    aRenderContext->render(*meshPointer, *materialPointer);
+                    aRenderContext->render(*meshPointer, *materialPointer, meshLodIndex);
                 }
 
                 return { EEngineStatus::Ok };
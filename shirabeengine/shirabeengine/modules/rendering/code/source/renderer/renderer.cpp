@@ -13,6 +13,103 @@ namespace engine
 {
     namespace rendering
     {
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CFrameGraphCache::CFrameGraphCache()
+            : mGraph(nullptr)
+            , mStructureKey(0)
+            , mStatistics({ 0, 0 })
+        {}
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        framegraph::CGraph *CFrameGraphCache::acquire(uint64_t aStructureKey, BuildFn_t const &aBuild)
+        {
+            if(nullptr != mGraph && aStructureKey == mStructureKey)
+            {
+                ++(mStatistics.hits);
+                return mGraph.get();
+            }
+
+            ++(mStatistics.misses);
+            invalidate();
+
+            CEngineResult<Unique<framegraph::CGraph>> build = aBuild();
+            if(not build.successful())
+            {
+                return nullptr;
+            }
+
+            mGraph        = std::move(build.data());
+            mStructureKey = aStructureKey;
+            return mGraph.get();
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        void CFrameGraphCache::invalidate()
+        {
+            mGraph        = nullptr;
+            mStructureKey = 0;
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        uint64_t CFrameGraphCache::deriveStructureKey(
+                uint32_t                       const &aWidth,
+                uint32_t                       const &aHeight,
+                framegraph::CGraph::EGraphMode const &aGraphMode,
+                RenderableList                 const &aRenderableCollection)
+        {
+            // FNV-1a, 64bit
+            uint64_t key = 14695981039346656037ull;
+
+            auto const combine = [&key] (void const *aData, std::size_t const aSize) -> void
+            {
+                uint8_t const *bytes = static_cast<uint8_t const *>(aData);
+                for(std::size_t k=0; k<aSize; ++k)
+                {
+                    key ^= bytes[k];
+                    key *= 1099511628211ull;
+                }
+            };
+
+            auto const combineString = [&combine] (std::string const &aString) -> void
+            {
+                std::size_t const size = aString.size();
+                combine(&size, sizeof(size));
+                combine(aString.data(), size);
+            };
+
+            combine(&aWidth,     sizeof(aWidth));
+            combine(&aHeight,    sizeof(aHeight));
+            combine(&aGraphMode, sizeof(aGraphMode));
+
+            std::size_t const renderableCount = aRenderableCollection.size();
+            combine(&renderableCount, sizeof(renderableCount));
+
+            // The mesh and material resources of each renderable are registered during pass setup
+            // and thus are part of the graph structure. The selected LOD is per frame state and
+            // handed to the cached graph, see CGraph::updateRenderables.
+            for(SRenderable const &renderable : aRenderableCollection)
+            {
+                combineString(renderable.meshInstanceId);
+                combine(&renderable.meshInstanceAssetId, sizeof(renderable.meshInstanceAssetId));
+                combineString(renderable.materialInstanceId);
+                combine(&renderable.materialInstanceAssetId, sizeof(renderable.materialInstanceAssetId));
+            }
+
+            return key;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -22,6 +119,7 @@ namespace engine
             , mDisplay(nullptr)
             , mFrameGraphRenderContext(nullptr)
             , mPaused(true)
+            , mFrameGraphCache()
         {}
         //<-----------------------------------------------------------------------------
 
@@ -63,6 +161,8 @@ namespace engine
         //<-----------------------------------------------------------------------------
         EEngineStatus CRenderer::deinitialize()
         {
+            mFrameGraphCache.invalidate();
+
             return EEngineStatus::Ok;
         }
         //<-----------------------------------------------------------------------------
@@ -72,6 +172,8 @@ namespace engine
         //<-----------------------------------------------------------------------------
         EEngineStatus CRenderer::reinitialize()
         {
+            mFrameGraphCache.invalidate();
+
             return EEngineStatus::Ok;
         }
         //<-----------------------------------------------------------------------------
@@ -147,20 +249,21 @@ namespace engine
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
-        EEngineStatus CRenderer::renderScene(RenderableList const &aRenderableCollection)
+        CEngineResult<Unique<framegraph::CGraph>> CRenderer::buildFrameGraph(
+                uint32_t                       const &aWidth,
+                uint32_t                       const &aHeight,
+                framegraph::CGraph::EGraphMode const &aGraphMode,
+                RenderableList                 const &aRenderableCollection)
         {
             using namespace engine;
             using namespace engine::framegraph;
 
-            SOSDisplayDescriptor const&displayDesc = mDisplay->screenInfo()[mDisplay->primaryScreenIndex()];
-
-            uint32_t
-                    width  = displayDesc.bounds.size.x(),
-                    height = displayDesc.bounds.size.y();
+            SHIRABE_UNUSED(aWidth);
+            SHIRABE_UNUSED(aHeight);
 
             CGraphBuilder graphBuilder{ };
             graphBuilder.initialize(mAppEnvironment, mDisplay);
-            graphBuilder.setGraphMode(CGraph::EGraphMode::Graphics);
+            graphBuilder.setGraphMode(aGraphMode);
             graphBuilder.setRenderToBackBuffer(true);
 
 
@@ -184,8 +287,8 @@ namespace engine
             //         graphicsAPICommonModule.addPrePass(
             //             sPrePassID,
             //             graphBuilder,
-            //             width,
-            //             height,
+            //             aWidth,
+            //             aHeight,
             //             FrameGraphFormat_t::R8G8B8A8_UNORM).data();
 
             // GBuffer
@@ -242,7 +345,7 @@ namespace engine
             if(not compilation.successful())
             {
                 CLog::Error(logTag(), "Failed to compile the framegraph.");
-                return EEngineStatus::Ok;
+                return { compilation.result() };
             }
 
             Unique<engine::framegraph::CGraph> frameGraph = std::move(compilation.data());
@@ -272,8 +375,36 @@ namespace engine
                 system("tools/makeFrameGraphPNG.sh");
             }
 #endif
-            if(frameGraph)
+
+            return { EEngineStatus::Ok, std::move(frameGraph) };
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        EEngineStatus CRenderer::renderScene(RenderableList const &aRenderableCollection)
+        {
+            SOSDisplayDescriptor const&displayDesc = mDisplay->screenInfo()[mDisplay->primaryScreenIndex()];
+
+            uint32_t
+                    width  = displayDesc.bounds.size.x(),
+                    height = displayDesc.bounds.size.y();
+
+            // The graph topology changes rarely. Only rebuild and recompile, if the structure did change.
+            framegraph::CGraph::EGraphMode const graphMode    = framegraph::CGraph::EGraphMode::Graphics;
+            uint64_t                       const structureKey = CFrameGraphCache::deriveStructureKey(width, height, graphMode, aRenderableCollection);
+            uint64_t                       const misses       = mFrameGraphCache.statistics().misses;
+
+            framegraph::CGraph *frameGraph = mFrameGraphCache.acquire(structureKey, [&, this] () { return buildFrameGraph(width, height, graphMode, aRenderableCollection); });
+            if(misses != mFrameGraphCache.statistics().misses && nullptr != frameGraph)
+            {
+                CLog::Debug(logTag(), CString::format("Framegraph rebuilt. Cache hits: {}, misses: {}", mFrameGraphCache.statistics().hits, mFrameGraphCache.statistics().misses));
+            }
+
+            if(nullptr != frameGraph)
             {
+                frameGraph->updateRenderables(aRenderableCollection);
                 frameGraph->execute(mFrameGraphRenderContext);
             }
 
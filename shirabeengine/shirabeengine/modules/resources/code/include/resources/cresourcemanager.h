@@ -5,12 +5,15 @@
 #ifndef __SHIRABEDEVELOPMENT_CRESOURCEMANAGER_H__
 #define __SHIRABEDEVELOPMENT_CRESOURCEMANAGER_H__
 
+#include <condition_variable>
+#include <mutex>
 #include <typeindex>
 #include <platform/platform.h>
 #include <graphicsapi/definitions.h>
 #include <asset/assettypes.h>
 #include <asset/assetstorage.h>
 #include <core/datastructures/adjacencytree.h>
+#include <core/threading/taskgraph.h>
 #include "resources/cresourceobject.h"
 #include "resources/agpuapiresourceobject.h"
 #include "resources/agpuapiresourceobjectfactory.h"
@@ -59,6 +62,43 @@ namespace engine {
 
             CEngineResult<> discardResource(ResourceId_t const &aResourceId);
 
+            /**
+             * Set the task graph used for asynchronous resource operations.
+             * Defaults to a graph executing tasks inline on the calling thread.
+             *
+             * @param aTaskGraph The task graph to use. Ignored, if null.
+             */
+            void setTaskGraph(Shared<threading::CTaskGraph> const &aTaskGraph);
+
+            /**
+             * Return the task graph used for asynchronous resource operations, so that
+             * callers can chain further work, e.g. descriptor updates, to resource tasks.
+             *
+             * @return See brief.
+             */
+            SHIRABE_INLINE Shared<threading::CTaskGraph> const &getTaskGraph() const
+            {
+                return mTaskGraph;
+            }
+
+            /**
+             * Schedule the initialization of a dynamic resource created before by useDynamicResource.
+             *
+             * The task runs once the initialization tasks of all resources listed in aDependencies
+             * and all aAdditionalDependencies finished. Thus chains like texture -> view -> descriptor
+             * form a DAG, which runs in parallel wherever the dependencies permit.
+             *
+             * @param aResourceId             The id of the resource to initialize.
+             * @param aDependencies           The dependencies passed to the resource's initialize op.
+             * @param aAdditionalDependencies Further tasks to wait for.
+             * @return                        A handle to the initialization task.
+             */
+            template <typename TResource>
+            threading::CTaskHandle initializeResourceAsync(
+                      ResourceId_t                       const &aResourceId
+                    , typename TResource::Dependencies_t const &aDependencies
+                    , Vector<threading::CTaskHandle>     const &aAdditionalDependencies = {});
+
         private_methods:
             template <typename TResource>
             Shared<CResourceFromAssetResourceObjectCreator<TResource>> getLoader();
@@ -78,6 +118,8 @@ namespace engine {
             bool addResourceState( ResourceId_t         const &aId
                                  , EGpuApiResourceState const  aState)
             {
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
                 if(mGpuApiResourceStates.end() != mGpuApiResourceStates.find(aId))
                 {
                     return true;
@@ -90,6 +132,9 @@ namespace engine {
             SHIRABE_INLINE
             core::CBitField<EGpuApiResourceState> &getResourceState(ResourceId_t const &aId)
             {
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                // The reference stays valid, since unordered_map never relocates its elements.
                 addResourceState(aId, EGpuApiResourceState::Unknown);
                 return mGpuApiResourceStates.at(aId);
             }
@@ -97,6 +142,7 @@ namespace engine {
             SHIRABE_INLINE
             void removeResourceState(ResourceId_t const &aId)
             {
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
                 mGpuApiResourceStates.erase(aId);
             }
 
@@ -111,6 +157,13 @@ namespace engine {
             std::unordered_map<ResourceId_t, Shared<ILogicalResourceObject>>        mResourceObjects;
             std::unordered_map<ResourceId_t, core::CBitField<EGpuApiResourceState>> mGpuApiResourceStates;
             CAdjacencyTree<ResourceId_t>                                            mResourceTree;
+
+            // Guards the resource objects, states and the dependency tree against concurrent
+            // resource tasks. Never held while the gpu api operations execute.
+            std::recursive_mutex                                                    mResourceMutex;
+            std::condition_variable_any                                             mResourceStateChanged;
+            Shared<threading::CTaskGraph>                                           mTaskGraph;
+            std::unordered_map<ResourceId_t, threading::CTaskHandle>                mPendingInitializations;
         };
         //<-----------------------------------------------------------------------------
 
@@ -212,6 +265,8 @@ namespace engine {
         {
             CEngineResult<Shared<ILogicalResourceObject>> result = {EEngineStatus::Error, nullptr };
 
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
             auto const alreadyFoundIt = mResourceObjects.find(aResourceId);
             if(mResourceObjects.end() != mResourceObjects.find(aResourceId))
             {
@@ -234,53 +289,79 @@ namespace engine {
             logicalResourceOps.initialize =
                     [aResourceId, aDescriptor, gpuApiResourceId, gpuApiOps, this] (typename TResource::Dependencies_t const &aDependencies) -> CEngineResult<>
             {
-                if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Creating | EGpuApiResourceState::Created))
+                GpuApiResourceDependencies_t dependenciesResolved {};
                 {
-                    return EEngineStatus::Ok;
-                }
-                getResourceState(aResourceId).set(EGpuApiResourceState::Creating);
+                    std::unique_lock<std::recursive_mutex> lock(mResourceMutex);
 
-                Shared<ILogicalResourceObject> logicalResourceObject = getResourceObject(aResourceId);
-                if(nullptr == logicalResourceObject)
-                {
-                    return EEngineStatus::Error;
-                }
+                    // Another thread is creating the resource. Wait for it to finish, so that no caller
+                    // proceeds with a resource, which does not exist yet.
+                    mResourceStateChanged.wait(lock, [this, &aResourceId] () -> bool
+                    {
+                        return not getResourceState(aResourceId).check(EGpuApiResourceState::Creating);
+                    });
 
-                Shared<TResource> resourceObject = std::static_pointer_cast<TResource>(logicalResourceObject);
-                if(nullptr == resourceObject)
-                {
-                    return EEngineStatus::Error;
-                }
+                    if(getResourceState(aResourceId).check(EGpuApiResourceState::Created))
+                    {
+                        return EEngineStatus::Ok;
+                    }
 
-                resourceObject->setCurrentDependencies(aDependencies);
+                    Shared<ILogicalResourceObject> logicalResourceObject = getResourceObject(aResourceId);
+                    if(nullptr == logicalResourceObject)
+                    {
+                        return EEngineStatus::Error;
+                    }
 
-                Vector<ResourceId_t> resolveDependenciesList = aDependencies.resolve();
+                    Shared<TResource> resourceObject = std::static_pointer_cast<TResource>(logicalResourceObject);
+                    if(nullptr == resourceObject)
+                    {
+                        return EEngineStatus::Error;
+                    }
+
+                    getResourceState(aResourceId).set(EGpuApiResourceState::Creating);
+
+                    resourceObject->setCurrentDependencies(aDependencies);
 
-                insertDependencies(mResourceTree, aResourceId, std::move(resolveDependenciesList));
-                auto dependenciesResolved = getGpuApiDependencies(aResourceId);
+                    Vector<ResourceId_t> resolveDependenciesList = aDependencies.resolve();
 
+                    insertDependencies(mResourceTree, aResourceId, std::move(resolveDependenciesList));
+                    dependenciesResolved = getGpuApiDependencies(aResourceId);
+                }
+
+                // Executed unlocked, so that independent resources are created in parallel.
                 CEngineResult<> const result = gpuApiOps.initialize(aDescriptor, aDependencies, dependenciesResolved);
 
-                getResourceState(aResourceId).reset(EGpuApiResourceState::Created);
+                {
+                    std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                    // A failed creation may be retried by the next caller.
+                    getResourceState(aResourceId).reset(result.successful() ? EGpuApiResourceState::Created : EGpuApiResourceState::Unknown);
+                }
+                mResourceStateChanged.notify_all();
 
                 return result.result();
             };
             logicalResourceOps.deinitialize =
                     [aResourceId, gpuApiOps, this] (typename TResource::Dependencies_t const &aDependencies) -> CEngineResult<>
             {
-                if(not getResourceState(aResourceId).check(EGpuApiResourceState::Unloaded))
                 {
-                    return EEngineStatus::Error;
+                    std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                    if(not getResourceState(aResourceId).check(EGpuApiResourceState::Unloaded))
+                    {
+                        return EEngineStatus::Error;
+                    }
+
+                    if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Discarding | EGpuApiResourceState::Discarded))
+                    {
+                        return EEngineStatus::Ok;
+                    }
+                    getResourceState(aResourceId).set(EGpuApiResourceState::Discarding);
                 }
 
-                if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Discarding | EGpuApiResourceState::Discarded))
-                {
-                    return EEngineStatus::Ok;
-                }
-                getResourceState(aResourceId).set(EGpuApiResourceState::Discarding);
-
                 CEngineResult<> const result = gpuApiOps.deinitialize();
 
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
                 Vector<ResourceId_t> resolveDependenciesList = aDependencies.resolve();
                 removeDependencies(mResourceTree, aResourceId, std::move(resolveDependenciesList));
 
@@ -290,58 +371,79 @@ namespace engine {
             };
             logicalResourceOps.load = [gpuApiOps, aResourceId, this] () -> CEngineResult<>
             {
-                if(not getResourceState(aResourceId).check(EGpuApiResourceState::Created))
                 {
-                    return EEngineStatus::Error;
+                    std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                    if(not getResourceState(aResourceId).check(EGpuApiResourceState::Created))
+                    {
+                        return EEngineStatus::Error;
+                    }
+
+                    if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Loading | EGpuApiResourceState::Loaded))
+                    {
+                        return EEngineStatus::Ok;
+                    }
+                    getResourceState(aResourceId).set(EGpuApiResourceState::Loading);
                 }
 
-                if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Loading | EGpuApiResourceState::Loaded))
-                {
-                    return EEngineStatus::Ok;
-                }
-                getResourceState(aResourceId).set(EGpuApiResourceState::Loading);
-
                 CEngineResult<> const result = gpuApiOps.load();
 
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
                 getResourceState(aResourceId).unset(EGpuApiResourceState::Loading);
                 getResourceState(aResourceId).set  (EGpuApiResourceState::Loaded);
+
+                return result.result();
             };
             logicalResourceOps.unload = [gpuApiOps, aResourceId, this] () -> CEngineResult<>
             {
-                if(not getResourceState(aResourceId).check(EGpuApiResourceState::Loaded))
                 {
-                    return EEngineStatus::Error;
+                    std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                    if(not getResourceState(aResourceId).check(EGpuApiResourceState::Loaded))
+                    {
+                        return EEngineStatus::Error;
+                    }
+
+                    if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Unloading | EGpuApiResourceState::Unloaded))
+                    {
+                        return EEngineStatus::Ok;
+                    }
+                    getResourceState(aResourceId).set(EGpuApiResourceState::Unloading);
                 }
 
-                if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Unloading | EGpuApiResourceState::Unloaded))
-                {
-                    return EEngineStatus::Ok;
-                }
-                getResourceState(aResourceId).set(EGpuApiResourceState::Unloading);
-
                 CEngineResult<> const result = gpuApiOps.unload();
 
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
                 getResourceState(aResourceId).unset(EGpuApiResourceState::Loading | EGpuApiResourceState::Loaded);
                 getResourceState(aResourceId).unset(EGpuApiResourceState::Unloading);
                 getResourceState(aResourceId).set  (EGpuApiResourceState::Unloaded);
+
+                return result.result();
             };
             logicalResourceOps.transfer= [gpuApiOps, aResourceId, this] () -> CEngineResult<>
             {
-                if(not getResourceState(aResourceId).check(EGpuApiResourceState::Loaded))
-                {
-                    return EEngineStatus::Error;
-                }
-
-                if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Transferring | EGpuApiResourceState::Transferred))
                 {
-                    return EEngineStatus::Ok;
+                    std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+                    if(not getResourceState(aResourceId).check(EGpuApiResourceState::Loaded))
+                    {
+                        return EEngineStatus::Error;
+                    }
+
+                    if(getResourceState(aResourceId).checkAny(EGpuApiResourceState::Transferring | EGpuApiResourceState::Transferred))
+                    {
+                        return EEngineStatus::Ok;
+                    }
+                    getResourceState(aResourceId).set(EGpuApiResourceState::Transferring);
                 }
-                getResourceState(aResourceId).set(EGpuApiResourceState::Transferring);
 
                 CEngineResult<> const result = gpuApiOps.transfer();
 
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
                 getResourceState(aResourceId).unset(EGpuApiResourceState::Transferring);
                 getResourceState(aResourceId).set  (EGpuApiResourceState::Transferred);
+
+                return result.result();
             };
 
             Shared<ILogicalResourceObject> resource         = makeShared<TResource>(aDescriptor);
@@ -354,6 +456,63 @@ namespace engine {
             return { EEngineStatus::Ok, resource };
         }
         //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        template <typename TResource>
+        threading::CTaskHandle CResourceManager::initializeResourceAsync(
+                  ResourceId_t                       const &aResourceId
+                , typename TResource::Dependencies_t const &aDependencies
+                , Vector<threading::CTaskHandle>     const &aAdditionalDependencies)
+        {
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+            // Chain onto an initialization scheduled before instead of racing it.
+            auto const pending = mPendingInitializations.find(aResourceId);
+            if(mPendingInitializations.end() != pending && not pending->second.finished())
+            {
+                return pending->second;
+            }
+
+            // Wait for the initialization of all resources this one refers to, if scheduled.
+            Vector<threading::CTaskHandle> predecessors = aAdditionalDependencies;
+            for(ResourceId_t const &dependencyId : aDependencies.resolve())
+            {
+                auto const it = mPendingInitializations.find(dependencyId);
+                if(mPendingInitializations.end() != it)
+                {
+                    predecessors.push_back(it->second);
+                }
+            }
+
+            threading::CTaskHandle const handle = mTaskGraph->add([this, aResourceId, aDependencies] () -> CEngineResult<>
+            {
+                Shared<TResource> resource = std::static_pointer_cast<TResource>(getResourceObject(aResourceId));
+                if(nullptr == resource)
+                {
+                    CLog::Error(logTag(), "Cannot initialize resource {}. Not created.", aResourceId);
+                    return EEngineStatus::Error;
+                }
+
+                CEngineResult<> const result = resource->initialize(aDependencies);
+
+                // Dependents scheduled from now on find the resource created and don't have to wait.
+                std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+                mPendingInitializations.erase(aResourceId);
+
+                return result;
+            }, predecessors);
+
+            // Tasks executed inline finished already.
+            if(not handle.finished())
+            {
+                mPendingInitializations[aResourceId] = handle;
+            }
+
+            return handle;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
 
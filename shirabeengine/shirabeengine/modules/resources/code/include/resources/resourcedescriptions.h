@@ -5,6 +5,7 @@
 #ifndef SHIRABEDEVELOPMENT_RESOURCEDESCRIPTIONS_H
 #define SHIRABEDEVELOPMENT_RESOURCEDESCRIPTIONS_H
 
+#include <array>
 #include <vector>
 #include <platform/platform.h>
 #include <vulkan/vk_platform.h>
@@ -159,6 +160,7 @@ namespace engine
             bool               isColorAttachment;
             bool               isDepthAttachment;
             bool               isInputAttachment;
+            bool               mayAlias;
         };
 
         struct SAttachmentReference
@@ -302,6 +304,11 @@ namespace engine
             std::vector<ResourceId_t> bufferViewIds;
             std::vector<ResourceId_t> textureViewIds;
 
+            // The vertex layout of the meshes drawn with the pipeline, which the vertex input formats
+            // are taken from. If empty, the layout derived from the shader inputs is used.
+            std::vector<VkVertexInputBindingDescription>   vertexInputBindings;
+            std::vector<VkVertexInputAttributeDescription> vertexInputAttributes;
+
             SHIRABE_INLINE
             Vector<ResourceId_t> const resolve() const
             {
@@ -347,6 +354,26 @@ namespace engine
             }
         };
 
+        /**
+         * A level of detail of a mesh, i.e. a range of its index buffer.
+         */
+        struct SMeshLodRange
+        {
+            uint32_t firstIndex;
+            uint32_t indexCount;
+        };
+
+        /**
+         * Per draw data of a mesh, pushed to the vertex stage as push constants at offset 0.
+         * Positions dequantize to object space as positionOffset + positionScale * position.
+         */
+        struct SMeshDrawConstants
+        {
+            std::array<float, 4> positionScale;
+            std::array<float, 4> positionOffset;
+        };
+        static_assert(32 == sizeof(SMeshDrawConstants), "SMeshDrawConstants must match the push constant block of the vertex shaders.");
+
         struct
             [[nodiscard]]
             SHIRABE_TEST_EXPORT SMeshDescriptor
@@ -354,11 +381,14 @@ namespace engine
             std::string                               name;
             uint32_t                                  attributeCount;
             uint32_t                                  indexSampleCount;
+            uint32_t                                  indexBytesPerSample; // 2 or 4.
+            Vector<SMeshLodRange>                     lods; // Finest first.
             SBufferDescription                        dataBufferDescription;
             SBufferDescription                        indexBufferDescription;
             Vector<VkVertexInputBindingDescription>   bindingDescriptions;
             Vector<VkVertexInputAttributeDescription> attributeDescriptions;
-            Vector<VkDeviceSize>                      offsets;
+            Vector<VkDeviceSize>                      offsets; // Per binding, i.e. stream of the mesh, into the data buffer.
+            SMeshDrawConstants                        drawConstants;
         };
 
         struct
@@ -23,6 +23,9 @@ namespace engine
                 , mAssetLoaders               ()
                 , mResourceObjects            ()
                 , mResourceTree               ()
+                , mResourceMutex              ()
+                , mTaskGraph                  (makeShared<threading::CTaskGraph>())
+                , mPendingInitializations     ()
         { }
         //<-----------------------------------------------------------------------------
 
@@ -67,6 +70,24 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        void CResourceManager::setTaskGraph(Shared<threading::CTaskGraph> const &aTaskGraph)
+        {
+            if(nullptr == aTaskGraph)
+            {
+                return;
+            }
+
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+            // Handles refer to their graph, they can't be mixed.
+            mPendingInitializations.clear();
+            mTaskGraph = aTaskGraph;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -96,6 +117,8 @@ namespace engine
         bool CResourceManager::storeResourceObject(ResourceId_t                      const &aId
                                                    , Shared <ILogicalResourceObject> const &aObject)
         {
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
             bool const hasObjectForId = (mResourceObjects.end() != mResourceObjects.find( aId));
             if(false == hasObjectForId)
             {
@@ -111,6 +134,8 @@ namespace engine
         //<-----------------------------------------------------------------------------
         Shared<ILogicalResourceObject> CResourceManager::getResourceObject(ResourceId_t const &aId)
         {
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
             bool const hasObjectForId = (mResourceObjects.end() != mResourceObjects.find(aId));
             if(hasObjectForId)
             {
@@ -126,6 +151,10 @@ namespace engine
         //<-----------------------------------------------------------------------------
         void CResourceManager::removeResourceObject(ResourceId_t const &aId)
         {
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
+            mPendingInitializations.erase(aId);
+
             bool const hasObjectForId = (mResourceObjects.end() != mResourceObjects.find(aId));
             if(hasObjectForId)
             {
@@ -140,6 +169,8 @@ namespace engine
         //<-----------------------------------------------------------------------------
         GpuApiResourceDependencies_t CResourceManager::getGpuApiDependencies(ResourceId_t const &aId)
         {
+            std::lock_guard<std::recursive_mutex> guard(mResourceMutex);
+
             GpuApiResourceDependencies_t dependencies {};
             auto const adjacent = mResourceTree.getAdjacentFor(aId);
             for(auto const &dependencyId : adjacent)
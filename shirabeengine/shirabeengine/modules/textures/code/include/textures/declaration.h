@@ -257,6 +257,16 @@ namespace engine
                     return mImageLayersBinaryAssetUid;
                 }
 
+                /**
+                 * Return the byte range of a single image subresource within the image layers binary.
+                 * Array layers are stored back to back, each holding its full mip chain.
+                 *
+                 * @param aArrayLayer The array layer of the subresource.
+                 * @param aMipLevel   The mip level of the subresource.
+                 * @return            See brief. Empty, if the subresource does not exist.
+                 */
+                asset::SAssetDataRange imageSubresourceDataRange(uint32_t aArrayLayer, uint32_t aMipLevel) const;
+
         private_members:
             std::string         mName;
             asset::STextureInfo mTextureInfo;
@@ -1,8 +1,10 @@
 ﻿#ifndef __SHIARBE_TEXTURE_LOADER_H__
 #define __SHIARBE_TEXTURE_LOADER_H__
 
+#include <mutex>
 #include <log/log.h>
 #include <core/enginestatus.h>
+#include <core/threading/asyncresult.h>
 #include <resources/resourcedescriptions.h>
 
 namespace engine
@@ -34,6 +36,17 @@ namespace engine
              */
             explicit CTextureLoader();
 
+        public_static_functions:
+            /**
+             * Return the assets a texture meta file refers to, so that they can be prefetched.
+             * Matches asset::AssetDependencyResolver_t.
+             *
+             * @param aAsset The texture file.
+             * @param aData  The data of the texture file.
+             * @return       See brief. Empty, if the data can't be decoded.
+             */
+            static std::vector<asset::AssetId_t> resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData);
+
         public_methods:
 
             CEngineResult <Shared<CTextureInstance>> createInstance(asset::AssetID_t const &aAssetId);
@@ -43,10 +56,42 @@ namespace engine
             CEngineResult <Shared<CTextureInstance>> loadInstance( Shared<asset::IAssetStorage> const &aAssetStorage
                                                                  , asset::AssetID_t             const &aAssetId);
 
+            /**
+             * Load a texture instance on aTaskGraph.
+             *
+             * Reading and deserializing the meta file are separate stages. Concurrent requests
+             * for the same asset share a single pipeline. The loader must outlive the returned result.
+             *
+             * @param aTaskGraph    The graph to run the stages on.
+             * @param aAssetStorage The storage to read the files from.
+             * @param aAssetId      The texture asset to load.
+             * @return              A result referring to the instance.
+             */
+            threading::CAsyncResult<Shared<CTextureInstance>> loadInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                               , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                               , asset::AssetID_t              const &aAssetId);
+
+            /**
+             * Load the data of a single image subresource of aInstance, without reading the
+             * other layers and mip levels.
+             *
+             * @param aAssetStorage The storage to read the data from.
+             * @param aInstance     The texture to read the subresource of.
+             * @param aArrayLayer   The array layer to read.
+             * @param aMipLevel     The mip level to read.
+             * @return              The subresource data, if successful. An error otherwise.
+             */
+            CEngineResult<ByteBuffer> loadImageSubresourceData( Shared<asset::IAssetStorage> const &aAssetStorage
+                                                              , CTextureInstance             const &aInstance
+                                                              , uint32_t                            aArrayLayer
+                                                              , uint32_t                            aMipLevel);
+
             CEngineResult<> destroyInstance(asset::AssetID_t const &aAssetId);
 
         private_members:
-            Map <asset::AssetID_t, Shared<CTextureInstance>> mInstantiatedInstances;
+            std::recursive_mutex                                                         mMutex; // Guards the maps below. Recursive, since stages may run inline.
+            Map <asset::AssetID_t, Shared<CTextureInstance>>                             mInstantiatedInstances;
+            Map <asset::AssetID_t, threading::CAsyncResult<Shared<CTextureInstance>>>   mPendingInstances;
         };
 
     }
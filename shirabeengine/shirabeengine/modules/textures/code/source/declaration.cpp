@@ -1,4 +1,6 @@
-﻿#include "textures/declaration.h"
+﻿#include <algorithm>
+
+#include "textures/declaration.h"
 #include <util/documents/json.h>
 #include <graphicsapi/definitions.h>
 
@@ -244,4 +246,42 @@ namespace engine::textures
         return true;
     }
     //<-----------------------------------------------------------------------------
+
+    //<-----------------------------------------------------------------------------
+    //<
+    //<-----------------------------------------------------------------------------
+    asset::SAssetDataRange CTextureInstance::imageSubresourceDataRange(uint32_t aArrayLayer, uint32_t aMipLevel) const
+    {
+        asset::STextureInfo const &info = mTextureInfo;
+
+        uint32_t const arraySize = std::max<uint32_t>(1, info.arraySize);
+        uint32_t const mipLevels = std::max<uint32_t>(1, info.mipLevels);
+        if(aArrayLayer >= arraySize || aMipLevel >= mipLevels)
+        {
+            return { 0, 0 };
+        }
+
+        auto const mipSize = [&info] (uint32_t aLevel) -> uint64_t
+        {
+            uint64_t const width  = std::max<uint32_t>(1, info.width  >> aLevel);
+            uint64_t const height = std::max<uint32_t>(1, info.height >> aLevel);
+            uint64_t const depth  = std::max<uint32_t>(1, info.depth  >> aLevel);
+
+            return (width * height * depth * info.channels * info.bitsPerChannel) / 8;
+        };
+
+        uint64_t layerSize = 0;
+        uint64_t mipOffset = 0;
+        for(uint32_t k=0; k<mipLevels; ++k)
+        {
+            if(k == aMipLevel)
+            {
+                mipOffset = layerSize;
+            }
+            layerSize += mipSize(k);
+        }
+
+        return { ((aArrayLayer * layerSize) + mipOffset), mipSize(aMipLevel) };
+    }
+    //<-----------------------------------------------------------------------------
 }
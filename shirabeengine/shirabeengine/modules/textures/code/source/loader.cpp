@@ -27,25 +27,18 @@ namespace engine
         //<
         //<-----------------------------------------------------------------------------
         template <typename T>
-        CEngineResult<T> readFile(  std::string                  const &aLogTag
-                                  , Shared<asset::IAssetStorage> const &aAssetStorage
-                                  , asset::AssetId_t             const &aAssetUID)
+        CEngineResult<T> decodeFile(  std::string      const &aLogTag
+                                    , asset::AssetId_t const &aAssetUID
+                                    , ByteBuffer       const &aDataBuffer)
         {
             using namespace documents;
 
             CJSONDeserializer<T> deserializer {};
             deserializer.initialize();
 
-            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
-            {
-                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
-                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
-            }
-
-            std::string rawInput(reinterpret_cast<char const *>(dataBuffer.data()),
-                                                                dataBuffer.size());
-
-            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(rawInput);
+            // Parse in place. The buffer may be a view of a memory mapped file.
+            auto const [deserializationSuccessful, resultData] = deserializer.deserialize(reinterpret_cast<char const *>(aDataBuffer.data()),
+                                                                                          aDataBuffer.size());
             {
                 PrintEngineError(not deserializationSuccessful, aLogTag, "Could not load material file '{}'", aAssetUID);
                 SHIRABE_RETURN_RESULT_ON_ERROR(not deserializationSuccessful);
@@ -59,6 +52,48 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        CEngineResult<T> readFile(  std::string                  const &aLogTag
+                                  , Shared<asset::IAssetStorage> const &aAssetStorage
+                                  , asset::AssetId_t             const &aAssetUID)
+        {
+            auto const [dataFetchResult, dataBuffer] = aAssetStorage->loadAssetData(aAssetUID);
+            {
+                PrintEngineError(dataFetchResult, aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                SHIRABE_RETURN_RESULT_ON_ERROR(dataFetchResult);
+            }
+
+            return decodeFile<T>(aLogTag, aAssetUID, dataBuffer);
+        }
+        //<-----------------------------------------------------------------------------
+
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        threading::CAsyncResult<T> readFileAsync(  threading::CTaskGraph              &aTaskGraph
+                                                 , std::string                  const &aLogTag
+                                                 , Shared<asset::IAssetStorage> const &aAssetStorage
+                                                 , asset::AssetId_t             const &aAssetUID)
+        {
+            // Stage 1: I/O. Stage 2: Deserialization.
+            threading::CAsyncResult<ByteBuffer> const data = threading::async<ByteBuffer>(aTaskGraph, [=] () -> CEngineResult<ByteBuffer>
+            {
+                CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetData(aAssetUID);
+                PrintEngineError(dataFetch.result(), aLogTag, "Could not load asset data for asset {}", aAssetUID);
+                return dataFetch;
+            });
+
+            return data.then([=] (ByteBuffer const &aDataBuffer) -> CEngineResult<T>
+            {
+                return decodeFile<T>(aLogTag, aAssetUID, aDataBuffer);
+            });
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -68,6 +103,26 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        std::vector<asset::AssetId_t> CTextureLoader::resolveDependencies(asset::SAsset const &aAsset, ByteBuffer const &aData)
+        {
+            if(EAssetSubtype::Meta != aAsset.subtype)
+            {
+                return {};
+            }
+
+            auto const [result, meta] = decodeFile<STextureMeta>(logTag(), aAsset.id, aData);
+            if(CheckEngineError(result))
+            {
+                return {};
+            }
+
+            return { meta.imageLayersBinaryUid };
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -77,6 +132,27 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        CEngineResult<ByteBuffer> CTextureLoader::loadImageSubresourceData( Shared<asset::IAssetStorage> const &aAssetStorage
+                                                                          , CTextureInstance             const &aInstance
+                                                                          , uint32_t                            aArrayLayer
+                                                                          , uint32_t                            aMipLevel)
+        {
+            asset::SAssetDataRange const range = aInstance.imageSubresourceDataRange(aArrayLayer, aMipLevel);
+            if(0 == range.length)
+            {
+                CLog::Error(logTag(), "Texture '{}' has no subresource at layer {}, mip level {}.", aInstance.name(), aArrayLayer, aMipLevel);
+                return { EEngineStatus::Error };
+            }
+
+            CEngineResult<ByteBuffer> dataFetch = aAssetStorage->loadAssetDataRange(aInstance.imageLayersBinaryAssetUid(), range.offset, range.length);
+            PrintEngineError(dataFetch.result(), logTag(), "Could not load subresource data for texture '{}'", aInstance.name());
+            return dataFetch;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
@@ -108,12 +184,15 @@ namespace engine
             //
             Shared<CTextureInstance> instance = nullptr;
 
+            std::unique_lock<std::recursive_mutex> lock(mMutex);
             if(mInstantiatedInstances.end() != mInstantiatedInstances.find(aAssetId))
             {
                 instance = mInstantiatedInstances.at(aAssetId);
             }
             else
             {
+                lock.unlock();
+
                 auto const [metaDataFetchResult, metaData] = readMeta(logTag(), aAssetStorage, aAssetId);
                 {
                     PrintEngineError(metaDataFetchResult, logTag(), "Could not fetch master meta data.");
@@ -123,8 +202,14 @@ namespace engine
                 static uint64_t sInstanceIndex = 0;
                 std::string instanceName = fmt::format("{}_instance_{}", metaData.name, ++sInstanceIndex);
 
-                instance = makeShared<CTextureInstance>(metaData.name, metaData.textureInfo, metaData.imageLayersBinaryUid);
-                mInstantiatedInstances[aAssetId] = instance;
+                lock.lock();
+                // An asynchronous load might have finished in the meantime. Keep the first instance.
+                auto const [iterator, inserted] = mInstantiatedInstances.insert({ aAssetId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CTextureInstance>(metaData.name, metaData.textureInfo, metaData.imageLayersBinaryUid);
+                }
+                instance = iterator->second;
             }
 
             if(nullptr == instance)
@@ -136,5 +221,61 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        threading::CAsyncResult<Shared<CTextureInstance>> CTextureLoader::loadInstanceAsync( Shared<threading::CTaskGraph> const &aTaskGraph
+                                                                                          , Shared<asset::IAssetStorage>  const &aAssetStorage
+                                                                                          , asset::AssetID_t              const &aAssetId)
+        {
+            using namespace threading;
+
+            CTaskGraph        &graph   = *aTaskGraph;
+            std::string const  tag     = logTag();
+            AssetID_t   const  assetId = aAssetId;
+
+            std::lock_guard<std::recursive_mutex> guard(mMutex);
+
+            if(mInstantiatedInstances.end() != mInstantiatedInstances.find(assetId))
+            {
+                return ready<Shared<CTextureInstance>>(graph, { EEngineStatus::Ok, mInstantiatedInstances.at(assetId) });
+            }
+
+            // Join a pending load. Failed loads are retried.
+            auto const pending = mPendingInstances.find(assetId);
+            if(mPendingInstances.end() != pending)
+            {
+                bool const failed = (pending->second.finished() && not pending->second.get().successful());
+                if(not failed)
+                {
+                    return pending->second;
+                }
+                mPendingInstances.erase(pending);
+            }
+
+            CAsyncResult<STextureMeta> const meta = readFileAsync<STextureMeta>(graph, tag, aAssetStorage, assetId);
+
+            CAsyncResult<Shared<CTextureInstance>> const instance = meta.then([this, assetId] (STextureMeta const &aMeta) -> CEngineResult<Shared<CTextureInstance>>
+            {
+                std::lock_guard<std::recursive_mutex> guard(mMutex);
+                auto const [iterator, inserted] = mInstantiatedInstances.insert({ assetId, nullptr });
+                if(inserted)
+                {
+                    iterator->second = makeShared<CTextureInstance>(aMeta.name, aMeta.textureInfo, aMeta.imageLayersBinaryUid);
+                }
+                mPendingInstances.erase(assetId);
+
+                return { EEngineStatus::Ok, iterator->second };
+            });
+
+            // The last stage can't finish while the lock is held, unless it ran inline already.
+            if(not instance.finished())
+            {
+                mPendingInstances[assetId] = instance;
+            }
+
+            return instance;
+        }
+        //<-----------------------------------------------------------------------------
     }
 }
@@ -709,6 +709,15 @@ namespace engine
              */
             CResult<Shared<typename IJSONDeserializer<T>::IResult>> deserialize(std::vector<uint8_t> const &aSource);
 
+            /*!
+             * Deserialize JSON text in place, e.g. from a memory mapped file, without copying it into a string first.
+             *
+             * @param aSource Pointer to the first character of the JSON text.
+             * @param aSize   Number of characters.
+             * @return
+             */
+            CResult<Shared<typename IJSONDeserializer<T>::IResult>> deserialize(char const *aSource, std::size_t aSize);
+
             /**
              * Begin a JSON array, to which the upcoming objects will be added.
              *
@@ -877,6 +886,32 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //<
+        //<-----------------------------------------------------------------------------
+        template <typename T>
+        CResult<Shared<typename IJSONDeserializer<T>::IResult>> CJSONDeserializer<T>::deserialize(char const *aSource, std::size_t aSize)
+        {
+            nlohmann::json json = nlohmann::json::parse(aSource, aSource + aSize);
+            mRoot = json;
+            mCurrentJSONState.push(mRoot);
+
+            IJSONDeserializer<T> &deserializer = *this;
+
+            T data {};
+
+            bool const successful = data.acceptDeserializer(deserializer);
+            if(successful)
+            {
+                auto result = makeShared<CDeserializationResult>(data);
+
+                return { std::move(result) };
+            }
+
+            return successful;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
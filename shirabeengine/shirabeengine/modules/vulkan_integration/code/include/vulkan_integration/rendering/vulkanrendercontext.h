@@ -154,7 +154,7 @@ namespace engine
              */
             EEngineStatus present() final;
 
-            EEngineStatus bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets) final;
+            EEngineStatus bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets, VkIndexType aIndexType) final;
 
             /**
              * Bind a pipeline instance  in the GPU.
@@ -174,6 +174,17 @@ namespace engine
              */
             EEngineStatus unbindPipeline(GpuApiHandle_t const &aPipelineUID) final;
 
+            /**
+             * Push per draw data to the vertex stage of a bound pipeline instance.
+             *
+             * @param aPipelineUID The uid of the bound pipeline instance.
+             * @param aData        The data to push at offset 0.
+             * @param aSize        The size of aData in bytes.
+             * @return             EEngineStatus::Ok, if successful.
+             * @return             EEngineStatus::Error, if failed.
+             */
+            EEngineStatus pushVertexConstants(GpuApiHandle_t const &aPipelineUID, void const *aData, uint32_t aSize) final;
+
             /**
              * Bind a resource to the pipeline.
              *
@@ -198,7 +209,7 @@ namespace engine
              */
             EEngineStatus render(SRenderable const &aRenderable) final;
 
-            EEngineStatus drawIndex(uint32_t const aIndexCount) final;
+            EEngineStatus drawIndex(uint32_t const aIndexCount, uint32_t const aFirstIndex) final;
 
             EEngineStatus drawQuad() final;
 
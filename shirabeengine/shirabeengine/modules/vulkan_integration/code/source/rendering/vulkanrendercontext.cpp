@@ -733,7 +733,7 @@ namespace engine
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
-        EEngineStatus CVulkanRenderContext::bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets)
+        EEngineStatus CVulkanRenderContext::bindAttributeAndIndexBuffers(GpuApiHandle_t const &aAttributeBufferId, GpuApiHandle_t const &aIndexBufferId, Vector<VkDeviceSize> aOffsets, VkIndexType aIndexType)
         {
             SVulkanState     &vkState        = mVulkanEnvironment->getState();
             VkCommandBuffer  vkCommandBuffer = mVulkanEnvironment->getVkCurrentFrameContext()->getGraphicsCommandBuffer();
@@ -747,10 +747,11 @@ namespace engine
                 return EEngineStatus::Error;
             }
 
-            std::vector<VkBuffer> buffers = { attributeBuffer->handle, attributeBuffer->handle, attributeBuffer->handle, attributeBuffer->handle };
+            // All streams of the mesh live in the attribute buffer, one binding per offset.
+            std::vector<VkBuffer> buffers(aOffsets.size(), attributeBuffer->handle);
 
             vkCmdBindVertexBuffers(vkCommandBuffer, 0, buffers.size(), buffers.data(), aOffsets.data());
-            vkCmdBindIndexBuffer(vkCommandBuffer, indexBuffer->handle, 0, VkIndexType::VK_INDEX_TYPE_UINT16);
+            vkCmdBindIndexBuffer(vkCommandBuffer, indexBuffer->handle, 0, aIndexType);
 
             return EEngineStatus::Ok;
         }
@@ -795,6 +796,26 @@ namespace engine
         }
         //<-----------------------------------------------------------------------------
 
+        //<-----------------------------------------------------------------------------
+        //
+        //<-----------------------------------------------------------------------------
+        EEngineStatus CVulkanRenderContext::pushVertexConstants(GpuApiHandle_t const &aPipelineUID, void const *aData, uint32_t aSize)
+        {
+            VkCommandBuffer vkCommandBuffer = mVulkanEnvironment->getVkCurrentFrameContext()->getGraphicsCommandBuffer();
+
+            auto const *const pipeline = mVulkanEnvironment->getResourceStorage()->extract<CVulkanPipelineResource>(aPipelineUID);
+            if(nullptr == pipeline)
+            {
+                CLog::Error(logTag(), "Failed to fetch pipeline '{}'.", aPipelineUID);
+                return EEngineStatus::Error;
+            }
+
+            vkCmdPushConstants(vkCommandBuffer, pipeline->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, aSize, aData);
+
+            return EEngineStatus::Ok;
+        }
+        //<-----------------------------------------------------------------------------
+
         //<-----------------------------------------------------------------------------
         //<
         //<-----------------------------------------------------------------------------
@@ -828,12 +849,12 @@ namespace engine
         //<-----------------------------------------------------------------------------
         //
         //<-----------------------------------------------------------------------------
-        EEngineStatus CVulkanRenderContext::drawIndex(uint32_t const aIndexCount)
+        EEngineStatus CVulkanRenderContext::drawIndex(uint32_t const aIndexCount, uint32_t const aFirstIndex)
         {
             SVulkanState     &vkState        = mVulkanEnvironment->getState();
             VkCommandBuffer  vkCommandBuffer = mVulkanEnvironment->getVkCurrentFrameContext()->getGraphicsCommandBuffer(); // The commandbuffers and swapchain count currently match
 
-            vkCmdDrawIndexed(vkCommandBuffer, aIndexCount, 1, 0, 0, 0);
+            vkCmdDrawIndexed(vkCommandBuffer, aIndexCount, 1, aFirstIndex, 0, 0);
 
             return EEngineStatus::Ok;
         }
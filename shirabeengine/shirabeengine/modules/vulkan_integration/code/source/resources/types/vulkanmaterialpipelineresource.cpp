@@ -32,14 +32,20 @@ namespace engine::vulkan
         // Create the shader modules here...
         // IMPORTANT: The task backend receives access to the asset system to not have the raw data stored in the descriptors and requests...
 
+        // The shader inputs only tell the types after conversion. Quantized meshes bring their own formats.
+        bool const useMeshVertexLayout = not aDependencies.vertexInputAttributes.empty();
+
+        std::vector<VkVertexInputBindingDescription>   const &vertexInputBindings   = useMeshVertexLayout ? aDependencies.vertexInputBindings   : aDescription.vertexInputBindings;
+        std::vector<VkVertexInputAttributeDescription> const &vertexInputAttributes = useMeshVertexLayout ? aDependencies.vertexInputAttributes : aDescription.vertexInputAttributes;
+
         VkPipelineVertexInputStateCreateInfo vertexInputStateCreateInfo {};
         vertexInputStateCreateInfo.sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
         vertexInputStateCreateInfo.pNext                           = nullptr;
         vertexInputStateCreateInfo.flags                           = 0;
-        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(aDescription.vertexInputAttributes.size());
-        vertexInputStateCreateInfo.vertexBindingDescriptionCount   = static_cast<uint32_t>(aDescription.vertexInputBindings  .size());
-        vertexInputStateCreateInfo.pVertexAttributeDescriptions    = aDescription.vertexInputAttributes.data();
-        vertexInputStateCreateInfo.pVertexBindingDescriptions      = aDescription.vertexInputBindings  .data();
+        vertexInputStateCreateInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexInputAttributes.size());
+        vertexInputStateCreateInfo.vertexBindingDescriptionCount   = static_cast<uint32_t>(vertexInputBindings  .size());
+        vertexInputStateCreateInfo.pVertexAttributeDescriptions    = vertexInputAttributes.data();
+        vertexInputStateCreateInfo.pVertexBindingDescriptions      = vertexInputBindings  .data();
 
         VkRect2D scissor {};
         scissor.offset = { 0, 0 };
@@ -185,12 +191,18 @@ namespace engine::vulkan
             vkDescriptorSets.push_back(set);
         }
 
+        // The per draw data of meshes, see SMeshDrawConstants.
+        VkPushConstantRange meshDrawConstantRange {};
+        meshDrawConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        meshDrawConstantRange.offset     = 0;
+        meshDrawConstantRange.size       = sizeof(SMeshDrawConstants);
+
         VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {};
         pipelineLayoutCreateInfo.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         pipelineLayoutCreateInfo.pNext                  = nullptr;
         pipelineLayoutCreateInfo.flags                  = 0;
-        pipelineLayoutCreateInfo.pPushConstantRanges    = nullptr;
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
+        pipelineLayoutCreateInfo.pPushConstantRanges    = &meshDrawConstantRange;
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
         pipelineLayoutCreateInfo.pSetLayouts            = setLayouts.data();
         pipelineLayoutCreateInfo.setLayoutCount         = setLayouts.size();
 
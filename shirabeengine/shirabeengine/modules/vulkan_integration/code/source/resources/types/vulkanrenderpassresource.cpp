@@ -31,7 +31,7 @@ namespace engine::vulkan
             vkAttachmentDesc.finalLayout    = static_cast<VkImageLayout>      (attachmentDesc.finalLayout);
             vkAttachmentDesc.format         = CVulkanDeviceCapsHelper::convertFormatToVk(attachmentDesc.format);
             vkAttachmentDesc.samples        = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT;
-            vkAttachmentDesc.flags          = 0;
+            vkAttachmentDesc.flags          = (attachmentDesc.mayAlias ? VK_ATTACHMENT_DESCRIPTION_MAY_ALIAS_BIT : 0);
 
             vkAttachmentDescriptions.push_back(vkAttachmentDesc);
         }
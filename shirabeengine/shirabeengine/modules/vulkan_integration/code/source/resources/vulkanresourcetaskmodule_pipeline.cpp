@@ -86,15 +86,16 @@ namespace engine
 
                     // We need to convert from a regular 8-bit data buffer to uint32 words of SPIR-V.
                     // TODO: Refactor the asset system to permit loading 32-bit buffers...
-                    std::vector<signed char> const &srcData      = data.dataVector();
-                    uint32_t const                  srcDataSize  = srcData.size();
+                    // Read through data(), the buffer may be a view of a memory mapped file.
+                    uint8_t const *const srcData     = data.data();
+                    uint32_t const       srcDataSize = data.size();
 
                     std::vector<uint32_t> convData {};
                     convData.resize( srcDataSize / 4 );
 
                     for(uint32_t k=0; k<srcDataSize; k += 4)
                     {
-                        uint32_t const value = *reinterpret_cast<uint32_t const*>( srcData.data() + k );
+                        uint32_t const value = *reinterpret_cast<uint32_t const*>( srcData + k );
                         convData[ k / 4 ] = value;
                     }
 
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+buildOne ()
+{
+    cd ${source_directory}/lib
+
+    # The library is built in-source, so drop the objects of the previous address mode.
+    make clean
+
+    make -j12
+    make install PREFIX=${deploy_directory}
+
+    cd ${THIS}
+}
+
+buildOne
@@ -2,6 +2,8 @@
 
 LIBRARIES=(                             \
            zlib                         \
+           lz4                          \
+           zstd                         \
            libxml2                      \
            libxslt                      \
            nlohmann_json                \
@@ -7,6 +7,8 @@ DEPLOY_DIR=${THIS}/_deploy
 
 declare -A REPOSITORIES
 REPOSITORIES[zlib]="git@github.com:madler/zlib.git"
+REPOSITORIES[lz4]="git@github.com:lz4/lz4.git"
+REPOSITORIES[zstd]="git@github.com:facebook/zstd.git"
 REPOSITORIES[libxml2]="git@github.com:GNOME/libxml2.git"
 REPOSITORIES[libxslt]="git@github.com:GNOME/libxslt.git"
 REPOSITORIES[nlohmann_json]="git@github.com:nlohmann/json.git"
@@ -31,6 +33,8 @@ REPOSITORIES[fmt]="git@github.com:fmtlib/fmt.git"
 
 declare -A TARGET_DIRECTORIES
 TARGET_DIRECTORIES[zlib]="${SOURCES_DIR}/zlib"
+TARGET_DIRECTORIES[lz4]="${SOURCES_DIR}/lz4"
+TARGET_DIRECTORIES[zstd]="${SOURCES_DIR}/zstd"
 TARGET_DIRECTORIES[libxml2]="${SOURCES_DIR}/libxml2"
 TARGET_DIRECTORIES[libxslt]="${SOURCES_DIR}/libxslt"
 TARGET_DIRECTORIES[googletest]="${SOURCES_DIR}/googletest"
@@ -150,6 +154,8 @@ function setup_glslang
 function setup_tools
 {
     setup_one zlib
+    setup_one lz4
+    setup_one zstd
     setup_one libxml2
     setup_one libxslt
     setup_one nlohmann_json